@@ -0,0 +1,74 @@
+#ifndef __APP_BATCH_H__
+#define __APP_BATCH_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "app_calib.h"
+
+// 一个批次最多容纳的样本数（列存储数组的长度）
+#define APP_BATCH_CAPACITY 50
+
+// 两次紧急上报的最小间隔：持续出现紧急样本时按这个节奏上报，不会每次唤醒都发一次
+#define APP_BATCH_URGENT_GAP_MS 1000
+
+// 样本优先级：紧急样本把批次标记为紧急，本轮收取结束后上报（受 APP_BATCH_URGENT_GAP_MS 限制）
+typedef enum
+{
+    APP_BATCH_PRIO_NORMAL = 0,
+    APP_BATCH_PRIO_URGENT,
+} app_batch_prio_t;
+
+// 批量上报配置：攒够 max_samples 个样本，或最早的样本已超过 max_age_ms，就上报一次
+typedef struct
+{
+    uint16_t max_samples; // 1~APP_BATCH_CAPACITY
+    uint32_t max_age_ms;  // 100~600000
+} app_batch_config_t;
+
+/**
+ * 按列存放的一批样本，上报时每个字段输出成一个数组，省掉每个样本重复的键名和外层信封
+ * 时间戳存成相对第一个样本的偏移（微秒），只在处理任务中使用
+ */
+typedef struct
+{
+    int64_t t0_us;                      // 第一个样本的采样时刻（esp_timer 微秒）
+    uint16_t count;                     // 已有样本数
+    bool urgent;                        // 批次中有紧急样本
+    int64_t urgent_us;                  // 紧急批次的上报时刻（采样时间轴），重置批次时保留，用于限制上报间隔
+    int32_t dt_us[APP_BATCH_CAPACITY];  // 相对 t0_us 的偏移
+    int32_t ax[APP_BATCH_CAPACITY];     // mg
+    int32_t ay[APP_BATCH_CAPACITY];
+    int32_t az[APP_BATCH_CAPACITY];
+    int32_t gx[APP_BATCH_CAPACITY];     // mdps
+    int32_t gy[APP_BATCH_CAPACITY];
+    int32_t gz[APP_BATCH_CAPACITY];
+    int32_t temp[APP_BATCH_CAPACITY];   // 0.01°C
+} app_batch_t;
+
+esp_err_t app_batch_set_config(const app_batch_config_t *config);
+void app_batch_get_config(app_batch_config_t *config);
+
+void app_batch_reset(app_batch_t *batch);
+
+/**
+ * @brief 加入一个样本
+ *
+ * 紧急样本只标记批次，不要求当场上报：同一轮收到多个紧急样本时，收取完再由 app_batch_due 触发一次上报，
+ * 且距上一次紧急上报不少于 APP_BATCH_URGENT_GAP_MS
+ *
+ * @return true 批次已满，需要先上报再继续加入（上报后调用 app_batch_reset）
+ */
+bool app_batch_push(app_batch_t *batch, const app_sample_t *sample, app_batch_prio_t prio);
+
+/**
+ * @brief 批次到期的时刻（esp_timer 微秒，紧急批次取紧急上报时刻），空批次返回 INT64_MAX
+ */
+int64_t app_batch_deadline_us(const app_batch_t *batch);
+
+/**
+ * @brief 是否需要上报：满、紧急且已过上报间隔，或已到期
+ */
+bool app_batch_due(const app_batch_t *batch, int64_t now_us);
+
+#endif // __APP_BATCH_H__
@@ -0,0 +1,121 @@
+#ifndef __APP_CALIB_H__
+#define __APP_CALIB_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "platform.h"
+
+// 标定的轴：加速度 XYZ + 陀螺仪 XYZ
+#define APP_CALIB_AXES 6
+
+// 温度补偿表的最大点数
+#define APP_CALIB_TEMP_POINTS 8
+
+// Q15 定点数的 1.0
+#define APP_CALIB_Q15_ONE 32768
+
+// 在线零偏标定最多收集的样本数（各轴累加用 int32，32768 * 1000 不会溢出）
+#define APP_CALIB_ZERO_SAMPLES_MAX 1000
+
+// 轴下标
+enum
+{
+    APP_CALIB_AX = 0,
+    APP_CALIB_AY,
+    APP_CALIB_AZ,
+    APP_CALIB_GX,
+    APP_CALIB_GY,
+    APP_CALIB_GZ,
+};
+
+// 温度补偿表的一个点：在该温度下各轴额外的零偏
+typedef struct
+{
+    int16_t temp_cdeg;              // 温度（0.01°C）
+    int16_t offset[APP_CALIB_AXES]; // 额外零偏（原始 LSB）
+} app_calib_temp_point_t;
+
+// 标定参数（整体保存在 NVS 中）
+typedef struct
+{
+    int16_t bias[APP_CALIB_AXES];                             // 零偏（原始 LSB）
+    int32_t scale_q15[APP_CALIB_AXES];                        // 比例系数（Q15，APP_CALIB_Q15_ONE 表示 1.0）
+    uint8_t temp_points;                                      // 温度补偿表有效点数，0 表示不做温度补偿
+    app_calib_temp_point_t temp_table[APP_CALIB_TEMP_POINTS]; // 按温度升序排列
+} app_calib_t;
+
+// 标定参数的快照：采集任务每批样本取一次，换算时不再加锁
+typedef struct
+{
+    app_calib_t cal;
+    int32_t gain_q15[APP_CALIB_AXES]; // 每轴换算系数（Q15）：量程换算 × 比例系数
+} app_calib_snap_t;
+
+// 样本标志
+#define APP_SAMPLE_F_URGENT 0x01 // 需要尽快上报（例如加速度接近满量程的冲击）
+
+// 标定后的样本（物理单位）
+typedef struct
+{
+    int64_t ts_us;        // 采样时刻（esp_timer 微秒）
+    int32_t gx, gy, gz;   // 角速度（mdps，千分之一度每秒）
+    int16_t ax, ay, az;   // 加速度（mg，千分之一 g）
+    int16_t temp;         // 温度（0.01°C）
+    uint8_t flags;        // APP_SAMPLE_F_*，占用原本的填充字节，结构体仍为 32 字节
+} app_sample_t;
+
+/**
+ * @brief 初始化标定模块：从 NVS 读取标定参数（没有则使用默认值），并按当前量程计算换算系数
+ */
+esp_err_t app_calib_init(void);
+
+void app_calib_get(app_calib_t *cal);
+
+/**
+ * @brief 设置标定参数
+ *
+ * @param cal     新的标定参数
+ * @param persist 是否写入 NVS
+ */
+esp_err_t app_calib_set(const app_calib_t *cal, bool persist);
+
+/**
+ * @brief 发起在线零偏标定：由采集任务收集接下来的 n 个原始样本（app_calib_collect），不等待
+ *
+ * 收齐后调用 app_calib_zero_finish 求零偏：陀螺仪应为 0，加速度计应为 (0, 0, +1g)，设备须保持静止、Z 轴朝上
+ *
+ * @param n       样本数（1~APP_CALIB_ZERO_SAMPLES_MAX）
+ * @param persist 求出零偏后是否写入 NVS
+ * @return ESP_ERR_INVALID_STATE 已有标定在进行
+ */
+esp_err_t app_calib_zero_start(uint16_t n, bool persist);
+
+/**
+ * @brief 完成在线零偏标定：样本收齐时求零偏并设置
+ *
+ * @param cancel  还没收齐时取消（超时），参数不变
+ * @param samples 输出参与计算的样本数（可传 NULL）
+ * @return ESP_ERR_NOT_FINISHED 还没收齐；ESP_ERR_TIMEOUT 已取消；ESP_ERR_INVALID_STATE 没有进行中的标定
+ */
+esp_err_t app_calib_zero_finish(bool cancel, uint16_t *samples);
+
+/**
+ * @brief 把一批原始样本交给进行中的在线零偏标定（采集任务调用，没有进行中的标定时直接返回）
+ *
+ * @return true 这一批让标定收齐了样本，调用方应通知发起方来完成
+ */
+bool app_calib_collect(const SensorData *raw, size_t n);
+
+/**
+ * @brief 取当前标定参数的快照（采集任务每批样本调用一次）
+ */
+void app_calib_snapshot(app_calib_snap_t *snap);
+
+/**
+ * @brief 按快照标定并换算成物理单位（采集热路径，只用整数运算，不加锁）
+ */
+void app_calib_apply(const app_calib_snap_t *snap, const SensorData *raw, app_sample_t *out);
+
+#endif // __APP_CALIB_H__
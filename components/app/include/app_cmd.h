@@ -0,0 +1,107 @@
+#ifndef __APP_CMD_H__
+#define __APP_CMD_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "json_writer.h"
+
+// 指令应答的上行主题
+#define APP_CMD_RESP_TOPIC "test/topic/resp"
+
+// 单条指令最多的参数个数，字符串参数的最大长度（含 '\0'）
+#define APP_CMD_ARGS_MAX 4
+#define APP_CMD_STR_MAX 16
+
+/**
+ * 下行指令格式：{"id":1,"cmd":"set_rate","args":{"sample_hz":200,"output_hz":50}}
+ * - id 可选，原样带回应答中，便于服务端对应请求
+ * - 应答：{"id":1,"cmd":"set_rate","ok":true,...} 或 {"id":1,"cmd":"set_rate","ok":false,"err":"...","arg":"..."}
+ *
+ * 指令表按名称排序，二分查找；参数按表中的类型和范围校验通过后才交给处理函数，整个过程不分配内存
+ *
+ * 要等其他任务完成的指令（calibrate、set_rate）不在处理函数里等：处理函数发起操作后返回 ESP_ERR_NOT_FINISHED，
+ * dispatch 先不应答；其他任务完成后通知处理任务调用 app_cmd_poll，由表中的 finish 取结果并生成应答
+ */
+
+// 参数类型
+typedef enum
+{
+    APP_CMD_ARG_INT = 0,
+    APP_CMD_ARG_BOOL,
+    APP_CMD_ARG_STRING,
+} app_cmd_arg_type_t;
+
+// 参数说明：整数按 [min, max] 校验，字符串按长度 [min, max] 校验
+typedef struct
+{
+    const char *name;
+    app_cmd_arg_type_t type;
+    bool required;
+    int32_t min;
+    int32_t max;
+} app_cmd_arg_spec_t;
+
+// 校验后的参数值，与参数说明一一对应
+typedef struct
+{
+    bool present;
+    int32_t i;
+    bool b;
+    char s[APP_CMD_STR_MAX];
+} app_cmd_arg_t;
+
+/**
+ * 指令处理函数：参数已校验，可以往应答里追加字段（应答对象已打开，不要关闭）
+ * 返回 ESP_OK 以外的值时应答为 ok:false，err 为错误码名称
+ */
+typedef esp_err_t (*app_cmd_handler_t)(const app_cmd_arg_t *args, json_writer_t *resp);
+
+/**
+ * 延后完成的指令取结果：返回 ESP_ERR_NOT_FINISHED 表示还没完成，其他值同处理函数
+ * expired 为 true 时已超时，必须取消操作并给出最终结果
+ */
+typedef esp_err_t (*app_cmd_finish_t)(bool expired, json_writer_t *resp);
+
+typedef struct
+{
+    const char *name;
+    app_cmd_handler_t handler;
+    const app_cmd_arg_spec_t *args;
+    uint8_t arg_count;
+    app_cmd_finish_t finish; // 延后完成的指令才有，NULL 表示处理函数当场给出结果
+    uint32_t timeout_ms;     // 延后完成的最长时间
+} app_cmd_t;
+
+/**
+ * @brief 检查指令表是否按名称排序（启动时调用一次）
+ */
+esp_err_t app_cmd_init(void);
+
+/**
+ * @brief 解析并执行一条下行指令，生成应答
+ *
+ * @param json 下行 JSON
+ * @param len 长度
+ * @param resp 应答缓冲区
+ * @param cap 缓冲区大小
+ * @return 应答长度；应答放不下，或指令已发起、应答由 app_cmd_poll 给出时返回 0
+ */
+size_t app_cmd_dispatch(const char *json, size_t len, char *resp, size_t cap);
+
+/**
+ * @brief 检查延后完成的指令，给出一条已完成（或已超时）的应答
+ *
+ * 与 app_cmd_dispatch 在同一个任务中调用；每次最多给出一条，返回 0 前反复调用
+ *
+ * @return 应答长度；没有完成的指令时返回 0
+ */
+size_t app_cmd_poll(char *resp, size_t cap);
+
+/**
+ * @brief 最早一条延后完成的指令的超时时刻（esp_timer 微秒），没有时返回 INT64_MAX
+ */
+int64_t app_cmd_deadline_us(void);
+
+#endif // __APP_CMD_H__
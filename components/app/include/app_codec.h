@@ -0,0 +1,47 @@
+#ifndef __APP_CODEC_H__
+#define __APP_CODEC_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "app_batch.h"
+
+// 上报数据的格式版本：所有编码器输出同样的字段，解码端按 ver 解析
+// ver 3：按列批量上报，t0 + dt 时间戳，数据为标定后的物理单位
+#define APP_CODEC_SCHEMA_VER 3
+
+// 编码器
+typedef enum
+{
+    APP_CODEC_JSON = 0, // 文本 JSON，便于调试
+    APP_CODEC_CBOR,     // 二进制 CBOR，字段与 JSON 相同，体积更小，适合蜂窝网络
+    APP_CODEC_DELTA,    // 差分 + zigzag 变长整数，高采样率下体积最小（格式见 app_codec.c）
+    APP_CODEC_MAX,
+} app_codec_id_t;
+
+/**
+ * 编码器接口：每种编码有自己的上行主题，服务端按主题选择解码器
+ * encode_batch 把批次中第 start 个起的 n 个样本编码进 buf，放不下时返回 0
+ */
+typedef struct
+{
+    const char *name;  // 名称，下行指令中用来选择编码器
+    const char *topic; // 上行主题
+    size_t (*encode_batch)(const app_batch_t *batch, uint16_t start, uint16_t n, uint8_t *buf, size_t len);
+} app_codec_t;
+
+const app_codec_t *app_codec_get(app_codec_id_t id);
+
+// 按名称查找编码器（"json" / "cbor" / "delta"）
+esp_err_t app_codec_find(const char *name, app_codec_id_t *id);
+
+// 选择批量上报使用的编码器（运行时可由下行指令切换，下一次上报生效）
+esp_err_t app_codec_select(app_codec_id_t id);
+
+// 当前使用的编码器
+const app_codec_t *app_codec_active(void);
+
+// 当前使用的编码器编号（断网暂存时随数据记下，补发时据此选择主题）
+app_codec_id_t app_codec_active_id(void);
+
+#endif // __APP_CODEC_H__
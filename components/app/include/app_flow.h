@@ -0,0 +1,98 @@
+#ifndef __APP_FLOW_H__
+#define __APP_FLOW_H__
+
+#include <stdint.h>
+#include "esp_err.h"
+
+// 流水线中的各级缓冲（生产者 -> 消费者）
+typedef enum
+{
+    APP_FLOW_STAGE_SAMPLE = 0, // 采样环形缓冲区：采集任务 -> 处理任务
+    APP_FLOW_STAGE_DOWNLINK,   // 下行通道：MQTT 回调 -> 处理任务
+    APP_FLOW_STAGE_MAX,
+} app_flow_stage_t;
+
+/**
+ * 下游满时的处理策略
+ * - BLOCK：最多等待 block_ms，仍然满就丢弃新数据（不会无限期阻塞生产者）
+ * - DROP_OLDEST：丢弃队列中最早的一条，腾出位置给新数据
+ * - DROP_NEWEST：直接丢弃新数据
+ * - COALESCE：把放不下的新数据合并成一条（样本求平均），有空位时再放进去
+ * 环形缓冲区是单生产者/单消费者，生产者不能丢最早的数据，样本级只支持 DROP_NEWEST 和 COALESCE；
+ * 下行通道的生产者是 MQTT 任务，不能等待，不支持 BLOCK；通道中的消息无法合并，COALESCE 按 DROP_NEWEST 处理
+ */
+typedef enum
+{
+    APP_FLOW_BLOCK = 0,
+    APP_FLOW_DROP_OLDEST,
+    APP_FLOW_DROP_NEWEST,
+    APP_FLOW_COALESCE,
+} app_flow_policy_t;
+
+// 每一级的配置：占用持续高于 high_pct 时向上游发出减载信号，持续低于 low_pct 时发出恢复信号
+typedef struct
+{
+    app_flow_policy_t policy;
+    uint32_t block_ms; // BLOCK 策略的最长等待
+    uint8_t high_pct;  // 高水位（占容量的百分比）
+    uint8_t low_pct;   // 低水位
+} app_flow_config_t;
+
+// 入队结果
+typedef enum
+{
+    APP_FLOW_EV_ACCEPTED = 0, // 放进去了（含等待或挤掉旧数据之后）
+    APP_FLOW_EV_BLOCKED,      // 满了，开始等待
+    APP_FLOW_EV_DROP_OLDEST,  // 挤掉了一条旧数据
+    APP_FLOW_EV_DROP_NEWEST,  // 新数据被丢弃
+    APP_FLOW_EV_COALESCED,    // 新数据被合并
+} app_flow_event_t;
+
+// 向上游发出的信号
+typedef enum
+{
+    APP_FLOW_SIGNAL_NONE = 0,
+    APP_FLOW_SIGNAL_SHED,    // 持续高于高水位：降低采样率或加大批量
+    APP_FLOW_SIGNAL_RESTORE, // 持续低于低水位：可以逐级恢复
+} app_flow_signal_t;
+
+// 每一级的统计
+typedef struct
+{
+    uint32_t accepted;
+    uint32_t blocked;
+    uint32_t dropped_oldest;
+    uint32_t dropped_newest;
+    uint32_t coalesced;
+    uint32_t used;     // 最近一次报告的占用
+    uint32_t peak;     // 占用的历史最高值
+    uint32_t capacity;
+    uint32_t sheds;    // 发出减载信号的次数
+} app_flow_stats_t;
+
+/**
+ * @brief 修改某一级的配置
+ *
+ * @return ESP_ERR_INVALID_ARG 参数不合法；ESP_ERR_NOT_SUPPORTED 该级不支持这个策略（下行通道不能用 BLOCK）
+ */
+esp_err_t app_flow_set_config(app_flow_stage_t stage, const app_flow_config_t *config);
+esp_err_t app_flow_get_config(app_flow_stage_t stage, app_flow_config_t *config);
+
+// 记录一次入队结果
+void app_flow_count(app_flow_stage_t stage, app_flow_event_t event);
+
+/**
+ * @brief 报告某一级的当前占用，由生产者在入队后调用
+ *
+ * 超过高水位（或低于低水位）持续 APP_FLOW_SUSTAIN_MS 才发出信号，之后若仍然如此，每隔同样的时间再发一次
+ *
+ * @return 需要上游执行的动作
+ */
+app_flow_signal_t app_flow_level(app_flow_stage_t stage, uint32_t used, uint32_t capacity);
+
+esp_err_t app_flow_get_stats(app_flow_stage_t stage, app_flow_stats_t *stats);
+
+// 打印各级的统计
+void app_flow_log_stats(void);
+
+#endif // __APP_FLOW_H__
@@ -0,0 +1,56 @@
+#ifndef __APP_POOL_H__
+#define __APP_POOL_H__
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+// 缓冲区大小与个数：按池里最大的消息定，即 MQTT 统计 JSON（各计数取最大值时约 560 字节），下行指令和应答都比它短
+// 上行批次（最大 2KB）只在处理任务中编码和发出，用它自己的缓冲区，不占池
+#define APP_POOL_BUF_SIZE 640
+#define APP_POOL_BUF_COUNT 6
+
+/**
+ * 定长缓冲区池
+ * - 生产者从池中申请缓冲区，直接在 data 里填内容，队列里只传指针，不再整块拷贝
+ * - 带引用计数：同一个缓冲区可以交给多个消费者，最后一个释放的把它还回池里
+ * - 池空时申请失败并计数，不会动态分配
+ */
+typedef struct
+{
+    _Atomic uint32_t refs;        // 引用计数，为 0 时在空闲队列中
+    size_t len;                   // data 中有效内容的长度（不含结尾 '\0'）
+    char data[APP_POOL_BUF_SIZE]; // 内容，字符串时保证以 '\0' 结尾
+} app_buf_t;
+
+// 池的使用统计
+typedef struct
+{
+    uint32_t total;     // 缓冲区总数
+    uint32_t free;      // 当前空闲数
+    uint32_t min_free;  // 空闲数的历史最低值（低水位）
+    uint32_t allocs;    // 成功申请次数
+    uint32_t exhausted; // 池空导致申请失败的次数
+} app_pool_stats_t;
+
+esp_err_t app_pool_init(void);
+
+/**
+ * @brief 申请一个缓冲区，引用计数为 1，len 为 0
+ *
+ * @param wait 池空时最多等待的时间，0 表示不等待
+ * @return 缓冲区；池空且超时返回 NULL
+ */
+app_buf_t *app_pool_alloc(TickType_t wait);
+
+// 增加一个引用（把同一缓冲区再交给另一个消费者之前调用）
+void app_pool_ref(app_buf_t *buf);
+
+// 释放一个引用，计数归零时还回池中（可传 NULL）
+void app_pool_release(app_buf_t *buf);
+
+void app_pool_get_stats(app_pool_stats_t *stats);
+
+#endif // __APP_POOL_H__
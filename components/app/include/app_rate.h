@@ -0,0 +1,97 @@
+#ifndef __APP_RATE_H__
+#define __APP_RATE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "app_calib.h"
+
+// 采样率配置：传感器以 sample_hz 采样，软件每 sample_hz / output_hz 个样本求平均输出一个
+typedef struct
+{
+    uint16_t sample_hz; // 传感器内部采样率（4~1000Hz），硬件低通滤波随之设置
+    uint16_t output_hz; // 抽取后写入环形缓冲区的有效速率（1~sample_hz）
+} app_rate_profile_t;
+
+// 抽取倍数上限（配置校验和减载翻倍都不超过它）
+#define APP_RATE_MAX_FACTOR 250
+
+// 抽取（求平均）状态，只在采集任务中使用
+typedef struct
+{
+    uint16_t factor; // 抽取倍数：每多少个样本输出一个
+    uint16_t count;  // 已累加的样本数
+    int64_t ts_sum;  // 时间戳累加（输出取平均，即窗口中点）
+    int64_t sum[7];  // ax ay az gx gy gz temp 的累加（角速度单位 mdps，累加上百个就会超出 int32）
+    uint8_t flags;   // 窗口内样本标志的并集
+} app_decim_t;
+
+/**
+ * @brief 从 NVS 读取采样率配置（没有则使用默认值）
+ */
+esp_err_t app_rate_init(void);
+
+/**
+ * @brief 设置采样率配置（可在运行时由下行指令调用）
+ *
+ * 只做校验并记录为待生效配置，通知采集任务应用（结果用 app_rate_poll_applied 查询），不需要重新初始化传感器
+ *
+ * @param profile 新配置
+ * @param persist 是否写入 NVS
+ */
+esp_err_t app_rate_set(const app_rate_profile_t *profile, bool persist);
+
+void app_rate_get(app_rate_profile_t *profile);
+
+/**
+ * @brief 查询最近一次 app_rate_set 的配置是否已被采集任务应用，不等待
+ *
+ * @return 应用结果；ESP_ERR_NOT_FINISHED 采集任务还没有应用
+ */
+esp_err_t app_rate_poll_applied(void);
+
+/**
+ * @brief 登记应用配置的任务（采集任务），有新配置时通知它立即应用
+ */
+void app_rate_set_notify(TaskHandle_t task);
+
+/**
+ * @brief 取出待生效的配置（采集任务调用）
+ *
+ * @return true 有新配置需要应用
+ */
+bool app_rate_take_pending(app_rate_profile_t *profile);
+
+/**
+ * @brief 报告 app_rate_take_pending 取出的配置的应用结果（采集任务调用）
+ *
+ * 失败时配置重新挂起，采集任务下一次唤醒时重试；调用方随后通知等结果的任务来查询（app_rate_poll_applied）
+ */
+void app_rate_applied(esp_err_t err);
+
+void app_decim_init(app_decim_t *decim, uint16_t factor);
+
+/**
+ * @brief 只改抽取倍数，保留正在累加的样本（减载时使用，不丢数据）
+ *
+ * 已累加的样本数达到新倍数时，下一个样本送入后立即输出
+ */
+void app_decim_set_factor(app_decim_t *decim, uint16_t factor);
+
+/**
+ * @brief 送入一个样本，每累计 factor 个输出一个平均后的样本
+ *
+ * @return true out 中是新输出的样本
+ */
+bool app_decim_push(app_decim_t *decim, const app_sample_t *in, app_sample_t *out);
+
+/**
+ * @brief 不等攒够 factor 个，把已累加的样本立即平均输出
+ *
+ * @return false 没有累加中的样本
+ */
+bool app_decim_flush(app_decim_t *decim, app_sample_t *out);
+
+#endif // __APP_RATE_H__
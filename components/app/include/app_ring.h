@@ -0,0 +1,43 @@
+#ifndef __APP_RING_H__
+#define __APP_RING_H__
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "app_calib.h"
+
+// 环形缓冲区容量（样本数），必须是 2 的幂；100Hz 采样下可缓存约 10 秒数据（每个样本 32 字节）
+#define APP_RING_CAPACITY 1024
+
+// 读写索引各占一个 cache line，避免生产者和消费者互相干扰
+#define APP_RING_ALIGN 32
+
+// 环形缓冲区中的一条记录为标定后的样本 app_sample_t（见 app_calib.h），自带采样时间戳 ts_us
+
+/**
+ * 单生产者/单消费者无锁环形缓冲区
+ * - 只允许一个任务写（采集任务），一个任务读（上传任务）
+ * - 写端直接在槽位里填数据再提交，读端直接在槽位上批量读再释放，不经过队列拷贝
+ * - 写满时 app_ring_reserve 返回 NULL，不会阻塞采集；丢弃还是合并由调用方决定并计数（见 app_flow）
+ */
+typedef struct
+{
+    _Atomic uint32_t head __attribute__((aligned(APP_RING_ALIGN))); // 写索引，只有生产者修改
+    _Atomic uint32_t tail __attribute__((aligned(APP_RING_ALIGN))); // 读索引，只有消费者修改
+    app_sample_t buf[APP_RING_CAPACITY] __attribute__((aligned(APP_RING_ALIGN)));
+} app_ring_t;
+
+void app_ring_init(app_ring_t *ring);
+
+// 生产者：取得下一个空闲槽位（满了返回 NULL），填好后调用 app_ring_commit 发布
+app_sample_t *app_ring_reserve(app_ring_t *ring);
+void app_ring_commit(app_ring_t *ring);
+
+// 消费者：取得一段连续可读的样本（不跨越回绕点），处理完后调用 app_ring_release 归还
+size_t app_ring_peek(app_ring_t *ring, const app_sample_t **first);
+void app_ring_release(app_ring_t *ring, size_t n);
+
+size_t app_ring_count(app_ring_t *ring);
+
+#endif // __APP_RING_H__
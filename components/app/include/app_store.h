@@ -0,0 +1,77 @@
+#ifndef __APP_STORE_H__
+#define __APP_STORE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// 内存暂存区大小（字节），放满后最早的记录转存到 flash
+#define APP_STORE_RAM_BYTES (16 * 1024)
+
+// 单条记录的最大长度，即一次上行发布的最大长度（补发时读进处理任务的上行缓冲区）
+#define APP_STORE_RECORD_MAX 2048
+
+// 转存用的 flash 分区标签（见 partitions.csv），找不到时只用内存暂存
+#define APP_STORE_PARTITION_LABEL "telemetry"
+
+/**
+ * 断网暂存（store-and-forward）
+ * - MQTT 断开或发布失败时，编码好的上行数据按到达顺序存进来，连上后按原顺序补发
+ * - 先放内存；内存放满时把最早的记录移到 flash 分区，flash 中的记录总比内存中的早
+ * - flash 也放满时擦除最早的一个扇区，丢弃最早的数据（淘汰策略：丢最旧，保最新）
+ * - 每条记录带一个 tag（由调用方定义，这里用编码器编号），补发时据此选择主题
+ * - 除 app_store_get_stats 外只在处理任务中调用，不加锁
+ */
+
+// 暂存统计
+typedef struct
+{
+    uint32_t records;     // 当前暂存的记录数（内存 + flash）
+    uint32_t bytes;       // 当前暂存的数据字节数
+    uint32_t high_water;  // bytes 的历史最高值（高水位）
+    uint32_t stored;      // 累计存入的记录数
+    uint32_t forwarded;   // 累计补发成功的记录数
+    uint32_t spilled;     // 累计从内存转存到 flash 的记录数
+    uint32_t evicted;     // 累计因空间不足被丢弃的记录数
+    uint32_t discarded;   // 累计因无法补发（例如标签无效）被丢弃的记录数
+    uint32_t mark_errors; // 累计标记“已补发”失败的次数（这些记录重启后会再补发一次）
+    bool flash;           // flash 分区是否可用
+} app_store_stats_t;
+
+/**
+ * @brief 查找 flash 分区并恢复上次断电前未补发的记录
+ */
+esp_err_t app_store_init(void);
+
+/**
+ * @brief 存入一条记录（追加到末尾）
+ *
+ * @param tag 记录标签
+ * @param data 数据
+ * @param len 长度，1~APP_STORE_RECORD_MAX
+ */
+esp_err_t app_store_put(uint8_t tag, const void *data, size_t len);
+
+bool app_store_empty(void);
+
+/**
+ * @brief 读出最早的一条记录（不移除），补发成功后再调用 app_store_pop
+ *
+ * @param tag 记录标签
+ * @param buf 读缓冲区
+ * @param cap 缓冲区大小，不小于 APP_STORE_RECORD_MAX 时一定放得下
+ * @param len 记录长度
+ * @return ESP_ERR_NOT_FOUND 暂存为空
+ */
+esp_err_t app_store_peek(uint8_t *tag, void *buf, size_t cap, size_t *len);
+
+// 移除最早的一条记录（已补发，计入 forwarded）
+void app_store_pop(void);
+
+// 移除最早的一条记录（无法补发，计入 discarded）
+void app_store_discard(void);
+
+void app_store_get_stats(app_store_stats_t *stats);
+
+#endif // __APP_STORE_H__
@@ -0,0 +1,112 @@
+#include "app_batch.h"
+#include "freertos/FreeRTOS.h"
+
+// 默认：每 10 秒或攒满一批上报一次
+#define APP_BATCH_DEFAULT_MAX_SAMPLES APP_BATCH_CAPACITY
+#define APP_BATCH_DEFAULT_MAX_AGE_MS 10000
+
+#define APP_BATCH_MIN_AGE_MS 100
+#define APP_BATCH_MAX_AGE_MS 600000
+
+static app_batch_config_t s_config = {APP_BATCH_DEFAULT_MAX_SAMPLES, APP_BATCH_DEFAULT_MAX_AGE_MS};
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+esp_err_t app_batch_set_config(const app_batch_config_t *config)
+{
+    if (!config || config->max_samples == 0 || config->max_samples > APP_BATCH_CAPACITY ||
+        config->max_age_ms < APP_BATCH_MIN_AGE_MS || config->max_age_ms > APP_BATCH_MAX_AGE_MS)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    s_config = *config;
+    portEXIT_CRITICAL(&s_lock);
+    return ESP_OK;
+}
+
+void app_batch_get_config(app_batch_config_t *config)
+{
+    if (!config)
+    {
+        return;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    *config = s_config;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void app_batch_reset(app_batch_t *batch)
+{
+    batch->t0_us = 0;
+    batch->count = 0;
+    batch->urgent = false;
+}
+
+bool app_batch_push(app_batch_t *batch, const app_sample_t *sample, app_batch_prio_t prio)
+{
+    app_batch_config_t config;
+    app_batch_get_config(&config);
+
+    if (batch->count >= APP_BATCH_CAPACITY)
+    {
+        return true;
+    }
+
+    uint16_t i = batch->count;
+    if (i == 0)
+    {
+        batch->t0_us = sample->ts_us;
+    }
+
+    batch->dt_us[i] = (int32_t)(sample->ts_us - batch->t0_us);
+    batch->ax[i] = sample->ax;
+    batch->ay[i] = sample->ay;
+    batch->az[i] = sample->az;
+    batch->gx[i] = sample->gx;
+    batch->gy[i] = sample->gy;
+    batch->gz[i] = sample->gz;
+    batch->temp[i] = sample->temp;
+    batch->count++;
+
+    // 批次里第一个紧急样本决定上报时刻：当场上报，但与上一次紧急上报至少隔开 APP_BATCH_URGENT_GAP_MS
+    if (prio == APP_BATCH_PRIO_URGENT && !batch->urgent)
+    {
+        int64_t earliest = batch->urgent_us + (int64_t)APP_BATCH_URGENT_GAP_MS * 1000;
+        batch->urgent = true;
+        batch->urgent_us = (sample->ts_us > earliest) ? sample->ts_us : earliest;
+    }
+
+    return batch->count >= config.max_samples;
+}
+
+int64_t app_batch_deadline_us(const app_batch_t *batch)
+{
+    if (batch->count == 0)
+    {
+        return INT64_MAX;
+    }
+
+    app_batch_config_t config;
+    app_batch_get_config(&config);
+    int64_t deadline = batch->t0_us + (int64_t)config.max_age_ms * 1000;
+    if (batch->urgent && batch->urgent_us < deadline)
+    {
+        deadline = batch->urgent_us;
+    }
+    return deadline;
+}
+
+bool app_batch_due(const app_batch_t *batch, int64_t now_us)
+{
+    if (batch->count == 0)
+    {
+        return false;
+    }
+
+    app_batch_config_t config;
+    app_batch_get_config(&config);
+    return (batch->urgent && now_us >= batch->urgent_us) || batch->count >= config.max_samples ||
+           now_us >= batch->t0_us + (int64_t)config.max_age_ms * 1000;
+}
@@ -0,0 +1,339 @@
+#include "app_calib.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include <string.h>
+
+static const char *TAG = "APP_CALIB";
+
+// NVS 存储位置与格式版本（结构体变化时递增，旧数据将被忽略）
+#define APP_CALIB_NVS_NAMESPACE "app_calib"
+#define APP_CALIB_NVS_KEY "calib"
+#define APP_CALIB_NVS_VERSION 1
+
+// 温度换算：°C = raw / 340 + 36.53  ==>  0.01°C = raw * (100 / 340) + 3653，100/340 的 Q15 值为 9638
+#define APP_CALIB_TEMP_Q15 9638
+#define APP_CALIB_TEMP_OFFSET_CDEG 3653
+
+typedef struct
+{
+    uint16_t version;
+    app_calib_t cal;
+} app_calib_blob_t;
+
+// 在线零偏标定：下行指令发起，采集任务把原始样本累加进来，收齐后由发起方求零偏
+typedef struct
+{
+    uint16_t want;                // 需要的样本数，0 表示没有进行中的标定
+    uint16_t got;                 // 已累加的样本数，收齐后停止累加，等发起方来完成
+    bool persist;                 // 求出零偏后是否写入 NVS
+    int32_t sum[APP_CALIB_AXES];  // 各轴原始值之和
+} app_calib_collect_t;
+
+static app_calib_t s_cal;                       // 当前标定参数
+static int32_t s_gain_q15[APP_CALIB_AXES];      // 每轴换算系数（Q15）：量程换算 × 比例系数
+static uint16_t s_accel_g = 2;                  // 当前加速度计量程（g）
+static app_calib_collect_t s_collect;           // 在线零偏标定的累加状态
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// 默认标定参数：无零偏、比例 1.0、不做温度补偿
+static void app_calib_default(app_calib_t *cal)
+{
+    memset(cal, 0, sizeof(*cal));
+    for (int i = 0; i < APP_CALIB_AXES; i++)
+    {
+        cal->scale_q15[i] = APP_CALIB_Q15_ONE;
+    }
+}
+
+// 根据量程和比例系数计算每轴换算系数，调用方持有 s_lock
+// 原始值满量程为 32768 LSB，所以 mg/LSB = 1000 * 量程(g) / 32768，
+// 写成 Q15 正好是 1000 * 量程；陀螺仪 mdps/LSB 同理为 1000 * 量程(dps)
+static void app_calib_update_gain(uint16_t accel_g, uint16_t gyro_dps)
+{
+    for (int i = 0; i < APP_CALIB_AXES; i++)
+    {
+        int64_t base = (i < APP_CALIB_GX) ? 1000LL * accel_g : 1000LL * gyro_dps;
+        s_gain_q15[i] = (int32_t)((base * s_cal.scale_q15[i]) >> 15);
+    }
+    s_accel_g = accel_g;
+}
+
+static esp_err_t app_calib_save(const app_calib_t *cal)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(APP_CALIB_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    app_calib_blob_t blob = {.version = APP_CALIB_NVS_VERSION, .cal = *cal};
+    err = nvs_set_blob(nvs, APP_CALIB_NVS_KEY, &blob, sizeof(blob));
+    if (err == ESP_OK)
+    {
+        err = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    return err;
+}
+
+static esp_err_t app_calib_load(app_calib_t *cal)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(APP_CALIB_NVS_NAMESPACE, NVS_READONLY, &nvs);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    app_calib_blob_t blob;
+    size_t len = sizeof(blob);
+    err = nvs_get_blob(nvs, APP_CALIB_NVS_KEY, &blob, &len);
+    nvs_close(nvs);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    if (len != sizeof(blob) || blob.version != APP_CALIB_NVS_VERSION)
+    {
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    *cal = blob.cal;
+    return ESP_OK;
+}
+
+esp_err_t app_calib_init(void)
+{
+    app_calib_t cal;
+    esp_err_t err = app_calib_load(&cal);
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(TAG, "No stored calibration (%s), using defaults", esp_err_to_name(err));
+        app_calib_default(&cal);
+    }
+    else
+    {
+        ESP_LOGI(TAG, "Calibration loaded from NVS");
+    }
+
+    return app_calib_set(&cal, false);
+}
+
+void app_calib_get(app_calib_t *cal)
+{
+    if (!cal)
+    {
+        return;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    *cal = s_cal;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+esp_err_t app_calib_set(const app_calib_t *cal, bool persist)
+{
+    if (!cal || cal->temp_points > APP_CALIB_TEMP_POINTS)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint16_t accel_g = 2, gyro_dps = 2000;
+    platform_sensor_get_range(&accel_g, &gyro_dps);
+
+    portENTER_CRITICAL(&s_lock);
+    s_cal = *cal;
+    app_calib_update_gain(accel_g, gyro_dps);
+    portEXIT_CRITICAL(&s_lock);
+
+    if (persist)
+    {
+        esp_err_t err = app_calib_save(cal);
+        if (err != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Failed to save calibration: %s", esp_err_to_name(err));
+            return err;
+        }
+    }
+    return ESP_OK;
+}
+
+static void app_calib_accumulate(int32_t sum[APP_CALIB_AXES], const SensorData *s)
+{
+    sum[APP_CALIB_AX] += s->mpu_ax;
+    sum[APP_CALIB_AY] += s->mpu_ay;
+    sum[APP_CALIB_AZ] += s->mpu_az;
+    sum[APP_CALIB_GX] += s->mpu_gx;
+    sum[APP_CALIB_GY] += s->mpu_gy;
+    sum[APP_CALIB_GZ] += s->mpu_gz;
+}
+
+// 按各轴原始值之和求零偏并设置
+static esp_err_t app_calib_zero_sum(const int32_t sum[APP_CALIB_AXES], size_t n, bool persist)
+{
+    app_calib_t cal;
+    app_calib_get(&cal);
+
+    for (int i = 0; i < APP_CALIB_AXES; i++)
+    {
+        cal.bias[i] = (int16_t)(sum[i] / (int32_t)n);
+    }
+
+    // 静止时 Z 轴朝上应读到 +1g，1g 对应 32768 / 量程 LSB
+    cal.bias[APP_CALIB_AZ] -= (int16_t)(32768 / s_accel_g);
+
+    return app_calib_set(&cal, persist);
+}
+
+esp_err_t app_calib_zero_start(uint16_t n, bool persist)
+{
+    if (n == 0 || n > APP_CALIB_ZERO_SAMPLES_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    bool busy = (s_collect.want != 0);
+    if (!busy)
+    {
+        memset(&s_collect, 0, sizeof(s_collect));
+        s_collect.want = n;
+        s_collect.persist = persist;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return busy ? ESP_ERR_INVALID_STATE : ESP_OK;
+}
+
+esp_err_t app_calib_zero_finish(bool cancel, uint16_t *samples)
+{
+    // 收齐或取消时结束这次标定，求零偏（可能写 NVS）放在锁外
+    portENTER_CRITICAL(&s_lock);
+    app_calib_collect_t done = s_collect;
+    bool complete = (done.want != 0 && done.got >= done.want);
+    if (complete || cancel)
+    {
+        s_collect.want = 0;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (done.want == 0)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (samples)
+    {
+        *samples = done.got;
+    }
+    if (!complete)
+    {
+        if (!cancel)
+        {
+            return ESP_ERR_NOT_FINISHED;
+        }
+        ESP_LOGW(TAG, "Zero calibration timed out, %u of %u samples", done.got, done.want);
+        return ESP_ERR_TIMEOUT;
+    }
+
+    ESP_LOGI(TAG, "Zero calibration from %u samples", done.want);
+    return app_calib_zero_sum(done.sum, done.want, done.persist);
+}
+
+bool app_calib_collect(const SensorData *raw, size_t n)
+{
+    bool completed = false;
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_collect.got < s_collect.want)
+    {
+        for (size_t i = 0; i < n && s_collect.got < s_collect.want; i++)
+        {
+            app_calib_accumulate(s_collect.sum, &raw[i]);
+            s_collect.got++;
+        }
+        completed = (s_collect.got >= s_collect.want);
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return completed;
+}
+
+void app_calib_snapshot(app_calib_snap_t *snap)
+{
+    portENTER_CRITICAL(&s_lock);
+    snap->cal = s_cal;
+    memcpy(snap->gain_q15, s_gain_q15, sizeof(snap->gain_q15));
+    portEXIT_CRITICAL(&s_lock);
+}
+
+// 在温度补偿表中线性插值出某一轴的额外零偏，超出表范围时取端点值
+static int32_t app_calib_temp_offset(const app_calib_t *cal, int axis, int32_t temp_cdeg)
+{
+    const app_calib_temp_point_t *t = cal->temp_table;
+    uint8_t n = cal->temp_points;
+
+    if (temp_cdeg <= t[0].temp_cdeg)
+    {
+        return t[0].offset[axis];
+    }
+    for (uint8_t i = 1; i < n; i++)
+    {
+        if (temp_cdeg <= t[i].temp_cdeg)
+        {
+            int32_t span = t[i].temp_cdeg - t[i - 1].temp_cdeg;
+            int32_t delta = t[i].offset[axis] - t[i - 1].offset[axis];
+            if (span <= 0)
+            {
+                return t[i].offset[axis];
+            }
+            return t[i - 1].offset[axis] + delta * (temp_cdeg - t[i - 1].temp_cdeg) / span;
+        }
+    }
+    return t[n - 1].offset[axis];
+}
+
+// 加速度以 int16 保存，16g 量程再乘比例系数后可能越界，饱和处理
+static inline int16_t app_calib_sat16(int32_t v)
+{
+    if (v > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (v < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+    return (int16_t)v;
+}
+
+void app_calib_apply(const app_calib_snap_t *snap, const SensorData *raw, app_sample_t *out)
+{
+    const app_calib_t *cal = &snap->cal;
+    const int32_t in[APP_CALIB_AXES] = {raw->mpu_ax, raw->mpu_ay, raw->mpu_az,
+                                        raw->mpu_gx, raw->mpu_gy, raw->mpu_gz};
+    int32_t res[APP_CALIB_AXES];
+
+    // 温度先换算，温度补偿要用到
+    int32_t temp_cdeg = ((raw->mpu_temp * APP_CALIB_TEMP_Q15) >> 15) + APP_CALIB_TEMP_OFFSET_CDEG;
+
+    for (int i = 0; i < APP_CALIB_AXES; i++)
+    {
+        int32_t bias = cal->bias[i];
+        if (cal->temp_points > 0)
+        {
+            bias += app_calib_temp_offset(cal, i, temp_cdeg);
+        }
+        // (raw - bias) 最大约 2^16，系数最大约 2^21（2000dps），乘积需要 64 位
+        res[i] = (int32_t)(((int64_t)(in[i] - bias) * snap->gain_q15[i]) >> 15);
+    }
+
+    out->ts_us = raw->ts_us;
+    out->ax = app_calib_sat16(res[APP_CALIB_AX]);
+    out->ay = app_calib_sat16(res[APP_CALIB_AY]);
+    out->az = app_calib_sat16(res[APP_CALIB_AZ]);
+    out->gx = res[APP_CALIB_GX];
+    out->gy = res[APP_CALIB_GY];
+    out->gz = res[APP_CALIB_GZ];
+    out->temp = (int16_t)temp_cdeg;
+    out->flags = 0;
+}
@@ -0,0 +1,463 @@
+#include "app_cmd.h"
+#include "app_calib.h"
+#include "app_rate.h"
+#include "app_batch.h"
+#include "app_codec.h"
+#include "json_reader.h"
+#include "trace.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <string.h>
+
+static const char *TAG = "APP_CMD";
+
+// 指令名称的最大长度（含 '\0'）
+#define APP_CMD_NAME_MAX 24
+
+// set_rate 等待采集任务应用新配置的最长时间
+#define APP_CMD_RATE_WAIT_MS 1000
+
+// calibrate 等待采集任务收齐样本的最长时间（100Hz 下约可收 300 个）
+#define APP_CMD_CALIB_WAIT_MS 3000
+
+// 已发起、还没应答的指令（每条指令最多一个），只在处理任务中访问
+typedef struct
+{
+    bool active;
+    bool has_id;
+    int64_t id;          // 请求中的 id，原样带回应答
+    int64_t deadline_us; // 超时时刻
+} app_cmd_pending_t;
+
+// ========================
+// 指令处理函数
+// ========================
+
+// {"cmd":"calibrate","args":{"samples":100,"persist":true}}：设备静止、Z 轴朝上时求零偏
+// 样本由采集任务收集，samples 省略时取 100；收齐后（延后）应答新的零偏（原始 LSB）
+static const app_cmd_arg_spec_t s_args_calibrate[] = {
+    {"samples", APP_CMD_ARG_INT, false, 1, APP_CALIB_ZERO_SAMPLES_MAX},
+    {"persist", APP_CMD_ARG_BOOL, false, 0, 0},
+};
+
+static esp_err_t app_cmd_calibrate(const app_cmd_arg_t *args, json_writer_t *resp)
+{
+    (void)resp;
+
+    uint16_t n = args[0].present ? (uint16_t)args[0].i : 100;
+    esp_err_t err = app_calib_zero_start(n, args[1].present && args[1].b);
+    return (err == ESP_OK) ? ESP_ERR_NOT_FINISHED : err;
+}
+
+static esp_err_t app_cmd_calibrate_finish(bool expired, json_writer_t *resp)
+{
+    uint16_t n = 0;
+    esp_err_t err = app_calib_zero_finish(expired, &n);
+    if (err == ESP_OK)
+    {
+        app_calib_t cal;
+        int32_t bias[APP_CALIB_AXES];
+        app_calib_get(&cal);
+        for (int i = 0; i < APP_CALIB_AXES; i++)
+        {
+            bias[i] = cal.bias[i];
+        }
+        json_writer_kv_int(resp, "samples", n);
+        json_writer_key(resp, "bias");
+        json_writer_int32_array(resp, bias, APP_CALIB_AXES);
+    }
+    return err;
+}
+
+// {"cmd":"get_config"}：返回当前的采样率、上报批量和编码
+static esp_err_t app_cmd_get_config(const app_cmd_arg_t *args, json_writer_t *resp)
+{
+    (void)args;
+
+    app_rate_profile_t rate;
+    app_batch_config_t batch;
+    app_rate_get(&rate);
+    app_batch_get_config(&batch);
+
+    json_writer_kv_int(resp, "sample_hz", rate.sample_hz);
+    json_writer_kv_int(resp, "output_hz", rate.output_hz);
+    json_writer_kv_int(resp, "interval_ms", batch.max_age_ms);
+    json_writer_kv_int(resp, "max_samples", batch.max_samples);
+    json_writer_kv_string(resp, "encoding", app_codec_active()->name);
+    return ESP_OK;
+}
+
+// {"cmd":"set_encoding","args":{"codec":"cbor"}}
+static const app_cmd_arg_spec_t s_args_set_encoding[] = {
+    {"codec", APP_CMD_ARG_STRING, true, 1, APP_CMD_STR_MAX - 1},
+};
+
+static esp_err_t app_cmd_set_encoding(const app_cmd_arg_t *args, json_writer_t *resp)
+{
+    app_codec_id_t id;
+    esp_err_t err = app_codec_find(args[0].s, &id);
+    if (err == ESP_OK)
+    {
+        err = app_codec_select(id);
+    }
+    if (err == ESP_OK)
+    {
+        json_writer_kv_string(resp, "encoding", app_codec_get(id)->name);
+        json_writer_kv_string(resp, "topic", app_codec_get(id)->topic);
+    }
+    return err;
+}
+
+// {"cmd":"set_rate","args":{"sample_hz":200,"output_hz":50,"persist":true}}
+// output_hz 省略时保持原值（超过新的采样率时取采样率）；采集任务应用后才（延后）应答，
+// 应用失败或超时时应答 ok:false，配置仍然挂起，由采集任务继续重试
+static const app_cmd_arg_spec_t s_args_set_rate[] = {
+    {"sample_hz", APP_CMD_ARG_INT, true, 4, 1000},
+    {"output_hz", APP_CMD_ARG_INT, false, 1, 1000},
+    {"persist", APP_CMD_ARG_BOOL, false, 0, 0},
+};
+
+static esp_err_t app_cmd_set_rate(const app_cmd_arg_t *args, json_writer_t *resp)
+{
+    (void)resp;
+
+    app_rate_profile_t rate;
+    app_rate_get(&rate);
+
+    rate.sample_hz = (uint16_t)args[0].i;
+    if (args[1].present)
+    {
+        rate.output_hz = (uint16_t)args[1].i;
+    }
+    else if (rate.output_hz > rate.sample_hz)
+    {
+        rate.output_hz = rate.sample_hz;
+    }
+
+    esp_err_t err = app_rate_set(&rate, args[2].present && args[2].b);
+    return (err == ESP_OK) ? ESP_ERR_NOT_FINISHED : err;
+}
+
+static esp_err_t app_cmd_set_rate_finish(bool expired, json_writer_t *resp)
+{
+    // 超时不用取消：配置已挂起，采集任务之后仍会应用
+    (void)expired;
+
+    esp_err_t err = app_rate_poll_applied();
+    if (err == ESP_OK)
+    {
+        app_rate_profile_t rate;
+        app_rate_get(&rate);
+        json_writer_kv_int(resp, "sample_hz", rate.sample_hz);
+        json_writer_kv_int(resp, "output_hz", rate.output_hz);
+    }
+    return err;
+}
+
+// {"cmd":"set_upload","args":{"interval_ms":5000,"max_samples":25}}，两个参数至少给一个
+static const app_cmd_arg_spec_t s_args_set_upload[] = {
+    {"interval_ms", APP_CMD_ARG_INT, false, 100, 600000},
+    {"max_samples", APP_CMD_ARG_INT, false, 1, APP_BATCH_CAPACITY},
+};
+
+static esp_err_t app_cmd_set_upload(const app_cmd_arg_t *args, json_writer_t *resp)
+{
+    if (!args[0].present && !args[1].present)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    app_batch_config_t batch;
+    app_batch_get_config(&batch);
+    if (args[0].present)
+    {
+        batch.max_age_ms = (uint32_t)args[0].i;
+    }
+    if (args[1].present)
+    {
+        batch.max_samples = (uint16_t)args[1].i;
+    }
+
+    esp_err_t err = app_batch_set_config(&batch);
+    if (err == ESP_OK)
+    {
+        json_writer_kv_int(resp, "interval_ms", batch.max_age_ms);
+        json_writer_kv_int(resp, "max_samples", batch.max_samples);
+    }
+    return err;
+}
+
+// ========================
+// 指令表：必须按名称（strcmp 顺序）排列，app_cmd_init 会检查
+// ========================
+
+#define APP_CMD_ENTRY(name, fn, args) {name, fn, args, sizeof(args) / sizeof((args)[0]), NULL, 0}
+#define APP_CMD_DEFERRED(name, fn, args, finish, timeout_ms) {name, fn, args, sizeof(args) / sizeof((args)[0]), finish, timeout_ms}
+
+static const app_cmd_t s_cmds[] = {
+    APP_CMD_DEFERRED("calibrate", app_cmd_calibrate, s_args_calibrate, app_cmd_calibrate_finish, APP_CMD_CALIB_WAIT_MS),
+    {"get_config", app_cmd_get_config, NULL, 0, NULL, 0},
+    APP_CMD_ENTRY("set_encoding", app_cmd_set_encoding, s_args_set_encoding),
+    APP_CMD_DEFERRED("set_rate", app_cmd_set_rate, s_args_set_rate, app_cmd_set_rate_finish, APP_CMD_RATE_WAIT_MS),
+    APP_CMD_ENTRY("set_upload", app_cmd_set_upload, s_args_set_upload),
+};
+
+#define APP_CMD_COUNT (sizeof(s_cmds) / sizeof(s_cmds[0]))
+
+static app_cmd_pending_t s_pending[APP_CMD_COUNT];
+
+esp_err_t app_cmd_init(void)
+{
+    for (size_t i = 0; i < APP_CMD_COUNT; i++)
+    {
+        if (s_cmds[i].arg_count > APP_CMD_ARGS_MAX || (i > 0 && strcmp(s_cmds[i - 1].name, s_cmds[i].name) >= 0))
+        {
+            ESP_LOGE(TAG, "Command table invalid at '%s'", s_cmds[i].name);
+            return ESP_ERR_INVALID_STATE;
+        }
+    }
+    return ESP_OK;
+}
+
+static const app_cmd_t *app_cmd_find(const char *name)
+{
+    size_t lo = 0, hi = APP_CMD_COUNT;
+    while (lo < hi)
+    {
+        size_t mid = (lo + hi) / 2;
+        int c = strcmp(name, s_cmds[mid].name);
+        if (c == 0)
+        {
+            return &s_cmds[mid];
+        }
+        if (c < 0)
+        {
+            hi = mid;
+        }
+        else
+        {
+            lo = mid + 1;
+        }
+    }
+    return NULL;
+}
+
+// ========================
+// 参数校验：按参数说明逐个取值，返回错误类型（NULL 表示通过），bad_arg 为出错的参数名
+// ========================
+static const char *app_cmd_parse_args(const app_cmd_t *cmd, const json_span_t *span, app_cmd_arg_t *args, const char **bad_arg)
+{
+    const char *keys[APP_CMD_ARGS_MAX];
+    json_span_t values[APP_CMD_ARGS_MAX];
+
+    memset(args, 0, sizeof(*args) * cmd->arg_count);
+    memset(values, 0, sizeof(values));
+    for (uint8_t i = 0; i < cmd->arg_count; i++)
+    {
+        keys[i] = cmd->args[i].name;
+    }
+
+    if (span->type == JSON_READER_OBJECT)
+    {
+        if (!json_reader_fields(span->p, span->len, keys, values, cmd->arg_count))
+        {
+            return "bad_args";
+        }
+    }
+    else if (span->type != JSON_READER_NONE && span->type != JSON_READER_NULL)
+    {
+        return "bad_args";
+    }
+
+    for (uint8_t i = 0; i < cmd->arg_count; i++)
+    {
+        const app_cmd_arg_spec_t *spec = &cmd->args[i];
+        const json_span_t *v = &values[i];
+        app_cmd_arg_t *arg = &args[i];
+        *bad_arg = spec->name;
+
+        if (v->type == JSON_READER_NONE || v->type == JSON_READER_NULL)
+        {
+            if (spec->required)
+            {
+                return "missing_arg";
+            }
+            continue;
+        }
+
+        bool ok = false;
+        switch (spec->type)
+        {
+        case APP_CMD_ARG_INT:
+        {
+            int64_t n;
+            ok = json_span_int(v, &n) && n >= spec->min && n <= spec->max;
+            arg->i = ok ? (int32_t)n : 0;
+            break;
+        }
+        case APP_CMD_ARG_BOOL:
+            ok = json_span_bool(v, &arg->b);
+            break;
+        case APP_CMD_ARG_STRING:
+        {
+            ok = json_span_string(v, arg->s, sizeof(arg->s));
+            size_t n = ok ? strlen(arg->s) : 0;
+            ok = ok && n >= (size_t)spec->min && n <= (size_t)spec->max;
+            break;
+        }
+        }
+        if (!ok)
+        {
+            return "bad_arg";
+        }
+        arg->present = true;
+    }
+
+    *bad_arg = NULL;
+    return NULL;
+}
+
+// ========================
+// 应答结尾：写入结果并关闭应答对象，记日志和跟踪事件
+// ========================
+static size_t app_cmd_end_resp(json_writer_t *w, const char *name, const char *err, const char *bad_arg)
+{
+    json_writer_kv_bool(w, "ok", err == NULL);
+    if (err)
+    {
+        json_writer_kv_string(w, "err", err);
+        if (bad_arg)
+        {
+            json_writer_kv_string(w, "arg", bad_arg);
+        }
+        ESP_LOGW(TAG, "Command '%s' rejected: %s%s%s", name, err, bad_arg ? " " : "", bad_arg ? bad_arg : "");
+    }
+    else
+    {
+        ESP_LOGI(TAG, "Command %s done", name);
+    }
+    json_writer_end_object(w);
+
+    size_t n = json_writer_finish(w);
+    TRACE_EVENT(APP, TRACE_INFO, TRACE_EV_APP_CMD, w->buf, n);
+    return n;
+}
+
+size_t app_cmd_dispatch(const char *json, size_t len, char *resp, size_t cap)
+{
+    static const char *const keys[] = {"id", "cmd", "args"};
+    json_span_t fields[3];
+    app_cmd_arg_t args[APP_CMD_ARGS_MAX];
+    char name[APP_CMD_NAME_MAX] = "";
+    const app_cmd_t *cmd = NULL;
+    const char *err = NULL;
+    const char *bad_arg = NULL;
+    int64_t id;
+
+    json_writer_t w;
+    json_writer_init(&w, resp, cap);
+    json_writer_begin_object(&w);
+
+    if (!json_reader_fields(json, len, keys, fields, 3))
+    {
+        err = "bad_json";
+    }
+    else
+    {
+        if (json_span_int(&fields[0], &id))
+        {
+            json_writer_kv_int(&w, "id", id);
+        }
+
+        if (!json_span_string(&fields[1], name, sizeof(name)))
+        {
+            err = "bad_cmd";
+        }
+        else
+        {
+            json_writer_kv_string(&w, "cmd", name);
+            cmd = app_cmd_find(name);
+            err = cmd ? app_cmd_parse_args(cmd, &fields[2], args, &bad_arg) : "unknown_cmd";
+        }
+    }
+
+    // 同一条延后完成的指令还没应答时不再发起
+    app_cmd_pending_t *pending = (!err && cmd->finish) ? &s_pending[cmd - s_cmds] : NULL;
+    if (pending && pending->active)
+    {
+        err = "busy";
+    }
+
+    // 处理函数只在成功时往应答里写字段；延后完成的指令记下 id，应答由 app_cmd_poll 给出
+    if (!err)
+    {
+        esp_err_t ret = cmd->handler(args, &w);
+        if (ret == ESP_ERR_NOT_FINISHED && pending)
+        {
+            pending->active = true;
+            pending->has_id = json_span_int(&fields[0], &pending->id);
+            pending->deadline_us = esp_timer_get_time() + (int64_t)cmd->timeout_ms * 1000;
+            ESP_LOGI(TAG, "Command %s started", cmd->name);
+            return 0;
+        }
+        if (ret != ESP_OK)
+        {
+            err = esp_err_to_name(ret);
+        }
+    }
+
+    return app_cmd_end_resp(&w, name, err, bad_arg);
+}
+
+size_t app_cmd_poll(char *resp, size_t cap)
+{
+    int64_t now = esp_timer_get_time();
+
+    for (size_t i = 0; i < APP_CMD_COUNT; i++)
+    {
+        app_cmd_pending_t *pending = &s_pending[i];
+        if (!pending->active)
+        {
+            continue;
+        }
+
+        const app_cmd_t *cmd = &s_cmds[i];
+        bool expired = (now >= pending->deadline_us);
+
+        json_writer_t w;
+        json_writer_init(&w, resp, cap);
+        json_writer_begin_object(&w);
+        if (pending->has_id)
+        {
+            json_writer_kv_int(&w, "id", pending->id);
+        }
+        json_writer_kv_string(&w, "cmd", cmd->name);
+
+        esp_err_t ret = cmd->finish(expired, &w);
+        if (ret == ESP_ERR_NOT_FINISHED)
+        {
+            if (!expired)
+            {
+                continue;
+            }
+            ret = ESP_ERR_TIMEOUT;
+        }
+
+        pending->active = false;
+        return app_cmd_end_resp(&w, cmd->name, (ret == ESP_OK) ? NULL : esp_err_to_name(ret), NULL);
+    }
+    return 0;
+}
+
+int64_t app_cmd_deadline_us(void)
+{
+    int64_t deadline = INT64_MAX;
+    for (size_t i = 0; i < APP_CMD_COUNT; i++)
+    {
+        if (s_pending[i].active && s_pending[i].deadline_us < deadline)
+        {
+            deadline = s_pending[i].deadline_us;
+        }
+    }
+    return deadline;
+}
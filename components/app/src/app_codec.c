@@ -0,0 +1,232 @@
+#include "app_codec.h"
+#include <stdbool.h>
+#include <string.h>
+#include "esp_log.h"
+#include "net_time.h"
+#include "json_writer.h"
+#include "cbor_writer.h"
+#include "varint_writer.h"
+
+static const char *TAG = "APP_CODEC";
+
+// 批次中按列输出的字段数：dt ax ay az gx gy gz temp
+#define APP_CODEC_COLUMNS 8
+
+// 信封字段数：type ver t0 utc n
+#define APP_CODEC_HEADER_FIELDS 5
+
+// 差分编码格式的首字节，用来和 JSON（'{'）、CBOR（0xAD，13 个键的 map）区分
+#define APP_CODEC_DELTA_MAGIC 0xD3
+
+// 差分编码的标志位
+#define APP_CODEC_DELTA_F_UTC 0x01
+
+static size_t app_codec_json_encode(const app_batch_t *batch, uint16_t start, uint16_t n, uint8_t *buf, size_t len);
+static size_t app_codec_cbor_encode(const app_batch_t *batch, uint16_t start, uint16_t n, uint8_t *buf, size_t len);
+static size_t app_codec_delta_encode(const app_batch_t *batch, uint16_t start, uint16_t n, uint8_t *buf, size_t len);
+
+static const app_codec_t s_codecs[APP_CODEC_MAX] = {
+    [APP_CODEC_JSON] = {.name = "json", .topic = "test/topic", .encode_batch = app_codec_json_encode},
+    [APP_CODEC_CBOR] = {.name = "cbor", .topic = "test/topic/cbor", .encode_batch = app_codec_cbor_encode},
+    [APP_CODEC_DELTA] = {.name = "delta", .topic = "test/topic/delta", .encode_batch = app_codec_delta_encode},
+};
+
+static volatile app_codec_id_t s_active = APP_CODEC_JSON;
+
+// 各列的键名与数据，两种编码共用，保证字段一致
+typedef struct
+{
+    const char *key;
+    const int32_t *col;
+} app_codec_column_t;
+
+static void app_codec_columns(const app_batch_t *batch, app_codec_column_t cols[APP_CODEC_COLUMNS])
+{
+    // 加速度 mg，角速度 mdps，温度 0.01°C，dt 为相对 t0 的偏移（微秒）
+    const app_codec_column_t c[APP_CODEC_COLUMNS] = {
+        {"dt", batch->dt_us}, {"ax", batch->ax}, {"ay", batch->ay}, {"az", batch->az},
+        {"gx", batch->gx}, {"gy", batch->gy}, {"gz", batch->gz}, {"temp", batch->temp},
+    };
+    memcpy(cols, c, sizeof(c));
+}
+
+// 参数合法性检查：要编码的区间必须落在批次内
+static bool app_codec_range_ok(const app_batch_t *batch, uint16_t start, uint16_t n, const uint8_t *buf, size_t len)
+{
+    return batch && buf && len > 0 && n > 0 && start + n <= batch->count;
+}
+
+// t0 为批次第一个样本的采样时刻（微秒）：SNTP 对时后为 UTC，对时前为开机后的时间，由 utc 字段区分
+static bool app_codec_t0(const app_batch_t *batch, int64_t *t0_us)
+{
+    *t0_us = batch->t0_us;
+    return net_time_to_epoch_us(batch->t0_us, t0_us) == ESP_OK;
+}
+
+// ========================
+// JSON：{"type":"upload","ver":3,"t0":...,"utc":true,"n":n,"dt":[...],"ax":[...],...,"temp":[...]}
+// ========================
+static size_t app_codec_json_encode(const app_batch_t *batch, uint16_t start, uint16_t n, uint8_t *buf, size_t len)
+{
+    if (!app_codec_range_ok(batch, start, n, buf, len))
+    {
+        return 0;
+    }
+
+    int64_t t0_us;
+    bool utc = app_codec_t0(batch, &t0_us);
+    app_codec_column_t cols[APP_CODEC_COLUMNS];
+    app_codec_columns(batch, cols);
+
+    // 直接写进调用方的缓冲区，不建 cJSON 树、不分配内存
+    json_writer_t w;
+    json_writer_init(&w, (char *)buf, len);
+
+    json_writer_begin_object(&w);
+    json_writer_kv_string(&w, "type", "upload");
+    json_writer_kv_int(&w, "ver", APP_CODEC_SCHEMA_VER);
+    json_writer_kv_int(&w, "t0", t0_us);
+    json_writer_kv_bool(&w, "utc", utc);
+    json_writer_kv_int(&w, "n", n);
+    for (int i = 0; i < APP_CODEC_COLUMNS; i++)
+    {
+        json_writer_key(&w, cols[i].key);
+        json_writer_int32_array(&w, &cols[i].col[start], n);
+    }
+    json_writer_end_object(&w);
+
+    return json_writer_finish(&w);
+}
+
+// ========================
+// CBOR：与 JSON 相同的键和结构，整数按实际大小用 1~5 字节编码
+// ========================
+static size_t app_codec_cbor_encode(const app_batch_t *batch, uint16_t start, uint16_t n, uint8_t *buf, size_t len)
+{
+    if (!app_codec_range_ok(batch, start, n, buf, len))
+    {
+        return 0;
+    }
+
+    int64_t t0_us;
+    bool utc = app_codec_t0(batch, &t0_us);
+    app_codec_column_t cols[APP_CODEC_COLUMNS];
+    app_codec_columns(batch, cols);
+
+    cbor_writer_t w;
+    cbor_writer_init(&w, buf, len);
+
+    cbor_writer_map(&w, APP_CODEC_HEADER_FIELDS + APP_CODEC_COLUMNS);
+    cbor_writer_text(&w, "type");
+    cbor_writer_text(&w, "upload");
+    cbor_writer_text(&w, "ver");
+    cbor_writer_uint(&w, APP_CODEC_SCHEMA_VER);
+    cbor_writer_text(&w, "t0");
+    cbor_writer_int(&w, t0_us);
+    cbor_writer_text(&w, "utc");
+    cbor_writer_bool(&w, utc);
+    cbor_writer_text(&w, "n");
+    cbor_writer_uint(&w, n);
+    for (int i = 0; i < APP_CODEC_COLUMNS; i++)
+    {
+        cbor_writer_text(&w, cols[i].key);
+        cbor_writer_int32_array(&w, &cols[i].col[start], n);
+    }
+
+    return cbor_writer_finish(&w);
+}
+
+// ========================
+// 差分 + 变长整数：相邻样本变化很小，差分后大多只需 1~2 字节
+// 格式（uvar 为 LEB128 无符号变长整数，svar 为 zigzag 后的 uvar）：
+//   u8   magic 0xD3
+//   uvar ver
+//   u8   flags（bit0：t0 为 UTC）
+//   svar t0（微秒）
+//   uvar n
+//   8 列，顺序为 dt ax ay az gx gy gz temp，每列 n 个 svar：
+//     dt 为二阶差分（等间隔采样时几乎全为 0），其余为一阶差分，第一个值与 0 相比
+// ========================
+static size_t app_codec_delta_encode(const app_batch_t *batch, uint16_t start, uint16_t n, uint8_t *buf, size_t len)
+{
+    if (!app_codec_range_ok(batch, start, n, buf, len))
+    {
+        return 0;
+    }
+
+    int64_t t0_us;
+    bool utc = app_codec_t0(batch, &t0_us);
+    app_codec_column_t cols[APP_CODEC_COLUMNS];
+    app_codec_columns(batch, cols);
+
+    varint_writer_t w;
+    varint_writer_init(&w, buf, len);
+
+    varint_writer_byte(&w, APP_CODEC_DELTA_MAGIC);
+    varint_writer_uint(&w, APP_CODEC_SCHEMA_VER);
+    varint_writer_byte(&w, utc ? APP_CODEC_DELTA_F_UTC : 0);
+    varint_writer_sint(&w, t0_us);
+    varint_writer_uint(&w, n);
+    for (int i = 0; i < APP_CODEC_COLUMNS; i++)
+    {
+        varint_writer_delta_int32(&w, &cols[i].col[start], n, (i == 0) ? 2 : 1);
+    }
+
+    return varint_writer_finish(&w);
+}
+
+// ========================
+// 编码器选择
+// ========================
+
+const app_codec_t *app_codec_get(app_codec_id_t id)
+{
+    if ((unsigned)id >= APP_CODEC_MAX)
+    {
+        return NULL;
+    }
+    return &s_codecs[id];
+}
+
+esp_err_t app_codec_find(const char *name, app_codec_id_t *id)
+{
+    if (!name || !id)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for (int i = 0; i < APP_CODEC_MAX; i++)
+    {
+        if (strcmp(s_codecs[i].name, name) == 0)
+        {
+            *id = (app_codec_id_t)i;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t app_codec_select(app_codec_id_t id)
+{
+    if ((unsigned)id >= APP_CODEC_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (id != s_active)
+    {
+        ESP_LOGI(TAG, "Uplink encoding: %s -> %s (topic %s)", s_codecs[s_active].name, s_codecs[id].name, s_codecs[id].topic);
+        s_active = id;
+    }
+    return ESP_OK;
+}
+
+const app_codec_t *app_codec_active(void)
+{
+    return &s_codecs[s_active];
+}
+
+app_codec_id_t app_codec_active_id(void)
+{
+    return s_active;
+}
@@ -0,0 +1,178 @@
+#include "app_flow.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+static const char *TAG = "APP_FLOW";
+
+// 超过（低于）水位持续这么久才向上游发信号，避免瞬时的突发引起来回调整
+#define APP_FLOW_SUSTAIN_MS 2000
+
+static const char *const s_stage_names[APP_FLOW_STAGE_MAX] = {"sample", "downlink"};
+static const char *const s_policy_names[] = {"block", "drop-oldest", "drop-newest", "coalesce"};
+
+// 默认策略：
+// - 样本：合并成平均样本，保留信号能量，只损失时间分辨率
+// - 下行：不能阻塞 MQTT 任务，满了丢弃新指令，已排队的指令按顺序执行；丢弃会计数并打日志，不会悄悄丢
+static app_flow_config_t s_config[APP_FLOW_STAGE_MAX] = {
+    [APP_FLOW_STAGE_SAMPLE] = {APP_FLOW_COALESCE, 0, 75, 25},
+    [APP_FLOW_STAGE_DOWNLINK] = {APP_FLOW_DROP_NEWEST, 0, 75, 25},
+};
+
+// 每一级的统计和水位计时
+typedef struct
+{
+    app_flow_stats_t stats;
+    int64_t above_since_us; // 开始持续高于高水位的时刻，0 表示当前不在高水位之上
+    int64_t below_since_us; // 开始持续低于低水位的时刻
+} app_flow_state_t;
+
+static app_flow_state_t s_state[APP_FLOW_STAGE_MAX];
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+esp_err_t app_flow_set_config(app_flow_stage_t stage, const app_flow_config_t *config)
+{
+    if ((unsigned)stage >= APP_FLOW_STAGE_MAX || !config || config->policy > APP_FLOW_COALESCE ||
+        config->high_pct > 100 || config->low_pct >= config->high_pct)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (stage == APP_FLOW_STAGE_DOWNLINK && config->policy == APP_FLOW_BLOCK)
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    s_config[stage] = *config;
+    portEXIT_CRITICAL(&s_lock);
+    return ESP_OK;
+}
+
+esp_err_t app_flow_get_config(app_flow_stage_t stage, app_flow_config_t *config)
+{
+    if ((unsigned)stage >= APP_FLOW_STAGE_MAX || !config)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    *config = s_config[stage];
+    portEXIT_CRITICAL(&s_lock);
+    return ESP_OK;
+}
+
+void app_flow_count(app_flow_stage_t stage, app_flow_event_t event)
+{
+    if ((unsigned)stage >= APP_FLOW_STAGE_MAX)
+    {
+        return;
+    }
+
+    app_flow_stats_t *s = &s_state[stage].stats;
+    portENTER_CRITICAL(&s_lock);
+    switch (event)
+    {
+    case APP_FLOW_EV_ACCEPTED:
+        s->accepted++;
+        break;
+    case APP_FLOW_EV_BLOCKED:
+        s->blocked++;
+        break;
+    case APP_FLOW_EV_DROP_OLDEST:
+        s->dropped_oldest++;
+        break;
+    case APP_FLOW_EV_DROP_NEWEST:
+        s->dropped_newest++;
+        break;
+    case APP_FLOW_EV_COALESCED:
+        s->coalesced++;
+        break;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+app_flow_signal_t app_flow_level(app_flow_stage_t stage, uint32_t used, uint32_t capacity)
+{
+    if ((unsigned)stage >= APP_FLOW_STAGE_MAX || capacity == 0)
+    {
+        return APP_FLOW_SIGNAL_NONE;
+    }
+
+    int64_t now = esp_timer_get_time();
+    int64_t sustain = (int64_t)APP_FLOW_SUSTAIN_MS * 1000;
+    uint32_t pct = (uint32_t)((uint64_t)used * 100 / capacity);
+    app_flow_signal_t signal = APP_FLOW_SIGNAL_NONE;
+    app_flow_state_t *st = &s_state[stage];
+
+    portENTER_CRITICAL(&s_lock);
+    st->stats.used = used;
+    st->stats.capacity = capacity;
+    if (used > st->stats.peak)
+    {
+        st->stats.peak = used;
+    }
+
+    if (pct >= s_config[stage].high_pct)
+    {
+        st->below_since_us = 0;
+        if (st->above_since_us == 0)
+        {
+            st->above_since_us = now;
+        }
+        else if (now - st->above_since_us >= sustain)
+        {
+            st->above_since_us = now;
+            st->stats.sheds++;
+            signal = APP_FLOW_SIGNAL_SHED;
+        }
+    }
+    else if (pct <= s_config[stage].low_pct)
+    {
+        st->above_since_us = 0;
+        if (st->below_since_us == 0)
+        {
+            st->below_since_us = now;
+        }
+        else if (now - st->below_since_us >= sustain)
+        {
+            st->below_since_us = now;
+            signal = APP_FLOW_SIGNAL_RESTORE;
+        }
+    }
+    else
+    {
+        st->above_since_us = 0;
+        st->below_since_us = 0;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    return signal;
+}
+
+esp_err_t app_flow_get_stats(app_flow_stage_t stage, app_flow_stats_t *stats)
+{
+    if ((unsigned)stage >= APP_FLOW_STAGE_MAX || !stats)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    *stats = s_state[stage].stats;
+    portEXIT_CRITICAL(&s_lock);
+    return ESP_OK;
+}
+
+void app_flow_log_stats(void)
+{
+    for (int i = 0; i < APP_FLOW_STAGE_MAX; i++)
+    {
+        app_flow_config_t cfg;
+        app_flow_stats_t s;
+        app_flow_get_config((app_flow_stage_t)i, &cfg);
+        app_flow_get_stats((app_flow_stage_t)i, &s);
+        ESP_LOGI(TAG, "%-8s %-11s %u/%u (peak %u): accepted %u, blocked %u, drop-oldest %u, drop-newest %u, coalesced %u, shed %u",
+                 s_stage_names[i], s_policy_names[cfg.policy], (unsigned)s.used, (unsigned)s.capacity, (unsigned)s.peak,
+                 (unsigned)s.accepted, (unsigned)s.blocked, (unsigned)s.dropped_oldest, (unsigned)s.dropped_newest,
+                 (unsigned)s.coalesced, (unsigned)s.sheds);
+    }
+}
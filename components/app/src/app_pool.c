@@ -0,0 +1,113 @@
+#include "app_pool.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+static const char *TAG = "APP_POOL";
+
+static app_buf_t s_bufs[APP_POOL_BUF_COUNT];  // 缓冲区本体，静态分配
+static QueueHandle_t s_free = NULL;           // 空闲缓冲区指针队列，池空时申请方可以阻塞等待
+static uint32_t s_min_free = APP_POOL_BUF_COUNT;
+static uint32_t s_allocs = 0;
+static uint32_t s_exhausted = 0;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+#if CONFIG_APP_STATIC_ALLOC
+// 空闲队列的存储区，静态分配
+static StaticQueue_t s_free_queue;
+static uint8_t s_free_storage[APP_POOL_BUF_COUNT * sizeof(app_buf_t *)];
+#endif
+
+esp_err_t app_pool_init(void)
+{
+    if (s_free)
+    {
+        return ESP_OK;
+    }
+
+#if CONFIG_APP_STATIC_ALLOC
+    s_free = xQueueCreateStatic(APP_POOL_BUF_COUNT, sizeof(app_buf_t *), s_free_storage, &s_free_queue);
+#else
+    s_free = xQueueCreate(APP_POOL_BUF_COUNT, sizeof(app_buf_t *));
+#endif
+    if (!s_free)
+    {
+        ESP_LOGE(TAG, "Failed to create free list");
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (int i = 0; i < APP_POOL_BUF_COUNT; i++)
+    {
+        app_buf_t *buf = &s_bufs[i];
+        atomic_store_explicit(&buf->refs, 0, memory_order_relaxed);
+        xQueueSend(s_free, &buf, 0);
+    }
+    return ESP_OK;
+}
+
+app_buf_t *app_pool_alloc(TickType_t wait)
+{
+    app_buf_t *buf = NULL;
+    if (!s_free || xQueueReceive(s_free, &buf, wait) != pdTRUE)
+    {
+        portENTER_CRITICAL(&s_lock);
+        s_exhausted++;
+        portEXIT_CRITICAL(&s_lock);
+        return NULL;
+    }
+
+    uint32_t free_now = (uint32_t)uxQueueMessagesWaiting(s_free);
+    portENTER_CRITICAL(&s_lock);
+    s_allocs++;
+    if (free_now < s_min_free)
+    {
+        s_min_free = free_now;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    atomic_store_explicit(&buf->refs, 1, memory_order_relaxed);
+    buf->len = 0;
+    buf->data[0] = '\0';
+    return buf;
+}
+
+void app_pool_ref(app_buf_t *buf)
+{
+    atomic_fetch_add_explicit(&buf->refs, 1, memory_order_relaxed);
+}
+
+void app_pool_release(app_buf_t *buf)
+{
+    if (!buf)
+    {
+        return;
+    }
+
+    // acq_rel：保证之前对内容的读写都完成后，缓冲区才可能被下一个申请者拿到
+    uint32_t prev = atomic_fetch_sub_explicit(&buf->refs, 1, memory_order_acq_rel);
+    if (prev == 1)
+    {
+        xQueueSend(s_free, &buf, 0);
+    }
+    else if (prev == 0)
+    {
+        ESP_LOGE(TAG, "Double release of buffer %p", (void *)buf);
+        atomic_store_explicit(&buf->refs, 0, memory_order_relaxed);
+    }
+}
+
+void app_pool_get_stats(app_pool_stats_t *stats)
+{
+    if (!stats)
+    {
+        return;
+    }
+
+    stats->total = APP_POOL_BUF_COUNT;
+    stats->free = s_free ? (uint32_t)uxQueueMessagesWaiting(s_free) : 0;
+    portENTER_CRITICAL(&s_lock);
+    stats->min_free = s_min_free;
+    stats->allocs = s_allocs;
+    stats->exhausted = s_exhausted;
+    portEXIT_CRITICAL(&s_lock);
+}
@@ -0,0 +1,232 @@
+#include "app_rate.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include <string.h>
+
+static const char *TAG = "APP_RATE";
+
+#define APP_RATE_NVS_NAMESPACE "app_rate"
+#define APP_RATE_NVS_KEY "profile"
+
+// 默认：传感器 100Hz 采样，不抽取
+#define APP_RATE_DEFAULT_SAMPLE_HZ 100
+#define APP_RATE_DEFAULT_OUTPUT_HZ 100
+
+static app_rate_profile_t s_profile = {APP_RATE_DEFAULT_SAMPLE_HZ, APP_RATE_DEFAULT_OUTPUT_HZ};
+static bool s_pending = false;
+static uint32_t s_set_seq = 0;     // 每次 app_rate_set 加 1
+static uint32_t s_taken_seq = 0;   // 采集任务取走的配置对应的序号
+static uint32_t s_applied_seq = 0; // 已出结果的配置对应的序号
+static esp_err_t s_apply_err = ESP_OK;
+static uint32_t s_apply_failures = 0; // 连续应用失败次数
+static TaskHandle_t s_notify = NULL;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static bool app_rate_valid(const app_rate_profile_t *p)
+{
+    if (p->sample_hz < 4 || p->sample_hz > 1000)
+    {
+        return false;
+    }
+    if (p->output_hz == 0 || p->output_hz > p->sample_hz)
+    {
+        return false;
+    }
+    return (p->sample_hz / p->output_hz) <= APP_RATE_MAX_FACTOR;
+}
+
+esp_err_t app_rate_init(void)
+{
+    app_rate_profile_t p = {APP_RATE_DEFAULT_SAMPLE_HZ, APP_RATE_DEFAULT_OUTPUT_HZ};
+
+    nvs_handle_t nvs;
+    if (nvs_open(APP_RATE_NVS_NAMESPACE, NVS_READONLY, &nvs) == ESP_OK)
+    {
+        app_rate_profile_t stored;
+        size_t len = sizeof(stored);
+        if (nvs_get_blob(nvs, APP_RATE_NVS_KEY, &stored, &len) == ESP_OK &&
+            len == sizeof(stored) && app_rate_valid(&stored))
+        {
+            p = stored;
+            ESP_LOGI(TAG, "Rate profile loaded from NVS: %u Hz -> %u Hz", p.sample_hz, p.output_hz);
+        }
+        nvs_close(nvs);
+    }
+
+    return app_rate_set(&p, false);
+}
+
+esp_err_t app_rate_set(const app_rate_profile_t *profile, bool persist)
+{
+    if (!profile || !app_rate_valid(profile))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    s_profile = *profile;
+    s_pending = true;
+    s_set_seq++;
+    TaskHandle_t notify = s_notify;
+    portEXIT_CRITICAL(&s_lock);
+
+    if (notify)
+    {
+        xTaskNotifyGive(notify);
+    }
+
+    if (!persist)
+    {
+        return ESP_OK;
+    }
+
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(APP_RATE_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    err = nvs_set_blob(nvs, APP_RATE_NVS_KEY, profile, sizeof(*profile));
+    if (err == ESP_OK)
+    {
+        err = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    return err;
+}
+
+void app_rate_get(app_rate_profile_t *profile)
+{
+    if (!profile)
+    {
+        return;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    *profile = s_profile;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+esp_err_t app_rate_poll_applied(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    bool done = (int32_t)(s_applied_seq - s_set_seq) >= 0;
+    esp_err_t err = s_apply_err;
+    portEXIT_CRITICAL(&s_lock);
+
+    return done ? err : ESP_ERR_NOT_FINISHED;
+}
+
+void app_rate_set_notify(TaskHandle_t task)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_notify = task;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+bool app_rate_take_pending(app_rate_profile_t *profile)
+{
+    portENTER_CRITICAL(&s_lock);
+    bool pending = s_pending;
+    if (pending)
+    {
+        *profile = s_profile;
+        s_pending = false;
+        s_taken_seq = s_set_seq;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return pending;
+}
+
+void app_rate_applied(esp_err_t err)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_applied_seq = s_taken_seq;
+    s_apply_err = err;
+    if (err == ESP_OK)
+    {
+        s_apply_failures = 0;
+    }
+    else
+    {
+        // 期间没有更新的配置时重新挂起，下一次唤醒再试
+        s_pending = true;
+        s_apply_failures++;
+    }
+    uint32_t failures = s_apply_failures;
+    app_rate_profile_t profile = s_profile;
+    portEXIT_CRITICAL(&s_lock);
+
+    // 只在失败次数为 2 的幂时打日志
+    if (failures > 0 && (failures & (failures - 1)) == 0)
+    {
+        ESP_LOGW(TAG, "Failed to apply %u Hz (%s), %u in a row, will retry",
+                 profile.sample_hz, esp_err_to_name(err), (unsigned)failures);
+    }
+}
+
+// ========================
+// 软件抽取：对 factor 个样本求平均（矩形窗低通），再每 factor 个输出一个，避免降速后混叠
+// ========================
+
+void app_decim_init(app_decim_t *decim, uint16_t factor)
+{
+    memset(decim, 0, sizeof(*decim));
+    decim->factor = factor ? factor : 1;
+}
+
+void app_decim_set_factor(app_decim_t *decim, uint16_t factor)
+{
+    decim->factor = factor ? factor : 1;
+}
+
+bool app_decim_push(app_decim_t *decim, const app_sample_t *in, app_sample_t *out)
+{
+    // 不抽取时直接透传（倍数刚改成 1 时先把累加中的样本随这一个一起输出）
+    if (decim->factor == 1 && decim->count == 0)
+    {
+        *out = *in;
+        return true;
+    }
+
+    decim->ts_sum += in->ts_us;
+    decim->sum[0] += in->ax;
+    decim->sum[1] += in->ay;
+    decim->sum[2] += in->az;
+    decim->sum[3] += in->gx;
+    decim->sum[4] += in->gy;
+    decim->sum[5] += in->gz;
+    decim->sum[6] += in->temp;
+    decim->flags |= in->flags;
+
+    if (++decim->count < decim->factor)
+    {
+        return false;
+    }
+
+    return app_decim_flush(decim, out);
+}
+
+bool app_decim_flush(app_decim_t *decim, app_sample_t *out)
+{
+    if (decim->count == 0)
+    {
+        return false;
+    }
+
+    int64_t n = decim->count;
+    out->ts_us = decim->ts_sum / n;
+    out->ax = (int16_t)(decim->sum[0] / n);
+    out->ay = (int16_t)(decim->sum[1] / n);
+    out->az = (int16_t)(decim->sum[2] / n);
+    out->gx = (int32_t)(decim->sum[3] / n);
+    out->gy = (int32_t)(decim->sum[4] / n);
+    out->gz = (int32_t)(decim->sum[5] / n);
+    out->temp = (int16_t)(decim->sum[6] / n);
+    out->flags = decim->flags;
+
+    app_decim_init(decim, decim->factor);
+    return true;
+}
@@ -0,0 +1,72 @@
+#include "app_ring.h"
+
+#define APP_RING_MASK (APP_RING_CAPACITY - 1)
+
+_Static_assert((APP_RING_CAPACITY & APP_RING_MASK) == 0, "APP_RING_CAPACITY must be a power of 2");
+
+void app_ring_init(app_ring_t *ring)
+{
+    atomic_store_explicit(&ring->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, 0, memory_order_relaxed);
+}
+
+// ========================
+// 生产者（采集任务）
+// ========================
+
+app_sample_t *app_ring_reserve(app_ring_t *ring)
+{
+    // head 只有自己会改，relaxed 读即可；tail 由消费者发布，需要 acquire 才能看到它已经读完的槽位
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    if (head - tail >= APP_RING_CAPACITY)
+    {
+        return NULL;
+    }
+
+    return &ring->buf[head & APP_RING_MASK];
+}
+
+void app_ring_commit(app_ring_t *ring)
+{
+    // release：保证槽位内容先于新的 head 对消费者可见
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+// ========================
+// 消费者（上传任务）
+// ========================
+
+size_t app_ring_peek(app_ring_t *ring, const app_sample_t **first)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    size_t avail = head - tail;
+    size_t idx = tail & APP_RING_MASK;
+
+    // 只返回到数组末尾为止的连续部分，回绕后的部分下一次再取
+    if (avail > APP_RING_CAPACITY - idx)
+    {
+        avail = APP_RING_CAPACITY - idx;
+    }
+
+    *first = &ring->buf[idx];
+    return avail;
+}
+
+void app_ring_release(app_ring_t *ring, size_t n)
+{
+    // release：保证对槽位的读取先于新的 tail 对生产者可见，之后槽位才会被覆盖
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, tail + (uint32_t)n, memory_order_release);
+}
+
+size_t app_ring_count(app_ring_t *ring)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    return head - tail;
+}
@@ -0,0 +1,606 @@
+#include "app_store.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_partition.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "APP_STORE";
+
+// flash 扇区头魔数（"TLM1"），扇区头之后依次存放记录
+#define STORE_SECTOR_MAGIC 0x314D4C54
+
+// 记录头中 len 为全 1 表示后面没有记录（flash 擦除后的状态 / 内存区的回绕标记）
+#define STORE_LEN_NONE 0xFFFF
+
+// 记录状态：flash 只能把 1 写成 0，补发后把状态字节清零即可，不用擦除
+#define STORE_STATE_PENDING 0xFF
+#define STORE_STATE_DONE 0x00
+
+// 记录按 4 字节对齐存放
+#define STORE_ALIGN(n) (((n) + 3) & ~(size_t)3)
+
+// 记录头：flash 上先写数据再写头，写到一半断电时头仍是全 1，恢复时当作扇区末尾
+typedef struct
+{
+    uint16_t len;  // 数据长度
+    uint8_t tag;   // 调用方定义的标签
+    uint8_t state; // STORE_STATE_*
+} store_hdr_t;
+
+// flash 扇区头：seq 每启用一个新扇区加 1，上电时据此找出最早和最新的扇区
+typedef struct
+{
+    uint32_t magic;
+    uint32_t seq;
+} store_sector_t;
+
+// ========================
+// 内存暂存区：按字节存放的环形队列，记录不跨越末尾，放不下时写回绕标记从头开始
+// ========================
+
+static uint8_t s_ram[APP_STORE_RAM_BYTES] __attribute__((aligned(4)));
+static size_t s_ram_head = 0;     // 下一条记录的写入位置
+static size_t s_ram_tail = 0;     // 最早一条记录的位置
+static uint32_t s_ram_records = 0;
+static uint32_t s_ram_bytes = 0;
+
+// ========================
+// flash 转存区：分区按扇区组成环，写指针所在扇区之前是更早的数据
+// ========================
+
+static const esp_partition_t *s_part = NULL;
+static uint32_t s_sector_size = 0;
+static uint32_t s_sectors = 0;
+static uint32_t s_seq = 0;    // 写指针所在扇区的序号
+static uint32_t s_wr_sec = 0; // 写指针
+static uint32_t s_wr_off = 0;
+static uint32_t s_rd_sec = 0; // 最早一条未补发记录的位置（flash 为空时与写指针相同）
+static uint32_t s_rd_off = 0;
+static uint32_t s_flash_records = 0;
+static uint32_t s_flash_bytes = 0;
+
+// 统计，其他任务读取时加锁
+static app_store_stats_t s_stats;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void store_update_stats(uint32_t stored, uint32_t forwarded, uint32_t spilled, uint32_t evicted, uint32_t discarded)
+{
+    uint32_t bytes = s_ram_bytes + s_flash_bytes;
+
+    portENTER_CRITICAL(&s_lock);
+    s_stats.records = s_ram_records + s_flash_records;
+    s_stats.bytes = bytes;
+    if (bytes > s_stats.high_water)
+    {
+        s_stats.high_water = bytes;
+    }
+    s_stats.stored += stored;
+    s_stats.forwarded += forwarded;
+    s_stats.spilled += spilled;
+    s_stats.evicted += evicted;
+    s_stats.discarded += discarded;
+    s_stats.flash = (s_part != NULL);
+    portEXIT_CRITICAL(&s_lock);
+}
+
+// ========================
+// 内存暂存区
+// ========================
+
+// 为 size 字节的记录找位置，放不下返回 -1
+static int32_t store_ram_reserve(size_t size)
+{
+    if (s_ram_records == 0)
+    {
+        s_ram_head = 0;
+        s_ram_tail = 0;
+    }
+    else if (s_ram_head == s_ram_tail)
+    {
+        return -1;
+    }
+
+    if (s_ram_head < s_ram_tail)
+    {
+        return (s_ram_tail - s_ram_head >= size) ? (int32_t)s_ram_head : -1;
+    }
+
+    if (APP_STORE_RAM_BYTES - s_ram_head >= size)
+    {
+        return (int32_t)s_ram_head;
+    }
+    if (s_ram_tail < size)
+    {
+        return -1;
+    }
+
+    // 末尾放不下，写回绕标记后从头开始
+    if (APP_STORE_RAM_BYTES - s_ram_head >= sizeof(store_hdr_t))
+    {
+        ((store_hdr_t *)&s_ram[s_ram_head])->len = STORE_LEN_NONE;
+    }
+    s_ram_head = 0;
+    return 0;
+}
+
+// 最早一条记录，内存区为空返回 NULL
+static const store_hdr_t *store_ram_front(void)
+{
+    if (s_ram_records == 0)
+    {
+        return NULL;
+    }
+
+    if (s_ram_tail + sizeof(store_hdr_t) > APP_STORE_RAM_BYTES ||
+        ((const store_hdr_t *)&s_ram[s_ram_tail])->len == STORE_LEN_NONE)
+    {
+        s_ram_tail = 0;
+    }
+    return (const store_hdr_t *)&s_ram[s_ram_tail];
+}
+
+static void store_ram_pop(void)
+{
+    const store_hdr_t *hdr = store_ram_front();
+    if (!hdr)
+    {
+        return;
+    }
+
+    s_ram_tail += STORE_ALIGN(sizeof(store_hdr_t) + hdr->len);
+    s_ram_records--;
+    s_ram_bytes -= hdr->len;
+}
+
+// ========================
+// flash 转存区
+// ========================
+
+static uint32_t store_sector_addr(uint32_t sec)
+{
+    return sec * s_sector_size;
+}
+
+// 从 off 起扫描扇区内的记录，累计未补发的记录；first_pending 返回第一条未补发记录的位置（没有则为 0）
+// 返回扇区内第一个空位置
+static uint32_t store_flash_scan(uint32_t sec, uint32_t off, uint32_t *records, uint32_t *bytes, uint32_t *first_pending)
+{
+    *records = 0;
+    *bytes = 0;
+    if (first_pending)
+    {
+        *first_pending = 0;
+    }
+
+    while (off + sizeof(store_hdr_t) <= s_sector_size)
+    {
+        store_hdr_t hdr;
+        if (esp_partition_read(s_part, store_sector_addr(sec) + off, &hdr, sizeof(hdr)) != ESP_OK ||
+            hdr.len == STORE_LEN_NONE || hdr.len == 0 || hdr.len > APP_STORE_RECORD_MAX ||
+            off + STORE_ALIGN(sizeof(hdr) + hdr.len) > s_sector_size)
+        {
+            break;
+        }
+
+        if (hdr.state == STORE_STATE_PENDING)
+        {
+            if (first_pending && *records == 0)
+            {
+                *first_pending = off;
+            }
+            (*records)++;
+            *bytes += hdr.len;
+        }
+        off += STORE_ALIGN(sizeof(hdr) + hdr.len);
+    }
+    return off;
+}
+
+// 启用下一个扇区作为写扇区；它若是最早数据所在的扇区，先整扇区丢弃（淘汰最旧）
+static esp_err_t store_flash_next_sector(void)
+{
+    uint32_t next = (s_wr_sec + 1) % s_sectors;
+
+    if (s_flash_records > 0 && next == s_rd_sec)
+    {
+        uint32_t records, bytes;
+        store_flash_scan(s_rd_sec, s_rd_off, &records, &bytes, NULL);
+        s_flash_records -= (records < s_flash_records) ? records : s_flash_records;
+        s_flash_bytes -= (bytes < s_flash_bytes) ? bytes : s_flash_bytes;
+        s_rd_sec = (s_rd_sec + 1) % s_sectors;
+        s_rd_off = sizeof(store_sector_t);
+        store_update_stats(0, 0, 0, records, 0);
+        ESP_LOGW(TAG, "Flash store full, %u oldest records evicted", (unsigned)records);
+    }
+
+    esp_err_t err = esp_partition_erase_range(s_part, store_sector_addr(next), s_sector_size);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    store_sector_t sector = {.magic = STORE_SECTOR_MAGIC, .seq = s_seq + 1};
+    err = esp_partition_write(s_part, store_sector_addr(next), &sector, sizeof(sector));
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    s_seq = sector.seq;
+    s_wr_sec = next;
+    s_wr_off = sizeof(store_sector_t);
+    if (s_flash_records == 0)
+    {
+        s_rd_sec = s_wr_sec;
+        s_rd_off = s_wr_off;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t store_flash_append(const store_hdr_t *hdr, const uint8_t *data)
+{
+    size_t size = STORE_ALIGN(sizeof(*hdr) + hdr->len);
+    esp_err_t err;
+
+    if (s_wr_off + size > s_sector_size)
+    {
+        err = store_flash_next_sector();
+        if (err != ESP_OK)
+        {
+            return err;
+        }
+    }
+
+    // 先写数据再写头，断电时不会留下头完整、数据残缺的记录
+    uint32_t addr = store_sector_addr(s_wr_sec) + s_wr_off;
+    err = esp_partition_write(s_part, addr + sizeof(*hdr), data, hdr->len);
+    if (err == ESP_OK)
+    {
+        store_hdr_t h = {.len = hdr->len, .tag = hdr->tag, .state = STORE_STATE_PENDING};
+        err = esp_partition_write(s_part, addr, &h, sizeof(h));
+    }
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    if (s_flash_records == 0)
+    {
+        s_rd_sec = s_wr_sec;
+        s_rd_off = s_wr_off;
+    }
+    s_wr_off += size;
+    s_flash_records++;
+    s_flash_bytes += hdr->len;
+    return ESP_OK;
+}
+
+// flash 中记录损坏时整体放弃，从写指针处重新开始
+static void store_flash_drop_all(void)
+{
+    ESP_LOGE(TAG, "Flash store corrupted, %u records dropped", (unsigned)s_flash_records);
+    uint32_t records = s_flash_records;
+    s_flash_records = 0;
+    s_flash_bytes = 0;
+    s_rd_sec = s_wr_sec;
+    s_rd_off = s_wr_off;
+    store_update_stats(0, 0, 0, records, 0);
+}
+
+// 读出最早一条未补发记录的头，读指针停在扇区末尾时移到下一个扇区
+static esp_err_t store_flash_front(store_hdr_t *hdr)
+{
+    for (uint32_t i = 0; i <= s_sectors; i++)
+    {
+        if (s_rd_off + sizeof(*hdr) <= s_sector_size)
+        {
+            esp_err_t err = esp_partition_read(s_part, store_sector_addr(s_rd_sec) + s_rd_off, hdr, sizeof(*hdr));
+            if (err != ESP_OK)
+            {
+                return err;
+            }
+            if (hdr->len != STORE_LEN_NONE)
+            {
+                if (hdr->len == 0 || hdr->len > APP_STORE_RECORD_MAX)
+                {
+                    break;
+                }
+                return ESP_OK;
+            }
+        }
+        if (s_rd_sec == s_wr_sec)
+        {
+            break;
+        }
+        s_rd_sec = (s_rd_sec + 1) % s_sectors;
+        s_rd_off = sizeof(store_sector_t);
+    }
+
+    store_flash_drop_all();
+    return ESP_ERR_INVALID_CRC;
+}
+
+static void store_flash_pop(void)
+{
+    store_hdr_t hdr;
+    if (store_flash_front(&hdr) != ESP_OK)
+    {
+        return;
+    }
+
+    // 标记失败时记录照样从内存中的读指针移走，不会卡住补发；只是重启恢复时它还算未补发，会再发一次
+    uint8_t done = STORE_STATE_DONE;
+    esp_err_t err = esp_partition_write(s_part, store_sector_addr(s_rd_sec) + s_rd_off + offsetof(store_hdr_t, state), &done, 1);
+    if (err != ESP_OK)
+    {
+        portENTER_CRITICAL(&s_lock);
+        uint32_t errors = ++s_stats.mark_errors;
+        portEXIT_CRITICAL(&s_lock);
+        if ((errors & (errors - 1)) == 0)
+        {
+            ESP_LOGW(TAG, "Failed to mark record done (%s), %u so far; it will be forwarded again after reboot",
+                     esp_err_to_name(err), (unsigned)errors);
+        }
+    }
+
+    s_rd_off += STORE_ALIGN(sizeof(hdr) + hdr.len);
+    s_flash_records--;
+    s_flash_bytes -= (hdr.len < s_flash_bytes) ? hdr.len : s_flash_bytes;
+    if (s_flash_records == 0)
+    {
+        s_rd_sec = s_wr_sec;
+        s_rd_off = s_wr_off;
+    }
+}
+
+// 上电恢复：按序号找出最早的扇区，沿环往后统计未补发的记录，然后在最新扇区之后启用一个新扇区写入
+// （最新扇区的末尾可能有断电时写了一半的数据，不再往里追加）
+static esp_err_t store_flash_recover(void)
+{
+    uint32_t oldest = UINT32_MAX, newest = UINT32_MAX;
+    uint32_t oldest_seq = 0, newest_seq = 0;
+
+    for (uint32_t sec = 0; sec < s_sectors; sec++)
+    {
+        store_sector_t sector;
+        if (esp_partition_read(s_part, store_sector_addr(sec), &sector, sizeof(sector)) != ESP_OK ||
+            sector.magic != STORE_SECTOR_MAGIC)
+        {
+            continue;
+        }
+        if (oldest == UINT32_MAX || sector.seq < oldest_seq)
+        {
+            oldest = sec;
+            oldest_seq = sector.seq;
+        }
+        if (newest == UINT32_MAX || sector.seq > newest_seq)
+        {
+            newest = sec;
+            newest_seq = sector.seq;
+        }
+    }
+
+    s_flash_records = 0;
+    s_flash_bytes = 0;
+
+    if (oldest == UINT32_MAX)
+    {
+        // 全新的分区
+        s_seq = 0;
+        s_wr_sec = s_sectors - 1;
+        return store_flash_next_sector();
+    }
+
+    // 从最早的扇区沿环往后走，序号必须连续，断开处之后的是更早以前留下的旧扇区
+    uint32_t sec = oldest;
+    uint32_t seq = oldest_seq;
+    for (uint32_t i = 0; i < s_sectors; i++)
+    {
+        store_sector_t sector;
+        if (esp_partition_read(s_part, store_sector_addr(sec), &sector, sizeof(sector)) != ESP_OK ||
+            sector.magic != STORE_SECTOR_MAGIC || sector.seq != seq)
+        {
+            break;
+        }
+
+        uint32_t records, bytes, first;
+        store_flash_scan(sec, sizeof(store_sector_t), &records, &bytes, &first);
+        if (records > 0 && s_flash_records == 0)
+        {
+            s_rd_sec = sec;
+            s_rd_off = first;
+        }
+        s_flash_records += records;
+        s_flash_bytes += bytes;
+
+        newest = sec;
+        newest_seq = seq;
+        sec = (sec + 1) % s_sectors;
+        seq++;
+    }
+
+    s_seq = newest_seq;
+    s_wr_sec = newest;
+    return store_flash_next_sector();
+}
+
+esp_err_t app_store_init(void)
+{
+    s_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, APP_STORE_PARTITION_LABEL);
+    if (!s_part)
+    {
+        ESP_LOGW(TAG, "Partition '%s' not found, store-and-forward limited to %u bytes of RAM",
+                 APP_STORE_PARTITION_LABEL, (unsigned)APP_STORE_RAM_BYTES);
+        store_update_stats(0, 0, 0, 0, 0);
+        return ESP_OK;
+    }
+
+    s_sector_size = s_part->erase_size;
+    s_sectors = s_part->size / s_sector_size;
+    if (s_sectors < 2 || s_sector_size < sizeof(store_sector_t) + STORE_ALIGN(sizeof(store_hdr_t) + APP_STORE_RECORD_MAX))
+    {
+        ESP_LOGE(TAG, "Partition '%s' too small", APP_STORE_PARTITION_LABEL);
+        s_part = NULL;
+        store_update_stats(0, 0, 0, 0, 0);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    esp_err_t err = store_flash_recover();
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Flash store init failed: %s", esp_err_to_name(err));
+        s_part = NULL;
+        s_flash_records = 0;
+        s_flash_bytes = 0;
+        store_update_stats(0, 0, 0, 0, 0);
+        return err;
+    }
+
+    store_update_stats(0, 0, 0, 0, 0);
+    ESP_LOGI(TAG, "Flash store: %u x %u bytes, %u records (%u bytes) pending from last run",
+             (unsigned)s_sectors, (unsigned)s_sector_size, (unsigned)s_flash_records, (unsigned)s_flash_bytes);
+    return ESP_OK;
+}
+
+esp_err_t app_store_put(uint8_t tag, const void *data, size_t len)
+{
+    if (!data || len == 0 || len > APP_STORE_RECORD_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t size = STORE_ALIGN(sizeof(store_hdr_t) + len);
+    uint32_t spilled = 0, evicted = 0;
+    int32_t off;
+
+    // 内存放不下时把最早的记录移到 flash（没有 flash 或写失败时丢弃），直到放得下
+    while ((off = store_ram_reserve(size)) < 0)
+    {
+        const store_hdr_t *hdr = store_ram_front();
+        if (s_part && store_flash_append(hdr, (const uint8_t *)(hdr + 1)) == ESP_OK)
+        {
+            spilled++;
+        }
+        else
+        {
+            evicted++;
+        }
+        store_ram_pop();
+    }
+    if (evicted > 0)
+    {
+        ESP_LOGW(TAG, "Store full, %u oldest records evicted", (unsigned)evicted);
+    }
+
+    store_hdr_t *hdr = (store_hdr_t *)&s_ram[off];
+    hdr->len = (uint16_t)len;
+    hdr->tag = tag;
+    hdr->state = STORE_STATE_PENDING;
+    memcpy(hdr + 1, data, len);
+
+    s_ram_head = (size_t)off + size;
+    s_ram_records++;
+    s_ram_bytes += len;
+
+    store_update_stats(1, 0, spilled, evicted, 0);
+    return ESP_OK;
+}
+
+bool app_store_empty(void)
+{
+    return s_ram_records == 0 && s_flash_records == 0;
+}
+
+esp_err_t app_store_peek(uint8_t *tag, void *buf, size_t cap, size_t *len)
+{
+    if (!tag || !buf || !len)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // flash 中的记录总比内存中的早，先补发 flash
+    if (s_flash_records > 0)
+    {
+        store_hdr_t hdr;
+        esp_err_t err = store_flash_front(&hdr);
+        if (err != ESP_OK)
+        {
+            return err;
+        }
+        if (hdr.len > cap)
+        {
+            return ESP_ERR_INVALID_SIZE;
+        }
+
+        err = esp_partition_read(s_part, store_sector_addr(s_rd_sec) + s_rd_off + sizeof(hdr), buf, hdr.len);
+        if (err != ESP_OK)
+        {
+            return err;
+        }
+        *tag = hdr.tag;
+        *len = hdr.len;
+        return ESP_OK;
+    }
+
+    const store_hdr_t *hdr = store_ram_front();
+    if (!hdr)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (hdr->len > cap)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    memcpy(buf, hdr + 1, hdr->len);
+    *tag = hdr->tag;
+    *len = hdr->len;
+    return ESP_OK;
+}
+
+// 移除最早的一条记录（flash 中的总比内存中的早）
+static bool store_remove_front(void)
+{
+    if (app_store_empty())
+    {
+        return false;
+    }
+
+    if (s_flash_records > 0)
+    {
+        store_flash_pop();
+    }
+    else
+    {
+        store_ram_pop();
+    }
+    return true;
+}
+
+void app_store_pop(void)
+{
+    if (store_remove_front())
+    {
+        store_update_stats(0, 1, 0, 0, 0);
+    }
+}
+
+void app_store_discard(void)
+{
+    if (store_remove_front())
+    {
+        store_update_stats(0, 0, 0, 0, 1);
+    }
+}
+
+void app_store_get_stats(app_store_stats_t *stats)
+{
+    if (!stats)
+    {
+        return;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    *stats = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+}
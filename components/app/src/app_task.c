@@ -1,13 +1,28 @@
 #include "app_task.h"
 #include "platform.h"
+#include "platform_i2c.h"
+#include "app_ring.h"
+#include "app_calib.h"
+#include "app_rate.h"
+#include "app_pool.h"
+#include "app_batch.h"
+#include "app_store.h"
+#include "app_flow.h"
+#include "app_cmd.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include "esp_timer.h"
 #include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_attr.h"
+#include "sdkconfig.h"
 #include "my_mqtt.h"
 #include <string.h>
 #include <stdio.h>
-#include "cJSON.h"
+#include <stdlib.h>
+#include <stdbool.h>
+#include "app_codec.h"
 
 // ========================
 // 任务配置参数
@@ -17,211 +32,673 @@
 #define TASK_DATA_PRIORITY 2
 #define TASK_DATA_STACK_DEPTH 4096
 
-// 下行消息转发任务：优先级较高（3），栈深度 4KB
-#define TASK_DOWNLINK_PRIORITY 3
-#define TASK_DOWNLINK_STACK_DEPTH 8192
-
 // 消息处理任务（上传/下行）：优先级 3，栈深度 4KB
 #define TASK_PROCESS_PRIORITY 3
 #define TASK_PROCESS_STACK_DEPTH 8192
 
-// 应用层消息队列长度（用于上传和下行消息的统一处理）
-#define APP_MSG_QUEUE_LEN 8
+// 处理任务的下行通道长度（MQTT 回调直接投递）；上行数据由处理任务从环形缓冲区自己收取，不走通道
+// 比缓冲区池少两个，留给正在处理的指令和它的应答
+#define APP_LANE_LEN_DOWNLINK (APP_POOL_BUF_COUNT - 2)
+
+// 上行数据的 QoS：1 表示至少一次，服务端确认前消息留在 MQTT outbox 中
+#define APP_UPLOAD_QOS 1
+
+// 上传时等待空闲缓冲区的最长时间（毫秒）
+#define APP_UPLOAD_BUF_WAIT_MS 100
+
+// 批次为空时处理任务的最长等待（毫秒），之后会去环形缓冲区收取新样本
+#define APP_BATCH_IDLE_POLL_MS 1000
+
+// 断网暂存的补发节奏：重连后每隔这么久补发一小批，避免积压的数据一下子挤占上行带宽
+#define APP_STORE_FORWARD_INTERVAL_MS 250
+#define APP_STORE_FORWARD_BURST 4
+
+// 紧急样本判定：任一轴加速度原始值接近满量程（冲击、跌落），该批次立即上报
+#define APP_URGENT_ACCEL_RAW 31000
+
+// 采集任务的唤醒间隔（毫秒）：数据就绪中断水位按采样率换算，使 FIFO 中每积攒这么久的样本唤醒一次
+#define APP_SAMPLE_WAKE_MS 500
+
+// 数据就绪中断水位上限：需小于 FIFO 容量 73，留出余量防止溢出
+#define APP_SAMPLE_WATERMARK_MAX 50
+
+// 等待中断的超时（毫秒）：超时说明 INT 线异常，此时直接去读 FIFO 兜底
+#define APP_SAMPLE_TIMEOUT_MS 2000
 
-// 下行原始消息队列长度（MQTT 收到的消息先入此队列）
-#define APP_INBOUND_QUEUE_LEN 8
+// 读传感器连续失败时的退避：从 100ms 起每次翻倍，最长 5s，避免线缆接触不良时空转刷日志
+#define APP_SAMPLE_BACKOFF_MIN_MS 100
+#define APP_SAMPLE_BACKOFF_MAX_MS 5000
 
-// JSON 消息最大长度（上传和下行共用上限）
-#define APP_MSG_MAX_JSON 512
+// 样本级合并策略下，一个合并样本最多累加的样本数，再多就丢弃新样本（防止累加溢出、时间分辨率过低）
+#define APP_SAMPLE_COALESCE_MAX 64
 
-// 下行原始消息缓冲区最大长度
-#define APP_INBOUND_MAX_JSON 512
+// 样本级持续拥塞时的减载：每一步把软件抽取倍数翻倍（不改传感器采样率），最多这么多步
+#define APP_SHED_LEVEL_MAX 4
 
-// 传感器数据上传间隔（毫秒）
-#define APP_UPLOAD_INTERVAL_MS 10000
+// 内存占用报告的间隔（毫秒）：启动时报告一次，之后定期对比堆的使用，确认稳定运行后没有新的堆分配
+#define APP_MEM_REPORT_INTERVAL_MS (10 * 60 * 1000)
+
+// MQTT 统计随遥测上报的主题和间隔（毫秒），未连接时跳过这一次
+#define APP_STATS_TOPIC "test/topic/stats"
+#define APP_STATS_INTERVAL_MS (60 * 1000)
 
 // 日志标签
 static const char *TAG = "APP_TASK";
-static const char *MQTT_TOPIC_UP = "test/topic"; // 上行主题（可根据实际情况修改）
 
 // ========================
-// 消息类型定义
+// 全局队列句柄（任务间通信）
 // ========================
 
-typedef enum
-{
-    APP_MSG_UPLOAD = 0,   // 上报消息：由本地传感器数据构建的 JSON
-    APP_MSG_DOWNLINK = 1, // 下行消息：从 MQTT 服务器接收到的原始 JSON
-} app_msg_type_t;
+// 下行通道：MQTT 回调把装好下行 JSON 的缓冲区指针直接投递到这里，缓冲区内容在池里，处理完由处理任务释放
+static QueueHandle_t s_lane_downlink = NULL;
 
-// 应用层统一消息结构体（用于任务间通信）
-typedef struct
-{
-    app_msg_type_t type;            // 消息类型
-    size_t len;                     // payload 实际长度
-    char payload[APP_MSG_MAX_JSON]; // 消息内容（JSON 字符串）
-} app_msg_t;
+// 处理任务的句柄：下行投递和唤醒请求都用任务通知的位告诉它，与通道里的消息数无关
+static TaskHandle_t s_task_process_handle = NULL;
+static TaskHandle_t s_task_data_handle = NULL;
 
-// 下行原始消息结构体（MQTT 回调中使用，避免大结构体拷贝）
-typedef struct
-{
-    size_t len;                         // payload 长度
-    char payload[APP_INBOUND_MAX_JSON]; // 原始 JSON 字符串（来自 MQTT）
-} app_inbound_msg_t;
+// 处理任务的通知位
+#define APP_NOTIFY_KICK (1u << 0)     // 环形缓冲区里有紧急样本或已够一批
+#define APP_NOTIFY_DOWNLINK (1u << 1) // 下行通道里有新消息
+#define APP_NOTIFY_CMD (1u << 2)      // 延后完成的指令有了结果（标定收齐了样本、采样率已应用）
 
-// ========================
-// 全局队列句柄（任务间通信）
-// ========================
+// 采样环形缓冲区：采集任务写入原始样本，处理任务按上传周期批量取走（无锁，单生产者/单消费者）
+static app_ring_t s_sample_ring;
+
+// 上行批次的编码缓冲区：编码发布和补发暂存数据都在处理任务中依次进行，一个就够，不占缓冲区池
+static char s_upload_buf[APP_STORE_RECORD_MAX];
 
-// 主消息队列：供 app_task_process 从中读取上传或下行消息进行处理
-static QueueHandle_t s_app_msg_queue = NULL;
+#if CONFIG_APP_STATIC_ALLOC
+// 静态分配模式：任务栈、任务控制块、通道存储区都在这里，启动后应用层不再使用堆
+static StaticQueue_t s_lane_downlink_queue;
+static uint8_t s_lane_downlink_storage[APP_LANE_LEN_DOWNLINK * sizeof(app_buf_t *)];
+static StaticTask_t s_task_data_tcb;
+static StackType_t s_task_data_stack[TASK_DATA_STACK_DEPTH];
+static StaticTask_t s_task_process_tcb;
+static StackType_t s_task_process_stack[TASK_PROCESS_STACK_DEPTH];
+#endif
 
-// 下行消息队列：MQTT 回调将消息放入此队列，由 app_task_downlink 转发至主队列
-static QueueHandle_t s_inbound_queue = NULL;
+// 启动完成时堆中已分配的块数，用于之后对比
+static size_t s_boot_heap_blocks = 0;
+
+#if CONFIG_APP_ALLOC_CHECK
+// 应用任务中发生的堆分配次数（由堆分配钩子累加）；MQTT outbox 在发布时为每条消息分配内存，单独计数
+static volatile uint32_t s_app_allocs = 0;
+static volatile uint32_t s_outbox_allocs = 0;
+static volatile bool s_in_publish = false; // 处理任务正在调用 MQTT 发布接口
+#endif
 
 // ========================
 // 任务函数声明
 // ========================
 
-static void app_task_get_data(void *pvParameters);                                                    // 采集传感器数据并构建上传 JSON
-static void app_task_downlink(void *pvParameters);                                                    // 将下行原始消息转发到主消息队列
-static void app_task_process(void *pvParameters);                                                     // 处理主队列中的消息（上传 or 下行）
+static void app_task_get_data(void *pvParameters);                                                    // 采集传感器数据写入环形缓冲区
+static void app_task_process(void *pvParameters);                                                     // 处理下行消息，并按批次上报样本
+static esp_err_t app_post_downlink(app_buf_t *buf);                                                   // 按下行通道的背压策略投递消息
 static void app_mqtt_data_cb(const char *topic, size_t topic_len, const char *data, size_t data_len); // MQTT 数据回调
-static size_t app_build_sensor_json(const SensorData *data, char *buf, size_t len);                   // 构建传感器 JSON
-static esp_err_t app_cloud_send_json(const char *json, size_t len);                                   // 通过 MQTT 发送上行数据
-static void app_handle_downlink_json(const char *json, size_t len);                                   // 处理下行指令（待实现）
+static esp_err_t app_cloud_send(const char *topic, const char *data, size_t len);                     // 通过 MQTT 发送上行数据
+static void app_publish_done(int handle, mqtt_pub_result_t result, uint32_t latency_ms, void *ctx);   // 异步发布完成回调
+static void app_upload(app_codec_id_t codec, const char *data, size_t len);                           // 发送上行数据，发不出去时暂存
+static void app_forward_stored(void);                                                                 // 按节奏补发暂存的上行数据
+static void app_handle_downlink_json(const char *json, size_t len);                                   // 执行下行指令并应答
+static void app_reply_finished_cmds(void);                                                            // 应答已完成的延后指令
+static void app_collect_samples(app_batch_t *batch);                                                  // 从环形缓冲区取出样本加入批次
+static void app_flush_batch(app_batch_t *batch);                                                      // 上报并清空批次
+static void app_kick_process(void);                                                                   // 唤醒处理任务收取样本
+static esp_err_t app_apply_rate(const app_rate_profile_t *profile, uint8_t shed, app_decim_t *decim); // 应用新的采样率配置
+static void app_apply_decim(const app_rate_profile_t *profile, uint8_t shed, app_decim_t *decim);     // 按减载级别设置抽取倍数
+static void app_write_sample(const app_sample_t *sample, app_decim_t *carry);                         // 按样本级背压策略写入环形缓冲区
+static uint8_t app_shed(app_flow_signal_t signal, uint8_t level);                                     // 根据拥塞信号调整减载级别
+static void app_report_mqtt_stats(void);                                                              // 上报 MQTT 统计
+static void app_mem_report(bool boot);                                                                // 打印内存占用
 
 // ========================
 // 应用任务初始化函数
 // ========================
 esp_err_t app_task_init(void)
 {
-    // 创建主消息队列（用于上传和下行消息的统一调度）
-    if (!s_app_msg_queue)
+    // 消息内容放在缓冲区池中，队列只传指针
+    if (app_pool_init() != ESP_OK)
     {
-        s_app_msg_queue = xQueueCreate(APP_MSG_QUEUE_LEN, sizeof(app_msg_t));
+        return ESP_ERR_NO_MEM;
     }
 
-    // 创建下行原始消息队列（MQTT 回调专用）
-    if (!s_inbound_queue)
+    // 断网暂存：恢复上次断电前没补发完的数据（flash 分区不可用时只用内存暂存）
+    app_store_init();
+
+    // 创建下行通道
+#if CONFIG_APP_STATIC_ALLOC
+    if (!s_lane_downlink)
+    {
+        s_lane_downlink = xQueueCreateStatic(APP_LANE_LEN_DOWNLINK, sizeof(app_buf_t *), s_lane_downlink_storage, &s_lane_downlink_queue);
+    }
+#else
+    if (!s_lane_downlink)
     {
-        s_inbound_queue = xQueueCreate(APP_INBOUND_QUEUE_LEN, sizeof(app_inbound_msg_t));
+        s_lane_downlink = xQueueCreate(APP_LANE_LEN_DOWNLINK, sizeof(app_buf_t *));
     }
+#endif
 
     // 检查队列是否创建成功
-    if (!s_app_msg_queue || !s_inbound_queue)
+    if (!s_lane_downlink)
     {
         ESP_LOGE(TAG, "Failed to create queues");
         return ESP_ERR_NO_MEM;
     }
 
+    app_ring_init(&s_sample_ring);
+
+    // 加载传感器标定参数与采样率配置（NVS 已在 Wi-Fi 初始化时完成初始化）
+    app_calib_init();
+    app_rate_init();
+
+    // 指令表没有排好序时二分查找会漏掉指令，不启动
+    esp_err_t err = app_cmd_init();
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
     // 注册 MQTT 数据接收回调函数
     mqtt_register_data_cb(app_mqtt_data_cb);
 
-    // 创建三个任务，并绑定到指定 CPU 核心（APP_CPU_NUM 定义在 platform.h 中）
-    xTaskCreatePinnedToCore(app_task_get_data, "app_task_get_data", TASK_DATA_STACK_DEPTH, NULL, TASK_DATA_PRIORITY, NULL, APP_CPU_NUM);
-    xTaskCreatePinnedToCore(app_task_downlink, "app_task_downlink", TASK_DOWNLINK_STACK_DEPTH, NULL, TASK_DOWNLINK_PRIORITY, NULL, APP_CPU_NUM);
-    xTaskCreatePinnedToCore(app_task_process, "app_task_process", TASK_PROCESS_STACK_DEPTH, NULL, TASK_PROCESS_PRIORITY, NULL, APP_CPU_NUM);
+    // 创建两个任务，并绑定到指定 CPU 核心（APP_CPU_NUM 定义在 platform.h 中）
+    // 先建处理任务：采集任务一启动就可能唤醒它
+#if CONFIG_APP_STATIC_ALLOC
+    s_task_process_handle = xTaskCreateStaticPinnedToCore(app_task_process, "app_task_process", TASK_PROCESS_STACK_DEPTH, NULL,
+                                                          TASK_PROCESS_PRIORITY, s_task_process_stack, &s_task_process_tcb, APP_CPU_NUM);
+    if (s_task_process_handle)
+    {
+        s_task_data_handle = xTaskCreateStaticPinnedToCore(app_task_get_data, "app_task_get_data", TASK_DATA_STACK_DEPTH, NULL,
+                                                           TASK_DATA_PRIORITY, s_task_data_stack, &s_task_data_tcb, APP_CPU_NUM);
+    }
+#else
+    if (xTaskCreatePinnedToCore(app_task_process, "app_task_process", TASK_PROCESS_STACK_DEPTH, NULL, TASK_PROCESS_PRIORITY,
+                                &s_task_process_handle, APP_CPU_NUM) != pdPASS)
+    {
+        s_task_process_handle = NULL;
+    }
+    else if (xTaskCreatePinnedToCore(app_task_get_data, "app_task_get_data", TASK_DATA_STACK_DEPTH, NULL, TASK_DATA_PRIORITY,
+                                     &s_task_data_handle, APP_CPU_NUM) != pdPASS)
+    {
+        s_task_data_handle = NULL;
+    }
+#endif
+
+    // 任一任务创建失败都不继续：只有处理任务时没有数据，删掉它，避免留下半个流水线
+    if (!s_task_process_handle || !s_task_data_handle)
+    {
+        ESP_LOGE(TAG, "Failed to create %s task", s_task_process_handle ? "data" : "process");
+        if (s_task_process_handle)
+        {
+            TaskHandle_t task = s_task_process_handle;
+            s_task_process_handle = NULL;
+            vTaskDelete(task);
+        }
+        return ESP_ERR_NO_MEM;
+    }
 
+    app_mem_report(true);
     return ESP_OK;
 }
 
 // ========================
-// 任务 1：采集传感器数据并构建上传消息
+// 内存占用报告：应用层的静态占用，整个堆的使用情况，以及上一个报告周期内应用任务做了多少次堆分配
+// 堆中块数的变化来自网络协议栈等其他组件（收发过程中的临时缓冲区会有波动），不能说明应用层是否分配；
+// 应用层的分配由堆分配钩子按任务计数（CONFIG_APP_ALLOC_CHECK），启动后的第一个周期算预热，之后每个周期应为 0
+// 例外：MQTT outbox 在发布时为每条消息分配两块内存（消息结构和内容），这发生在处理任务中，单独计数，不算失败
+// ========================
+#if CONFIG_APP_STATIC_ALLOC
+#define APP_ALLOC_MODE "static"
+#else
+#define APP_ALLOC_MODE "stacks and lanes on heap"
+#endif
+
+#if CONFIG_APP_ALLOC_CHECK
+// 堆分配钩子：每次分配成功后由堆调用，可能在任意任务中，只做计数
+void IRAM_ATTR esp_heap_trace_alloc_hook(void *ptr, size_t size, uint32_t caps)
+{
+    (void)ptr;
+    (void)size;
+    (void)caps;
+
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    if (!task || (task != s_task_data_handle && task != s_task_process_handle))
+    {
+        return;
+    }
+    if (s_in_publish && task == s_task_process_handle)
+    {
+        s_outbox_allocs++;
+    }
+    else
+    {
+        s_app_allocs++;
+    }
+}
+
+void IRAM_ATTR esp_heap_trace_free_hook(void *ptr)
+{
+    (void)ptr;
+}
+#endif
+
+static void app_mem_report(bool boot)
+{
+    multi_heap_info_t heap;
+    heap_caps_get_info(&heap, MALLOC_CAP_DEFAULT);
+
+    if (boot)
+    {
+        size_t lanes = APP_LANE_LEN_DOWNLINK * sizeof(app_buf_t *);
+        size_t stacks = TASK_DATA_STACK_DEPTH + TASK_PROCESS_STACK_DEPTH;
+        ESP_LOGI(TAG, "Static footprint: ring %u, pool %u, upload %u, store %u, lanes %u, stacks %u (%s)",
+                 (unsigned)sizeof(s_sample_ring), (unsigned)(APP_POOL_BUF_COUNT * sizeof(app_buf_t)),
+                 (unsigned)sizeof(s_upload_buf), (unsigned)APP_STORE_RAM_BYTES, (unsigned)lanes, (unsigned)stacks,
+                 APP_ALLOC_MODE);
+        s_boot_heap_blocks = heap.allocated_blocks;
+    }
+
+    ESP_LOGI(TAG, "Heap: %u free, %u min free, %u largest block, %u blocks in use (%+d since boot)",
+             (unsigned)heap.total_free_bytes, (unsigned)heap.minimum_free_bytes, (unsigned)heap.largest_free_block,
+             (unsigned)heap.allocated_blocks, (int)heap.allocated_blocks - (int)s_boot_heap_blocks);
+
+#if CONFIG_APP_ALLOC_CHECK
+    // 每个周期取走计数重新开始；计数只由钩子递增，取走和清零之间漏掉的几次计入下一个周期
+    static bool warm = false;
+    if (!boot)
+    {
+        uint32_t app = s_app_allocs;
+        uint32_t outbox = s_outbox_allocs;
+        s_app_allocs -= app;
+        s_outbox_allocs -= outbox;
+        if (!warm)
+        {
+            ESP_LOGI(TAG, "App heap allocations in warm-up window: %u (+%u by MQTT outbox)", (unsigned)app, (unsigned)outbox);
+            warm = true;
+        }
+        else if (app == 0)
+        {
+            ESP_LOGI(TAG, "App heap allocations in steady state: 0, PASS (+%u by MQTT outbox, per published message)",
+                     (unsigned)outbox);
+        }
+        else
+        {
+            ESP_LOGW(TAG, "App heap allocations in steady state: %u, FAIL (+%u by MQTT outbox)", (unsigned)app, (unsigned)outbox);
+        }
+    }
+#else
+    if (!boot)
+    {
+        ESP_LOGI(TAG, "App heap allocations not measured (CONFIG_APP_ALLOC_CHECK off)");
+    }
+#endif
+}
+
+// ========================
+// 任务 1：采集传感器数据写入环形缓冲区
 // ========================
 static void app_task_get_data(void *pvParameters)
 {
     (void)pvParameters; // 避免编译警告
 
-    SensorData data = {0}; // 存储传感器原始数据
-    app_msg_t msg = {0};   // 构建好的上传消息
+    static SensorData batch[MPU6050_FIFO_MAX_SAMPLES];  // 一次从 FIFO 中取回的样本
+    static app_calib_snap_t calib;                       // 本批样本使用的标定参数
+    app_decim_t decim;                                   // 软件抽取状态
+    app_rate_profile_t profile;                          // 采样率配置
+    app_sample_t sample;                                 // 标定后的单个样本
+    uint32_t read_errors = 0;                            // 连续读失败次数
+    uint32_t backoff_ms = APP_SAMPLE_BACKOFF_MIN_MS;     // 当前退避时间
+    app_batch_config_t batch_cfg;                        // 批量上报配置，用于判断是否该唤醒处理任务
+    app_decim_t carry;                                   // 环形缓冲区满时合并中的样本
+    uint8_t shed = 0;                                    // 当前减载级别，0 为不减载
+
+    app_decim_init(&decim, 1);
+    app_decim_init(&carry, APP_SAMPLE_COALESCE_MAX);
+    app_rate_get(&profile);
+    app_rate_set_notify(xTaskGetCurrentTaskHandle());
+
+    // 采样节拍由 MPU6050 内部时钟决定：样本进 FIFO，攒够水位后由 INT 引脚中断唤醒本任务
+    platform_sensor_fifo_start();
+    if (platform_sensor_int_start(xTaskGetCurrentTaskHandle(), APP_SAMPLE_WATERMARK_MAX) != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Sensor interrupt unavailable, falling back to timeout polling");
+    }
 
     for (;;)
     {
-        // 从硬件平台读取传感器数据
-        if (platform_get_sensor_data(&data) == ESP_OK)
+        // 有新的采样率配置（启动时从 NVS 读取，或运行时由下行指令修改）就先应用，并叫处理任务来应答 set_rate
+        if (app_rate_take_pending(&profile))
         {
-            // 将传感器数据格式化为 JSON 字符串
-            size_t len = app_build_sensor_json(&data, msg.payload, sizeof(msg.payload));
-            if (len > 0)
+            app_rate_applied(app_apply_rate(&profile, shed, &decim));
+            if (s_task_process_handle)
             {
-                // 设置消息类型为上传，并填充长度
-                msg.type = APP_MSG_UPLOAD;
-                msg.len = len;
+                xTaskNotify(s_task_process_handle, APP_NOTIFY_CMD, eSetBits);
+            }
+        }
 
-                // 将消息发送到主消息队列，等待处理
-                xQueueSend(s_app_msg_queue, &msg, portMAX_DELAY);
+        // 阻塞等待数据就绪通知，没有新数据时任务不会被唤醒
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(APP_SAMPLE_TIMEOUT_MS));
+
+        // 一次把 FIFO 中积压的样本全部取出
+        // 读失败时整批丢弃（平台层不会返回半截数据），退避后再试；只在失败次数为 2 的幂时打日志
+        size_t count = 0;
+        esp_err_t err = platform_get_sensor_batch(batch, MPU6050_FIFO_MAX_SAMPLES, &count);
+        if (err != ESP_OK)
+        {
+            read_errors++;
+            if ((read_errors & (read_errors - 1)) == 0)
+            {
+                ESP_LOGW(TAG, "Failed to read sensor data (%s), %u in a row, retry in %u ms",
+                         esp_err_to_name(err), (unsigned)read_errors, (unsigned)backoff_ms);
             }
-            else
+            vTaskDelay(pdMS_TO_TICKS(backoff_ms));
+            backoff_ms = (backoff_ms * 2 > APP_SAMPLE_BACKOFF_MAX_MS) ? APP_SAMPLE_BACKOFF_MAX_MS : backoff_ms * 2;
+            continue;
+        }
+        if (read_errors > 0)
+        {
+            ESP_LOGI(TAG, "Sensor read recovered after %u failures", (unsigned)read_errors);
+            read_errors = 0;
+            backoff_ms = APP_SAMPLE_BACKOFF_MIN_MS;
+        }
+
+        // 有进行中的在线零偏标定时，原始样本也交给它累加；收齐时叫处理任务来求零偏并应答
+        if (app_calib_collect(batch, count) && s_task_process_handle)
+        {
+            xTaskNotify(s_task_process_handle, APP_NOTIFY_CMD, eSetBits);
+        }
+
+        // 标定换算、抽取后写进环形缓冲区的槽位，不加锁、不走队列；写满时按样本级的背压策略处理
+        // 标定参数每批取一次快照，逐个样本换算时不再加锁；每个样本已由平台层打上采样时刻的时间戳
+        app_calib_snapshot(&calib);
+        bool urgent = false;
+        for (size_t i = 0; i < count; i++)
+        {
+            app_calib_apply(&calib, &batch[i], &sample);
+            if (abs(batch[i].mpu_ax) >= APP_URGENT_ACCEL_RAW || abs(batch[i].mpu_ay) >= APP_URGENT_ACCEL_RAW ||
+                abs(batch[i].mpu_az) >= APP_URGENT_ACCEL_RAW)
             {
-                ESP_LOGW(TAG, "Sensor JSON buffer too small");
+                sample.flags |= APP_SAMPLE_F_URGENT;
             }
+            if (!app_decim_push(&decim, &sample, &sample))
+            {
+                continue;
+            }
+
+            app_write_sample(&sample, &carry);
+            urgent |= (sample.flags & APP_SAMPLE_F_URGENT) != 0;
         }
-        else
+
+        // 处理任务持续跟不上时（例如发布卡在网络上）降低写入速率，恢复后逐级撤销
+        app_flow_signal_t signal = app_flow_level(APP_FLOW_STAGE_SAMPLE, app_ring_count(&s_sample_ring), APP_RING_CAPACITY);
+        if (signal != APP_FLOW_SIGNAL_NONE)
         {
-            ESP_LOGW(TAG, "Failed to read sensor data");
+            uint8_t level = app_shed(signal, shed);
+            if (level != shed)
+            {
+                shed = level;
+                app_apply_decim(&profile, shed, &decim);
+            }
         }
 
-        // 按固定间隔休眠（默认 1 秒）
-        vTaskDelay(pdMS_TO_TICKS(APP_UPLOAD_INTERVAL_MS));
+        // 有紧急样本或已够一批时叫醒处理任务，否则由处理任务按批次时限自己来取
+        app_batch_get_config(&batch_cfg);
+        if (urgent || app_ring_count(&s_sample_ring) >= batch_cfg.max_samples)
+        {
+            app_kick_process();
+        }
     }
 }
 
 // ========================
-// 任务 2：转发下行消息到主队列
+// 应用采样率配置：改传感器采样率、中断水位和软件抽取倍数（在采集任务中执行）
 // ========================
-static void app_task_downlink(void *pvParameters)
+static esp_err_t app_apply_rate(const app_rate_profile_t *profile, uint8_t shed, app_decim_t *decim)
 {
-    (void)pvParameters;
+    // 失败时由 app_rate_applied 重新挂起并打日志，抽取倍数和水位保持原样
+    esp_err_t err = platform_sensor_set_rate(profile->sample_hz);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
 
-    app_inbound_msg_t in_msg = {0}; // 从下行队列接收的原始消息
-    app_msg_t out_msg = {0};        // 转换后的主队列消息
+    // 采样率变了，累加中的样本不能和新速率的样本混在一起
+    uint16_t actual = platform_sensor_get_rate();
+    app_decim_init(decim, 1);
+    app_apply_decim(profile, shed, decim);
 
-    for (;;)
+    uint32_t watermark = (uint32_t)actual * APP_SAMPLE_WAKE_MS / 1000;
+    if (watermark > APP_SAMPLE_WATERMARK_MAX)
     {
-        // 从下行队列阻塞等待新消息
-        if (xQueueReceive(s_inbound_queue, &in_msg, portMAX_DELAY) == pdTRUE)
+        watermark = APP_SAMPLE_WATERMARK_MAX;
+    }
+    platform_sensor_set_watermark((uint16_t)watermark);
+
+    ESP_LOGI(TAG, "Sample rate %u Hz, decimation 1/%u, watermark %u",
+             actual, decim->factor, (unsigned)watermark);
+    return ESP_OK;
+}
+
+// ========================
+// 设置抽取倍数：基础倍数按输出速率算，每个减载级别再翻一倍，不超过 APP_RATE_MAX_FACTOR
+// 只改软件抽取，不碰传感器采样率和 FIFO；累加中的样本保留
+// ========================
+static void app_apply_decim(const app_rate_profile_t *profile, uint8_t shed, app_decim_t *decim)
+{
+    // 传感器实际采样率是 1000 / (1 + 分频值)，可能与期望值略有差别，按实际值计算
+    uint32_t factor = platform_sensor_get_rate() / profile->output_hz;
+    if (factor == 0)
+    {
+        factor = 1;
+    }
+    factor <<= shed;
+    if (factor > APP_RATE_MAX_FACTOR)
+    {
+        factor = APP_RATE_MAX_FACTOR;
+    }
+    app_decim_set_factor(decim, (uint16_t)factor);
+}
+
+// ========================
+// 样本写入环形缓冲区：满了按样本级的策略丢弃或合并；有空位时先放合并好的样本，保持时间顺序
+// ========================
+static void app_write_sample(const app_sample_t *sample, app_decim_t *carry)
+{
+    app_flow_config_t cfg;
+    app_flow_get_config(APP_FLOW_STAGE_SAMPLE, &cfg);
+
+    app_sample_t merged;
+    if (carry->count > 0)
+    {
+        app_sample_t *slot = app_ring_reserve(&s_sample_ring);
+        if (slot)
         {
-            // 转换为通用 app_msg_t 格式
-            out_msg.type = APP_MSG_DOWNLINK;
-            out_msg.len = in_msg.len;
+            app_decim_flush(carry, &merged);
+            *slot = merged;
+            app_ring_commit(&s_sample_ring);
+            app_flow_count(APP_FLOW_STAGE_SAMPLE, APP_FLOW_EV_ACCEPTED);
+        }
+    }
+
+    // 还有合并中的样本时新样本只能继续合并，否则会排到更早的样本前面
+    app_sample_t *slot = (carry->count == 0) ? app_ring_reserve(&s_sample_ring) : NULL;
+    if (slot)
+    {
+        *slot = *sample;
+        app_ring_commit(&s_sample_ring);
+        app_flow_count(APP_FLOW_STAGE_SAMPLE, APP_FLOW_EV_ACCEPTED);
+        return;
+    }
+
+    // carry 的抽取倍数是 APP_SAMPLE_COALESCE_MAX，累加到倍数减一为止，不会触发输出；再多就丢弃新样本
+    if (cfg.policy == APP_FLOW_COALESCE && carry->count + 1 < carry->factor)
+    {
+        app_decim_push(carry, sample, &merged);
+        app_flow_count(APP_FLOW_STAGE_SAMPLE, APP_FLOW_EV_COALESCED);
+        return;
+    }
+    app_flow_count(APP_FLOW_STAGE_SAMPLE, APP_FLOW_EV_DROP_NEWEST);
+}
+
+// ========================
+// 减载：收到减载信号升一级，收到恢复信号降一级，每一级由 app_apply_decim 把抽取倍数翻倍
+// 只改采集任务自己的抽取状态，不改批量配置，恢复时不会覆盖期间下行指令做的修改
+// ========================
+static uint8_t app_shed(app_flow_signal_t signal, uint8_t level)
+{
+    if (signal == APP_FLOW_SIGNAL_SHED && level < APP_SHED_LEVEL_MAX)
+    {
+        level++;
+        ESP_LOGW(TAG, "Sample ring congested, shed level %u", level);
+        app_flow_log_stats();
+    }
+    else if (signal == APP_FLOW_SIGNAL_RESTORE && level > 0)
+    {
+        level--;
+        ESP_LOGI(TAG, "Sample ring drained, shed level %u", level);
+    }
+    return level;
+}
 
-            // 拷贝 JSON 内容（+1 确保字符串结尾有 '\0'）
-            memcpy(out_msg.payload, in_msg.payload, in_msg.len + 1);
+// ========================
+// 投递下行消息到处理任务：缓冲区的所有权随消息转交
+// 在 MQTT 任务中调用，从不等待；通道满时按下行通道的背压策略丢弃，投递失败时缓冲区仍归调用方
+// ========================
+static esp_err_t app_post_downlink(app_buf_t *buf)
+{
+    const app_flow_stage_t stage = APP_FLOW_STAGE_DOWNLINK;
+    QueueHandle_t lane = s_lane_downlink;
+
+    app_flow_config_t cfg;
+    app_flow_get_config(stage, &cfg);
 
-            // 发送到主消息队列，由 process 任务统一处理
-            xQueueSend(s_app_msg_queue, &out_msg, portMAX_DELAY);
+    BaseType_t ok = xQueueSend(lane, &buf, 0);
+    if (ok != pdTRUE && cfg.policy == APP_FLOW_DROP_OLDEST)
+    {
+        // 挤掉最早的一条；唤醒用的是通知位，不用跟着调整任何计数
+        app_buf_t *old;
+        if (xQueueReceive(lane, &old, 0) == pdTRUE)
+        {
+            app_pool_release(old);
+            app_flow_count(stage, APP_FLOW_EV_DROP_OLDEST);
         }
+        ok = xQueueSend(lane, &buf, 0);
+    }
+
+    if (ok != pdTRUE)
+    {
+        app_flow_count(stage, APP_FLOW_EV_DROP_NEWEST);
+        return ESP_ERR_TIMEOUT;
+    }
+
+    app_flow_count(stage, APP_FLOW_EV_ACCEPTED);
+    if (s_task_process_handle)
+    {
+        xTaskNotify(s_task_process_handle, APP_NOTIFY_DOWNLINK, eSetBits);
+    }
+
+    // 通道只是瞬时缓冲，持续高水位说明处理任务跟不上，记入统计并打印
+    if (app_flow_level(stage, (uint32_t)uxQueueMessagesWaiting(lane), APP_LANE_LEN_DOWNLINK) == APP_FLOW_SIGNAL_SHED)
+    {
+        ESP_LOGW(TAG, "Lane congested");
+        app_flow_log_stats();
     }
+    return ESP_OK;
 }
 
 // ========================
-// 任务 3：统一处理上传与下行消息
+// 唤醒处理任务去收取样本：只置通知位，重复唤醒会合并成一次
+// ========================
+static void app_kick_process(void)
+{
+    if (s_task_process_handle)
+    {
+        xTaskNotify(s_task_process_handle, APP_NOTIFY_KICK, eSetBits);
+    }
+}
+
+// ========================
+// 任务 2：处理下行消息，并按批次上报样本
 // ========================
 static void app_task_process(void *pvParameters)
 {
     (void)pvParameters;
 
-    app_msg_t msg = {0}; // 从主队列接收的消息
+    static app_batch_t batch;     // 正在攒的批次，只在本任务中使用
+    app_buf_t *msg = NULL;        // 从下行通道中取出的消息
+    int64_t next_forward_us = 0;  // 下一次补发暂存数据的时刻
+    int64_t next_report_us = esp_timer_get_time() + (int64_t)APP_MEM_REPORT_INTERVAL_MS * 1000;
+    int64_t next_stats_us = esp_timer_get_time() + (int64_t)APP_STATS_INTERVAL_MS * 1000;
+
+    app_batch_reset(&batch);
 
     for (;;)
     {
-        // 从主消息队列阻塞等待消息
-        if (xQueueReceive(s_app_msg_queue, &msg, portMAX_DELAY) != pdTRUE)
+        // 等待消息或唤醒，最多等到当前批次到期；批次为空时定期去环形缓冲区看看
+        int64_t now = esp_timer_get_time();
+        int64_t deadline = app_batch_deadline_us(&batch);
+        int64_t cmd_deadline = app_cmd_deadline_us();
+        if (cmd_deadline < deadline)
+        {
+            deadline = cmd_deadline;
+        }
+        TickType_t wait = pdMS_TO_TICKS(APP_BATCH_IDLE_POLL_MS);
+        if (deadline != INT64_MAX)
+        {
+            wait = (deadline > now) ? pdMS_TO_TICKS((uint32_t)((deadline - now + 999) / 1000)) : 0;
+        }
+
+        // 有暂存数据且已连上时，按补发节奏醒来
+        bool forwarding = !app_store_empty() && mqtt_is_connected();
+        if (forwarding)
+        {
+            TickType_t fwd_wait = (next_forward_us > now) ? pdMS_TO_TICKS((uint32_t)((next_forward_us - now + 999) / 1000)) : 0;
+            if (fwd_wait < wait)
+            {
+                wait = fwd_wait;
+            }
+        }
+
+        // 每次醒来先把下行通道取空（如配置更新、控制命令等），再补发和收取样本
+        // 不管因为哪个通知位或超时醒来都去取一次，投递在通知之前完成，不会漏掉消息
+        xTaskNotifyWait(0, UINT32_MAX, NULL, wait);
+        while (xQueueReceive(s_lane_downlink, &msg, 0) == pdTRUE)
+        {
+            app_handle_downlink_json(msg->data, msg->len);
+            app_pool_release(msg);
+        }
+        app_reply_finished_cmds();
+
+        // 先补发积压的数据，新数据排在后面
+        if (forwarding && esp_timer_get_time() >= next_forward_us)
         {
-            continue; // 理论上不会发生，但防御性编程
+            app_forward_stored();
+            next_forward_us = esp_timer_get_time() + (int64_t)APP_STORE_FORWARD_INTERVAL_MS * 1000;
         }
 
-        // 根据消息类型分发处理
-        if (msg.type == APP_MSG_UPLOAD)
+        if (esp_timer_get_time() >= next_report_us)
         {
-            // 执行上传：通过 MQTT 发送 JSON 到云端
-            app_cloud_send_json(msg.payload, msg.len);
+            app_mem_report(false);
+            platform_i2c_log_stats();
+
+            platform_sensor_stats_t sensor;
+            platform_sensor_get_stats(&sensor);
+            ESP_LOGI(TAG, "Sensor FIFO: %u overflows, at least %u samples lost",
+                     (unsigned)sensor.fifo_overflows, (unsigned)sensor.samples_lost);
+            next_report_us += (int64_t)APP_MEM_REPORT_INTERVAL_MS * 1000;
         }
-        else // APP_MSG_DOWNLINK
+
+        if (esp_timer_get_time() >= next_stats_us)
+        {
+            app_report_mqtt_stats();
+            next_stats_us += (int64_t)APP_STATS_INTERVAL_MS * 1000;
+        }
+
+        // 收取新样本（攒满时当场上报），再检查批次是否到期或该做紧急上报（一轮最多一次）
+        app_collect_samples(&batch);
+        if (app_batch_due(&batch, esp_timer_get_time()))
         {
-            // 处理下行指令（如配置更新、控制命令等）
-            app_handle_downlink_json(msg.payload, msg.len);
+            app_flush_batch(&batch);
         }
     }
 }
@@ -235,120 +712,288 @@ static void app_mqtt_data_cb(const char *topic, size_t topic_len, const char *da
     (void)topic_len;
 
     // 安全检查：队列未初始化或数据无效则直接返回
-    if (!s_inbound_queue || !data || data_len == 0)
+    if (!s_lane_downlink || !data || data_len == 0)
     {
         return;
     }
 
-    app_inbound_msg_t msg = {0};
+    // 不阻塞 MQTT 任务：池空时直接丢弃，由池的 exhausted 计数记录
+    app_buf_t *buf = app_pool_alloc(0);
+    if (!buf)
+    {
+        ESP_LOGW(TAG, "Buffer pool exhausted, downlink dropped");
+        return;
+    }
+
     size_t copy_len = data_len;
 
     // 防止缓冲区溢出：截断超长消息
-    if (copy_len >= sizeof(msg.payload))
+    if (copy_len >= sizeof(buf->data))
     {
-        copy_len = sizeof(msg.payload) - 1;
+        copy_len = sizeof(buf->data) - 1;
     }
 
-    // 拷贝数据并确保字符串以 '\0' 结尾
-    memcpy(msg.payload, data, copy_len);
-    msg.payload[copy_len] = '\0';
-    msg.len = copy_len;
+    // 拷贝数据并确保字符串以 '\0' 结尾，这是下行路径上唯一的一次拷贝
+    memcpy(buf->data, data, copy_len);
+    buf->data[copy_len] = '\0';
+    buf->len = copy_len;
 
-    // 尝试将消息放入下行队列（非阻塞发送，避免在中断上下文中卡死）
-    xQueueSend(s_inbound_queue, &msg, 0);
+    // 直接投递到处理任务的下行通道（不阻塞 MQTT 任务，满了按 app_flow.c 的默认策略丢弃），失败时归还缓冲区
+    if (app_post_downlink(buf) != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Downlink lane full, message dropped");
+        app_pool_release(buf);
+    }
 }
 
 // ========================
-// 构建传感器数据的 JSON 字符串
+// 通过 MQTT 发送上行数据（JSON 文本或二进制编码，由主题区分）
 // ========================
-static size_t app_build_sensor_json(const SensorData *data, char *buf, size_t len)
+static esp_err_t app_cloud_send(const char *topic, const char *data, size_t len)
 {
-    // 参数合法性检查
-    if (!data || !buf || len == 0)
+    // 参数检查
+    if (!topic || !data || len == 0)
     {
-        return 0;
+        return ESP_ERR_INVALID_ARG;
     }
 
-    cJSON *root = cJSON_CreateObject();
-    if (!root)
+    // 检查 MQTT 是否已连接，未连接时由调用方暂存
+    if (!mqtt_is_connected())
     {
-        return 0;
+        return ESP_ERR_INVALID_STATE;
     }
 
-    cJSON *data_obj = cJSON_CreateObject();
-    if (!data_obj)
+    // 异步发布（QoS=1，不保留）：放入 outbox 即返回，处理任务不等网络；未确认的消息由持久化 outbox 保存，重启后重发
+    // 在途消息已满时返回 ESP_ERR_NO_MEM，由调用方暂存
+#if CONFIG_APP_ALLOC_CHECK
+    s_in_publish = true;
+    esp_err_t err = mqtt_app_publish_async(topic, data, len, APP_UPLOAD_QOS, false, app_publish_done, NULL, NULL);
+    s_in_publish = false;
+    return err;
+#else
+    return mqtt_app_publish_async(topic, data, len, APP_UPLOAD_QOS, false, app_publish_done, NULL, NULL);
+#endif
+}
+
+// ========================
+// 异步发布完成回调（在 MQTT 任务中执行，只记日志）
+// ========================
+static void app_publish_done(int handle, mqtt_pub_result_t result, uint32_t latency_ms, void *ctx)
+{
+    (void)ctx;
+
+    if (result == MQTT_PUB_ACKED)
+    {
+        ESP_LOGD(TAG, "Upload %d acknowledged in %u ms", handle, (unsigned)latency_ms);
+    }
+    else
     {
-        cJSON_Delete(root);
-        return 0;
+        ESP_LOGW(TAG, "Upload %d failed after %u ms, %u in flight", handle, (unsigned)latency_ms, (unsigned)mqtt_app_inflight());
     }
+}
 
-    cJSON_AddStringToObject(root, "type", "upload");
-    cJSON_AddNumberToObject(root, "ver", 1);
-    cJSON_AddNumberToObject(root, "ts", (double)xTaskGetTickCount());
+// ========================
+// 发送上行数据：有积压时新数据也进暂存排队，保证服务端按产生顺序收到；发送失败时暂存等重连后补发
+// ========================
+static void app_upload(app_codec_id_t codec, const char *data, size_t len)
+{
+    if (app_store_empty() && app_cloud_send(app_codec_get(codec)->topic, data, len) == ESP_OK)
+    {
+        return;
+    }
 
-    cJSON_AddNumberToObject(data_obj, "ax", (int)data->mpu_ax);
-    // cJSON_AddNumberToObject(data_obj, "ay", (int)data->mpu_ay);
-    // cJSON_AddNumberToObject(data_obj, "az", (int)data->mpu_az);
-    // cJSON_AddNumberToObject(data_obj, "gx", (int)data->mpu_gx);
-    // cJSON_AddNumberToObject(data_obj, "gy", (int)data->mpu_gy);
-    // cJSON_AddNumberToObject(data_obj, "gz", (int)data->mpu_gz);
+    if (app_store_put((uint8_t)codec, data, len) != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Upload of %u bytes dropped", (unsigned)len);
+    }
+}
 
-    cJSON_AddItemToObject(root, "data", data_obj);
+// ========================
+// 补发暂存的上行数据：每次最多 APP_STORE_FORWARD_BURST 条，按存入顺序，发送失败就停下等下一轮
+// ========================
+static void app_forward_stored(void)
+{
+    for (int i = 0; i < APP_STORE_FORWARD_BURST && !app_store_empty(); i++)
+    {
+        uint8_t tag;
+        size_t len;
+        if (app_store_peek(&tag, s_upload_buf, sizeof(s_upload_buf), &len) != ESP_OK)
+        {
+            break;
+        }
 
-    char *json = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
+        // 标签不对应任何编码器（例如固件升级后编号变了）时不知道该发到哪个主题，丢掉并计数
+        const app_codec_t *codec = app_codec_get((app_codec_id_t)tag);
+        if (!codec)
+        {
+            ESP_LOGW(TAG, "Stored record with unknown codec %u discarded (%u bytes)", tag, (unsigned)len);
+            app_store_discard();
+            continue;
+        }
+        if (app_cloud_send(codec->topic, s_upload_buf, len) != ESP_OK)
+        {
+            break;
+        }
+        app_store_pop();
+    }
 
-    if (!json)
+    if (app_store_empty())
     {
-        return 0;
+        app_store_stats_t stats;
+        app_store_get_stats(&stats);
+        ESP_LOGI(TAG, "Store drained: %u forwarded, %u evicted, %u discarded, %u mark errors, high water %u bytes",
+                 (unsigned)stats.forwarded, (unsigned)stats.evicted, (unsigned)stats.discarded,
+                 (unsigned)stats.mark_errors, (unsigned)stats.high_water);
     }
+}
 
-    size_t json_len = strlen(json);
-    if (json_len >= len)
+// ========================
+// 上报 MQTT 统计：快照只反映当前状态，发不出去时直接放弃，不进暂存
+// ========================
+static void app_report_mqtt_stats(void)
+{
+    if (!mqtt_is_connected())
     {
-        cJSON_free(json);
-        return 0;
+        return;
+    }
+
+    app_buf_t *buf = app_pool_alloc(0);
+    if (!buf)
+    {
+        return;
     }
 
-    memcpy(buf, json, json_len + 1);
-    cJSON_free(json);
-    return json_len;
+    buf->len = mqtt_app_stats_json(buf->data, sizeof(buf->data));
+    if (buf->len > 0)
+    {
+        app_cloud_send(APP_STATS_TOPIC, buf->data, buf->len);
+    }
+    app_pool_release(buf);
 }
 
 // ========================
-// 通过 MQTT 发送上行 JSON 数据
+// 处理下行 JSON 指令：交给指令分发器执行，应答发到应答主题
 // ========================
-static esp_err_t app_cloud_send_json(const char *json, size_t len)
+static void app_handle_downlink_json(const char *json, size_t len)
 {
     // 参数检查
     if (!json || len == 0)
     {
-        return ESP_ERR_INVALID_ARG;
+        return;
     }
 
-    // 检查 MQTT 是否已连接，避免发送失败
-    if (!mqtt_is_connected())
+    ESP_LOGD(TAG, "Downlink JSON: %.*s", (int)len, json);
+
+    // 应答很短，池空时指令照常执行，只是不应答
+    app_buf_t *resp = app_pool_alloc(pdMS_TO_TICKS(APP_UPLOAD_BUF_WAIT_MS));
+    char scratch[128];
+    char *out = resp ? resp->data : scratch;
+    size_t cap = resp ? sizeof(resp->data) : sizeof(scratch);
+
+    size_t n = app_cmd_dispatch(json, len, out, cap);
+    if (resp && n > 0)
     {
-        ESP_LOGW(TAG, "MQTT not connected, upload skipped");
-        return ESP_ERR_INVALID_STATE;
+        app_cloud_send(APP_CMD_RESP_TOPIC, out, n);
     }
+    app_pool_release(resp);
+}
 
-    // 调用封装好的 MQTT 发布接口（QoS=1，不保留）
-    return mqtt_app_publish(MQTT_TOPIC_UP, json, len, 0, false);
+// ========================
+// 应答延后完成的指令：标定收齐样本、采样率已应用由采集任务通知，超时的也在这里给出失败应答
+// ========================
+static void app_reply_finished_cmds(void)
+{
+    // 没有进行中的延后指令时不申请缓冲区
+    while (app_cmd_deadline_us() != INT64_MAX)
+    {
+        // 与下行指令一样，池空时照常完成，只是不应答
+        app_buf_t *resp = app_pool_alloc(pdMS_TO_TICKS(APP_UPLOAD_BUF_WAIT_MS));
+        char scratch[128];
+        char *out = resp ? resp->data : scratch;
+        size_t cap = resp ? sizeof(resp->data) : sizeof(scratch);
+
+        size_t n = app_cmd_poll(out, cap);
+        if (resp && n > 0)
+        {
+            app_cloud_send(APP_CMD_RESP_TOPIC, out, n);
+        }
+        app_pool_release(resp);
+        if (n == 0)
+        {
+            break;
+        }
+    }
 }
 
 // ========================
-// 处理下行 JSON 指令（用户需在此实现具体逻辑）
+// 从环形缓冲区取出样本加入批次，批次满时当场上报；紧急样本只标记批次，收取完后由调用者上报一次
 // ========================
-static void app_handle_downlink_json(const char *json, size_t len)
+static void app_collect_samples(app_batch_t *batch)
 {
-    // 参数检查
-    if (!json || len == 0)
+    // 在槽位上直接读取，处理完一整段再归还，不逐条拷贝
+    for (;;)
+    {
+        const app_sample_t *first = NULL;
+        size_t n = app_ring_peek(&s_sample_ring, &first);
+        if (n == 0)
+        {
+            break;
+        }
+
+        for (size_t i = 0; i < n; i++)
+        {
+            app_batch_prio_t prio = (first[i].flags & APP_SAMPLE_F_URGENT) ? APP_BATCH_PRIO_URGENT : APP_BATCH_PRIO_NORMAL;
+            if (app_batch_push(batch, &first[i], prio))
+            {
+                app_flush_batch(batch);
+            }
+        }
+        app_ring_release(&s_sample_ring, n);
+    }
+}
+
+// ========================
+// 上报并清空批次：一个缓冲区放不下时对半拆成多次发布
+// ========================
+static void app_flush_batch(app_batch_t *batch)
+{
+    if (batch->count == 0)
     {
         return;
     }
 
-    // 当前仅打印日志，实际应用中应解析 JSON 并执行相应操作
-    // 例如：OTA 触发、参数配置、LED 控制等
-    ESP_LOGI(TAG, "Downlink JSON: %.*s", (int)len, json);
-}
\ No newline at end of file
+    app_pool_stats_t pool;
+    app_flow_stats_t flow;
+    app_pool_get_stats(&pool);
+    app_flow_get_stats(APP_FLOW_STAGE_SAMPLE, &flow);
+    ESP_LOGD(TAG, "Flush batch: %u samples%s, %u coalesced, %u dropped; pool %u/%u free (min %u, exhausted %u)",
+             (unsigned)batch->count, batch->urgent ? " (urgent)" : "", (unsigned)flow.coalesced, (unsigned)flow.dropped_newest,
+             (unsigned)pool.free, (unsigned)pool.total, (unsigned)pool.min_free, (unsigned)pool.exhausted);
+
+    // 按当前选择的编码器编码，发布到该编码器的主题
+    app_codec_id_t codec_id = app_codec_active_id();
+    const app_codec_t *codec = app_codec_get(codec_id);
+    uint8_t *out = (uint8_t *)s_upload_buf;
+
+    uint16_t start = 0;
+    while (start < batch->count)
+    {
+        uint16_t n = batch->count - start;
+        size_t len = codec->encode_batch(batch, start, n, out, sizeof(s_upload_buf));
+        while (len == 0 && n > 1)
+        {
+            n /= 2;
+            len = codec->encode_batch(batch, start, n, out, sizeof(s_upload_buf));
+        }
+        if (len == 0)
+        {
+            ESP_LOGW(TAG, "Sensor %s buffer too small", codec->name);
+            break;
+        }
+
+        app_upload(codec_id, s_upload_buf, len);
+        start += n;
+    }
+
+    app_batch_reset(batch);
+}
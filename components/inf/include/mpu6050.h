@@ -4,24 +4,78 @@
 #include <stdint.h>
 
 // 这个是MPU6050的驱动注册 一共会要用到几个函数 在这里定义成为函数指针的结构体
+// 读写函数返回 0 表示成功，非 0 表示总线错误（由平台层定义具体错误码），错误会原样向上传递
 typedef struct
 {
-    void (*MPU6050_WriteByte)(uint8_t reg_addr, uint8_t send_byte);
-    void (*MPU6050_ReadByte)(uint8_t reg_addr, uint8_t *receive_byte);
-    void (*MPU6050_ReadBytes)(uint8_t reg_addr, uint8_t *buf, uint8_t len);
+    int (*MPU6050_WriteByte)(uint8_t reg_addr, uint8_t send_byte);
+    int (*MPU6050_ReadByte)(uint8_t reg_addr, uint8_t *receive_byte);
+    int (*MPU6050_ReadBytes)(uint8_t reg_addr, uint8_t *buf, uint16_t len);
     void (*MPU6050_DelayMs)(uint32_t ms);
 } MPU6050_DrvTypeDef;
 
+// 一个完整样本的字节数：加速度 XYZ 6 字节 + 温度 2 字节 + 陀螺仪 XYZ 6 字节
+// 寄存器 0x3B~0x48 与 FIFO 中的排列顺序相同，直接读和 FIFO 读共用一种解码
+#define MPU6050_SAMPLE_SIZE 14
+// FIFO 中每个样本的字节数
+#define MPU6050_FIFO_SAMPLE_SIZE MPU6050_SAMPLE_SIZE
+// MPU6050 片上 FIFO 的容量（字节）
+#define MPU6050_FIFO_MAX_BYTES 1024
+// 一次最多能从 FIFO 中取出的完整样本数
+#define MPU6050_FIFO_MAX_SAMPLES (MPU6050_FIFO_MAX_BYTES / MPU6050_FIFO_SAMPLE_SIZE)
+
+// 陀螺仪量程（MPU_GYRO_CFG_REG 的 FS_SEL）
+#define MPU6050_GYRO_FSR_250DPS 0
+#define MPU6050_GYRO_FSR_500DPS 1
+#define MPU6050_GYRO_FSR_1000DPS 2
+#define MPU6050_GYRO_FSR_2000DPS 3
+
+// 加速度计量程（MPU_ACCEL_CFG_REG 的 AFS_SEL）
+#define MPU6050_ACCEL_FSR_2G 0
+#define MPU6050_ACCEL_FSR_4G 1
+#define MPU6050_ACCEL_FSR_8G 2
+#define MPU6050_ACCEL_FSR_16G 3
+
+// 中断使能/状态位（MPU_INT_EN_REG / MPU_INT_STA_REG）
+#define MPU6050_INT_DATA_RDY 0x01  // 数据就绪
+#define MPU6050_INT_FIFO_OFLOW 0x10 // FIFO 溢出
+
+// 一个完整的六轴 + 温度样本（原始计数值），字段顺序与寄存器顺序一致
+typedef struct __attribute__((packed))
+{
+    short ax, ay, az;
+    short temp;
+    short gx, gy, gz;
+} MPU6050_Sample_t;
+
 void MPU6050_RegisterDriver(
-    void (*read_byte)(uint8_t reg_addr, uint8_t *receive_byte),
-    void (*read_bytes)(uint8_t reg_addr, uint8_t *receive_buff, uint8_t size),
-    void (*write_byte)(uint8_t reg_addr, uint8_t value),
+    int (*read_byte)(uint8_t reg_addr, uint8_t *receive_byte),
+    int (*read_bytes)(uint8_t reg_addr, uint8_t *receive_buff, uint16_t size),
+    int (*write_byte)(uint8_t reg_addr, uint8_t value),
     void (*delay_ms)(uint32_t ms)
 );
 
-void Int_MPU6050_Init(void);
-void Int_MPU6050_Get_Gyro(short *gx, short *gy, short *gz);
-void Int_MPU6050_Get_Accel(short *ax, short *ay, short *az);
+// 以下返回 int 的函数：0 表示成功，非 0 为驱动返回的第一个错误
+int Int_MPU6050_Init(void);
+int Int_MPU6050_SetGyroRate(uint16_t rate);
+uint16_t Int_MPU6050_GetSampleRate(void);
+int Int_MPU6050_SetGyroFsr(uint8_t fsr);
+int Int_MPU6050_SetAccelFsr(uint8_t fsr);
+uint16_t Int_MPU6050_GetGyroRangeDps(void);
+uint16_t Int_MPU6050_GetAccelRangeG(void);
+int Int_MPU6050_Get_Gyro(short *gx, short *gy, short *gz);
+int Int_MPU6050_Get_Accel(short *ax, short *ay, short *az);
+int Int_MPU6050_Get_All(MPU6050_Sample_t *sample);
+
+int Int_MPU6050_FIFO_Enable(void);
+int Int_MPU6050_FIFO_Disable(void);
+int Int_MPU6050_FIFO_Count(uint16_t *count);
+int Int_MPU6050_FIFO_Read(MPU6050_Sample_t *samples, uint16_t max, uint16_t *count);
+// FIFO 写满后复位重新开始并计数；溢出次数用来发现丢数据（采集任务跟不上或被阻塞太久）
+int Int_MPU6050_FIFO_Recover(void);
+uint32_t Int_MPU6050_FIFO_GetOverflows(void);
+
+int Int_MPU6050_INT_Enable(uint8_t mask);
+uint8_t Int_MPU6050_Get_INT_Status(void);
 
 
 
@@ -3,12 +3,26 @@
 
 static MPU6050_DrvTypeDef s_default_driver = {0}; // 内部静态实例
 MPU6050_DrvTypeDef *g_mpu6050_driver = &s_default_driver;
+static uint16_t s_sample_rate = 0;                // 当前实际生效的采样率（Hz），0 表示还未配置
+static uint8_t s_gyro_fsr = MPU6050_GYRO_FSR_2000DPS; // 陀螺仪量程
+static uint8_t s_accel_fsr = MPU6050_ACCEL_FSR_2G;    // 加速度计量程
+
+/* 执行一次寄存器读写，出错时直接把驱动返回的错误码交给调用方 */
+#define MPU6050_CHECK(x)        \
+    do                          \
+    {                           \
+        int mpu_err = (x);      \
+        if (mpu_err != 0)       \
+        {                       \
+            return mpu_err;     \
+        }                       \
+    } while (0)
 
 // 使用前要注册驱动
 void MPU6050_RegisterDriver(
-    void (*read_byte)(uint8_t reg_addr, uint8_t *receive_byte),
-    void (*read_bytes)(uint8_t reg_addr, uint8_t *receive_buff, uint8_t size),
-    void (*write_byte)(uint8_t reg_addr, uint8_t value),
+    int (*read_byte)(uint8_t reg_addr, uint8_t *receive_byte),
+    int (*read_bytes)(uint8_t reg_addr, uint8_t *receive_buff, uint16_t size),
+    int (*write_byte)(uint8_t reg_addr, uint8_t value),
     void (*delay_ms)(uint32_t ms))
 {
     g_mpu6050_driver->MPU6050_ReadByte = read_byte;
@@ -19,13 +33,13 @@ void MPU6050_RegisterDriver(
 
 
 // 1. 向MPU6050的寄存器写入单个数据 从机地址 0x68，寄存器地址，数据
-void Int_MPU6050_WriteByte(uint8_t reg_addr, uint8_t send_byte) { g_mpu6050_driver->MPU6050_WriteByte(reg_addr, send_byte); }
+int Int_MPU6050_WriteByte(uint8_t reg_addr, uint8_t send_byte) { return g_mpu6050_driver->MPU6050_WriteByte(reg_addr, send_byte); }
 
 // 2. 从MPU6050的寄存器读取单个数据 从机地址 0x68，寄存器地址，接收数据的指针
-void Int_MPU6050_ReadByte(uint8_t reg_addr, uint8_t *receive_byte) { g_mpu6050_driver->MPU6050_ReadByte(reg_addr, receive_byte); }
+int Int_MPU6050_ReadByte(uint8_t reg_addr, uint8_t *receive_byte) { return g_mpu6050_driver->MPU6050_ReadByte(reg_addr, receive_byte); }
 
 // 3. 从MPU6050的寄存器连续读取多个数据 从机地址 0x68，寄存器地址，接收数据的指针，数据长度
-void Int_MPU6050_ReadBytes(uint8_t reg_addr, uint8_t *receive_buff, uint8_t size) { g_mpu6050_driver->MPU6050_ReadBytes(reg_addr, receive_buff, size); }
+int Int_MPU6050_ReadBytes(uint8_t reg_addr, uint8_t *receive_buff, uint16_t size) { return g_mpu6050_driver->MPU6050_ReadBytes(reg_addr, receive_buff, size); }
 
 // 4. 延迟函数，单位ms
 void Int_delay_ms(uint32_t ms) { g_mpu6050_driver->MPU6050_DelayMs(ms); }
@@ -33,9 +47,9 @@ void Int_delay_ms(uint32_t ms) { g_mpu6050_driver->MPU6050_DelayMs(ms); }
 /**
  * @description: 根据采样率设置低通滤波器
  * @param {uint16_t} rate
- * @return {*}
+ * @return {int} 0 成功，非 0 为总线错误
  */
-void Int_MPU6050_Set_DLPF_CFG(uint16_t rate)
+int Int_MPU6050_Set_DLPF_CFG(uint16_t rate)
 {
     /* 采样定理： 采样率 >= 2*带宽 才不会失真 ===》 带宽 <= 采样率/2 */
     uint8_t cfg = 0;
@@ -64,15 +78,15 @@ void Int_MPU6050_Set_DLPF_CFG(uint16_t rate)
     {
         cfg = 6;
     }
-    Int_MPU6050_WriteByte(MPU_CFG_REG, cfg << 0);
+    return Int_MPU6050_WriteByte(MPU_CFG_REG, cfg << 0);
 }
 
 /**
  * @description: 设置陀螺仪的采样率
  * @param {uint16_t} rate
- * @return {*}
+ * @return {int} 0 成功，非 0 为总线错误
  */
-void Int_MPU6050_SetGyroRate(uint16_t rate)
+int Int_MPU6050_SetGyroRate(uint16_t rate)
 {
     /* 采样率=输出频率/(1+分频值) ===》 分频值 = (输出频率/采样率) -1 */
     uint8_t sample_div = 0;
@@ -89,49 +103,105 @@ void Int_MPU6050_SetGyroRate(uint16_t rate)
     /* 2. 根据期望的采样率，计算出分频值 */
     sample_div = 1000 / rate - 1;
 
-    /* 3. 将分频值设置到寄存器中 */
-    Int_MPU6050_WriteByte(MPU_SAMPLE_RATE_REG, sample_div);
+    /* 3. 将分频值设置到寄存器中，并记下实际生效的采样率（整除后可能与期望值略有差别） */
+    MPU6050_CHECK(Int_MPU6050_WriteByte(MPU_SAMPLE_RATE_REG, sample_div));
+    s_sample_rate = 1000 / (1 + sample_div);
 
     /* 4. 根据采样率去设置低通滤波器 */
-    Int_MPU6050_Set_DLPF_CFG(rate);
+    return Int_MPU6050_Set_DLPF_CFG(rate);
+}
+
+/**
+ * @description: 设置陀螺仪量程
+ * @param {uint8_t} fsr MPU6050_GYRO_FSR_250DPS ~ MPU6050_GYRO_FSR_2000DPS
+ * @return {int} 0 成功，非 0 为总线错误（此时记录的量程不变）
+ */
+int Int_MPU6050_SetGyroFsr(uint8_t fsr)
+{
+    fsr &= 0x03;
+    MPU6050_CHECK(Int_MPU6050_WriteByte(MPU_GYRO_CFG_REG, fsr << 3));
+    s_gyro_fsr = fsr;
+    return 0;
+}
+
+/**
+ * @description: 设置加速度计量程
+ * @param {uint8_t} fsr MPU6050_ACCEL_FSR_2G ~ MPU6050_ACCEL_FSR_16G
+ * @return {int} 0 成功，非 0 为总线错误（此时记录的量程不变）
+ */
+int Int_MPU6050_SetAccelFsr(uint8_t fsr)
+{
+    fsr &= 0x03;
+    MPU6050_CHECK(Int_MPU6050_WriteByte(MPU_ACCEL_CFG_REG, fsr << 3));
+    s_accel_fsr = fsr;
+    return 0;
+}
+
+/**
+ * @description: 获取陀螺仪量程
+ * @return {uint16_t} 满量程（°/s）：250/500/1000/2000
+ */
+uint16_t Int_MPU6050_GetGyroRangeDps(void)
+{
+    return 250 << s_gyro_fsr;
+}
+
+/**
+ * @description: 获取加速度计量程
+ * @return {uint16_t} 满量程（g）：2/4/8/16
+ */
+uint16_t Int_MPU6050_GetAccelRangeG(void)
+{
+    return 2 << s_accel_fsr;
+}
+
+/**
+ * @description: 获取当前实际生效的采样率
+ * @return {uint16_t} 采样率（Hz），未配置时为 0
+ */
+uint16_t Int_MPU6050_GetSampleRate(void)
+{
+    return s_sample_rate;
 }
 
 /**
  * @description: 初始化
- * @return {*}
+ * @return {int} 0 成功，非 0 为总线错误；ID 不匹配时返回 -1
  */
-void Int_MPU6050_Init(void)
+int Int_MPU6050_Init(void)
 {
     uint8_t dev_id = 0;
 
     /* 2 复位 -》延迟一会 -》 唤醒 */
-    Int_MPU6050_WriteByte(MPU_PWR_MGMT1_REG, 0x80);
+    MPU6050_CHECK(Int_MPU6050_WriteByte(MPU_PWR_MGMT1_REG, 0x80));
     Int_delay_ms(300);
-    Int_MPU6050_WriteByte(MPU_PWR_MGMT1_REG, 0x00);
+    MPU6050_CHECK(Int_MPU6050_WriteByte(MPU_PWR_MGMT1_REG, 0x00));
 
-    /* 3 陀螺仪量程 +-2000°/s, fsr=3 */
-    Int_MPU6050_WriteByte(MPU_GYRO_CFG_REG, 3 << 3);
+    /* 3 陀螺仪量程，默认 +-2000°/s, fsr=3 */
+    MPU6050_CHECK(Int_MPU6050_SetGyroFsr(s_gyro_fsr));
 
-    /* 4 加速度量程 */
-    Int_MPU6050_WriteByte(MPU_ACCEL_CFG_REG, 0 << 3);
+    /* 4 加速度量程，默认 +-2g, fsr=0 */
+    MPU6050_CHECK(Int_MPU6050_SetAccelFsr(s_accel_fsr));
 
     /* 5 其他功能设置（可选）：FIFO、第二IIC、中断 */
-    Int_MPU6050_WriteByte(MPU_INT_EN_REG, 0x00);    // 关闭所有中断
-    Int_MPU6050_WriteByte(MPU_USER_CTRL_REG, 0x00); // 关闭第二IIC
-    Int_MPU6050_WriteByte(MPU_FIFO_EN_REG, 0x00);   // 关闭FIFO
+    MPU6050_CHECK(Int_MPU6050_WriteByte(MPU_INT_EN_REG, 0x00));    // 关闭所有中断
+    MPU6050_CHECK(Int_MPU6050_WriteByte(MPU_USER_CTRL_REG, 0x00)); // 关闭第二IIC
+    MPU6050_CHECK(Int_MPU6050_WriteByte(MPU_FIFO_EN_REG, 0x00));   // 关闭FIFO
 
     /* 6 系统时钟源、陀螺仪采样率、低通滤波的设置 */
     /* 配置时钟源之前，确认正常工作，读一下id */
-    Int_MPU6050_ReadByte(MPU_DEVICE_ID_REG, &dev_id);
-    if (dev_id == MPU_IIC_ADDR)
+    MPU6050_CHECK(Int_MPU6050_ReadByte(MPU_DEVICE_ID_REG, &dev_id));
+    if (dev_id != MPU_IIC_ADDR)
     {
-        /* 6.1 设置时钟源：陀螺仪X轴的时钟，精度更高 */
-        Int_MPU6050_WriteByte(MPU_PWR_MGMT1_REG, 0x01);
-        /* 6.2 设置陀螺仪采样率、低通滤波 */
-        Int_MPU6050_SetGyroRate(100);
-        /* 6.3 让两个传感器退出待机模式，进入正常工作状态*/
-        Int_MPU6050_WriteByte(MPU_PWR_MGMT2_REG, 0x00);
+        return -1;
     }
+
+    /* 6.1 设置时钟源：陀螺仪X轴的时钟，精度更高 */
+    MPU6050_CHECK(Int_MPU6050_WriteByte(MPU_PWR_MGMT1_REG, 0x01));
+    /* 6.2 设置陀螺仪采样率、低通滤波 */
+    MPU6050_CHECK(Int_MPU6050_SetGyroRate(100));
+    /* 6.3 让两个传感器退出待机模式，进入正常工作状态*/
+    return Int_MPU6050_WriteByte(MPU_PWR_MGMT2_REG, 0x00);
 }
 
 /**
@@ -139,12 +209,12 @@ void Int_MPU6050_Init(void)
  * @param {short} *gx
  * @param {short} *gy
  * @param {short} *gz
- * @return {*}
+ * @return {int} 0 成功，非 0 为总线错误（输出不变）
  */
-void Int_MPU6050_Get_Gyro(short *gx, short *gy, short *gz)
+int Int_MPU6050_Get_Gyro(short *gx, short *gy, short *gz)
 {
     uint8_t buff[6];
-    Int_MPU6050_ReadBytes(MPU_GYRO_XOUTH_REG, buff, 6);
+    MPU6050_CHECK(Int_MPU6050_ReadBytes(MPU_GYRO_XOUTH_REG, buff, 6));
 
     /*
         buff[0]:角速度X轴高8位
@@ -157,6 +227,7 @@ void Int_MPU6050_Get_Gyro(short *gx, short *gy, short *gz)
     *gx = ((short)buff[0] << 8) | buff[1];
     *gy = ((short)buff[2] << 8) | buff[3];
     *gz = ((short)buff[4] << 8) | buff[5];
+    return 0;
 }
 
 /**
@@ -164,12 +235,12 @@ void Int_MPU6050_Get_Gyro(short *gx, short *gy, short *gz)
  * @param {short} *ax
  * @param {short} *ay
  * @param {short} *az
- * @return {*}
+ * @return {int} 0 成功，非 0 为总线错误（输出不变）
  */
-void Int_MPU6050_Get_Accel(short *ax, short *ay, short *az)
+int Int_MPU6050_Get_Accel(short *ax, short *ay, short *az)
 {
     uint8_t buff[6];
-    Int_MPU6050_ReadBytes(MPU_ACCEL_XOUTH_REG, buff, 6);
+    MPU6050_CHECK(Int_MPU6050_ReadBytes(MPU_ACCEL_XOUTH_REG, buff, 6));
 
     /*
         buff[0]:加速度X轴高8位
@@ -182,4 +253,177 @@ void Int_MPU6050_Get_Accel(short *ax, short *ay, short *az)
     *ax = ((short)buff[0] << 8) | buff[1];
     *ay = ((short)buff[2] << 8) | buff[3];
     *az = ((short)buff[4] << 8) | buff[5];
+    return 0;
+}
+
+/**
+ * @description: 把 14 字节原始数据（高字节在前）解码成样本
+ * @param {uint8_t} *p 原始数据，顺序：加速度 XYZ、温度、陀螺仪 XYZ
+ * @param {MPU6050_Sample_t} *sample
+ * @return {*}
+ */
+static void Int_MPU6050_Decode(const uint8_t *p, MPU6050_Sample_t *sample)
+{
+    sample->ax = ((short)p[0] << 8) | p[1];
+    sample->ay = ((short)p[2] << 8) | p[3];
+    sample->az = ((short)p[4] << 8) | p[5];
+    sample->temp = ((short)p[6] << 8) | p[7];
+    sample->gx = ((short)p[8] << 8) | p[9];
+    sample->gy = ((short)p[10] << 8) | p[11];
+    sample->gz = ((short)p[12] << 8) | p[13];
+}
+
+/**
+ * @description: 一次 14 字节突发读出加速度、温度、陀螺仪，三者来自同一个采样时刻
+ * @param {MPU6050_Sample_t} *sample
+ * @return {int} 0 成功，非 0 为总线错误（输出不变）
+ */
+int Int_MPU6050_Get_All(MPU6050_Sample_t *sample)
+{
+    uint8_t buff[MPU6050_SAMPLE_SIZE];
+    MPU6050_CHECK(Int_MPU6050_ReadBytes(MPU_ACCEL_XOUTH_REG, buff, MPU6050_SAMPLE_SIZE));
+    Int_MPU6050_Decode(buff, sample);
+    return 0;
+}
+
+/* FIFO 突发读取缓冲区：只存放完整样本，1024 字节的 FIFO 最多容纳 73 个样本 */
+static uint8_t s_fifo_buff[MPU6050_FIFO_MAX_SAMPLES * MPU6050_FIFO_SAMPLE_SIZE];
+
+/* FIFO 写满后复位的累计次数，每次复位都丢掉了 FIFO 中的全部样本 */
+static uint32_t s_fifo_overflows = 0;
+
+/**
+ * @description: 复位并开启 FIFO，加速度计和三轴陀螺仪的数据按采样率写入 FIFO
+ * @return {int} 0 成功，非 0 为总线错误
+ */
+int Int_MPU6050_FIFO_Enable(void)
+{
+    /* 1. 先关掉写入源和 FIFO，再复位 FIFO，清掉里面的旧数据 */
+    MPU6050_CHECK(Int_MPU6050_WriteByte(MPU_FIFO_EN_REG, 0x00));
+    MPU6050_CHECK(Int_MPU6050_WriteByte(MPU_USER_CTRL_REG, 0x04)); // bit2: FIFO_RESET，完成后自动清零
+
+    /* 2. 打开 FIFO 操作（USER_CTRL bit6: FIFO_EN） */
+    MPU6050_CHECK(Int_MPU6050_WriteByte(MPU_USER_CTRL_REG, 0x40));
+
+    /* 3. 选择写入 FIFO 的数据：TEMP(bit7) XG(bit6) YG(bit5) ZG(bit4) ACCEL(bit3)
+          FIFO 中的顺序与寄存器地址顺序一致：加速度 XYZ、温度、陀螺仪 XYZ */
+    return Int_MPU6050_WriteByte(MPU_FIFO_EN_REG, 0xF8);
+}
+
+/**
+ * @description: 关闭 FIFO，回到直接读数据寄存器的方式
+ * @return {int} 0 成功，非 0 为总线错误
+ */
+int Int_MPU6050_FIFO_Disable(void)
+{
+    MPU6050_CHECK(Int_MPU6050_WriteByte(MPU_FIFO_EN_REG, 0x00));
+    MPU6050_CHECK(Int_MPU6050_WriteByte(MPU_USER_CTRL_REG, 0x04));
+    return Int_MPU6050_WriteByte(MPU_USER_CTRL_REG, 0x00);
+}
+
+/**
+ * @description: FIFO 写满后的恢复：复位 FIFO 重新开始，并计入溢出次数
+ * @return {int} 0 成功，非 0 为总线错误
+ */
+int Int_MPU6050_FIFO_Recover(void)
+{
+    s_fifo_overflows++;
+    return Int_MPU6050_FIFO_Enable();
+}
+
+/**
+ * @description: FIFO 溢出（复位）的累计次数
+ * @return {uint32_t} 次数
+ */
+uint32_t Int_MPU6050_FIFO_GetOverflows(void)
+{
+    return s_fifo_overflows;
+}
+
+/**
+ * @description: 读取 FIFO 中当前积压的字节数（FIFO_COUNTH/FIFO_COUNTL 一次读出）
+ * @param {uint16_t} *count 输出的字节数
+ * @return {int} 0 成功，非 0 为总线错误
+ */
+int Int_MPU6050_FIFO_Count(uint16_t *count)
+{
+    uint8_t buff[2];
+    MPU6050_CHECK(Int_MPU6050_ReadBytes(MPU_FIFO_CNTH_REG, buff, 2));
+    *count = ((uint16_t)buff[0] << 8) | buff[1];
+    return 0;
+}
+
+/**
+ * @description: 把 FIFO 中积压的完整样本一次性全部读出并解码
+ * @param {MPU6050_Sample_t} *samples 输出的样本数组
+ * @param {uint16_t} max 数组最多能放的样本数
+ * @param {uint16_t} *count 实际读出的样本数；FIFO 溢出时会复位 FIFO 并输出 0（计入 Int_MPU6050_FIFO_GetOverflows）
+ * @return {int} 0 成功，非 0 为总线错误（此时 *count 为 0）
+ */
+int Int_MPU6050_FIFO_Read(MPU6050_Sample_t *samples, uint16_t max, uint16_t *count)
+{
+    uint16_t bytes = 0;
+    uint16_t n = 0;
+
+    *count = 0;
+    if (samples == 0 || max == 0)
+    {
+        return 0;
+    }
+
+    /* 1. 查询积压的字节数 */
+    MPU6050_CHECK(Int_MPU6050_FIFO_Count(&bytes));
+
+    /* 2. FIFO 写满后新数据会覆盖旧数据，样本边界就对不齐了，只能复位重新开始 */
+    if (bytes >= MPU6050_FIFO_MAX_BYTES)
+    {
+        return Int_MPU6050_FIFO_Recover();
+    }
+
+    /* 3. 只取完整的样本，剩下不足一个样本的字节留到下一次 */
+    n = bytes / MPU6050_FIFO_SAMPLE_SIZE;
+    if (n > max)
+    {
+        n = max;
+    }
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    /* 4. 一次 I2C 事务把所有样本从 FIFO_R_W 寄存器突发读出 */
+    MPU6050_CHECK(Int_MPU6050_ReadBytes(MPU_FIFO_RW_REG, s_fifo_buff, n * MPU6050_FIFO_SAMPLE_SIZE));
+
+    /* 5. 解码：每个样本 14 字节，和直接读寄存器的排列一样 */
+    for (uint16_t i = 0; i < n; i++)
+    {
+        Int_MPU6050_Decode(&s_fifo_buff[i * MPU6050_FIFO_SAMPLE_SIZE], &samples[i]);
+    }
+
+    *count = n;
+    return 0;
+}
+
+/**
+ * @description: 配置 INT 引脚并打开指定的中断源
+ * @param {uint8_t} mask 中断源，MPU6050_INT_DATA_RDY / MPU6050_INT_FIFO_OFLOW 的组合，0 表示全部关闭
+ * @return {int} 0 成功，非 0 为总线错误
+ */
+int Int_MPU6050_INT_Enable(uint8_t mask)
+{
+    /* INT 高电平有效、推挽输出、输出 50us 脉冲（不锁存），任意读操作清除中断状态
+       bit7 INT_LEVEL=0, bit6 INT_OPEN=0, bit5 LATCH_INT_EN=0, bit4 INT_RD_CLEAR=1 */
+    MPU6050_CHECK(Int_MPU6050_WriteByte(MPU_INTBP_CFG_REG, 0x10));
+    return Int_MPU6050_WriteByte(MPU_INT_EN_REG, mask);
+}
+
+/**
+ * @description: 读取中断状态寄存器，读完后状态位自动清零
+ * @return {uint8_t} 中断状态，读失败时为 0
+ */
+uint8_t Int_MPU6050_Get_INT_Status(void)
+{
+    uint8_t status = 0;
+    Int_MPU6050_ReadByte(MPU_INT_STA_REG, &status);
+    return status;
 }
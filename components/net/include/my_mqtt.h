@@ -5,6 +5,7 @@
 #include "esp_err.h"
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,6 +43,92 @@ esp_err_t mqtt_app_init(
  */
 esp_err_t mqtt_app_publish(const char* topic, const char* payload, size_t len, int qos, bool retain);
 
+// 同时跟踪的异步发布最多条数，满了以后 mqtt_app_publish_async 返回 ESP_ERR_NO_MEM
+#define MQTT_PUB_INFLIGHT_MAX 16
+
+// 异步发布超过这么久仍没有结果时按失败处理（释放跟踪位置）
+#define MQTT_PUB_TIMEOUT_MS 60000
+
+// 异步发布的结果
+typedef enum
+{
+    MQTT_PUB_ACKED = 0, // 收到 PUBACK（QoS1）/ PUBCOMP（QoS2）
+    MQTT_PUB_FAILED,    // 在 outbox 中过期被删除，或超时未确认
+} mqtt_pub_result_t;
+
+/**
+ * @brief 异步发布完成回调
+ *
+ * 一般在 MQTT 任务中调用；超时、或确认在入队返回前就已到达时，在发起发布的任务中调用。不要在回调里阻塞
+ *
+ * @param handle     mqtt_app_publish_async 返回的句柄（消息 ID）
+ * @param result     结果
+ * @param latency_ms 从入队到出结果的时间
+ * @param ctx        发布时传入的参数
+ */
+typedef void (*mqtt_pub_cb_t)(int handle, mqtt_pub_result_t result, uint32_t latency_ms, void *ctx);
+
+/**
+ * @brief 异步发布：消息放入 outbox 后立即返回，由 MQTT 任务发送，不等待网络
+ *
+ * QoS0 没有确认，入队即算完成，不跟踪也不回调
+ *
+ * @param topic     主题名
+ * @param payload   消息内容（入队时已复制）
+ * @param len       消息长度
+ * @param qos       QoS 等级：0, 1, 2
+ * @param retain    是否保留消息
+ * @param cb        完成回调（可为 NULL，仍会计入在途数）
+ * @param ctx       回调参数
+ * @param handle    返回消息句柄（可为 NULL）
+ * @return ESP_ERR_INVALID_STATE 未连接；ESP_ERR_NO_MEM 在途消息已满
+ */
+esp_err_t mqtt_app_publish_async(const char *topic, const char *payload, size_t len, int qos, bool retain,
+                                 mqtt_pub_cb_t cb, void *ctx, int *handle);
+
+/**
+ * @brief 当前已入队、尚未确认的异步发布条数
+ */
+uint32_t mqtt_app_inflight(void);
+
+// 确认延迟直方图的桶上界（毫秒），最后一个桶收集超过 2500 ms 的样本
+#define MQTT_LATENCY_BOUNDS_MS {10, 25, 50, 100, 250, 500, 1000, 2500}
+#define MQTT_LATENCY_BUCKETS 9
+
+// MQTT 客户端统计（累计值从启动开始计）
+typedef struct
+{
+    bool connected;
+    uint32_t connected_ms;      // 累计连接时长（含当前这次连接）
+    uint32_t reconnects;        // 第一次连接之后的重连次数
+    uint32_t published;         // 交给 MQTT 客户端的发布数
+    uint32_t acked;             // 收到确认的异步发布数
+    uint32_t failed;            // 过期或超时的异步发布数
+    uint32_t dropped;           // 未连接时被拒绝的发布数
+    uint32_t inflight;          // 当前在途的异步发布数
+    uint32_t received;          // 收到的下行消息数
+    uint64_t bytes_sent;        // 发布的负载字节数
+    uint64_t bytes_received;    // 收到的负载字节数
+    uint32_t latency_min_ms;    // 发布到确认的延迟（只统计异步发布）
+    uint32_t latency_max_ms;
+    uint32_t latency_avg_ms;
+    uint32_t latency_hist[MQTT_LATENCY_BUCKETS];
+} mqtt_stats_t;
+
+/**
+ * @brief 读取统计快照（任意任务可调用）
+ */
+void mqtt_app_get_stats(mqtt_stats_t *stats);
+
+/**
+ * @brief 把统计快照（连同持久化 outbox 的深度）写成 JSON，供 HTTP 接口和遥测上报使用
+ *
+ * @param buf 输出缓冲区
+ * @param cap 缓冲区大小
+ * @return JSON 长度；放不下时返回 0
+ */
+size_t mqtt_app_stats_json(char *buf, size_t cap);
+
 /**
  * @brief 订阅主题
  *
@@ -0,0 +1,60 @@
+// my_outbox.h
+#ifndef __MY_OUTBOX_H__
+#define __MY_OUTBOX_H__
+
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 持久化 outbox 用的 flash 分区标签（见 partitions.csv），找不到时退化为内存 outbox
+#define MQTT_OUTBOX_PARTITION_LABEL "mqtt_outbox"
+
+/**
+ * 持久化 MQTT outbox（CONFIG_MQTT_CUSTOM_OUTBOX）
+ * - 替换 esp-mqtt 自带的内存 outbox，实现同名的 outbox_* 接口（my_outbox.c 编进 mqtt 组件）
+ * - QoS1/2 的 PUBLISH 先留在内存，攒够一批（2 KB）或最早一条等了 500 ms 后由 MQTT 任务一次写入 flash
+ *   并释放内存；在此之前已收到 PUBACK 的消息不写 flash
+ * - flash 只追加：删除写一条删除记录，不改写原记录；分区按扇区组成环，写满时擦除最早的扇区
+ * - 上电时重放 flash 中未删除的消息，连上服务器后由 esp-mqtt 重发（至少一次）
+ */
+
+// outbox 统计
+typedef struct
+{
+    uint32_t depth;       // 当前未确认的消息数
+    uint32_t bytes;       // 当前未确认的消息字节数
+    uint32_t flash_bytes; // 其中已写入 flash 的字节数
+    uint32_t replayed;    // 上电时从 flash 恢复的消息数
+    uint32_t flushes;     // 累计批量写入 flash 的次数
+    uint32_t evicted;     // 累计因 flash 写满被丢弃的消息数
+    uint32_t del_dropped; // 累计因待写删除记录已满而丢弃的删除记录数（对应的消息重启后会重发）
+    bool flash;           // flash 分区是否可用
+} mqtt_outbox_stats_t;
+
+#if CONFIG_MQTT_CUSTOM_OUTBOX
+
+/**
+ * @brief 读取 outbox 统计（任意任务可调用）
+ */
+void mqtt_outbox_get_stats(mqtt_outbox_stats_t *stats);
+
+#else
+
+// 未启用持久化 outbox 时没有统计
+static inline void mqtt_outbox_get_stats(mqtt_outbox_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __MY_OUTBOX_H__
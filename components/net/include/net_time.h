@@ -0,0 +1,38 @@
+#ifndef NET_TIME_H
+#define NET_TIME_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 启动 SNTP 对时（联网后调用一次即可，重复调用直接返回）
+ *
+ * @param server NTP 服务器地址，NULL 时使用默认服务器
+ * @return esp_err_t
+ */
+esp_err_t net_time_sync_start(const char *server);
+
+/**
+ * @brief 是否已经完成过一次 SNTP 对时
+ */
+bool net_time_is_synced(void);
+
+/**
+ * @brief 把 esp_timer 时间（开机后微秒）换算成 UTC 时间（1970 起的微秒）
+ *
+ * @param mono_us esp_timer_get_time() 得到的时间
+ * @param epoch_us 输出 UTC 微秒
+ * @return ESP_OK 换算成功；ESP_ERR_INVALID_STATE 尚未对时
+ */
+esp_err_t net_time_to_epoch_us(int64_t mono_us, int64_t *epoch_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NET_TIME_H
@@ -5,6 +5,8 @@
 #include "esp_log.h"
 #include "wifi.h"
 #include "http.h"
+#include "trace.h"
+#include "my_mqtt.h"
 
 static const char *TAG = "http_server";
 
@@ -165,6 +167,85 @@ static esp_err_t connect_handler(httpd_req_t *req)
     return ESP_OK;
 }
 
+/* ================== /trace 接口 ================== */
+// 每次拷贝的记录条数，栈上缓冲区 TRACE_HTTP_BATCH * sizeof(trace_record_t)
+#define TRACE_HTTP_BATCH 4
+
+// GET /trace?since=<seq>：按 trace_record_t 原样输出序号大于 since 的记录（二进制，小端）
+// 只输出到进入时的最新一条，之后写入的留给下一次请求；否则记录写得比发得快时永远发不完
+// 带 mod=<mqtt|net|app>&level=<0~5>[&sample=N] 时先修改该模块的运行期级别和采样
+static esp_err_t trace_handler(httpd_req_t *req)
+{
+    char query[96] = {0};
+    char val[16];
+    char name[8];
+    uint32_t since = 0;
+
+    int len = httpd_req_get_url_query_len(req);
+    if (len > 0 && len < (int)sizeof(query) && httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK)
+    {
+        if (httpd_query_key_value(query, "since", val, sizeof(val)) == ESP_OK)
+        {
+            since = (uint32_t)strtoul(val, NULL, 10);
+        }
+        if (httpd_query_key_value(query, "mod", name, sizeof(name)) == ESP_OK)
+        {
+            trace_module_t module = trace_module_find(name);
+            if (module == TRACE_MOD_MAX)
+            {
+                httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "unknown module");
+                return ESP_FAIL;
+            }
+
+            uint8_t level;
+            uint16_t sample;
+            trace_get_level(module, &level, &sample);
+            if (httpd_query_key_value(query, "level", val, sizeof(val)) == ESP_OK)
+            {
+                level = (uint8_t)strtoul(val, NULL, 10);
+            }
+            if (httpd_query_key_value(query, "sample", val, sizeof(val)) == ESP_OK)
+            {
+                sample = (uint16_t)strtoul(val, NULL, 10);
+            }
+            trace_set_level(module, level, sample);
+            ESP_LOGI(TAG, "trace %s: level=%u sample=%u", name, level, sample);
+        }
+    }
+
+    httpd_resp_set_type(req, "application/octet-stream");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+
+    trace_record_t batch[TRACE_HTTP_BATCH];
+    uint32_t until = trace_last_seq();
+    size_t n;
+    while ((n = trace_read(since, until, batch, TRACE_HTTP_BATCH)) > 0)
+    {
+        if (httpd_resp_send_chunk(req, (const char *)batch, n * sizeof(trace_record_t)) != ESP_OK)
+        {
+            return ESP_FAIL;
+        }
+        since = batch[n - 1].seq;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+/* ================== /mqtt_stats 接口 ================== */
+static esp_err_t mqtt_stats_handler(httpd_req_t *req)
+{
+    char json[512];
+    if (mqtt_app_stats_json(json, sizeof(json)) == 0)
+    {
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    httpd_resp_sendstr(req, json);
+    return ESP_OK;
+}
+
 /* ================== 启动服务器 ================== */
 esp_err_t start_webserver(void)
 {
@@ -229,6 +310,20 @@ esp_err_t start_webserver(void)
         .user_ctx = NULL};
     httpd_register_uri_handler(server, &connect_uri);
 
+    httpd_uri_t trace_uri = {
+        .uri = "/trace",
+        .method = HTTP_GET,
+        .handler = trace_handler,
+        .user_ctx = NULL};
+    httpd_register_uri_handler(server, &trace_uri);
+
+    httpd_uri_t mqtt_stats_uri = {
+        .uri = "/mqtt_stats",
+        .method = HTTP_GET,
+        .handler = mqtt_stats_handler,
+        .user_ctx = NULL};
+    httpd_register_uri_handler(server, &mqtt_stats_uri);
+
     ESP_LOGI(TAG, "HTTP server started on http://192.168.100.1");
     return ESP_OK;
 }
\ No newline at end of file
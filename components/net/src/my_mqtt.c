@@ -3,8 +3,13 @@
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "esp_timer.h"
 #include <inttypes.h>
-#include "OLED.h"
+#include <string.h>
+#include "ui_status.h"
+#include "trace.h"
+#include "json_writer.h"
+#include "my_outbox.h"
 
 static const char *TAG = "MY_MQTT";
 
@@ -12,6 +17,109 @@ static esp_mqtt_client_handle_t s_mqtt_client = NULL;
 static bool s_is_connected = false;
 static mqtt_data_cb_t s_data_cb = NULL;
 
+// 异步发布的跟踪项：msg_id 为 0 表示空闲，MQTT_PUB_RESERVED 表示已占用、正在入队
+#define MQTT_PUB_RESERVED (-1)
+
+typedef struct
+{
+    int msg_id;
+    int64_t start_us;
+    mqtt_pub_cb_t cb;
+    void *ctx;
+} mqtt_pub_slot_t;
+
+// 确认可能在 esp_mqtt_client_enqueue 返回前就到了（入队后 MQTT 任务立刻发送、服务端立刻应答），
+// 此时跟踪项还是 MQTT_PUB_RESERVED，先把结果记在这里，由 mqtt_pub_bind 取走
+typedef struct
+{
+    int msg_id;
+    mqtt_pub_result_t result;
+} mqtt_pub_early_t;
+
+static mqtt_pub_slot_t s_pub_slots[MQTT_PUB_INFLIGHT_MAX];
+static uint32_t s_pub_inflight = 0;
+static mqtt_pub_early_t s_pub_early[MQTT_PUB_INFLIGHT_MAX];
+static int s_pub_early_next = 0;
+static int s_pub_reserved = 0; // 处于 MQTT_PUB_RESERVED 的跟踪项数
+static portMUX_TYPE s_pub_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void mqtt_pub_complete(int msg_id, mqtt_pub_result_t result);
+
+// 统计，在 MQTT 任务和发布任务中更新，读取时加锁
+static const uint16_t s_latency_bounds[MQTT_LATENCY_BUCKETS - 1] = MQTT_LATENCY_BOUNDS_MS;
+static mqtt_stats_t s_stats;
+static uint32_t s_connects = 0;
+static int64_t s_connected_since_us = 0;
+static uint64_t s_latency_sum_ms = 0;
+static portMUX_TYPE s_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// 连接状态变化：累计连接时长，统计重连次数
+static void mqtt_stats_link(bool up)
+{
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_stats_lock);
+    if (up && !s_stats.connected)
+    {
+        if (s_connects++ > 0)
+        {
+            s_stats.reconnects++;
+        }
+        s_connected_since_us = now;
+    }
+    else if (!up && s_stats.connected)
+    {
+        s_stats.connected_ms += (uint32_t)((now - s_connected_since_us) / 1000);
+    }
+    s_stats.connected = up;
+    portEXIT_CRITICAL(&s_stats_lock);
+}
+
+static void mqtt_stats_publish(esp_err_t err, size_t len)
+{
+    portENTER_CRITICAL(&s_stats_lock);
+    if (err == ESP_OK)
+    {
+        s_stats.published++;
+        s_stats.bytes_sent += len;
+    }
+    else if (err == ESP_ERR_INVALID_STATE)
+    {
+        s_stats.dropped++;
+    }
+    portEXIT_CRITICAL(&s_stats_lock);
+}
+
+static void mqtt_stats_complete(mqtt_pub_result_t result, uint32_t latency_ms)
+{
+    portENTER_CRITICAL(&s_stats_lock);
+    if (result != MQTT_PUB_ACKED)
+    {
+        s_stats.failed++;
+        portEXIT_CRITICAL(&s_stats_lock);
+        return;
+    }
+
+    if (s_stats.acked == 0 || latency_ms < s_stats.latency_min_ms)
+    {
+        s_stats.latency_min_ms = latency_ms;
+    }
+    if (latency_ms > s_stats.latency_max_ms)
+    {
+        s_stats.latency_max_ms = latency_ms;
+    }
+    s_stats.acked++;
+    s_latency_sum_ms += latency_ms;
+
+    int bucket = 0;
+    while (bucket < MQTT_LATENCY_BUCKETS - 1 && latency_ms > s_latency_bounds[bucket])
+    {
+        bucket++;
+    }
+    s_stats.latency_hist[bucket]++;
+    portEXIT_CRITICAL(&s_stats_lock);
+}
+
 // MQTT 事件处理函数
 static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data)
 {
@@ -21,27 +129,40 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
     {
     case MQTT_EVENT_CONNECTED:
         ESP_LOGI(TAG, "MQTT connected");
-        OLED_ClearArea(0, 20, 128, 10);
-        OLED_Printf(0, 20, OLED_6X8, "MQTT Connected");
-        OLED_Update();
+        // 只投递状态事件，由显示任务刷屏，MQTT 任务里不做 I2C
+        ui_status_post(UI_EVT_MQTT_CONNECTED, 0);
+        mqtt_stats_link(true);
         s_is_connected = true;
         break;
 
     case MQTT_EVENT_DISCONNECTED:
         ESP_LOGW(TAG, "MQTT disconnected");
-        OLED_ClearArea(0, 20, 128, 10);
-        OLED_Printf(0, 20, OLED_6X8, "MQTT Disconnected");
-        OLED_Update();
+        ui_status_post(UI_EVT_MQTT_DISCONNECTED, 0);
+        mqtt_stats_link(false);
         s_is_connected = false;
         break;
 
+    case MQTT_EVENT_PUBLISHED: // QoS1 收到 PUBACK / QoS2 收到 PUBCOMP
+        mqtt_pub_complete(event->msg_id, MQTT_PUB_ACKED);
+        break;
+
+    case MQTT_EVENT_DELETED: // 消息在 outbox 中过期被删除（CONFIG_MQTT_REPORT_DELETED_MESSAGES）
+        ESP_LOGW(TAG, "Message %d expired in outbox", event->msg_id);
+        mqtt_pub_complete(event->msg_id, MQTT_PUB_FAILED);
+        break;
+
     case MQTT_EVENT_SUBSCRIBED:
         ESP_LOGI(TAG, "Subscribed to topic: %s", event->topic);
         break;
 
     case MQTT_EVENT_DATA: // 这个就是当前的设备就是订阅了某个主题 然后服务器发过来了数据
-        ESP_LOGI(TAG, "Received data on topic: %.*s", event->topic_len, event->topic);
-        ESP_LOG_BUFFER_HEXDUMP(TAG, event->data, event->data_len, ESP_LOG_INFO);
+        // 每条消息都会走这里：不在串口打印负载，需要时通过 /trace 打开 MQTT 模块的 DEBUG 级别查看
+        ESP_LOGD(TAG, "Received %d bytes on topic: %.*s", event->data_len, event->topic_len, event->topic);
+        TRACE_EVENT(MQTT, TRACE_DEBUG, TRACE_EV_MQTT_RX, event->data, (size_t)event->data_len);
+        portENTER_CRITICAL(&s_stats_lock);
+        s_stats.received++;
+        s_stats.bytes_received += (uint64_t)event->data_len;
+        portEXIT_CRITICAL(&s_stats_lock);
         if (s_data_cb)
         {
             s_data_cb(event->topic, (size_t)event->topic_len, event->data, (size_t)event->data_len);
@@ -51,6 +172,7 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
     case MQTT_EVENT_ERROR:
         ESP_LOGE(TAG, "MQTT error");
 
+        mqtt_stats_link(false);
         s_is_connected = false;
         break;
 
@@ -120,6 +242,7 @@ esp_err_t mqtt_app_publish(const char *topic, const char *payload, size_t len, i
     if (!s_is_connected)
     {
         ESP_LOGW(TAG, "MQTT not connected, dropping publish");
+        mqtt_stats_publish(ESP_ERR_INVALID_STATE, len);
         return ESP_ERR_INVALID_STATE;
     }
 
@@ -130,9 +253,207 @@ esp_err_t mqtt_app_publish(const char *topic, const char *payload, size_t len, i
         return ESP_FAIL;
     }
     ESP_LOGD(TAG, "Published message ID: %d", msg_id);
+    TRACE_EVENT(MQTT, TRACE_DEBUG, TRACE_EV_MQTT_TX, payload, len);
+    mqtt_stats_publish(ESP_OK, len);
+    return ESP_OK;
+}
+
+// ========================
+// 异步发布：消息交给 esp_mqtt_client_enqueue 放入 outbox 就返回，由 MQTT 任务发送；
+// QoS1/2 的消息占一个跟踪项，收到确认或被删除时回调
+// ========================
+
+// 占一个空闲的跟踪项，顺便释放超时的跟踪项（在锁外回调失败）
+static int mqtt_pub_reserve(mqtt_pub_cb_t cb, void *ctx)
+{
+    mqtt_pub_slot_t expired[MQTT_PUB_INFLIGHT_MAX];
+    int expired_count = 0;
+    int slot = -1;
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_pub_lock);
+    for (int i = 0; i < MQTT_PUB_INFLIGHT_MAX; i++)
+    {
+        mqtt_pub_slot_t *s = &s_pub_slots[i];
+        if (s->msg_id > 0 && now - s->start_us > (int64_t)MQTT_PUB_TIMEOUT_MS * 1000)
+        {
+            expired[expired_count++] = *s;
+            s->msg_id = 0;
+            s_pub_inflight--;
+        }
+        if (s->msg_id == 0 && slot < 0)
+        {
+            s->msg_id = MQTT_PUB_RESERVED;
+            s->start_us = now;
+            s->cb = cb;
+            s->ctx = ctx;
+            s_pub_inflight++;
+            s_pub_reserved++;
+            slot = i;
+        }
+    }
+    portEXIT_CRITICAL(&s_pub_lock);
+
+    for (int i = 0; i < expired_count; i++)
+    {
+        mqtt_stats_complete(MQTT_PUB_FAILED, 0);
+        ESP_LOGW(TAG, "Message %d not acknowledged in %d ms", expired[i].msg_id, MQTT_PUB_TIMEOUT_MS);
+        if (expired[i].cb)
+        {
+            expired[i].cb(expired[i].msg_id, MQTT_PUB_FAILED, (uint32_t)((now - expired[i].start_us) / 1000), expired[i].ctx);
+        }
+    }
+    return slot;
+}
+
+// 统计并回调（在锁外调用）
+static void mqtt_pub_finish(const mqtt_pub_slot_t *done, int msg_id, mqtt_pub_result_t result)
+{
+    uint32_t latency_ms = (uint32_t)((esp_timer_get_time() - done->start_us) / 1000);
+    mqtt_stats_complete(result, latency_ms);
+    if (done->cb)
+    {
+        done->cb(msg_id, result, latency_ms, done->ctx);
+    }
+}
+
+// 入队后填上消息 ID；入队失败（msg_id < 0）时释放。
+// 如果确认已经先到了，直接在这里完成（在发起发布的任务中回调）
+static void mqtt_pub_bind(int slot, int msg_id)
+{
+    mqtt_pub_slot_t done = {0};
+    mqtt_pub_result_t result = MQTT_PUB_ACKED;
+
+    portENTER_CRITICAL(&s_pub_lock);
+    s_pub_reserved--;
+    if (msg_id > 0)
+    {
+        s_pub_slots[slot].msg_id = msg_id;
+        for (int i = 0; i < MQTT_PUB_INFLIGHT_MAX; i++)
+        {
+            if (s_pub_early[i].msg_id == msg_id)
+            {
+                result = s_pub_early[i].result;
+                s_pub_early[i].msg_id = 0;
+                done = s_pub_slots[slot];
+                s_pub_slots[slot].msg_id = 0;
+                s_pub_inflight--;
+                break;
+            }
+        }
+    }
+    else
+    {
+        s_pub_slots[slot].msg_id = 0;
+        s_pub_inflight--;
+    }
+    // 没有正在入队的消息时，剩下的提前确认都不属于异步发布（同步发布、重启后重放的消息）
+    if (s_pub_reserved == 0)
+    {
+        memset(s_pub_early, 0, sizeof(s_pub_early));
+    }
+    portEXIT_CRITICAL(&s_pub_lock);
+
+    if (done.msg_id > 0)
+    {
+        mqtt_pub_finish(&done, msg_id, result);
+    }
+}
+
+// 取出 msg_id 对应的跟踪项并回调（在 MQTT 任务中调用）；
+// 找不到而又有消息正在入队时，先记下结果留给 mqtt_pub_bind
+static void mqtt_pub_complete(int msg_id, mqtt_pub_result_t result)
+{
+    mqtt_pub_slot_t done = {0};
+
+    if (msg_id <= 0)
+    {
+        return;
+    }
+
+    portENTER_CRITICAL(&s_pub_lock);
+    for (int i = 0; i < MQTT_PUB_INFLIGHT_MAX; i++)
+    {
+        if (s_pub_slots[i].msg_id == msg_id)
+        {
+            done = s_pub_slots[i];
+            s_pub_slots[i].msg_id = 0;
+            s_pub_inflight--;
+            break;
+        }
+    }
+    if (done.msg_id <= 0 && s_pub_reserved > 0)
+    {
+        s_pub_early[s_pub_early_next].msg_id = msg_id;
+        s_pub_early[s_pub_early_next].result = result;
+        s_pub_early_next = (s_pub_early_next + 1) % MQTT_PUB_INFLIGHT_MAX;
+    }
+    portEXIT_CRITICAL(&s_pub_lock);
+
+    if (done.msg_id > 0)
+    {
+        mqtt_pub_finish(&done, msg_id, result);
+    }
+}
+
+esp_err_t mqtt_app_publish_async(const char *topic, const char *payload, size_t len, int qos, bool retain,
+                                 mqtt_pub_cb_t cb, void *ctx, int *handle)
+{
+    if (handle)
+    {
+        *handle = 0;
+    }
+    if (!s_mqtt_client || !topic || !payload || qos < 0 || qos > 2)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_is_connected)
+    {
+        mqtt_stats_publish(ESP_ERR_INVALID_STATE, len);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // QoS0 没有确认，不占跟踪项
+    int slot = -1;
+    if (qos > 0)
+    {
+        slot = mqtt_pub_reserve(cb, ctx);
+        if (slot < 0)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    // 只复制进 outbox，不写 socket；但 MQTT 任务可能在这里返回前就发出并收到确认，
+    // 这种情况由 mqtt_pub_complete / mqtt_pub_bind 配合处理
+    int msg_id = esp_mqtt_client_enqueue(s_mqtt_client, topic, payload, (int)len, qos, retain, true);
+    if (slot >= 0)
+    {
+        mqtt_pub_bind(slot, msg_id);
+    }
+    if (msg_id < 0)
+    {
+        ESP_LOGE(TAG, "Failed to enqueue message");
+        return ESP_FAIL;
+    }
+
+    TRACE_EVENT(MQTT, TRACE_DEBUG, TRACE_EV_MQTT_TX, payload, len);
+    mqtt_stats_publish(ESP_OK, len);
+    if (handle)
+    {
+        *handle = msg_id;
+    }
     return ESP_OK;
 }
 
+uint32_t mqtt_app_inflight(void)
+{
+    portENTER_CRITICAL(&s_pub_lock);
+    uint32_t inflight = s_pub_inflight;
+    portEXIT_CRITICAL(&s_pub_lock);
+    return inflight;
+}
+
 esp_err_t mqtt_app_subscribe(const char *topic, int qos)
 {
     if (!s_mqtt_client || !topic)
@@ -164,4 +485,74 @@ bool mqtt_is_connected(void)
 void mqtt_register_data_cb(mqtt_data_cb_t cb)
 {
     s_data_cb = cb;
-}
\ No newline at end of file
+}
+
+// ========================
+// 统计快照
+// ========================
+
+void mqtt_app_get_stats(mqtt_stats_t *stats)
+{
+    if (!stats)
+    {
+        return;
+    }
+
+    int64_t now = esp_timer_get_time();
+    uint32_t inflight = mqtt_app_inflight();
+
+    portENTER_CRITICAL(&s_stats_lock);
+    *stats = s_stats;
+    if (s_stats.connected)
+    {
+        stats->connected_ms += (uint32_t)((now - s_connected_since_us) / 1000);
+    }
+    stats->latency_avg_ms = s_stats.acked ? (uint32_t)(s_latency_sum_ms / s_stats.acked) : 0;
+    portEXIT_CRITICAL(&s_stats_lock);
+
+    stats->inflight = inflight;
+}
+
+size_t mqtt_app_stats_json(char *buf, size_t cap)
+{
+    mqtt_stats_t st;
+    mqtt_outbox_stats_t outbox;
+    mqtt_app_get_stats(&st);
+    mqtt_outbox_get_stats(&outbox);
+
+    int32_t hist[MQTT_LATENCY_BUCKETS];
+    for (int i = 0; i < MQTT_LATENCY_BUCKETS; i++)
+    {
+        hist[i] = (int32_t)st.latency_hist[i];
+    }
+
+    json_writer_t w;
+    json_writer_init(&w, buf, cap);
+    json_writer_begin_object(&w);
+    json_writer_kv_bool(&w, "connected", st.connected);
+    json_writer_kv_int(&w, "connected_s", st.connected_ms / 1000);
+    json_writer_kv_int(&w, "reconnects", st.reconnects);
+    json_writer_kv_int(&w, "published", st.published);
+    json_writer_kv_int(&w, "acked", st.acked);
+    json_writer_kv_int(&w, "failed", st.failed);
+    json_writer_kv_int(&w, "dropped", st.dropped);
+    json_writer_kv_int(&w, "inflight", st.inflight);
+    json_writer_kv_int(&w, "received", st.received);
+    json_writer_kv_int(&w, "tx_bytes", (int64_t)st.bytes_sent);
+    json_writer_kv_int(&w, "rx_bytes", (int64_t)st.bytes_received);
+    json_writer_kv_int(&w, "lat_min_ms", st.latency_min_ms);
+    json_writer_kv_int(&w, "lat_avg_ms", st.latency_avg_ms);
+    json_writer_kv_int(&w, "lat_max_ms", st.latency_max_ms);
+    json_writer_key(&w, "lat_hist");
+    json_writer_int32_array(&w, hist, MQTT_LATENCY_BUCKETS);
+    json_writer_key(&w, "outbox");
+    json_writer_begin_object(&w);
+    json_writer_kv_int(&w, "depth", outbox.depth);
+    json_writer_kv_int(&w, "bytes", outbox.bytes);
+    json_writer_kv_int(&w, "flash_bytes", outbox.flash_bytes);
+    json_writer_kv_int(&w, "evicted", outbox.evicted);
+    json_writer_kv_int(&w, "del_dropped", outbox.del_dropped);
+    json_writer_end_object(&w);
+    json_writer_end_object(&w);
+    return json_writer_finish(&w);
+}
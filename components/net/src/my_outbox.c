@@ -0,0 +1,935 @@
+#include "mqtt_outbox.h"
+#include "my_outbox.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_partition.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/queue.h>
+
+static const char *TAG = "MY_OUTBOX";
+
+// 攒够这么多字节的待写消息就写一次 flash
+#define OUTBOX_BATCH_BYTES 2048
+
+// 待写消息最多在内存中停留的时间，超过后即使不满一批也写入（断电时最多丢失这段时间内未确认的消息）
+#define OUTBOX_FLUSH_MS 500
+
+// 单条消息的最大长度，更大的消息只留在内存（与 mqtt_app_init 中的 buffer.size 一致）
+#define OUTBOX_RECORD_MAX 2048
+
+// 写缓冲区大小：一批之外再留一条最长记录的余量
+#define OUTBOX_WBUF_BYTES (OUTBOX_BATCH_BYTES + sizeof(outbox_rec_t) + OUTBOX_RECORD_MAX)
+
+// 一批中最多的删除记录数，攒到一半时在 MQTT 任务里写一次 flash；其他任务删除的消息只能等 MQTT 任务来写，
+// 这期间删除记录满了就丢掉多出的并计数（对应的消息重启后会重发一次，QoS1/2 允许）
+#define OUTBOX_DEL_MAX 32
+#define OUTBOX_DEL_FLUSH (OUTBOX_DEL_MAX / 2)
+
+// flash 扇区头魔数（"MOB1"），扇区头之后依次存放记录
+#define OUTBOX_SECTOR_MAGIC 0x31424F4D
+
+// 记录类型；len 为全 1 表示扇区中后面没有记录（flash 擦除后的状态）
+#define OUTBOX_REC_PUBLISH 0x50 // 一条消息，数据为完整的 PUBLISH 报文
+#define OUTBOX_REC_DELETE 0x44  // 删除一条消息，数据为被删消息的 flash 地址
+#define OUTBOX_REC_CLEAR 0x43   // 删除之前的所有消息
+#define OUTBOX_LEN_NONE 0xFFFF
+
+// 不在 flash 中
+#define OUTBOX_ADDR_NONE UINT32_MAX
+
+// esp-mqtt 的 MQTT_MSG_TYPE_PUBLISH（mqtt_msg.h）
+#define OUTBOX_MSG_TYPE_PUBLISH 3
+
+// 记录按 4 字节对齐存放
+#define OUTBOX_ALIGN(n) (((n) + 3) & ~(size_t)3)
+
+// 记录头：整批一次写入，写到一半断电时靠校验和发现不完整的记录
+typedef struct
+{
+    uint16_t len;    // 数据长度
+    uint8_t kind;    // OUTBOX_REC_*
+    uint8_t qos;
+    uint16_t msg_id;
+    uint16_t sum;    // 头和数据的校验和
+} outbox_rec_t;
+
+// flash 扇区头：seq 每启用一个新扇区加 1，上电时据此找出最早和最新的扇区
+typedef struct
+{
+    uint32_t magic;
+    uint32_t seq;
+} outbox_sector_t;
+
+// 内存索引：每条消息一项；数据在内存（data）或 flash（addr）中，写入 flash 后释放内存
+typedef struct outbox_item
+{
+    STAILQ_ENTRY(outbox_item) next;
+    uint8_t *data;
+    uint32_t addr;
+    int len;
+    int msg_id;
+    int msg_type;
+    int msg_qos;
+    outbox_tick_t tick;
+    pending_state_t pending;
+    bool persist;     // QoS1/2 的 PUBLISH，需要写入 flash
+    bool replayed;    // 上电时从 flash 重放的消息
+    uint16_t rec_id;  // flash 记录中的消息 ID，删除记录按它和地址匹配
+    uint16_t id_off;  // 报文标识符在 PUBLISH 报文中的位置，与 msg_id 不同时读出后改写
+} outbox_item_t;
+
+STAILQ_HEAD(outbox_list_t, outbox_item);
+
+// 只有一个 MQTT 客户端，outbox 用静态实例；esp-mqtt 调用 outbox_* 时已持有客户端锁
+static struct outbox_list_t s_list = STAILQ_HEAD_INITIALIZER(s_list);
+static bool s_inited = false;
+static uint32_t s_count = 0;        // 消息数
+static uint32_t s_bytes = 0;        // 所有消息的字节数
+static uint32_t s_flash_bytes = 0;  // 已写入 flash 的消息字节数
+static uint32_t s_batch_bytes = 0;  // 待写入 flash 的消息字节数
+static int64_t s_batch_since = 0;   // 最早一条待写消息的时间（毫秒）
+
+// 待写的删除记录
+static uint32_t s_dels[OUTBOX_DEL_MAX];
+static uint16_t s_del_ids[OUTBOX_DEL_MAX];
+static uint32_t s_del_count = 0;
+static bool s_clear_pending = false;
+
+// MQTT 任务（每轮循环调用 outbox_dequeue），只有它可以写 flash
+static TaskHandle_t s_mqtt_task = NULL;
+
+// flash 环
+static const esp_partition_t *s_part = NULL;
+static uint32_t s_sector_size = 0;
+static uint32_t s_sectors = 0;
+static uint32_t s_seq = 0;    // 写指针所在扇区的序号
+static uint32_t s_wr_sec = 0; // 写指针
+static uint32_t s_wr_off = 0;
+
+// 写缓冲区（一批记录拼在一起写入）和读缓冲区（重发 flash 中的消息时读出）
+static uint8_t *s_wbuf = NULL;
+static uint32_t s_wbuf_len = 0;
+static uint32_t s_wbuf_addr = 0;
+static uint8_t *s_rbuf = NULL;
+
+// 给重放的消息重新分配 ID，从大往小取，避开正在使用的
+static uint16_t s_next_id = UINT16_MAX;
+
+// 统计，其他任务读取时加锁
+static mqtt_outbox_stats_t s_stats;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static int64_t outbox_now_ms(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+static void outbox_update_stats(uint32_t replayed, uint32_t flushes, uint32_t evicted, uint32_t del_dropped)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_stats.depth = s_count;
+    s_stats.bytes = s_bytes;
+    s_stats.flash_bytes = s_flash_bytes;
+    s_stats.replayed += replayed;
+    s_stats.flushes += flushes;
+    s_stats.evicted += evicted;
+    s_stats.del_dropped += del_dropped;
+    s_stats.flash = (s_part != NULL);
+    portEXIT_CRITICAL(&s_lock);
+}
+
+// 从索引中移除并释放（不写删除记录）
+static void outbox_item_free(outbox_item_t *item)
+{
+    STAILQ_REMOVE(&s_list, item, outbox_item, next);
+    s_count--;
+    s_bytes -= (uint32_t)item->len;
+    if (item->addr != OUTBOX_ADDR_NONE)
+    {
+        s_flash_bytes -= (uint32_t)item->len;
+    }
+    else if (item->persist && s_part)
+    {
+        s_batch_bytes -= (uint32_t)item->len;
+    }
+    free(item->data);
+    free(item);
+}
+
+static void outbox_item_free_all(void)
+{
+    outbox_item_t *it, *tmp;
+    STAILQ_FOREACH_SAFE(it, &s_list, next, tmp)
+    {
+        outbox_item_free(it);
+    }
+}
+
+// ========================
+// flash 环
+// ========================
+
+static uint32_t outbox_sector_addr(uint32_t sec)
+{
+    return sec * s_sector_size;
+}
+
+static uint16_t outbox_checksum(const outbox_rec_t *rec, const uint8_t *data)
+{
+    uint32_t sum = rec->len + rec->kind + rec->qos + rec->msg_id;
+    for (uint16_t i = 0; i < rec->len; i++)
+    {
+        sum = (sum << 1 | sum >> 15) + data[i];
+    }
+    return (uint16_t)(sum ^ (sum >> 16));
+}
+
+// 启用下一个扇区作为写扇区；扇区里还有未确认的消息时一起丢弃（淘汰最旧）
+static esp_err_t outbox_next_sector(void)
+{
+    uint32_t next = (s_wr_sec + 1) % s_sectors;
+    uint32_t start = outbox_sector_addr(next);
+    uint32_t evicted = 0;
+
+    outbox_item_t *it, *tmp;
+    STAILQ_FOREACH_SAFE(it, &s_list, next, tmp)
+    {
+        if (it->addr != OUTBOX_ADDR_NONE && it->addr >= start && it->addr < start + s_sector_size)
+        {
+            outbox_item_free(it);
+            evicted++;
+        }
+    }
+    if (evicted > 0)
+    {
+        ESP_LOGW(TAG, "Outbox flash full, %u oldest messages evicted", (unsigned)evicted);
+        outbox_update_stats(0, 0, evicted, 0);
+    }
+
+    esp_err_t err = esp_partition_erase_range(s_part, start, s_sector_size);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    outbox_sector_t sector = {.magic = OUTBOX_SECTOR_MAGIC, .seq = s_seq + 1};
+    err = esp_partition_write(s_part, start, &sector, sizeof(sector));
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    s_seq = sector.seq;
+    s_wr_sec = next;
+    s_wr_off = sizeof(outbox_sector_t);
+    return ESP_OK;
+}
+
+// 把写缓冲区写入 flash；失败时把这批中的消息退回内存，下次再写
+static esp_err_t outbox_wbuf_write(void)
+{
+    if (s_wbuf_len == 0)
+    {
+        return ESP_OK;
+    }
+
+    uint32_t start = s_wbuf_addr;
+    uint32_t end = s_wbuf_addr + s_wbuf_len;
+    esp_err_t err = esp_partition_write(s_part, start, s_wbuf, s_wbuf_len);
+    s_wbuf_len = 0;
+
+    // 失败的区域可能写了一半，不再使用，从下一个扇区重新开始
+    s_wr_off = (err == ESP_OK) ? end - outbox_sector_addr(s_wr_sec) : s_sector_size;
+
+    outbox_item_t *it;
+    STAILQ_FOREACH(it, &s_list, next)
+    {
+        if (it->data && it->addr != OUTBOX_ADDR_NONE && it->addr >= start && it->addr < end)
+        {
+            if (err == ESP_OK)
+            {
+                free(it->data);
+                it->data = NULL;
+                s_flash_bytes += (uint32_t)it->len;
+                s_batch_bytes -= (uint32_t)it->len;
+            }
+            else
+            {
+                it->addr = OUTBOX_ADDR_NONE;
+            }
+        }
+    }
+    return err;
+}
+
+// 往写缓冲区追加一条记录，返回数据在 flash 中的地址
+static esp_err_t outbox_wbuf_append(uint8_t kind, uint8_t qos, uint16_t msg_id, const void *data, uint16_t len, uint32_t *addr)
+{
+    size_t size = OUTBOX_ALIGN(sizeof(outbox_rec_t) + len);
+    esp_err_t err;
+
+    if (s_wr_off + s_wbuf_len + size > s_sector_size)
+    {
+        err = outbox_wbuf_write();
+        if (err == ESP_OK)
+        {
+            err = outbox_next_sector();
+        }
+        if (err != ESP_OK)
+        {
+            return err;
+        }
+    }
+    else if (s_wbuf_len + size > OUTBOX_WBUF_BYTES)
+    {
+        err = outbox_wbuf_write();
+        if (err != ESP_OK)
+        {
+            return err;
+        }
+    }
+
+    if (s_wbuf_len == 0)
+    {
+        s_wbuf_addr = outbox_sector_addr(s_wr_sec) + s_wr_off;
+    }
+
+    outbox_rec_t *rec = (outbox_rec_t *)&s_wbuf[s_wbuf_len];
+    rec->len = len;
+    rec->kind = kind;
+    rec->qos = qos;
+    rec->msg_id = msg_id;
+    if (len > 0)
+    {
+        memcpy(rec + 1, data, len);
+    }
+    memset((uint8_t *)(rec + 1) + len, 0xFF, size - sizeof(*rec) - len);
+    rec->sum = outbox_checksum(rec, (const uint8_t *)(rec + 1));
+
+    if (addr)
+    {
+        *addr = s_wbuf_addr + s_wbuf_len + sizeof(*rec);
+    }
+    s_wbuf_len += size;
+    return ESP_OK;
+}
+
+// 一次写入：先写清空和删除记录（它们只针对更早的记录），再写待写的消息
+static void outbox_flush(void)
+{
+    if (!s_part || (s_batch_bytes == 0 && s_del_count == 0 && !s_clear_pending))
+    {
+        return;
+    }
+
+    esp_err_t err = ESP_OK;
+    if (s_clear_pending)
+    {
+        err = outbox_wbuf_append(OUTBOX_REC_CLEAR, 0, 0, NULL, 0, NULL);
+        s_clear_pending = (err != ESP_OK);
+    }
+    for (uint32_t i = 0; i < s_del_count && err == ESP_OK; i++)
+    {
+        err = outbox_wbuf_append(OUTBOX_REC_DELETE, 0, s_del_ids[i], &s_dels[i], sizeof(s_dels[i]), NULL);
+    }
+    if (err == ESP_OK)
+    {
+        s_del_count = 0;
+    }
+
+    outbox_item_t *it;
+    STAILQ_FOREACH(it, &s_list, next)
+    {
+        if (err != ESP_OK)
+        {
+            break;
+        }
+        if (it->persist && it->data && it->addr == OUTBOX_ADDR_NONE)
+        {
+            it->rec_id = (uint16_t)it->msg_id;
+            err = outbox_wbuf_append(OUTBOX_REC_PUBLISH, (uint8_t)it->msg_qos, (uint16_t)it->msg_id,
+                                     it->data, (uint16_t)it->len, &it->addr);
+        }
+    }
+    if (err == ESP_OK)
+    {
+        err = outbox_wbuf_write();
+    }
+    else
+    {
+        // 写缓冲区中已分配地址的消息退回内存
+        s_wbuf_len = 0;
+        STAILQ_FOREACH(it, &s_list, next)
+        {
+            if (it->data)
+            {
+                it->addr = OUTBOX_ADDR_NONE;
+            }
+        }
+    }
+
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Outbox flash write failed: %s", esp_err_to_name(err));
+    }
+    s_batch_since = outbox_now_ms();
+    outbox_update_stats(0, 1, 0, 0);
+}
+
+// 攒够一批或等得太久时写入；擦写 flash 耗时，只在 MQTT 任务里调用（outbox_dequeue、过期检查和
+// 收到确认后的 outbox_delete_item），不在发布任务调用的 outbox_enqueue / outbox_delete_item 里写
+static void outbox_flush_if_due(void)
+{
+    if ((s_batch_bytes > 0 || s_del_count > 0 || s_clear_pending) &&
+        (s_batch_bytes >= OUTBOX_BATCH_BYTES || s_del_count >= OUTBOX_DEL_FLUSH ||
+         outbox_now_ms() - s_batch_since >= OUTBOX_FLUSH_MS))
+    {
+        outbox_flush();
+    }
+}
+
+// ========================
+// 重放消息的 ID
+// esp-mqtt 的消息 ID 是随机的，重放的消息还带着上次运行时的 ID，可能和本次新发的消息相同，
+// 确认和删除时就会找错消息；相同时把重放的那条换成一个空闲的 ID
+// ========================
+
+// PUBLISH 报文中报文标识符的位置：固定头、剩余长度（1~4 字节）、主题（2 字节长度 + 内容）之后；失败返回 0
+static uint16_t outbox_publish_id_off(const uint8_t *data, int len)
+{
+    int off = 1;
+    while (off < len && off <= 4 && (data[off] & 0x80))
+    {
+        off++;
+    }
+    off++;
+    if (off + 2 > len)
+    {
+        return 0;
+    }
+    off += 2 + ((data[off] << 8) | data[off + 1]);
+    return (off + 2 <= len) ? (uint16_t)off : 0;
+}
+
+static bool outbox_id_in_use(int msg_id, const outbox_item_t *except)
+{
+    outbox_item_t *it;
+    STAILQ_FOREACH(it, &s_list, next)
+    {
+        if (it != except && it->msg_id == msg_id)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 换一个空闲的 ID；已发出的改回待发，用新 ID 重发（QoS1/2 允许重复）
+static void outbox_renumber(outbox_item_t *item)
+{
+    if (item->id_off == 0)
+    {
+        return;
+    }
+
+    int old_id = item->msg_id;
+    for (uint32_t i = 0; i < UINT16_MAX; i++)
+    {
+        uint16_t id = s_next_id--;
+        if (s_next_id == 0)
+        {
+            s_next_id = UINT16_MAX;
+        }
+        if (!outbox_id_in_use(id, item))
+        {
+            item->msg_id = id;
+            item->pending = QUEUED;
+            ESP_LOGD(TAG, "Replayed message %d renumbered to %d", old_id, id);
+            return;
+        }
+    }
+}
+
+// 新消息入队时，和它 ID 相同的重放消息换 ID
+static void outbox_resolve_id_clash(const outbox_item_t *item)
+{
+    outbox_item_t *it;
+    STAILQ_FOREACH(it, &s_list, next)
+    {
+        if (it != item && it->replayed && it->msg_id == item->msg_id)
+        {
+            outbox_renumber(it);
+        }
+    }
+}
+
+// ========================
+// 上电重放
+// ========================
+
+// 逐条处理扇区中的记录：消息加入索引，删除记录移除对应的消息；遇到空位置或校验失败时停止
+static void outbox_replay_sector(uint32_t sec, outbox_tick_t tick, uint32_t *replayed)
+{
+    uint32_t off = sizeof(outbox_sector_t);
+
+    while (off + sizeof(outbox_rec_t) <= s_sector_size)
+    {
+        uint32_t addr = outbox_sector_addr(sec) + off;
+        outbox_rec_t rec;
+        if (esp_partition_read(s_part, addr, &rec, sizeof(rec)) != ESP_OK || rec.len == OUTBOX_LEN_NONE ||
+            rec.len > OUTBOX_RECORD_MAX || off + OUTBOX_ALIGN(sizeof(rec) + rec.len) > s_sector_size ||
+            esp_partition_read(s_part, addr + sizeof(rec), s_rbuf, rec.len) != ESP_OK ||
+            outbox_checksum(&rec, s_rbuf) != rec.sum)
+        {
+            break;
+        }
+        off += OUTBOX_ALIGN(sizeof(rec) + rec.len);
+
+        outbox_item_t *it, *tmp;
+        if (rec.kind == OUTBOX_REC_PUBLISH && rec.len > 0)
+        {
+            outbox_item_t *item = calloc(1, sizeof(outbox_item_t));
+            if (!item)
+            {
+                continue;
+            }
+            item->addr = addr + sizeof(rec);
+            item->len = rec.len;
+            item->msg_id = rec.msg_id;
+            item->msg_type = OUTBOX_MSG_TYPE_PUBLISH;
+            item->msg_qos = rec.qos;
+            item->tick = tick;
+            item->pending = QUEUED;
+            item->persist = true;
+            item->replayed = true;
+            item->rec_id = rec.msg_id;
+            item->id_off = outbox_publish_id_off(s_rbuf, rec.len);
+            // 上次运行中先后用过同一个 ID 的两条消息
+            if (outbox_id_in_use(item->msg_id, NULL))
+            {
+                outbox_renumber(item);
+            }
+            STAILQ_INSERT_TAIL(&s_list, item, next);
+            s_count++;
+            s_bytes += rec.len;
+            s_flash_bytes += rec.len;
+            (*replayed)++;
+        }
+        else if (rec.kind == OUTBOX_REC_DELETE && rec.len == sizeof(uint32_t))
+        {
+            uint32_t target;
+            memcpy(&target, s_rbuf, sizeof(target));
+            STAILQ_FOREACH_SAFE(it, &s_list, next, tmp)
+            {
+                if (it->addr == target && it->rec_id == rec.msg_id)
+                {
+                    outbox_item_free(it);
+                    (*replayed)--;
+                    break;
+                }
+            }
+        }
+        else if (rec.kind == OUTBOX_REC_CLEAR)
+        {
+            outbox_item_free_all();
+            *replayed = 0;
+        }
+    }
+}
+
+// 按序号找出最早的扇区，沿环往后重放，然后在最新扇区之后启用一个新扇区写入
+// （最新扇区的末尾可能有断电时写了一半的数据，不再往里追加）
+static esp_err_t outbox_recover(uint32_t *replayed)
+{
+    uint32_t oldest = UINT32_MAX, newest = UINT32_MAX;
+    uint32_t oldest_seq = 0, newest_seq = 0;
+
+    for (uint32_t sec = 0; sec < s_sectors; sec++)
+    {
+        outbox_sector_t sector;
+        if (esp_partition_read(s_part, outbox_sector_addr(sec), &sector, sizeof(sector)) != ESP_OK ||
+            sector.magic != OUTBOX_SECTOR_MAGIC)
+        {
+            continue;
+        }
+        if (oldest == UINT32_MAX || sector.seq < oldest_seq)
+        {
+            oldest = sec;
+            oldest_seq = sector.seq;
+        }
+        if (newest == UINT32_MAX || sector.seq > newest_seq)
+        {
+            newest = sec;
+            newest_seq = sector.seq;
+        }
+    }
+
+    *replayed = 0;
+    if (oldest == UINT32_MAX)
+    {
+        // 全新的分区
+        s_seq = 0;
+        s_wr_sec = s_sectors - 1;
+        return outbox_next_sector();
+    }
+
+    // 序号必须连续，断开处之后的是更早以前留下的旧扇区
+    outbox_tick_t tick = outbox_now_ms();
+    uint32_t sec = oldest;
+    uint32_t seq = oldest_seq;
+    for (uint32_t i = 0; i < s_sectors; i++)
+    {
+        outbox_sector_t sector;
+        if (esp_partition_read(s_part, outbox_sector_addr(sec), &sector, sizeof(sector)) != ESP_OK ||
+            sector.magic != OUTBOX_SECTOR_MAGIC || sector.seq != seq)
+        {
+            break;
+        }
+
+        outbox_replay_sector(sec, tick, replayed);
+        newest = sec;
+        newest_seq = seq;
+        sec = (sec + 1) % s_sectors;
+        seq++;
+    }
+
+    s_seq = newest_seq;
+    s_wr_sec = newest;
+    return outbox_next_sector();
+}
+
+// ========================
+// esp-mqtt outbox 接口（mqtt_outbox.h）
+// ========================
+
+outbox_t outbox_init(void)
+{
+    if (s_inited)
+    {
+        ESP_LOGE(TAG, "Only one MQTT client is supported");
+        return NULL;
+    }
+
+    s_wbuf = malloc(OUTBOX_WBUF_BYTES);
+    s_rbuf = malloc(OUTBOX_RECORD_MAX);
+    if (!s_wbuf || !s_rbuf)
+    {
+        free(s_wbuf);
+        free(s_rbuf);
+        s_wbuf = NULL;
+        s_rbuf = NULL;
+        return NULL;
+    }
+    s_inited = true;
+    s_batch_since = outbox_now_ms();
+
+    uint32_t replayed = 0;
+    s_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, MQTT_OUTBOX_PARTITION_LABEL);
+    if (!s_part)
+    {
+        ESP_LOGW(TAG, "Partition '%s' not found, outbox kept in RAM only", MQTT_OUTBOX_PARTITION_LABEL);
+    }
+    else
+    {
+        s_sector_size = s_part->erase_size;
+        s_sectors = s_part->size / s_sector_size;
+        esp_err_t err = ESP_ERR_INVALID_SIZE;
+        if (s_sectors >= 2 &&
+            s_sector_size >= sizeof(outbox_sector_t) + OUTBOX_ALIGN(sizeof(outbox_rec_t) + OUTBOX_RECORD_MAX))
+        {
+            err = outbox_recover(&replayed);
+        }
+        if (err != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Outbox flash init failed: %s", esp_err_to_name(err));
+            outbox_item_free_all();
+            s_part = NULL;
+            replayed = 0;
+        }
+        else
+        {
+            ESP_LOGI(TAG, "Outbox flash: %u x %u bytes, %u messages (%u bytes) replayed",
+                     (unsigned)s_sectors, (unsigned)s_sector_size, (unsigned)replayed, (unsigned)s_bytes);
+        }
+    }
+
+    outbox_update_stats(replayed, 0, 0, 0);
+    return (outbox_t)&s_list;
+}
+
+outbox_item_handle_t outbox_enqueue(outbox_t outbox, outbox_message_handle_t message, outbox_tick_t tick)
+{
+    outbox_item_t *item = calloc(1, sizeof(outbox_item_t));
+    if (!item)
+    {
+        return NULL;
+    }
+
+    item->len = message->len + message->remaining_len;
+    item->data = malloc((size_t)item->len);
+    if (!item->data)
+    {
+        free(item);
+        return NULL;
+    }
+    memcpy(item->data, message->data, (size_t)message->len);
+    if (message->remaining_data)
+    {
+        memcpy(item->data + message->len, message->remaining_data, (size_t)message->remaining_len);
+    }
+
+    item->addr = OUTBOX_ADDR_NONE;
+    item->msg_id = message->msg_id;
+    item->rec_id = (uint16_t)message->msg_id;
+    item->msg_type = message->msg_type;
+    item->msg_qos = message->msg_qos;
+    item->tick = tick;
+    item->pending = QUEUED;
+    item->persist = (message->msg_type == OUTBOX_MSG_TYPE_PUBLISH && message->msg_qos > 0 &&
+                     item->len <= OUTBOX_RECORD_MAX);
+    STAILQ_INSERT_TAIL(&s_list, item, next);
+    s_count++;
+    s_bytes += (uint32_t)item->len;
+    outbox_resolve_id_clash(item);
+
+    if (item->persist && s_part)
+    {
+        if (s_batch_bytes == 0)
+        {
+            s_batch_since = outbox_now_ms();
+        }
+        s_batch_bytes += (uint32_t)item->len;
+    }
+    outbox_update_stats(0, 0, 0, 0);
+    return item;
+}
+
+outbox_item_handle_t outbox_get(outbox_t outbox, int msg_id)
+{
+    outbox_item_t *it;
+    STAILQ_FOREACH(it, &s_list, next)
+    {
+        if (it->msg_id == msg_id)
+        {
+            return it;
+        }
+    }
+    return NULL;
+}
+
+outbox_item_handle_t outbox_dequeue(outbox_t outbox, pending_state_t pending, outbox_tick_t *tick)
+{
+    // MQTT 任务每轮循环都会调用，顺便检查待写的批次
+    s_mqtt_task = xTaskGetCurrentTaskHandle();
+    outbox_flush_if_due();
+
+    outbox_item_t *it;
+    STAILQ_FOREACH(it, &s_list, next)
+    {
+        if (it->pending == pending)
+        {
+            if (tick)
+            {
+                *tick = it->tick;
+            }
+            return it;
+        }
+    }
+    return NULL;
+}
+
+uint8_t *outbox_item_get_data(outbox_item_handle_t item, size_t *len, uint16_t *msg_id, int *msg_type, int *qos)
+{
+    if (!item)
+    {
+        return NULL;
+    }
+
+    *len = (size_t)item->len;
+    *msg_id = (uint16_t)item->msg_id;
+    *msg_type = item->msg_type;
+    *qos = item->msg_qos;
+    if (item->data)
+    {
+        return item->data;
+    }
+
+    // 已写入 flash：读到共享的读缓冲区（调用方在下一次 outbox 调用前用完）
+    if (esp_partition_read(s_part, item->addr, s_rbuf, (size_t)item->len) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to read message %d from flash", item->msg_id);
+        return NULL;
+    }
+    if (item->msg_id != item->rec_id)
+    {
+        s_rbuf[item->id_off] = (uint8_t)(item->msg_id >> 8);
+        s_rbuf[item->id_off + 1] = (uint8_t)item->msg_id;
+    }
+    return s_rbuf;
+}
+
+esp_err_t outbox_delete_item(outbox_t outbox, outbox_item_handle_t item)
+{
+    outbox_item_t *it;
+    STAILQ_FOREACH(it, &s_list, next)
+    {
+        if (it == item)
+        {
+            break;
+        }
+    }
+    if (!it)
+    {
+        return ESP_FAIL;
+    }
+
+    // 已写入 flash 的消息追加一条删除记录；还没写入的直接丢掉，不占 flash
+    uint32_t dropped = 0;
+    if (it->addr != OUTBOX_ADDR_NONE && s_part)
+    {
+        if (s_del_count >= OUTBOX_DEL_MAX)
+        {
+            dropped = 1;
+            ESP_LOGW(TAG, "Delete record for message %d dropped, it will be resent after reboot", it->msg_id);
+        }
+        else
+        {
+            if (s_batch_bytes == 0 && s_del_count == 0)
+            {
+                s_batch_since = outbox_now_ms();
+            }
+            s_dels[s_del_count] = it->addr;
+            s_del_ids[s_del_count] = it->rec_id;
+            s_del_count++;
+        }
+    }
+    outbox_item_free(it);
+
+    // 一次收到大量确认时 MQTT 任务一直在处理接收，等不到 outbox_dequeue，删除记录攒到一半就在这里写
+    if (s_del_count >= OUTBOX_DEL_FLUSH && s_mqtt_task && xTaskGetCurrentTaskHandle() == s_mqtt_task)
+    {
+        outbox_flush();
+    }
+    outbox_update_stats(0, 0, 0, dropped);
+    return ESP_OK;
+}
+
+esp_err_t outbox_delete(outbox_t outbox, int msg_id, int msg_type)
+{
+    outbox_item_t *it;
+    STAILQ_FOREACH(it, &s_list, next)
+    {
+        if (it->msg_id == msg_id && (0xFF & it->msg_type) == msg_type)
+        {
+            return outbox_delete_item(outbox, it);
+        }
+    }
+    return ESP_FAIL;
+}
+
+int outbox_delete_single_expired(outbox_t outbox, outbox_tick_t current_tick, outbox_tick_t timeout)
+{
+    outbox_flush_if_due();
+
+    outbox_item_t *it;
+    STAILQ_FOREACH(it, &s_list, next)
+    {
+        if (current_tick - it->tick > timeout)
+        {
+            int msg_id = it->msg_id;
+            outbox_delete_item(outbox, it);
+            return msg_id;
+        }
+    }
+    return -1;
+}
+
+int outbox_delete_expired(outbox_t outbox, outbox_tick_t current_tick, outbox_tick_t timeout)
+{
+    int deleted = 0;
+    while (outbox_delete_single_expired(outbox, current_tick, timeout) >= 0)
+    {
+        deleted++;
+    }
+    return deleted;
+}
+
+esp_err_t outbox_set_pending(outbox_t outbox, int msg_id, pending_state_t pending)
+{
+    outbox_item_t *item = outbox_get(outbox, msg_id);
+    if (!item)
+    {
+        return ESP_FAIL;
+    }
+    item->pending = pending;
+    return ESP_OK;
+}
+
+pending_state_t outbox_item_get_pending(outbox_item_handle_t item)
+{
+    return item ? item->pending : QUEUED;
+}
+
+esp_err_t outbox_set_tick(outbox_t outbox, int msg_id, outbox_tick_t tick)
+{
+    outbox_item_t *item = outbox_get(outbox, msg_id);
+    if (!item)
+    {
+        return ESP_FAIL;
+    }
+    item->tick = tick;
+    return ESP_OK;
+}
+
+uint64_t outbox_get_size(outbox_t outbox)
+{
+    return s_bytes;
+}
+
+// 客户端要求丢弃全部消息：写一条清空记录，重启后也不再重放
+void outbox_delete_all_items(outbox_t outbox)
+{
+    outbox_item_free_all();
+    s_del_count = 0;
+    s_clear_pending = (s_part != NULL);
+    s_batch_since = outbox_now_ms();
+    outbox_update_stats(0, 0, 0, 0);
+}
+
+// 客户端销毁：写入待写的批次后释放内存，flash 中的消息留到下次启动重放
+void outbox_destroy(outbox_t outbox)
+{
+    outbox_flush();
+
+    outbox_item_free_all();
+    s_batch_bytes = 0;
+    s_del_count = 0;
+    s_clear_pending = false;
+    free(s_wbuf);
+    free(s_rbuf);
+    s_wbuf = NULL;
+    s_rbuf = NULL;
+    s_part = NULL;
+    s_mqtt_task = NULL;
+    s_inited = false;
+    outbox_update_stats(0, 0, 0, 0);
+}
+
+// ========================
+// 统计
+// ========================
+
+void mqtt_outbox_get_stats(mqtt_outbox_stats_t *stats)
+{
+    if (!stats)
+    {
+        return;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    *stats = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+}
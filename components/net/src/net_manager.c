@@ -1,4 +1,5 @@
 #include "net_manager.h"
+#include "ui_status.h"
 
 #define NET_CB_MAX 4
 
@@ -61,6 +62,8 @@ esp_err_t net_register_disconnected_cb(net_disconnected_cb_t cb)
 
 void net_notify_connected(net_transport_t transport, const char *ip)
 {
+    ui_status_post(UI_EVT_NET_CONNECTED, (uint8_t)transport);
+
     for (int i = 0; i < NET_CB_MAX; i++)
     {
         if (s_connected_cbs[i])
@@ -72,6 +75,8 @@ void net_notify_connected(net_transport_t transport, const char *ip)
 
 void net_notify_disconnected(net_transport_t transport)
 {
+    ui_status_post(UI_EVT_NET_DISCONNECTED, (uint8_t)transport);
+
     for (int i = 0; i < NET_CB_MAX; i++)
     {
         if (s_disconnected_cbs[i])
@@ -0,0 +1,71 @@
+#include "net_time.h"
+#include "esp_sntp.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include <sys/time.h>
+
+static const char *TAG = "net_time";
+
+#define NET_TIME_DEFAULT_SERVER "pool.ntp.org"
+
+static bool s_started = false;
+static bool s_synced = false;
+static int64_t s_offset_us = 0; // UTC 微秒 - esp_timer 微秒
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// 对时完成回调（在 lwIP 任务中执行）：记录 esp_timer 与 UTC 的差值
+static void net_time_sync_cb(struct timeval *tv)
+{
+    int64_t utc_us = (int64_t)tv->tv_sec * 1000000 + tv->tv_usec;
+    int64_t offset = utc_us - esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_lock);
+    s_offset_us = offset;
+    s_synced = true;
+    portEXIT_CRITICAL(&s_lock);
+
+    ESP_LOGI(TAG, "Time synced, epoch %lld s", (long long)tv->tv_sec);
+}
+
+esp_err_t net_time_sync_start(const char *server)
+{
+    if (s_started)
+    {
+        return ESP_OK;
+    }
+
+    esp_sntp_setoperatingmode(ESP_SNTP_OPMODE_POLL);
+    esp_sntp_setservername(0, server ? server : NET_TIME_DEFAULT_SERVER);
+    sntp_set_time_sync_notification_cb(net_time_sync_cb);
+    esp_sntp_init();
+
+    s_started = true;
+    return ESP_OK;
+}
+
+bool net_time_is_synced(void)
+{
+    return s_synced;
+}
+
+esp_err_t net_time_to_epoch_us(int64_t mono_us, int64_t *epoch_us)
+{
+    if (!epoch_us)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    bool synced = s_synced;
+    int64_t offset = s_offset_us;
+    portEXIT_CRITICAL(&s_lock);
+
+    if (!synced)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    *epoch_us = mono_us + offset;
+    return ESP_OK;
+}
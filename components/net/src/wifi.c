@@ -1,5 +1,7 @@
 #include "wifi.h"
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_log.h"
@@ -9,7 +11,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "net_manager.h"
-#include "OLED.h"
+#include "ui_status.h"
 #include "http_server.h"
 
 static const char *TAG = "wifi";
@@ -50,9 +52,7 @@ static void wifi_event_handler(void *arg, esp_event_base_t event_base, int32_t e
         // 6. 启动 HTTP 服务器 用于配网的网页服务
         ESP_ERROR_CHECK(start_webserver());
 
-        OLED_ClearArea(0, 10, 128, 10);
-        OLED_Printf(0, 10, OLED_6X8, "net setting ap started");
-        OLED_Update();
+        ui_status_post(UI_EVT_PROV_AP_STARTED, 0);
 
         s_sta_connected = false;
         s_sta_ip.addr = 0;
@@ -221,6 +221,7 @@ esp_err_t wifi_stop_provisioning_ap(void)
     esp_netif_dhcps_stop(esp_netif_ap);
 
     ESP_LOGI(TAG, "Provisioning AP stopped.");
+    ui_status_post(UI_EVT_PROV_AP_STOPPED, 0);
     return ESP_OK;
 }
 
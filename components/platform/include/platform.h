@@ -2,14 +2,52 @@
 #define __PLATFORM_H__
 
 #include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "mpu6050.h" // FIFO 模式下一次最多取回 MPU6050_FIFO_MAX_SAMPLES 个样本
 
 typedef struct 
 {
+    int64_t ts_us;                   // 采样时刻（esp_timer 微秒，自开机起计）
     short   mpu_ax;                  // 这里最后一定是会用丙酮的数据 这里就用这个去模拟丙酮的数据
+    short   mpu_ay;
+    short   mpu_az;
+    short   mpu_temp;                // 温度原始值
+    short   mpu_gx;
+    short   mpu_gy;
+    short   mpu_gz;
 }SensorData;   // 封装要上报的数据结构
 
+// 采集统计：FIFO 写满说明读 FIFO 的任务被耽搁太久，这段时间的样本已经丢了
+typedef struct
+{
+    uint32_t fifo_overflows; // FIFO 溢出复位的次数
+    uint32_t samples_lost;   // 因此丢弃的样本数（下限）
+} platform_sensor_stats_t;
+
 esp_err_t platform_get_sensor_data(SensorData *data);
 
+// 当前量程：加速度计满量程（g）与陀螺仪满量程（°/s），用于把原始值换算成物理单位
+void platform_sensor_get_range(uint16_t *accel_g, uint16_t *gyro_dps);
+
+// FIFO 批量采集：先开启 FIFO，之后周期性调用 platform_get_sensor_batch 把积压的样本一次取完
+esp_err_t platform_sensor_fifo_start(void);
+esp_err_t platform_sensor_fifo_stop(void);
+esp_err_t platform_get_sensor_batch(SensorData *data, size_t max, size_t *count);
+void platform_sensor_get_stats(platform_sensor_stats_t *stats);
+
+// 数据就绪中断：MPU6050 INT 引脚接 GPIO 中断，每累计 watermark 个新样本给 task 发一次任务通知
+esp_err_t platform_sensor_int_start(TaskHandle_t task, uint16_t watermark);
+esp_err_t platform_sensor_int_stop(void);
+void platform_sensor_set_watermark(uint16_t watermark);
+
+// 运行时修改采样率（4~1000Hz，低通滤波随之调整），不需要重新初始化传感器；FIFO 模式下会清空 FIFO 中旧速率的样本
+// 需要由读取 FIFO 的任务调用，避免与批量读取交错
+esp_err_t platform_sensor_set_rate(uint16_t hz);
+uint16_t platform_sensor_get_rate(void);
+
 
 
-#endif // __PLATFORM_H__
\ No newline at end of file
+#endif // __PLATFORM_H__
@@ -1,9 +1,75 @@
 #ifndef __PLATFORM_I2C_H__
 #define __PLATFORM_I2C_H__
 
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+// 异步事务内联写数据的最大长度（OLED 一次写 128 字节显存 + 1 字节控制字）
+#define PLATFORM_I2C_TX_MAX 132
+
+// 总线上的设备
+typedef enum
+{
+    PLATFORM_I2C_DEV_MPU6050 = 0,
+    PLATFORM_I2C_DEV_OLED,
+    PLATFORM_I2C_DEV_MAX,
+} platform_i2c_dev_t;
+
+// 事务优先级：高优先级队列总是先于低优先级队列被调度
+typedef enum
+{
+    PLATFORM_I2C_PRIO_HIGH = 0, // 传感器读写
+    PLATFORM_I2C_PRIO_LOW,      // 显示刷新等批量写
+} platform_i2c_prio_t;
+
+// 事务完成回调，在总线调度任务中执行，不要在里面做耗时操作
+typedef void (*platform_i2c_done_cb_t)(esp_err_t err, void *arg);
+
+// 异步事务描述符：先写 tx，再读 rx（rx_len 为 0 时只写）
+typedef struct
+{
+    platform_i2c_dev_t dev;
+    uint8_t tx[PLATFORM_I2C_TX_MAX]; // 提交时拷贝进来，提交后调用方的缓冲区可以立即复用
+    size_t tx_len;
+    uint8_t *rx;                     // 读缓冲区，调用方保证在完成回调之前一直有效
+    size_t rx_len;
+    platform_i2c_done_cb_t done_cb;  // 可为 NULL（不关心结果）
+    void *arg;
+} platform_i2c_xfer_t;
+
+// 每个设备的总线占用与错误统计
+typedef struct
+{
+    uint32_t speed_hz;   // 当前 SCL 频率
+    uint32_t xfers;      // 已执行的事务数（含重试）
+    uint64_t bytes;      // 读写的总字节数（不含地址字节）
+    uint64_t busy_us;    // 占用总线的累计时间（微秒）
+    uint32_t errors;     // 重试用尽后仍失败的事务数
+    uint32_t retries;    // 重试次数
+    uint32_t recoveries; // 由该设备的失败触发的总线恢复次数
+} platform_i2c_stats_t;
+
 void platform_i2c_init(void);
 void platform_i2c_mpu6050_is_present(void);
 void platform_driver_register(void);
 void platform_i2c_oled_is_present(void);
 
+// 异步提交：事务排队后立即返回，完成后调用 done_cb；wait 为队列满时最多等待的时间
+esp_err_t platform_i2c_submit(const platform_i2c_xfer_t *xfer, platform_i2c_prio_t prio, TickType_t wait);
+
+// 同步传输：提交后阻塞等待完成，返回 I2C 驱动的结果（调度任务内部已做退避重试，失败即为最终结果）
+esp_err_t platform_i2c_transfer(platform_i2c_dev_t dev, platform_i2c_prio_t prio,
+                                const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len);
+
+// 设置设备的 SCL 频率：在 platform_i2c_init 之前调用则作为初始配置，之后调用则在该设备下一个事务前生效
+esp_err_t platform_i2c_set_speed(platform_i2c_dev_t dev, uint32_t speed_hz);
+
+// 读取设备的总线占用统计快照
+esp_err_t platform_i2c_get_stats(platform_i2c_dev_t dev, platform_i2c_stats_t *stats);
+
+// 打印各设备的总线占用情况（占开机以来总时间的比例）
+void platform_i2c_log_stats(void);
+
 #endif /* __PLATFORM_I2C_H__ */
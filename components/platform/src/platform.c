@@ -1,5 +1,34 @@
 #include "platform.h"
+#include <stdbool.h>
 #include "mpu6050.h" // 假设有这个头文件，包含 MPU6050 相关函数声明 
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+static const char *TAG = "PLATFORM";
+
+#define MPU_INT_PIN GPIO_NUM_40 // MPU6050 INT 引脚接到的 GPIO
+
+static TaskHandle_t s_int_task = NULL;         // 收到中断后要通知的任务
+static uint16_t s_int_watermark = 1;           // 累计多少个数据就绪中断才通知一次
+static volatile uint16_t s_int_count = 0;      // 当前已累计的中断次数
+static int64_t s_int_last_us = 0;              // 最近一次数据就绪中断的时刻，即最新样本的采样时刻
+static uint32_t s_int_total = 0;               // 数据就绪中断的累计次数（不随 watermark 清零）
+static bool s_int_active = false;              // 数据就绪中断是否已启用
+static portMUX_TYPE s_int_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool s_fifo_active = false;             // 是否处于 FIFO 批量采集模式
+static uint32_t s_fifo_lost = 0;               // FIFO 溢出复位时丢弃的样本数（只在读 FIFO 的任务中修改）
+
+static void platform_sample_to_sensor_data(const MPU6050_Sample_t *sample, SensorData *data)
+{
+    data->mpu_ax = sample->ax;
+    data->mpu_ay = sample->ay;
+    data->mpu_az = sample->az;
+    data->mpu_temp = sample->temp;
+    data->mpu_gx = sample->gx;
+    data->mpu_gy = sample->gy;
+    data->mpu_gz = sample->gz;
+}
 
 esp_err_t platform_get_sensor_data(SensorData *data)
 {
@@ -8,12 +37,269 @@ esp_err_t platform_get_sensor_data(SensorData *data)
         return ESP_ERR_INVALID_ARG;
     }
 
-    // 假设有函数 Int_MPU6050_Get_Accel 和 Int_MPU6050_Get_Gyro 用于获取传感器数据
-    short ax, ay, az;
-    Int_MPU6050_Get_Accel(&ax, &ay, &az);
+    // 一次 14 字节突发读出加速度、温度、陀螺仪，时间戳取读之前的时刻
+    // 驱动层返回的就是 I2C 的 esp_err_t，读失败时不写 data，避免把旧数据当新数据
+    MPU6050_Sample_t sample;
+    int64_t ts_us = esp_timer_get_time();
+    esp_err_t err = Int_MPU6050_Get_All(&sample);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    platform_sample_to_sensor_data(&sample, data);
+    data->ts_us = ts_us;
+    return ESP_OK;
+}
+
+
+void platform_sensor_get_range(uint16_t *accel_g, uint16_t *gyro_dps)
+{
+    if (accel_g)
+    {
+        *accel_g = Int_MPU6050_GetAccelRangeG();
+    }
+    if (gyro_dps)
+    {
+        *gyro_dps = Int_MPU6050_GetGyroRangeDps();
+    }
+}
+
+esp_err_t platform_sensor_fifo_start(void)
+{
+    esp_err_t err = Int_MPU6050_FIFO_Enable();
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    s_fifo_active = true;
+    return ESP_OK;
+}
+
+esp_err_t platform_sensor_fifo_stop(void)
+{
+    s_fifo_active = false;
+    return Int_MPU6050_FIFO_Disable();
+}
+
+esp_err_t platform_sensor_set_rate(uint16_t hz)
+{
+    if (hz < 4 || hz > 1000)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err = Int_MPU6050_SetGyroRate(hz);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // FIFO 里剩下的是旧速率的样本，按新周期推算时间戳会错位，直接清掉
+    if (s_fifo_active)
+    {
+        err = Int_MPU6050_FIFO_Enable();
+        if (err != ESP_OK)
+        {
+            return err;
+        }
+    }
+
+    portENTER_CRITICAL(&s_int_lock);
+    s_int_count = 0;
+    portEXIT_CRITICAL(&s_int_lock);
+    return ESP_OK;
+}
+
+uint16_t platform_sensor_get_rate(void)
+{
+    return Int_MPU6050_GetSampleRate();
+}
+
+esp_err_t platform_get_sensor_batch(SensorData *data, size_t max, size_t *count)
+{
+    if (data == NULL || count == NULL || max == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    static MPU6050_Sample_t samples[MPU6050_FIFO_MAX_SAMPLES];
+    *count = 0;
+
+    // 1. 先确定时间基准：读 FIFO 计数的同时记下最近一次数据就绪中断的时刻（没有中断时取读计数的时刻）。
+    //    读计数期间来了新中断时重读，保证计数里最新的那个样本就是 last_us 对应的样本。
+    //    突发读要几十毫秒，期间中断还在继续，读完再取时间就会晚到 FIFO 里更新的样本上
+    uint16_t bytes = 0;
+    int64_t last_us = 0;
+    esp_err_t err = ESP_OK;
+    for (int retry = 0; retry < 3; retry++)
+    {
+        portENTER_CRITICAL(&s_int_lock);
+        uint32_t total = s_int_total;
+        last_us = s_int_last_us;
+        portEXIT_CRITICAL(&s_int_lock);
+
+        int64_t count_us = esp_timer_get_time();
+        err = Int_MPU6050_FIFO_Count(&bytes);
+        if (err != ESP_OK)
+        {
+            return err;
+        }
+        if (!s_int_active)
+        {
+            last_us = count_us;
+            break;
+        }
+
+        portENTER_CRITICAL(&s_int_lock);
+        bool stable = (total == s_int_total);
+        portEXIT_CRITICAL(&s_int_lock);
+        if (stable)
+        {
+            break;
+        }
+    }
+
+    // 2. 只取计数时已在 FIFO 里的样本（最早的 want 个），之后新进来的留到下一次；
+    //    FIFO 写满后样本边界对不齐，复位重新开始，本次没有样本。丢掉的至少是一整个 FIFO 的样本，
+    //    写满之后被覆盖的无从得知，所以丢弃数是下限
+    if (bytes >= MPU6050_FIFO_MAX_BYTES)
+    {
+        s_fifo_lost += MPU6050_FIFO_MAX_SAMPLES;
+        err = Int_MPU6050_FIFO_Recover();
+        ESP_LOGW(TAG, "Sensor FIFO overflow, reset (%u overflows, at least %u samples lost)",
+                 (unsigned)Int_MPU6050_FIFO_GetOverflows(), (unsigned)s_fifo_lost);
+        return err;
+    }
+    uint16_t queued = bytes / MPU6050_FIFO_SAMPLE_SIZE;
+    if (queued == 0)
+    {
+        return ESP_OK;
+    }
+    uint16_t want = (max < queued) ? (uint16_t)max : queued;
+    uint16_t n = 0;
+    err = Int_MPU6050_FIFO_Read(samples, want, &n);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // 3. 计数中最新的样本（第 queued 个）在 last_us 采样，其余按采样周期依次往前推
+    uint16_t rate = Int_MPU6050_GetSampleRate();
+    int64_t period_us = rate ? (1000000 / rate) : 0;
+
+    for (uint16_t i = 0; i < n; i++)
+    {
+        platform_sample_to_sensor_data(&samples[i], &data[i]);
+        data[i].ts_us = last_us - (int64_t)(queued - 1 - i) * period_us;
+    }
+
+    *count = n;
+    return ESP_OK;
+}
+
+void platform_sensor_get_stats(platform_sensor_stats_t *stats)
+{
+    if (stats == NULL)
+    {
+        return;
+    }
+    stats->fifo_overflows = Int_MPU6050_FIFO_GetOverflows();
+    stats->samples_lost = s_fifo_lost;
+}
+
+// MPU6050 每产生一个新样本就在 INT 引脚上输出一个脉冲，这里只计数，攒够 watermark 个再唤醒任务
+static void IRAM_ATTR platform_sensor_isr(void *arg)
+{
+    (void)arg;
+
+    portENTER_CRITICAL_ISR(&s_int_lock);
+    s_int_last_us = esp_timer_get_time();
+    s_int_total++;
+    bool reached = (++s_int_count >= s_int_watermark);
+    if (reached)
+    {
+        s_int_count = 0;
+    }
+    portEXIT_CRITICAL_ISR(&s_int_lock);
+
+    if (!reached)
+    {
+        return;
+    }
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(s_int_task, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+esp_err_t platform_sensor_int_start(TaskHandle_t task, uint16_t watermark)
+{
+    if (task == NULL || watermark == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    s_int_task = task;
+    s_int_watermark = watermark;
+    s_int_count = 0;
+
+    // 1. INT 为高电平有效的短脉冲，GPIO 配成输入 + 上升沿中断
+    gpio_config_t io_conf = {0};
+    io_conf.pin_bit_mask = 1ULL << MPU_INT_PIN;
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.pull_up_en = GPIO_PULLUP_DISABLE;
+    io_conf.pull_down_en = GPIO_PULLDOWN_ENABLE;
+    io_conf.intr_type = GPIO_INTR_POSEDGE;
+    esp_err_t err = gpio_config(&io_conf);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // 2. 安装 GPIO 中断服务（已经安装过会返回 ESP_ERR_INVALID_STATE，可以忽略）
+    err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE)
+    {
+        return err;
+    }
 
-    // 这里只使用 ax 来模拟丙酮的数据，其他数据暂时不使用
-    data->mpu_ax = ax;
+    err = gpio_isr_handler_add(MPU_INT_PIN, platform_sensor_isr, NULL);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // 3. 打开 MPU6050 的数据就绪中断，读一次状态寄存器清掉旧的中断
+    err = Int_MPU6050_INT_Enable(MPU6050_INT_DATA_RDY);
+    if (err != ESP_OK)
+    {
+        gpio_isr_handler_remove(MPU_INT_PIN);
+        return err;
+    }
+    Int_MPU6050_Get_INT_Status();
+    s_int_active = true;
     return ESP_OK;
 }
 
+void platform_sensor_set_watermark(uint16_t watermark)
+{
+    if (watermark == 0)
+    {
+        watermark = 1;
+    }
+
+    portENTER_CRITICAL(&s_int_lock);
+    s_int_watermark = watermark;
+    s_int_count = 0;
+    portEXIT_CRITICAL(&s_int_lock);
+}
+
+esp_err_t platform_sensor_int_stop(void)
+{
+    s_int_active = false;
+    esp_err_t err = Int_MPU6050_INT_Enable(0);
+    gpio_isr_handler_remove(MPU_INT_PIN);
+    s_int_task = NULL;
+    return err;
+}
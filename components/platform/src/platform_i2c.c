@@ -1,8 +1,16 @@
 #include "platform_i2c.h"
 #include "driver/i2c_master.h"
+#include "driver/gpio.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include <assert.h>
 #include <stdbool.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
 #include "mpu6050.h"
 #include "OLED.h"
 
@@ -17,11 +25,122 @@ static const char *TAG = "platform_i2c";
 
 #define DEV_OLED_ADDR 0x3C // OLED的I2C地址
 
-static i2c_master_bus_handle_t bus_handle;      // 这个是I2C总线的句柄
-static i2c_master_dev_handle_t mpu_dev_handle;  // 这个是MPU6050设备的句柄
-static i2c_master_dev_handle_t oled_dev_handle; // 这个是OLED设备的句柄
+// 默认速率：标准模式 100KHz，任何接线都能用；实际速率由板级配置在 platform_i2c_init 之前用 platform_i2c_set_speed 设置
+#define DEV_MPU_SPEED_HZ 100000
+#define DEV_OLED_SPEED_HZ 100000
 
-void platform_i2c_init(void)
+// 允许设置的速率范围
+#define I2C_SPEED_MIN_HZ 10000
+#define I2C_SPEED_MAX_HZ 1000000
+
+// 总线调度任务：优先级高于所有应用任务，保证排队的事务尽快上总线
+#define I2C_TASK_PRIORITY 5
+#define I2C_TASK_STACK_DEPTH 3072
+
+// 高优先级队列（传感器）与低优先级队列（显示）的长度
+// OLED 全屏刷新 8 页，每页 3 条命令 + 1 次数据，共 32 个事务
+#define I2C_QUEUE_LEN_HIGH 8
+#define I2C_QUEUE_LEN_LOW 32
+
+// 失败重试：最多再试 3 次，两次之间等待 1、2、4 个 tick（退避），参数错误不重试
+#define I2C_RETRY_MAX 3
+#define I2C_RETRY_BACKOFF_TICKS 1
+
+// 总线卡死判定：连续这么多个事务在重试后仍失败，且超时或 SDA 被拉低，就做总线恢复
+#define I2C_RECOVER_THRESHOLD 3
+
+// 手动恢复：最多打 9 个 SCL 时钟，让卡在字节中间的从机把剩下的位送完并释放 SDA；半周期 5us 约 100KHz
+#define I2C_RECOVER_SCL_PULSES 9
+#define I2C_RECOVER_HALF_PERIOD_US 5
+
+static i2c_master_bus_handle_t bus_handle;      // 这个是I2C总线的句柄，只有总线调度任务直接使用
+static uint32_t s_fail_streak = 0;              // 总线上连续失败的事务数，任一事务成功即清零，只有调度任务访问
+
+// 每个设备的句柄、速率、超时、统计与同步等待用的信号量
+typedef struct
+{
+    i2c_master_dev_handle_t handle; // 设备句柄
+    uint16_t addr;                  // 7 位设备地址
+    uint32_t speed_hz;              // 当前句柄使用的 SCL 频率，只有总线调度任务修改
+    volatile uint32_t target_hz;    // 期望的 SCL 频率，与 speed_hz 不同时由调度任务重建句柄
+    int timeout_ms;                 // 单次事务超时
+    platform_i2c_stats_t stats;     // 总线占用统计，读写都在 s_stats_lock 保护下
+    const char *name;               // 日志用
+    SemaphoreHandle_t sync_lock;    // 同一设备同一时刻只允许一个同步等待者
+    SemaphoreHandle_t sync_done;    // 同步事务完成信号
+    esp_err_t sync_err;             // 同步事务结果
+} platform_i2c_dev_ctx_t;
+
+static platform_i2c_dev_ctx_t s_devs[PLATFORM_I2C_DEV_MAX] = {
+    [PLATFORM_I2C_DEV_MPU6050] = {.addr = DEV_MPU_ADDR, .target_hz = DEV_MPU_SPEED_HZ, .timeout_ms = 100, .name = "MPU6050"},
+    [PLATFORM_I2C_DEV_OLED] = {.addr = DEV_OLED_ADDR, .target_hz = DEV_OLED_SPEED_HZ, .timeout_ms = 100, .name = "OLED"},
+};
+
+static portMUX_TYPE s_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static QueueHandle_t s_queue_high = NULL;   // 高优先级事务队列
+static QueueHandle_t s_queue_low = NULL;    // 低优先级事务队列
+static SemaphoreHandle_t s_pending = NULL;  // 两个队列中待处理事务的总数
+
+// 按 speed_hz 在总线上添加设备
+static esp_err_t platform_i2c_add_device(platform_i2c_dev_ctx_t *dev)
+{
+    i2c_device_config_t dev_config = {0};
+    dev_config.device_address = dev->addr;
+    dev_config.scl_speed_hz = dev->speed_hz;
+    dev_config.dev_addr_length = I2C_ADDR_BIT_7; // 7位地址
+    esp_err_t err = i2c_master_bus_add_device(bus_handle, &dev_config, &dev->handle);
+    if (err != ESP_OK)
+    {
+        dev->handle = NULL;
+    }
+    return err;
+}
+
+// 运行时改速率：驱动不支持直接修改已添加设备的频率，只能在两次事务之间移除后按新频率重新添加
+// 按原频率也加不回去时句柄为空，返回错误，该设备的下一个事务（或重试）再加
+static esp_err_t platform_i2c_apply_speed(platform_i2c_dev_ctx_t *dev)
+{
+    uint32_t target = dev->target_hz;
+    if (dev->handle && target == dev->speed_hz)
+    {
+        return ESP_OK;
+    }
+
+    uint32_t old = dev->speed_hz;
+    if (dev->handle)
+    {
+        i2c_master_bus_rm_device(dev->handle);
+        dev->handle = NULL;
+    }
+    dev->speed_hz = target;
+    esp_err_t err = platform_i2c_add_device(dev);
+    if (err != ESP_OK && target != old)
+    {
+        // 新频率添加失败，退回原来的频率
+        ESP_LOGE(TAG, "%s: failed to switch to %u Hz: %s", dev->name, (unsigned)target, esp_err_to_name(err));
+        dev->speed_hz = old;
+        dev->target_hz = old;
+        err = platform_i2c_add_device(dev);
+    }
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "%s: failed to re-add at %u Hz: %s", dev->name, (unsigned)dev->speed_hz, esp_err_to_name(err));
+        return err;
+    }
+    if (dev->speed_hz != old)
+    {
+        ESP_LOGI(TAG, "%s: SCL %u Hz -> %u Hz", dev->name, (unsigned)old, (unsigned)target);
+    }
+
+    portENTER_CRITICAL(&s_stats_lock);
+    dev->stats.speed_hz = dev->speed_hz;
+    portEXIT_CRITICAL(&s_stats_lock);
+    return ESP_OK;
+}
+
+// 创建总线并按各自的 speed_hz 添加所有设备（初始化和总线恢复时调用）
+static esp_err_t platform_i2c_bus_create(void)
 {
     // 1.完善总线的配置结构体
     i2c_master_bus_config_t i2c_bus_config = {0};
@@ -33,20 +152,338 @@ void platform_i2c_init(void)
     i2c_bus_config.flags.enable_internal_pullup = true;
 
     // 2.将配置结构体传递给I2C驱动，创建I2C总线
-    ESP_ERROR_CHECK(i2c_new_master_bus(&i2c_bus_config, &bus_handle));
+    esp_err_t err = i2c_new_master_bus(&i2c_bus_config, &bus_handle);
+    if (err != ESP_OK)
+    {
+        bus_handle = NULL;
+        return err;
+    }
 
-    // 3. 创建一个设备的配置
-    i2c_device_config_t dev_config = {0};
-    dev_config.device_address = DEV_MPU_ADDR;
-    dev_config.scl_speed_hz = 100000;            // 100KHz
-    dev_config.dev_addr_length = I2C_ADDR_BIT_7; // 7位地址
+    // 3. 在总线上添加 MPU6050 和 OLED 设备
+    for (int i = 0; i < PLATFORM_I2C_DEV_MAX; i++)
+    {
+        err = platform_i2c_add_device(&s_devs[i]);
+        if (err != ESP_OK)
+        {
+            return err;
+        }
+    }
+    return ESP_OK;
+}
+
+// 拆掉总线：移除所有设备后删除总线，把引脚还给 GPIO
+static void platform_i2c_bus_destroy(void)
+{
+    for (int i = 0; i < PLATFORM_I2C_DEV_MAX; i++)
+    {
+        if (s_devs[i].handle)
+        {
+            i2c_master_bus_rm_device(s_devs[i].handle);
+            s_devs[i].handle = NULL;
+        }
+    }
+    if (bus_handle)
+    {
+        i2c_del_master_bus(bus_handle);
+        bus_handle = NULL;
+    }
+}
+
+// 用 GPIO 手动打 SCL 时钟，直到从机释放 SDA，最后发一个 STOP 让所有从机回到空闲状态
+static void platform_i2c_clock_out(void)
+{
+    gpio_config_t io_conf = {0};
+    io_conf.pin_bit_mask = (1ULL << I2C_SCL_PIN) | (1ULL << I2C_SDA_PIN);
+    io_conf.mode = GPIO_MODE_INPUT_OUTPUT_OD;
+    io_conf.pull_up_en = GPIO_PULLUP_ENABLE;
+    io_conf.intr_type = GPIO_INTR_DISABLE;
+    gpio_config(&io_conf);
+
+    gpio_set_level(I2C_SDA_PIN, 1);
+    gpio_set_level(I2C_SCL_PIN, 1);
+    esp_rom_delay_us(I2C_RECOVER_HALF_PERIOD_US);
+
+    for (int i = 0; i < I2C_RECOVER_SCL_PULSES && gpio_get_level(I2C_SDA_PIN) == 0; i++)
+    {
+        gpio_set_level(I2C_SCL_PIN, 0);
+        esp_rom_delay_us(I2C_RECOVER_HALF_PERIOD_US);
+        gpio_set_level(I2C_SCL_PIN, 1);
+        esp_rom_delay_us(I2C_RECOVER_HALF_PERIOD_US);
+    }
+
+    // STOP：SCL 高电平期间 SDA 由低变高
+    gpio_set_level(I2C_SCL_PIN, 0);
+    esp_rom_delay_us(I2C_RECOVER_HALF_PERIOD_US);
+    gpio_set_level(I2C_SDA_PIN, 0);
+    esp_rom_delay_us(I2C_RECOVER_HALF_PERIOD_US);
+    gpio_set_level(I2C_SCL_PIN, 1);
+    esp_rom_delay_us(I2C_RECOVER_HALF_PERIOD_US);
+    gpio_set_level(I2C_SDA_PIN, 1);
+    esp_rom_delay_us(I2C_RECOVER_HALF_PERIOD_US);
+}
+
+// 总线恢复：先让驱动复位控制器（会打时钟清总线），SDA 仍被拉低时再拆掉总线手动打时钟并重建
+static void platform_i2c_recover(platform_i2c_dev_ctx_t *dev)
+{
+    portENTER_CRITICAL(&s_stats_lock);
+    dev->stats.recoveries++;
+    portEXIT_CRITICAL(&s_stats_lock);
+
+    esp_err_t err = i2c_master_bus_reset(bus_handle);
+    if (err == ESP_OK && gpio_get_level(I2C_SDA_PIN) == 1)
+    {
+        ESP_LOGW(TAG, "%s: bus stuck, controller reset", dev->name);
+        return;
+    }
+
+    ESP_LOGW(TAG, "%s: bus stuck (SDA %s), clocking out and rebuilding bus",
+             dev->name, gpio_get_level(I2C_SDA_PIN) ? "high" : "low");
+    platform_i2c_bus_destroy();
+    platform_i2c_clock_out();
+    err = platform_i2c_bus_create();
+    if (err != ESP_OK)
+    {
+        // 重建失败时把总线拆干净，下一个事务到来时再试
+        ESP_LOGE(TAG, "Bus rebuild failed: %s", esp_err_to_name(err));
+        platform_i2c_bus_destroy();
+    }
+}
+
+// 在总线上执行一个事务，并记入该设备的总线占用统计
+static esp_err_t platform_i2c_execute(const platform_i2c_xfer_t *xfer)
+{
+    platform_i2c_dev_ctx_t *dev = &s_devs[xfer->dev];
+    esp_err_t err;
+
+    err = platform_i2c_apply_speed(dev);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    int64_t start = esp_timer_get_time();
+    if (xfer->rx_len > 0)
+    {
+        err = i2c_master_transmit_receive(dev->handle, xfer->tx, xfer->tx_len, xfer->rx, xfer->rx_len, dev->timeout_ms);
+    }
+    else
+    {
+        err = i2c_master_transmit(dev->handle, xfer->tx, xfer->tx_len, dev->timeout_ms);
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
 
-    // 4. 配置完成后 创建设备句柄
-    ESP_ERROR_CHECK(i2c_master_bus_add_device(bus_handle, &dev_config, &mpu_dev_handle));
+    portENTER_CRITICAL(&s_stats_lock);
+    dev->stats.xfers++;
+    dev->stats.bytes += xfer->tx_len + xfer->rx_len;
+    dev->stats.busy_us += (uint64_t)elapsed;
+    portEXIT_CRITICAL(&s_stats_lock);
 
-    // 5. 在总线添加OLED设备
-    dev_config.device_address = DEV_OLED_ADDR;
-    ESP_ERROR_CHECK(i2c_master_bus_add_device(bus_handle, &dev_config, &oled_dev_handle));
+    return err;
+}
+
+// 执行一个事务，失败时退避重试；重试用尽仍失败则计入错误，连续失败且像是总线卡死时做总线恢复
+static esp_err_t platform_i2c_execute_retry(const platform_i2c_xfer_t *xfer)
+{
+    platform_i2c_dev_ctx_t *dev = &s_devs[xfer->dev];
+    TickType_t backoff = I2C_RETRY_BACKOFF_TICKS;
+    esp_err_t err = ESP_ERR_INVALID_STATE;
+
+    // 上次恢复时重建总线失败，先重建；仍然失败就直接报错，不在坏掉的总线上重试
+    if (!bus_handle && platform_i2c_bus_create() != ESP_OK)
+    {
+        platform_i2c_bus_destroy();
+    }
+    else
+    {
+        err = platform_i2c_execute(xfer);
+        for (int i = 0; i < I2C_RETRY_MAX && err != ESP_OK && err != ESP_ERR_INVALID_ARG; i++)
+        {
+            vTaskDelay(backoff);
+            backoff <<= 1;
+
+            portENTER_CRITICAL(&s_stats_lock);
+            dev->stats.retries++;
+            portEXIT_CRITICAL(&s_stats_lock);
+
+            err = platform_i2c_execute(xfer);
+        }
+
+        if (err == ESP_OK)
+        {
+            s_fail_streak = 0;
+            return ESP_OK;
+        }
+
+        // 从机不应答（设备掉线）时 SDA 是高的，不需要恢复；超时或 SDA 被拉低才认为总线卡死
+        if (++s_fail_streak >= I2C_RECOVER_THRESHOLD &&
+            (err == ESP_ERR_TIMEOUT || gpio_get_level(I2C_SDA_PIN) == 0))
+        {
+            platform_i2c_recover(dev);
+            s_fail_streak = 0;
+        }
+    }
+
+    portENTER_CRITICAL(&s_stats_lock);
+    dev->stats.errors++;
+    portEXIT_CRITICAL(&s_stats_lock);
+    return err;
+}
+
+// 总线调度任务：每次都先看高优先级队列，所以传感器事务总能插在两次显示写之间
+static void platform_i2c_bus_task(void *pvParameters)
+{
+    (void)pvParameters;
+
+    static platform_i2c_xfer_t xfer;
+
+    for (;;)
+    {
+        xSemaphoreTake(s_pending, portMAX_DELAY);
+
+        if (xQueueReceive(s_queue_high, &xfer, 0) != pdTRUE &&
+            xQueueReceive(s_queue_low, &xfer, 0) != pdTRUE)
+        {
+            continue;
+        }
+
+        esp_err_t err = platform_i2c_execute_retry(&xfer);
+        if (err != ESP_OK)
+        {
+            ESP_LOGE(TAG, "%s transfer failed: %s", s_devs[xfer.dev].name, esp_err_to_name(err));
+        }
+
+        if (xfer.done_cb)
+        {
+            xfer.done_cb(err, xfer.arg);
+        }
+    }
+}
+
+void platform_i2c_init(void)
+{
+    // 1. 创建总线，按各自的速率配置添加 MPU6050 和 OLED 设备
+    for (int i = 0; i < PLATFORM_I2C_DEV_MAX; i++)
+    {
+        s_devs[i].speed_hz = s_devs[i].target_hz;
+        s_devs[i].stats.speed_hz = s_devs[i].speed_hz;
+    }
+    ESP_ERROR_CHECK(platform_i2c_bus_create());
+
+    // 4. 创建事务队列和总线调度任务，之后所有设备访问都经由调度任务完成
+    for (int i = 0; i < PLATFORM_I2C_DEV_MAX; i++)
+    {
+        s_devs[i].sync_lock = xSemaphoreCreateMutex();
+        s_devs[i].sync_done = xSemaphoreCreateBinary();
+        assert(s_devs[i].sync_lock && s_devs[i].sync_done);
+    }
+    s_queue_high = xQueueCreate(I2C_QUEUE_LEN_HIGH, sizeof(platform_i2c_xfer_t));
+    s_queue_low = xQueueCreate(I2C_QUEUE_LEN_LOW, sizeof(platform_i2c_xfer_t));
+    s_pending = xSemaphoreCreateCounting(I2C_QUEUE_LEN_HIGH + I2C_QUEUE_LEN_LOW, 0);
+    assert(s_queue_high && s_queue_low && s_pending);
+
+    xTaskCreate(platform_i2c_bus_task, "i2c_bus", I2C_TASK_STACK_DEPTH, NULL, I2C_TASK_PRIORITY, NULL);
+}
+
+esp_err_t platform_i2c_submit(const platform_i2c_xfer_t *xfer, platform_i2c_prio_t prio, TickType_t wait)
+{
+    if (!xfer || xfer->dev >= PLATFORM_I2C_DEV_MAX || xfer->tx_len > PLATFORM_I2C_TX_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    QueueHandle_t queue = (prio == PLATFORM_I2C_PRIO_HIGH) ? s_queue_high : s_queue_low;
+    if (xQueueSend(queue, xfer, wait) != pdTRUE)
+    {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    xSemaphoreGive(s_pending);
+    return ESP_OK;
+}
+
+// 同步传输的完成回调：记录结果并唤醒等待者
+static void platform_i2c_sync_done(esp_err_t err, void *arg)
+{
+    platform_i2c_dev_ctx_t *dev = (platform_i2c_dev_ctx_t *)arg;
+    dev->sync_err = err;
+    xSemaphoreGive(dev->sync_done);
+}
+
+esp_err_t platform_i2c_transfer(platform_i2c_dev_t dev, platform_i2c_prio_t prio,
+                                const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len)
+{
+    if (dev >= PLATFORM_I2C_DEV_MAX || tx_len > PLATFORM_I2C_TX_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    platform_i2c_dev_ctx_t *ctx = &s_devs[dev];
+    platform_i2c_xfer_t xfer = {0};
+    xfer.dev = dev;
+    memcpy(xfer.tx, tx, tx_len);
+    xfer.tx_len = tx_len;
+    xfer.rx = rx;
+    xfer.rx_len = rx_len;
+    xfer.done_cb = platform_i2c_sync_done;
+    xfer.arg = ctx;
+
+    xSemaphoreTake(ctx->sync_lock, portMAX_DELAY);
+    esp_err_t err = platform_i2c_submit(&xfer, prio, portMAX_DELAY);
+    if (err == ESP_OK)
+    {
+        xSemaphoreTake(ctx->sync_done, portMAX_DELAY);
+        err = ctx->sync_err;
+    }
+    xSemaphoreGive(ctx->sync_lock);
+
+    return err;
+}
+
+esp_err_t platform_i2c_set_speed(platform_i2c_dev_t dev, uint32_t speed_hz)
+{
+    if (dev >= PLATFORM_I2C_DEV_MAX || speed_hz < I2C_SPEED_MIN_HZ || speed_hz > I2C_SPEED_MAX_HZ)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 只记录期望值，真正的切换由总线调度任务在该设备下一个事务前完成，不会打断正在进行的传输
+    s_devs[dev].target_hz = speed_hz;
+    return ESP_OK;
+}
+
+esp_err_t platform_i2c_get_stats(platform_i2c_dev_t dev, platform_i2c_stats_t *stats)
+{
+    if (dev >= PLATFORM_I2C_DEV_MAX || !stats)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&s_stats_lock);
+    *stats = s_devs[dev].stats;
+    portEXIT_CRITICAL(&s_stats_lock);
+    return ESP_OK;
+}
+
+void platform_i2c_log_stats(void)
+{
+    int64_t uptime_us = esp_timer_get_time();
+    if (uptime_us <= 0)
+    {
+        return;
+    }
+
+    for (int i = 0; i < PLATFORM_I2C_DEV_MAX; i++)
+    {
+        platform_i2c_stats_t st;
+        platform_i2c_get_stats((platform_i2c_dev_t)i, &st);
+        // 千分比，避免浮点
+        uint32_t permille = (uint32_t)(st.busy_us * 1000 / (uint64_t)uptime_us);
+        ESP_LOGI(TAG, "%s @%u Hz: %u xfers, %llu bytes, busy %llu ms (%u.%u%%), %u errors, %u retries, %u recoveries",
+                 s_devs[i].name, (unsigned)st.speed_hz, (unsigned)st.xfers,
+                 (unsigned long long)st.bytes, (unsigned long long)(st.busy_us / 1000),
+                 (unsigned)(permille / 10), (unsigned)(permille % 10),
+                 (unsigned)st.errors, (unsigned)st.retries, (unsigned)st.recoveries);
+    }
 }
 
 void platform_i2c_mpu6050_is_present(void)
@@ -54,10 +491,7 @@ void platform_i2c_mpu6050_is_present(void)
     uint8_t reg = MPU6050_WHO_AM_I_REG;
     uint8_t whoami = 0;
 
-    esp_err_t err = i2c_master_transmit_receive(mpu_dev_handle,
-                                                &reg, 1,
-                                                &whoami, 1,
-                                                1000);
+    esp_err_t err = platform_i2c_transfer(PLATFORM_I2C_DEV_MPU6050, PLATFORM_I2C_PRIO_HIGH, &reg, 1, &whoami, 1);
     if (err != ESP_OK)
     {
         ESP_LOGE(TAG, "MPU6050 not detected");
@@ -70,7 +504,7 @@ void platform_i2c_mpu6050_is_present(void)
 void platform_i2c_oled_is_present(void)
 {
     uint8_t test_data = 0x00;
-    esp_err_t err = i2c_master_transmit(oled_dev_handle, &test_data, 1, 1000);
+    esp_err_t err = platform_i2c_transfer(PLATFORM_I2C_DEV_OLED, PLATFORM_I2C_PRIO_LOW, &test_data, 1, NULL, 0);
     if (err != ESP_OK)
     {
         ESP_LOGE(TAG, "OLED not detected");
@@ -81,20 +515,21 @@ void platform_i2c_oled_is_present(void)
 }
 
 /***********************************************************  MPU6050驱动 *********************************************************/
-void Int_MPU6050_WriteByteFunc(uint8_t reg_addr, uint8_t send_byte)
+// 传感器事务走高优先级队列，并同步等待结果；返回值就是 I2C 驱动的 esp_err_t（重试后的最终结果）
+int Int_MPU6050_WriteByteFunc(uint8_t reg_addr, uint8_t send_byte)
 {
     uint8_t buff[2] = {reg_addr, send_byte};
-    i2c_master_transmit(mpu_dev_handle, buff, 2, 1000);
+    return platform_i2c_transfer(PLATFORM_I2C_DEV_MPU6050, PLATFORM_I2C_PRIO_HIGH, buff, 2, NULL, 0);
 }
 
-void Int_MPU6050_ReadByteFunc(uint8_t reg_addr, uint8_t *receive_byte)
+int Int_MPU6050_ReadByteFunc(uint8_t reg_addr, uint8_t *receive_byte)
 {
-    i2c_master_transmit_receive(mpu_dev_handle, &reg_addr, 1, receive_byte, 1, 1000);
+    return platform_i2c_transfer(PLATFORM_I2C_DEV_MPU6050, PLATFORM_I2C_PRIO_HIGH, &reg_addr, 1, receive_byte, 1);
 }
 
-void Int_MPU6050_ReadBytesFunc(uint8_t reg_addr, uint8_t *receive_buff, uint8_t size)
+int Int_MPU6050_ReadBytesFunc(uint8_t reg_addr, uint8_t *receive_buff, uint16_t size)
 {
-    i2c_master_transmit_receive(mpu_dev_handle, &reg_addr, 1, receive_buff, size, 1000);
+    return platform_i2c_transfer(PLATFORM_I2C_DEV_MPU6050, PLATFORM_I2C_PRIO_HIGH, &reg_addr, 1, receive_buff, size);
 }
 
 void Int_MPU6050_DelayMsFunc(uint32_t ms)
@@ -104,27 +539,32 @@ void Int_MPU6050_DelayMsFunc(uint32_t ms)
 /***********************************************************  MPU6050驱动 *********************************************************/
 
 /***********************************************************  OLED驱动 *********************************************************/
+// 显示事务走低优先级队列，异步提交后立即返回，数据已拷贝进事务，显存可以继续修改
+// 同一队列先进先出，命令与数据的先后顺序保持不变；失败由总线调度任务统一打印日志
 void OLED_WriteCommandFunc(uint8_t Command)
 {
-    uint8_t buff[2] = {0x00, Command};
-    esp_err_t ret = i2c_master_transmit(oled_dev_handle, buff, 2, 100);
-    if (ret != ESP_OK)
-    {
-        ESP_LOGE("I2C_WRITE", "Failed to add device: %s", esp_err_to_name(ret));
-    }
+    platform_i2c_xfer_t xfer = {0};
+    xfer.dev = PLATFORM_I2C_DEV_OLED;
+    xfer.tx[0] = 0x00;
+    xfer.tx[1] = Command;
+    xfer.tx_len = 2;
+    platform_i2c_submit(&xfer, PLATFORM_I2C_PRIO_LOW, portMAX_DELAY);
 }
 
 // IIC OLED写入多个字节的数据
 void OLED_WriteDataFunc(uint8_t *Data, uint8_t Count)
 {
-    uint8_t buff[Count + 1];
-    buff[0] = 0x40;
-    memcpy(&buff[1], Data, Count);
-    esp_err_t ret = i2c_master_transmit(oled_dev_handle, buff, Count + 1, 100);
-    if (ret != ESP_OK)
+    if (Count + 1 > PLATFORM_I2C_TX_MAX)
     {
-        ESP_LOGE("I2C_WRITE", "Failed to add device: %s", esp_err_to_name(ret));
+        return;
     }
+
+    platform_i2c_xfer_t xfer = {0};
+    xfer.dev = PLATFORM_I2C_DEV_OLED;
+    xfer.tx[0] = 0x40;
+    memcpy(&xfer.tx[1], Data, Count);
+    xfer.tx_len = Count + 1;
+    platform_i2c_submit(&xfer, PLATFORM_I2C_PRIO_LOW, portMAX_DELAY);
 }
 /***********************************************************  OLED驱动 *********************************************************/
 
@@ -0,0 +1,51 @@
+#ifndef __CBOR_WRITER_H__
+#define __CBOR_WRITER_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 流式 CBOR（RFC 8949）写入器：直接往调用方的缓冲区输出，不分配内存
+ * - 只支持定长的 map/array（调用方事先知道元素个数），整数、文本串、字节串、布尔
+ * - 写满后只置位 overflow，之后的写入全部忽略，最后由 cbor_writer_finish 统一判断
+ */
+typedef struct
+{
+    uint8_t *buf;  // 输出缓冲区
+    size_t cap;    // 缓冲区大小
+    size_t len;    // 已写入的长度
+    bool overflow; // 是否已写满
+} cbor_writer_t;
+
+void cbor_writer_init(cbor_writer_t *w, uint8_t *buf, size_t cap);
+
+/**
+ * @brief 结束写入
+ *
+ * @return 输出长度；溢出时返回 0
+ */
+size_t cbor_writer_finish(cbor_writer_t *w);
+
+// 容器头：之后再写 n 个元素（map 为 n 对 key/value）
+void cbor_writer_map(cbor_writer_t *w, size_t n);
+void cbor_writer_array(cbor_writer_t *w, size_t n);
+
+void cbor_writer_uint(cbor_writer_t *w, uint64_t value);
+void cbor_writer_int(cbor_writer_t *w, int64_t value);
+void cbor_writer_bool(cbor_writer_t *w, bool value);
+void cbor_writer_text(cbor_writer_t *w, const char *str);
+void cbor_writer_bytes(cbor_writer_t *w, const uint8_t *data, size_t n);
+
+// 整数数组：数组头 + n 个整数
+void cbor_writer_int32_array(cbor_writer_t *w, const int32_t *values, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __CBOR_WRITER_H__
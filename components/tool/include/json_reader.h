@@ -0,0 +1,70 @@
+#ifndef __JSON_READER_H__
+#define __JSON_READER_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 最大嵌套层数，超过按语法错误处理
+#define JSON_READER_MAX_DEPTH 16
+
+// 值的类型
+typedef enum
+{
+    JSON_READER_NONE = 0, // 没有找到
+    JSON_READER_OBJECT,
+    JSON_READER_ARRAY,
+    JSON_READER_STRING,
+    JSON_READER_NUMBER,
+    JSON_READER_TRUE,
+    JSON_READER_FALSE,
+    JSON_READER_NULL,
+} json_reader_type_t;
+
+/**
+ * 指向原始 JSON 文本中某个值的片段，不拷贝、不分配内存
+ * - 字符串：p/len 为引号内的原始内容（转义尚未处理）
+ * - 对象/数组：p/len 包含外层的括号，可以再交给 json_reader_fields 解析
+ */
+typedef struct
+{
+    json_reader_type_t type;
+    const char *p;
+    size_t len;
+} json_span_t;
+
+/**
+ * @brief 一次扫描 JSON 对象的顶层字段，按 key 取出多个值
+ *
+ * 嵌套的对象/数组整体跳过，不展开；没有出现的 key 对应 type 为 JSON_READER_NONE；重复的 key 取最后一个
+ *
+ * @param json 文本（不要求以 '\0' 结尾）
+ * @param len 长度
+ * @param keys 要取的 key
+ * @param out 与 keys 一一对应的结果
+ * @param n key 的个数
+ * @return false 不是合法的 JSON 对象
+ */
+bool json_reader_fields(const char *json, size_t len, const char *const *keys, json_span_t *out, size_t n);
+
+// 整数（不接受小数和指数），超出 int64 范围返回 false
+bool json_span_int(const json_span_t *v, int64_t *out);
+
+bool json_span_bool(const json_span_t *v, bool *out);
+
+/**
+ * @brief 取出字符串并处理转义，结果以 '\0' 结尾
+ *
+ * \uXXXX 只支持 ASCII 范围；放不下或类型不符时返回 false
+ */
+bool json_span_string(const json_span_t *v, char *buf, size_t cap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __JSON_READER_H__
@@ -0,0 +1,67 @@
+#ifndef __JSON_WRITER_H__
+#define __JSON_WRITER_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 最大嵌套层数
+#define JSON_WRITER_MAX_DEPTH 8
+
+/**
+ * 流式 JSON 写入器：直接往调用方提供的缓冲区里按顺序输出，不建树、不分配内存
+ * - 写满后只置位 overflow，之后的写入全部忽略，最后由 json_writer_finish 统一判断
+ * - 逗号和冒号由写入器自动处理，调用方只需按 key、value 的顺序调用
+ */
+typedef struct
+{
+    char *buf;                            // 输出缓冲区
+    size_t cap;                           // 缓冲区大小（含结尾 '\0'）
+    size_t len;                           // 已写入的长度
+    bool overflow;                        // 是否已写满
+    bool after_key;                       // 刚写完 key，下一个值前不加逗号
+    uint8_t depth;                        // 当前嵌套层数
+    bool first[JSON_WRITER_MAX_DEPTH + 1]; // 各层是否还没有写过元素
+} json_writer_t;
+
+void json_writer_init(json_writer_t *w, char *buf, size_t cap);
+
+/**
+ * @brief 结束写入并补上 '\0'
+ *
+ * @return 输出长度（不含 '\0'）；溢出或对象/数组没有闭合时返回 0
+ */
+size_t json_writer_finish(json_writer_t *w);
+
+void json_writer_begin_object(json_writer_t *w);
+void json_writer_end_object(json_writer_t *w);
+void json_writer_begin_array(json_writer_t *w);
+void json_writer_end_array(json_writer_t *w);
+
+void json_writer_key(json_writer_t *w, const char *key);
+void json_writer_int(json_writer_t *w, int64_t value);
+void json_writer_bool(json_writer_t *w, bool value);
+void json_writer_null(json_writer_t *w);
+void json_writer_string(json_writer_t *w, const char *str);
+
+// 定点数：输出 value / 10^decimals，例如 (2537, 2) 输出 25.37，decimals 最大 9
+void json_writer_fixed(json_writer_t *w, int64_t value, uint8_t decimals);
+
+// 整数数组：[v0,v1,...]
+void json_writer_int32_array(json_writer_t *w, const int32_t *values, size_t n);
+
+// 常用的 key + value 组合
+void json_writer_kv_int(json_writer_t *w, const char *key, int64_t value);
+void json_writer_kv_bool(json_writer_t *w, const char *key, bool value);
+void json_writer_kv_string(json_writer_t *w, const char *key, const char *str);
+void json_writer_kv_fixed(json_writer_t *w, const char *key, int64_t value, uint8_t decimals);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __JSON_WRITER_H__
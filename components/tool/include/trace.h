@@ -0,0 +1,136 @@
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 二进制跟踪：把事件和一段原始数据写进内存环形缓冲区，不格式化、不走串口，可通过 HTTP 读出
+ * - 编译期：每个模块有自己的最高级别（TRACE_CL_<模块>），高于它的 TRACE_EVENT 整个被编译掉
+ * - 运行期：每个模块可单独设置级别和采样（每 N 条记录 1 条）
+ * - 缓冲区写满后覆盖最早的记录
+ */
+
+// 级别
+#define TRACE_NONE 0
+#define TRACE_ERROR 1
+#define TRACE_WARN 2
+#define TRACE_INFO 3
+#define TRACE_DEBUG 4
+#define TRACE_VERBOSE 5
+
+// 模块
+typedef enum
+{
+    TRACE_MOD_MQTT = 0,
+    TRACE_MOD_NET,
+    TRACE_MOD_APP,
+    TRACE_MOD_MAX,
+} trace_module_t;
+
+// 编译期级别：默认保留到 DEBUG，可在编译选项中按模块覆盖，例如 -DTRACE_CL_MQTT=TRACE_NONE
+#ifndef TRACE_COMPILE_LEVEL_DEFAULT
+#define TRACE_COMPILE_LEVEL_DEFAULT TRACE_DEBUG
+#endif
+#ifndef TRACE_CL_MQTT
+#define TRACE_CL_MQTT TRACE_COMPILE_LEVEL_DEFAULT
+#endif
+#ifndef TRACE_CL_NET
+#define TRACE_CL_NET TRACE_COMPILE_LEVEL_DEFAULT
+#endif
+#ifndef TRACE_CL_APP
+#define TRACE_CL_APP TRACE_COMPILE_LEVEL_DEFAULT
+#endif
+
+// 运行期默认级别：DEBUG 级别的负载跟踪默认关闭，需要时通过 HTTP 打开
+#define TRACE_RUNTIME_LEVEL_DEFAULT TRACE_INFO
+
+// 每条记录最多保存的数据字节数，超出部分截断（记录中保留原始长度）
+#define TRACE_PAYLOAD_MAX 64
+
+// 环形缓冲区的记录条数
+#define TRACE_RECORD_COUNT 96
+
+// 事件编号
+enum
+{
+    TRACE_EV_MQTT_RX = 1,  // 收到的下行数据（data 为负载）
+    TRACE_EV_MQTT_TX,      // 发布的上行数据（data 为负载）
+    TRACE_EV_APP_CMD,      // 执行的下行指令（data 为应答）
+};
+
+// 一条跟踪记录（HTTP 按此格式原样输出，小端）
+typedef struct
+{
+    uint32_t seq;                     // 序号，从 1 开始递增，读取方据此续读
+    uint32_t ts_us;                   // 时间戳（esp_timer 微秒的低 32 位）
+    uint8_t module;                   // trace_module_t
+    uint8_t level;
+    uint16_t event;
+    uint16_t len;                     // 原始数据长度
+    uint16_t stored;                  // 实际保存的长度（不超过 TRACE_PAYLOAD_MAX）
+    uint8_t data[TRACE_PAYLOAD_MAX];
+} trace_record_t;
+
+/**
+ * @brief 记录一条跟踪事件
+ *
+ * 用法：TRACE_EVENT(MQTT, TRACE_DEBUG, TRACE_EV_MQTT_RX, data, len)
+ * 编译期级别不够时整条语句被优化掉；运行期先比较级别，通过后才进入 trace_write 做采样和拷贝
+ */
+#define TRACE_EVENT(mod, level, event, data, len)                                  \
+    do                                                                             \
+    {                                                                              \
+        if ((level) <= TRACE_CL_##mod && trace_enabled(TRACE_MOD_##mod, (level)))  \
+        {                                                                          \
+            trace_write(TRACE_MOD_##mod, (level), (event), (data), (len));         \
+        }                                                                          \
+    } while (0)
+
+// 运行期级别检查（只读一个字节，开销很小）
+bool trace_enabled(trace_module_t module, uint8_t level);
+
+void trace_write(trace_module_t module, uint8_t level, uint16_t event, const void *data, size_t len);
+
+/**
+ * @brief 设置模块的运行期级别和采样
+ *
+ * @param level TRACE_NONE ~ TRACE_VERBOSE
+ * @param sample 每 sample 条记录 1 条，0 和 1 都表示全部记录
+ */
+void trace_set_level(trace_module_t module, uint8_t level, uint16_t sample);
+
+void trace_get_level(trace_module_t module, uint8_t *level, uint16_t *sample);
+
+// 按名称查找模块（"mqtt" / "net" / "app"），找不到返回 TRACE_MOD_MAX
+trace_module_t trace_module_find(const char *name);
+
+// 最新一条记录的序号，还没有记录时为 0
+uint32_t trace_last_seq(void);
+
+/**
+ * @brief 按顺序读出序号大于 since、不大于 until 的记录
+ *
+ * 分多次读完一段时，先用 trace_last_seq 定下 until，写入方一直在写也能读完
+ *
+ * @param since 上次读到的最大序号，0 表示从最早的记录开始
+ * @param until 读到这个序号为止
+ * @param out 输出
+ * @param max 最多读几条
+ * @return 读出的条数
+ */
+size_t trace_read(uint32_t since, uint32_t until, trace_record_t *out, size_t max);
+
+// 因采样被跳过的记录数，以及被覆盖的记录数
+void trace_get_stats(uint32_t *sampled_out, uint32_t *overwritten);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __TRACE_H__
@@ -0,0 +1,55 @@
+#ifndef __VARINT_WRITER_H__
+#define __VARINT_WRITER_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 变长整数写入器：无符号数按 LEB128 编码（每字节 7 位，最高位表示后面还有字节），
+ * 有符号数先做 zigzag 映射（0,-1,1,-2... -> 0,1,2,3...），绝对值小的数只占 1 字节
+ * 写满后只置位 overflow，之后的写入全部忽略，最后由 varint_writer_finish 统一判断
+ */
+typedef struct
+{
+    uint8_t *buf;  // 输出缓冲区
+    size_t cap;    // 缓冲区大小
+    size_t len;    // 已写入的长度
+    bool overflow; // 是否已写满
+} varint_writer_t;
+
+// zigzag 映射：符号位移到最低位
+static inline uint64_t varint_zigzag64(int64_t v)
+{
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+void varint_writer_init(varint_writer_t *w, uint8_t *buf, size_t cap);
+
+/**
+ * @brief 结束写入
+ *
+ * @return 输出长度；溢出时返回 0
+ */
+size_t varint_writer_finish(varint_writer_t *w);
+
+void varint_writer_byte(varint_writer_t *w, uint8_t b);
+void varint_writer_uint(varint_writer_t *w, uint64_t v);
+void varint_writer_sint(varint_writer_t *w, int64_t v);
+
+/**
+ * @brief 差分编码一列整数：写入每个值与前一个值之差（第一个值与 0 相比）
+ *
+ * @param order 差分阶数：1 为一阶差分；2 为二阶差分，适合等间隔的时间戳（差分后几乎全为 0）
+ */
+void varint_writer_delta_int32(varint_writer_t *w, const int32_t *values, size_t n, uint8_t order);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __VARINT_WRITER_H__
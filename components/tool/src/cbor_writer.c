@@ -0,0 +1,142 @@
+#include "cbor_writer.h"
+#include <string.h>
+
+// 主类型（高 3 位）
+#define CBOR_MT_UINT (0 << 5)
+#define CBOR_MT_NINT (1 << 5)
+#define CBOR_MT_BYTES (2 << 5)
+#define CBOR_MT_TEXT (3 << 5)
+#define CBOR_MT_ARRAY (4 << 5)
+#define CBOR_MT_MAP (5 << 5)
+
+#define CBOR_FALSE 0xF4
+#define CBOR_TRUE 0xF5
+
+static void cbor_writer_put(cbor_writer_t *w, const uint8_t *data, size_t n)
+{
+    if (w->overflow || n == 0)
+    {
+        return;
+    }
+    if (w->len + n > w->cap)
+    {
+        w->overflow = true;
+        return;
+    }
+    memcpy(&w->buf[w->len], data, n);
+    w->len += n;
+}
+
+// 类型头：参数小于 24 直接放在低 5 位，否则按 1/2/4/8 字节大端跟在后面
+static void cbor_writer_head(cbor_writer_t *w, uint8_t major, uint64_t arg)
+{
+    uint8_t head[9];
+    size_t n;
+
+    if (arg < 24)
+    {
+        head[0] = major | (uint8_t)arg;
+        n = 1;
+    }
+    else if (arg <= 0xFF)
+    {
+        head[0] = major | 24;
+        head[1] = (uint8_t)arg;
+        n = 2;
+    }
+    else if (arg <= 0xFFFF)
+    {
+        head[0] = major | 25;
+        head[1] = (uint8_t)(arg >> 8);
+        head[2] = (uint8_t)arg;
+        n = 3;
+    }
+    else if (arg <= 0xFFFFFFFFULL)
+    {
+        head[0] = major | 26;
+        for (int i = 0; i < 4; i++)
+        {
+            head[1 + i] = (uint8_t)(arg >> (24 - 8 * i));
+        }
+        n = 5;
+    }
+    else
+    {
+        head[0] = major | 27;
+        for (int i = 0; i < 8; i++)
+        {
+            head[1 + i] = (uint8_t)(arg >> (56 - 8 * i));
+        }
+        n = 9;
+    }
+    cbor_writer_put(w, head, n);
+}
+
+void cbor_writer_init(cbor_writer_t *w, uint8_t *buf, size_t cap)
+{
+    w->buf = buf;
+    w->cap = cap;
+    w->len = 0;
+    w->overflow = (buf == NULL);
+}
+
+size_t cbor_writer_finish(cbor_writer_t *w)
+{
+    return w->overflow ? 0 : w->len;
+}
+
+void cbor_writer_map(cbor_writer_t *w, size_t n)
+{
+    cbor_writer_head(w, CBOR_MT_MAP, n);
+}
+
+void cbor_writer_array(cbor_writer_t *w, size_t n)
+{
+    cbor_writer_head(w, CBOR_MT_ARRAY, n);
+}
+
+void cbor_writer_uint(cbor_writer_t *w, uint64_t value)
+{
+    cbor_writer_head(w, CBOR_MT_UINT, value);
+}
+
+void cbor_writer_int(cbor_writer_t *w, int64_t value)
+{
+    if (value >= 0)
+    {
+        cbor_writer_head(w, CBOR_MT_UINT, (uint64_t)value);
+    }
+    else
+    {
+        // 负整数编码为 -1 - value，用按位取反避免 INT64_MIN 溢出
+        cbor_writer_head(w, CBOR_MT_NINT, ~(uint64_t)value);
+    }
+}
+
+void cbor_writer_bool(cbor_writer_t *w, bool value)
+{
+    uint8_t b = value ? CBOR_TRUE : CBOR_FALSE;
+    cbor_writer_put(w, &b, 1);
+}
+
+void cbor_writer_text(cbor_writer_t *w, const char *str)
+{
+    size_t n = str ? strlen(str) : 0;
+    cbor_writer_head(w, CBOR_MT_TEXT, n);
+    cbor_writer_put(w, (const uint8_t *)str, n);
+}
+
+void cbor_writer_bytes(cbor_writer_t *w, const uint8_t *data, size_t n)
+{
+    cbor_writer_head(w, CBOR_MT_BYTES, n);
+    cbor_writer_put(w, data, n);
+}
+
+void cbor_writer_int32_array(cbor_writer_t *w, const int32_t *values, size_t n)
+{
+    cbor_writer_array(w, n);
+    for (size_t i = 0; i < n && !w->overflow; i++)
+    {
+        cbor_writer_int(w, values[i]);
+    }
+}
@@ -0,0 +1,372 @@
+#include "json_reader.h"
+#include <string.h>
+
+// ========================
+// 词法：每个函数返回扫描结束后的位置，出错返回 NULL
+// ========================
+
+static const char *json_reader_ws(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+    {
+        p++;
+    }
+    return p;
+}
+
+// p 指向开头的引号，返回结尾引号之后的位置
+static const char *json_reader_skip_string(const char *p, const char *end)
+{
+    p++;
+    while (p < end)
+    {
+        char c = *p;
+        if (c == '"')
+        {
+            return p + 1;
+        }
+        if ((unsigned char)c < 0x20)
+        {
+            return NULL;
+        }
+        p += (c == '\\') ? 2 : 1;
+    }
+    return NULL;
+}
+
+static const char *json_reader_skip_literal(const char *p, const char *end, const char *lit)
+{
+    size_t n = strlen(lit);
+    if ((size_t)(end - p) < n || memcmp(p, lit, n) != 0)
+    {
+        return NULL;
+    }
+    return p + n;
+}
+
+static const char *json_reader_skip_number(const char *p, const char *end)
+{
+    const char *start = p;
+    while (p < end && ((*p >= '0' && *p <= '9') || *p == '-' || *p == '+' || *p == '.' || *p == 'e' || *p == 'E'))
+    {
+        p++;
+    }
+    return (p > start) ? p : NULL;
+}
+
+// 跳过整个对象或数组：只检查括号配对和字符串边界，内部的值到用到时再解析
+static const char *json_reader_skip_container(const char *p, const char *end)
+{
+    char stack[JSON_READER_MAX_DEPTH];
+    size_t depth = 0;
+
+    while (p < end)
+    {
+        char c = *p;
+        if (c == '"')
+        {
+            p = json_reader_skip_string(p, end);
+            if (!p)
+            {
+                return NULL;
+            }
+            continue;
+        }
+
+        if (c == '{' || c == '[')
+        {
+            if (depth >= JSON_READER_MAX_DEPTH)
+            {
+                return NULL;
+            }
+            stack[depth++] = (c == '{') ? '}' : ']';
+        }
+        else if (c == '}' || c == ']')
+        {
+            if (depth == 0 || stack[depth - 1] != c)
+            {
+                return NULL;
+            }
+            if (--depth == 0)
+            {
+                return p + 1;
+            }
+        }
+        p++;
+    }
+    return NULL;
+}
+
+static const char *json_reader_skip_value(const char *p, const char *end, json_reader_type_t *type)
+{
+    switch (*p)
+    {
+    case '"':
+        *type = JSON_READER_STRING;
+        return json_reader_skip_string(p, end);
+    case '{':
+        *type = JSON_READER_OBJECT;
+        return json_reader_skip_container(p, end);
+    case '[':
+        *type = JSON_READER_ARRAY;
+        return json_reader_skip_container(p, end);
+    case 't':
+        *type = JSON_READER_TRUE;
+        return json_reader_skip_literal(p, end, "true");
+    case 'f':
+        *type = JSON_READER_FALSE;
+        return json_reader_skip_literal(p, end, "false");
+    case 'n':
+        *type = JSON_READER_NULL;
+        return json_reader_skip_literal(p, end, "null");
+    default:
+        *type = JSON_READER_NUMBER;
+        return json_reader_skip_number(p, end);
+    }
+}
+
+// ========================
+// 公共接口
+// ========================
+
+bool json_reader_fields(const char *json, size_t len, const char *const *keys, json_span_t *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i].type = JSON_READER_NONE;
+        out[i].p = NULL;
+        out[i].len = 0;
+    }
+    if (!json)
+    {
+        return false;
+    }
+
+    const char *end = json + len;
+    const char *p = json_reader_ws(json, end);
+    if (p >= end || *p != '{')
+    {
+        return false;
+    }
+
+    p = json_reader_ws(p + 1, end);
+    if (p < end && *p == '}')
+    {
+        return json_reader_ws(p + 1, end) == end;
+    }
+
+    for (;;)
+    {
+        // "key"
+        if (p >= end || *p != '"')
+        {
+            return false;
+        }
+        const char *key = p + 1;
+        p = json_reader_skip_string(p, end);
+        if (!p)
+        {
+            return false;
+        }
+        size_t key_len = (size_t)(p - 1 - key);
+
+        // :
+        p = json_reader_ws(p, end);
+        if (p >= end || *p != ':')
+        {
+            return false;
+        }
+        p = json_reader_ws(p + 1, end);
+        if (p >= end)
+        {
+            return false;
+        }
+
+        // value
+        const char *value = p;
+        json_reader_type_t type;
+        p = json_reader_skip_value(p, end, &type);
+        if (!p)
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < n; i++)
+        {
+            if (strlen(keys[i]) == key_len && memcmp(keys[i], key, key_len) == 0)
+            {
+                out[i].type = type;
+                out[i].p = (type == JSON_READER_STRING) ? value + 1 : value;
+                out[i].len = (type == JSON_READER_STRING) ? (size_t)(p - value - 2) : (size_t)(p - value);
+            }
+        }
+
+        // , 或 }
+        p = json_reader_ws(p, end);
+        if (p >= end)
+        {
+            return false;
+        }
+        if (*p == '}')
+        {
+            return json_reader_ws(p + 1, end) == end;
+        }
+        if (*p != ',')
+        {
+            return false;
+        }
+        p = json_reader_ws(p + 1, end);
+    }
+}
+
+bool json_span_int(const json_span_t *v, int64_t *out)
+{
+    if (!v || v->type != JSON_READER_NUMBER || v->len == 0)
+    {
+        return false;
+    }
+
+    const char *p = v->p;
+    const char *end = v->p + v->len;
+    bool neg = (*p == '-');
+    if (neg)
+    {
+        p++;
+    }
+    if (p >= end)
+    {
+        return false;
+    }
+
+    // 按负数累加，INT64_MIN 也能表示
+    int64_t value = 0;
+    for (; p < end; p++)
+    {
+        if (*p < '0' || *p > '9')
+        {
+            return false;
+        }
+        int digit = *p - '0';
+        if (value < (INT64_MIN + digit) / 10)
+        {
+            return false;
+        }
+        value = value * 10 - digit;
+    }
+
+    if (!neg)
+    {
+        if (value == INT64_MIN)
+        {
+            return false;
+        }
+        value = -value;
+    }
+    *out = value;
+    return true;
+}
+
+bool json_span_bool(const json_span_t *v, bool *out)
+{
+    if (!v || (v->type != JSON_READER_TRUE && v->type != JSON_READER_FALSE))
+    {
+        return false;
+    }
+    *out = (v->type == JSON_READER_TRUE);
+    return true;
+}
+
+static int json_reader_hex(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+bool json_span_string(const json_span_t *v, char *buf, size_t cap)
+{
+    if (!v || v->type != JSON_READER_STRING || !buf || cap == 0)
+    {
+        return false;
+    }
+
+    const char *p = v->p;
+    const char *end = v->p + v->len;
+    size_t n = 0;
+
+    while (p < end)
+    {
+        char c = *p++;
+        if (c == '\\')
+        {
+            if (p >= end)
+            {
+                return false;
+            }
+            char e = *p++;
+            switch (e)
+            {
+            case '"':
+            case '\\':
+            case '/':
+                c = e;
+                break;
+            case 'b':
+                c = '\b';
+                break;
+            case 'f':
+                c = '\f';
+                break;
+            case 'n':
+                c = '\n';
+                break;
+            case 'r':
+                c = '\r';
+                break;
+            case 't':
+                c = '\t';
+                break;
+            case 'u':
+            {
+                int code = 0;
+                for (int i = 0; i < 4; i++)
+                {
+                    int h = (p < end) ? json_reader_hex(*p++) : -1;
+                    if (h < 0)
+                    {
+                        return false;
+                    }
+                    code = (code << 4) | h;
+                }
+                if (code == 0 || code > 0x7F)
+                {
+                    return false;
+                }
+                c = (char)code;
+                break;
+            }
+            default:
+                return false;
+            }
+        }
+
+        if (n + 1 >= cap)
+        {
+            return false;
+        }
+        buf[n++] = c;
+    }
+
+    buf[n] = '\0';
+    return true;
+}
@@ -0,0 +1,243 @@
+#include "json_writer.h"
+#include <string.h>
+
+// ========================
+// 底层输出：空间不够时置位 overflow，不写半截内容
+// ========================
+
+static void json_writer_put(json_writer_t *w, const char *s, size_t n)
+{
+    if (w->overflow)
+    {
+        return;
+    }
+    // 预留结尾 '\0' 的位置
+    if (w->len + n + 1 > w->cap)
+    {
+        w->overflow = true;
+        return;
+    }
+    memcpy(&w->buf[w->len], s, n);
+    w->len += n;
+}
+
+static void json_writer_putc(json_writer_t *w, char c)
+{
+    json_writer_put(w, &c, 1);
+}
+
+// 写值或 key 之前：同一层的第二个元素起加逗号；刚写完 key 时不加
+static void json_writer_sep(json_writer_t *w)
+{
+    if (w->after_key)
+    {
+        w->after_key = false;
+        return;
+    }
+    if (!w->first[w->depth])
+    {
+        json_writer_putc(w, ',');
+    }
+    w->first[w->depth] = false;
+}
+
+// 无符号整数转十进制，倒序写进临时缓冲区再一次输出
+static void json_writer_put_u64(json_writer_t *w, uint64_t v, uint8_t min_digits)
+{
+    char tmp[20];
+    uint8_t n = 0;
+    do
+    {
+        tmp[sizeof(tmp) - 1 - n] = (char)('0' + v % 10);
+        v /= 10;
+        n++;
+    } while ((v != 0 || n < min_digits) && n < sizeof(tmp));
+    json_writer_put(w, &tmp[sizeof(tmp) - n], n);
+}
+
+// ========================
+// 公共接口
+// ========================
+
+void json_writer_init(json_writer_t *w, char *buf, size_t cap)
+{
+    memset(w, 0, sizeof(*w));
+    w->buf = buf;
+    w->cap = cap;
+    w->first[0] = true;
+    if (!buf || cap == 0)
+    {
+        w->overflow = true;
+    }
+}
+
+size_t json_writer_finish(json_writer_t *w)
+{
+    if (w->overflow || w->depth != 0)
+    {
+        if (w->cap > 0)
+        {
+            w->buf[0] = '\0';
+        }
+        return 0;
+    }
+    w->buf[w->len] = '\0';
+    return w->len;
+}
+
+static void json_writer_open(json_writer_t *w, char c)
+{
+    json_writer_sep(w);
+    json_writer_putc(w, c);
+    if (w->depth >= JSON_WRITER_MAX_DEPTH)
+    {
+        w->overflow = true;
+        return;
+    }
+    w->depth++;
+    w->first[w->depth] = true;
+}
+
+static void json_writer_close(json_writer_t *w, char c)
+{
+    json_writer_putc(w, c);
+    if (w->depth > 0)
+    {
+        w->depth--;
+    }
+}
+
+void json_writer_begin_object(json_writer_t *w) { json_writer_open(w, '{'); }
+void json_writer_end_object(json_writer_t *w) { json_writer_close(w, '}'); }
+void json_writer_begin_array(json_writer_t *w) { json_writer_open(w, '['); }
+void json_writer_end_array(json_writer_t *w) { json_writer_close(w, ']'); }
+
+// 字符串：转义引号、反斜杠和控制字符
+static void json_writer_put_string(json_writer_t *w, const char *str)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    json_writer_putc(w, '"');
+    for (const char *p = str; p && *p; p++)
+    {
+        unsigned char c = (unsigned char)*p;
+        if (c == '"' || c == '\\')
+        {
+            char esc[2] = {'\\', (char)c};
+            json_writer_put(w, esc, 2);
+        }
+        else if (c < 0x20)
+        {
+            char esc[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0x0F]};
+            json_writer_put(w, esc, 6);
+        }
+        else
+        {
+            json_writer_putc(w, (char)c);
+        }
+    }
+    json_writer_putc(w, '"');
+}
+
+void json_writer_key(json_writer_t *w, const char *key)
+{
+    json_writer_sep(w);
+    json_writer_put_string(w, key);
+    json_writer_putc(w, ':');
+    w->after_key = true;
+}
+
+void json_writer_int(json_writer_t *w, int64_t value)
+{
+    json_writer_sep(w);
+    if (value < 0)
+    {
+        json_writer_putc(w, '-');
+        // 先转成无符号再取负，INT64_MIN 也不会溢出
+        json_writer_put_u64(w, (uint64_t)0 - (uint64_t)value, 1);
+    }
+    else
+    {
+        json_writer_put_u64(w, (uint64_t)value, 1);
+    }
+}
+
+void json_writer_fixed(json_writer_t *w, int64_t value, uint8_t decimals)
+{
+    static const uint32_t pow10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+    if (decimals == 0 || decimals > 9)
+    {
+        json_writer_int(w, value);
+        return;
+    }
+
+    json_writer_sep(w);
+    uint64_t mag = (value < 0) ? (uint64_t)0 - (uint64_t)value : (uint64_t)value;
+    if (value < 0)
+    {
+        json_writer_putc(w, '-');
+    }
+    json_writer_put_u64(w, mag / pow10[decimals], 1);
+    json_writer_putc(w, '.');
+    json_writer_put_u64(w, mag % pow10[decimals], decimals);
+}
+
+void json_writer_bool(json_writer_t *w, bool value)
+{
+    json_writer_sep(w);
+    if (value)
+    {
+        json_writer_put(w, "true", 4);
+    }
+    else
+    {
+        json_writer_put(w, "false", 5);
+    }
+}
+
+void json_writer_null(json_writer_t *w)
+{
+    json_writer_sep(w);
+    json_writer_put(w, "null", 4);
+}
+
+void json_writer_string(json_writer_t *w, const char *str)
+{
+    json_writer_sep(w);
+    json_writer_put_string(w, str);
+}
+
+void json_writer_int32_array(json_writer_t *w, const int32_t *values, size_t n)
+{
+    json_writer_begin_array(w);
+    for (size_t i = 0; i < n && !w->overflow; i++)
+    {
+        json_writer_int(w, values[i]);
+    }
+    json_writer_end_array(w);
+}
+
+void json_writer_kv_int(json_writer_t *w, const char *key, int64_t value)
+{
+    json_writer_key(w, key);
+    json_writer_int(w, value);
+}
+
+void json_writer_kv_bool(json_writer_t *w, const char *key, bool value)
+{
+    json_writer_key(w, key);
+    json_writer_bool(w, value);
+}
+
+void json_writer_kv_string(json_writer_t *w, const char *key, const char *str)
+{
+    json_writer_key(w, key);
+    json_writer_string(w, str);
+}
+
+void json_writer_kv_fixed(json_writer_t *w, const char *key, int64_t value, uint8_t decimals)
+{
+    json_writer_key(w, key);
+    json_writer_fixed(w, value, decimals);
+}
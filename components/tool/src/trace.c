@@ -0,0 +1,156 @@
+#include "trace.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include <string.h>
+
+// 模块名称，与 trace_module_t 一一对应
+static const char *const s_module_names[TRACE_MOD_MAX] = {"mqtt", "net", "app"};
+
+// 运行期配置：级别单独放一个数组，TRACE_EVENT 的快速检查只读这一个字节
+static volatile uint8_t s_levels[TRACE_MOD_MAX] = {
+    TRACE_RUNTIME_LEVEL_DEFAULT,
+    TRACE_RUNTIME_LEVEL_DEFAULT,
+    TRACE_RUNTIME_LEVEL_DEFAULT,
+};
+static uint16_t s_sample[TRACE_MOD_MAX];
+static uint16_t s_sample_count[TRACE_MOD_MAX];
+
+// 环形缓冲区：s_seq 为最新一条的序号，第 seq 条放在 (seq - 1) % TRACE_RECORD_COUNT
+static trace_record_t s_ring[TRACE_RECORD_COUNT];
+static uint32_t s_seq = 0;
+static uint32_t s_sampled_out = 0;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+bool trace_enabled(trace_module_t module, uint8_t level)
+{
+    return module < TRACE_MOD_MAX && level != TRACE_NONE && level <= s_levels[module];
+}
+
+void trace_write(trace_module_t module, uint8_t level, uint16_t event, const void *data, size_t len)
+{
+    if (module >= TRACE_MOD_MAX)
+    {
+        return;
+    }
+
+    uint32_t ts_us = (uint32_t)esp_timer_get_time();
+    size_t stored = (data && len > TRACE_PAYLOAD_MAX) ? TRACE_PAYLOAD_MAX : (data ? len : 0);
+
+    portENTER_CRITICAL_SAFE(&s_lock);
+
+    // 采样：每 N 条记录第 1 条
+    if (s_sample[module] > 1)
+    {
+        uint16_t n = s_sample_count[module];
+        s_sample_count[module] = (n + 1 >= s_sample[module]) ? 0 : n + 1;
+        if (n != 0)
+        {
+            s_sampled_out++;
+            portEXIT_CRITICAL_SAFE(&s_lock);
+            return;
+        }
+    }
+
+    trace_record_t *r = &s_ring[s_seq % TRACE_RECORD_COUNT];
+    r->seq = ++s_seq;
+    r->ts_us = ts_us;
+    r->module = (uint8_t)module;
+    r->level = level;
+    r->event = event;
+    r->len = (len > UINT16_MAX) ? UINT16_MAX : (uint16_t)len;
+    r->stored = (uint16_t)stored;
+    if (stored)
+    {
+        memcpy(r->data, data, stored);
+    }
+
+    portEXIT_CRITICAL_SAFE(&s_lock);
+}
+
+void trace_set_level(trace_module_t module, uint8_t level, uint16_t sample)
+{
+    if (module >= TRACE_MOD_MAX)
+    {
+        return;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    s_levels[module] = (level > TRACE_VERBOSE) ? TRACE_VERBOSE : level;
+    s_sample[module] = sample;
+    s_sample_count[module] = 0;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void trace_get_level(trace_module_t module, uint8_t *level, uint16_t *sample)
+{
+    if (module >= TRACE_MOD_MAX)
+    {
+        return;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    if (level)
+    {
+        *level = s_levels[module];
+    }
+    if (sample)
+    {
+        *sample = s_sample[module];
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+trace_module_t trace_module_find(const char *name)
+{
+    for (int i = 0; name && i < TRACE_MOD_MAX; i++)
+    {
+        if (strcmp(name, s_module_names[i]) == 0)
+        {
+            return (trace_module_t)i;
+        }
+    }
+    return TRACE_MOD_MAX;
+}
+
+uint32_t trace_last_seq(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    uint32_t seq = s_seq;
+    portEXIT_CRITICAL(&s_lock);
+    return seq;
+}
+
+size_t trace_read(uint32_t since, uint32_t until, trace_record_t *out, size_t max)
+{
+    size_t n = 0;
+
+    portENTER_CRITICAL(&s_lock);
+    uint32_t last = (until < s_seq) ? until : s_seq;
+
+    // 已被覆盖的记录从最早仍在缓冲区中的一条开始
+    uint32_t oldest = (s_seq > TRACE_RECORD_COUNT) ? s_seq - TRACE_RECORD_COUNT + 1 : 1;
+    uint32_t seq = (since + 1 > oldest) ? since + 1 : oldest;
+
+    // 每次最多拷贝 max 条，临界区的长度有上限
+    for (; seq <= last && n < max; seq++)
+    {
+        out[n++] = s_ring[(seq - 1) % TRACE_RECORD_COUNT];
+    }
+
+    portEXIT_CRITICAL(&s_lock);
+    return n;
+}
+
+void trace_get_stats(uint32_t *sampled_out, uint32_t *overwritten)
+{
+    portENTER_CRITICAL(&s_lock);
+    if (sampled_out)
+    {
+        *sampled_out = s_sampled_out;
+    }
+    if (overwritten)
+    {
+        *overwritten = (s_seq > TRACE_RECORD_COUNT) ? s_seq - TRACE_RECORD_COUNT : 0;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
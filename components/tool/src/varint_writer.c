@@ -0,0 +1,66 @@
+#include "varint_writer.h"
+
+void varint_writer_init(varint_writer_t *w, uint8_t *buf, size_t cap)
+{
+    w->buf = buf;
+    w->cap = cap;
+    w->len = 0;
+    w->overflow = (buf == NULL);
+}
+
+size_t varint_writer_finish(varint_writer_t *w)
+{
+    return w->overflow ? 0 : w->len;
+}
+
+void varint_writer_byte(varint_writer_t *w, uint8_t b)
+{
+    if (w->overflow)
+    {
+        return;
+    }
+    if (w->len >= w->cap)
+    {
+        w->overflow = true;
+        return;
+    }
+    w->buf[w->len++] = b;
+}
+
+void varint_writer_uint(varint_writer_t *w, uint64_t v)
+{
+    // 低 7 位在前，除最后一个字节外最高位置 1
+    while (v >= 0x80)
+    {
+        varint_writer_byte(w, (uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    varint_writer_byte(w, (uint8_t)v);
+}
+
+void varint_writer_sint(varint_writer_t *w, int64_t v)
+{
+    varint_writer_uint(w, varint_zigzag64(v));
+}
+
+void varint_writer_delta_int32(varint_writer_t *w, const int32_t *values, size_t n, uint8_t order)
+{
+    int64_t prev = 0;       // 上一个值
+    int64_t prev_delta = 0; // 上一个一阶差分（二阶差分时使用）
+
+    for (size_t i = 0; i < n && !w->overflow; i++)
+    {
+        int64_t delta = (int64_t)values[i] - prev;
+        prev = values[i];
+
+        if (order == 2)
+        {
+            varint_writer_sint(w, delta - prev_delta);
+            prev_delta = delta;
+        }
+        else
+        {
+            varint_writer_sint(w, delta);
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef __UI_STATUS_H__
+#define __UI_STATUS_H__
+
+#include <stdint.h>
+#include "esp_err.h"
+
+/**
+ * 状态事件总线
+ * - 网络、MQTT 等模块在自己的事件回调里只投递一个 2 字节的状态事件，不碰 I2C
+ * - 低优先级的显示任务把一段时间内的事件合并成当前状态，只刷新变化的行
+ */
+
+// 状态事件
+typedef enum
+{
+    UI_EVT_SENSOR_READY = 0, // 传感器初始化完成，arg 为 1 成功 / 0 失败
+    UI_EVT_PROV_AP_STARTED,  // 配网 AP 已开启
+    UI_EVT_PROV_AP_STOPPED,  // 已联网，配网 AP 已关闭
+    UI_EVT_NET_CONNECTED,    // 联网成功，arg 为 ui_net_t
+    UI_EVT_NET_DISCONNECTED, // 网络断开，arg 为 ui_net_t
+    UI_EVT_MQTT_CONNECTED,
+    UI_EVT_MQTT_DISCONNECTED,
+    UI_EVT_MAX,
+} ui_event_id_t;
+
+// 联网方式（与 net_manager 的 net_transport_t 取值相同）
+typedef enum
+{
+    UI_NET_WIFI = 0,
+    UI_NET_CELLULAR = 1,
+} ui_net_t;
+
+typedef struct
+{
+    uint8_t id;  // ui_event_id_t
+    uint8_t arg; // 事件参数
+} ui_event_t;
+
+/**
+ * @brief 创建事件队列（不涉及 I2C，开机后尽早调用，之前投递的事件会被丢弃）
+ */
+esp_err_t ui_status_init(void);
+
+/**
+ * @brief 启动显示任务（OLED 驱动注册之后调用），由显示任务初始化屏幕
+ */
+esp_err_t ui_status_start(void);
+
+/**
+ * @brief 投递一个状态事件，不阻塞，可在任意任务中调用；队列满时丢弃并计数
+ */
+void ui_status_post(ui_event_id_t id, uint8_t arg);
+
+// 因队列满被丢弃的事件数
+uint32_t ui_status_dropped(void);
+
+#endif // __UI_STATUS_H__
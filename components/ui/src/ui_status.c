@@ -0,0 +1,174 @@
+#include "ui_status.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+#include "OLED.h"
+#include <stdbool.h>
+#include <string.h>
+
+static const char *TAG = "UI_STATUS";
+
+// 事件队列长度：显示任务一次取空，合并后只刷新一次屏幕
+#define UI_QUEUE_LEN 16
+
+// 显示任务：最低的应用优先级，I2C 刷屏不会挡住网络和采集
+#define UI_TASK_PRIORITY 1
+#define UI_TASK_STACK_DEPTH 3072
+
+// 屏幕布局：每行 10 像素高，6x8 字体一行最多 21 个字符
+#define UI_LINE_COUNT 3
+#define UI_LINE_HEIGHT 10
+#define UI_LINE_LEN 22
+
+// 各行显示的内容
+enum
+{
+    UI_LINE_SENSOR = 0, // 传感器状态
+    UI_LINE_PROV,       // 配网状态
+    UI_LINE_LINK,       // 网络 / MQTT 连接状态
+};
+
+static QueueHandle_t s_queue = NULL;
+static uint32_t s_dropped = 0;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// 以下只在显示任务中使用
+static char s_lines[UI_LINE_COUNT][UI_LINE_LEN];
+static bool s_dirty[UI_LINE_COUNT];
+
+esp_err_t ui_status_init(void)
+{
+    if (s_queue)
+    {
+        return ESP_OK;
+    }
+
+    s_queue = xQueueCreate(UI_QUEUE_LEN, sizeof(ui_event_t));
+    if (!s_queue)
+    {
+        ESP_LOGE(TAG, "Failed to create event queue");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void ui_status_post(ui_event_id_t id, uint8_t arg)
+{
+    ui_event_t evt = {.id = (uint8_t)id, .arg = arg};
+
+    if (!s_queue || xQueueSend(s_queue, &evt, 0) != pdTRUE)
+    {
+        portENTER_CRITICAL(&s_lock);
+        s_dropped++;
+        portEXIT_CRITICAL(&s_lock);
+    }
+}
+
+uint32_t ui_status_dropped(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    uint32_t dropped = s_dropped;
+    portEXIT_CRITICAL(&s_lock);
+    return dropped;
+}
+
+// ========================
+// 显示任务
+// ========================
+
+static void ui_status_set_line(int line, const char *text)
+{
+    if (strncmp(s_lines[line], text, UI_LINE_LEN - 1) != 0)
+    {
+        strncpy(s_lines[line], text, UI_LINE_LEN - 1);
+        s_lines[line][UI_LINE_LEN - 1] = '\0';
+        s_dirty[line] = true;
+    }
+}
+
+// 事件只改状态，不直接画屏；同一行的多次变化合并成最后一次
+static void ui_status_apply(const ui_event_t *evt)
+{
+    switch ((ui_event_id_t)evt->id)
+    {
+    case UI_EVT_SENSOR_READY:
+        ui_status_set_line(UI_LINE_SENSOR, evt->arg ? "sensor init!" : "sensor init failed");
+        break;
+    case UI_EVT_PROV_AP_STARTED:
+        ui_status_set_line(UI_LINE_PROV, "net setting ap started");
+        break;
+    case UI_EVT_PROV_AP_STOPPED:
+        ui_status_set_line(UI_LINE_PROV, "net success ap stop");
+        break;
+    case UI_EVT_NET_CONNECTED:
+        ui_status_set_line(UI_LINE_LINK, (evt->arg == UI_NET_CELLULAR) ? "4G OK" : "WiFi OK");
+        break;
+    case UI_EVT_NET_DISCONNECTED:
+        ui_status_set_line(UI_LINE_LINK, (evt->arg == UI_NET_CELLULAR) ? "4G lost" : "WiFi lost");
+        break;
+    case UI_EVT_MQTT_CONNECTED:
+        ui_status_set_line(UI_LINE_LINK, "MQTT Connected");
+        break;
+    case UI_EVT_MQTT_DISCONNECTED:
+        ui_status_set_line(UI_LINE_LINK, "MQTT Disconnected");
+        break;
+    default:
+        break;
+    }
+}
+
+// 只重画并发送变化的行，不整屏刷新
+static void ui_status_render(void)
+{
+    for (int i = 0; i < UI_LINE_COUNT; i++)
+    {
+        if (!s_dirty[i])
+        {
+            continue;
+        }
+        OLED_ClearArea(0, i * UI_LINE_HEIGHT, 128, UI_LINE_HEIGHT);
+        OLED_Printf(0, i * UI_LINE_HEIGHT, OLED_6X8, "%s", s_lines[i]);
+        OLED_UpdateArea(0, i * UI_LINE_HEIGHT, 128, UI_LINE_HEIGHT);
+        s_dirty[i] = false;
+    }
+}
+
+static void ui_status_task(void *pvParameters)
+{
+    (void)pvParameters;
+    ui_event_t evt;
+
+    OLED_Init();
+
+    for (;;)
+    {
+        // 等到第一个事件后把队列取空，合并成一次刷新
+        if (xQueueReceive(s_queue, &evt, portMAX_DELAY) != pdTRUE)
+        {
+            continue;
+        }
+        do
+        {
+            ui_status_apply(&evt);
+        } while (xQueueReceive(s_queue, &evt, 0) == pdTRUE);
+
+        ui_status_render();
+    }
+}
+
+esp_err_t ui_status_start(void)
+{
+    esp_err_t err = ui_status_init();
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    if (xTaskCreate(ui_status_task, "ui_status", UI_TASK_STACK_DEPTH, NULL, UI_TASK_PRIORITY, NULL) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Failed to create display task");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
@@ -5,11 +5,12 @@
 #include "freertos/task.h"
 #include "platform_i2c.h"
 #include "mpu6050.h"
-#include "OLED.h"
+#include "ui_status.h"
 #include "wifi.h"
 #include "http_server.h"
 #include "my_mqtt.h"
 #include "net_manager.h"
+#include "net_time.h"
 #include "app_task.h"
 
 static const char *TAG = "main";
@@ -21,23 +22,19 @@ short ax, ay, az;
 #define MQTT_PASSWORD "esp32"
 #define MQTT_CA_CERT NULL
 
+// I2C 速率：MPU6050 最高支持 400KHz；OLED 一帧 1KB 显存，100KHz 下约 90ms，400KHz 下约 23ms
+#define MPU6050_I2C_SPEED_HZ 400000
+#define OLED_I2C_SPEED_HZ 400000
+
 static bool s_mqtt_started = false;
 
 static void net_connected_cb(net_transport_t transport, const char *ip)
 {
-    if (transport == NET_TRANSPORT_CELLULAR)
-    {
-        OLED_ClearArea(0, 20, 128, 10);
-        OLED_Printf(0, 20, OLED_6X8, "4G OK");
-    }
-    else
-    {
-        OLED_ClearArea(0, 20, 128, 10);
-        OLED_Printf(0, 20, OLED_6X8, "WiFi OK");
-    }
-    OLED_Update();
     ESP_LOGI(TAG, "Network connected (%s), IP: %s",(transport == NET_TRANSPORT_CELLULAR) ? "4G" : "Wi-Fi",ip ? ip : "");
 
+    // 联网后启动 SNTP 对时，传感器样本的时间戳在对时完成后换算为 UTC
+    net_time_sync_start(NULL);
+
     if (!s_mqtt_started)
     {
         if (mqtt_app_init(MQTT_URI, MQTT_CLIENT_ID, MQTT_USERNAME, MQTT_PASSWORD, MQTT_CA_CERT) == ESP_OK)
@@ -49,15 +46,16 @@ static void net_connected_cb(net_transport_t transport, const char *ip)
 
     // 到这里说明当前就是已经可以上网 为了功耗考虑 可以关闭配网 AP
     wifi_stop_provisioning_ap();
-
-    OLED_ClearArea(0, 10, 128, 10);
-    OLED_Printf(0, 10, OLED_6X8, "net success ap stop");
-    OLED_Update();
 }
 
 void app_main(void)
 {
-    // 1. 初始化I2C平台
+    // 状态事件队列最先创建，之后各模块的状态事件都不会丢（显示任务在 OLED 驱动注册后再启动）
+    ui_status_init();
+
+    // 1. 初始化I2C平台（先按本板的接线设置各设备的速率）
+    platform_i2c_set_speed(PLATFORM_I2C_DEV_MPU6050, MPU6050_I2C_SPEED_HZ);
+    platform_i2c_set_speed(PLATFORM_I2C_DEV_OLED, OLED_I2C_SPEED_HZ);
     platform_i2c_init();
 
     // 2. 初始化 Wi-Fi（AP+STA 模式） 这个是硬件的初始化配置
@@ -70,13 +68,21 @@ void app_main(void)
     // 3. 注册MPU6050驱动函数
     platform_driver_register();
 
-    // 4. 初始化MPU6050传感器
-    Int_MPU6050_Init();
-    OLED_Init();
-    OLED_Printf(0, 0, OLED_6X8, "sensor init!");
-    OLED_Update();
+    // 4. 初始化MPU6050传感器（失败不阻止启动，采集任务会按读失败退避并计数）
+    int mpu_err = Int_MPU6050_Init();
+    if (mpu_err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "MPU6050 init failed");
+    }
+
+    // 启动显示任务（由它初始化 OLED），屏幕上的内容全部来自状态事件
+    ui_status_start();
+    ui_status_post(UI_EVT_SENSOR_READY, mpu_err == ESP_OK);
 
     net_register_connected_cb(net_connected_cb);
 
-    app_task_init();
+    if (app_task_init() != ESP_OK)
+    {
+        ESP_LOGE(TAG, "App task init failed");
+    }
 }
@@ -0,0 +1,96 @@
+// 下行指令基准：app_cmd_dispatch（json_reader 取字段 + json_writer 写应答）每条指令的耗时，
+// 与用 cJSON 解析同一条指令、建树生成同样应答的耗时和堆分配次数对比
+#include "app_cmd.h"
+#include "cJSON.h"
+#include "test_util.h"
+#include <stdlib.h>
+
+#define BENCH_ROUNDS 200000
+
+static const char *const s_cmds[] = {
+    "{\"id\":1,\"cmd\":\"get_config\"}",
+    "{\"id\":2,\"cmd\":\"set_upload\",\"args\":{\"interval_ms\":5000,\"max_samples\":25}}",
+    "{\"id\":3,\"cmd\":\"set_encoding\",\"args\":{\"codec\":\"json\"}}",
+    "{\"id\":4,\"cmd\":\"set_rate\",\"args\":{\"sample_hz\":\"bad\"}}",
+    "{\"id\":5,\"cmd\":\"no_such_cmd\",\"args\":{}}",
+};
+
+static volatile size_t s_sink;
+static uint64_t s_mallocs;
+
+static void *bench_malloc(size_t n)
+{
+    s_mallocs++;
+    return malloc(n);
+}
+
+// cJSON 的常规写法：解析成树，取 id/cmd/args，建应答树再打印（只做和指令无关的公共部分）
+static size_t bench_cjson_dispatch(const char *json, char *resp, size_t cap)
+{
+    cJSON *root = cJSON_Parse(json);
+    cJSON *out = cJSON_CreateObject();
+    cJSON *id = cJSON_GetObjectItemCaseSensitive(root, "id");
+    cJSON *cmd = cJSON_GetObjectItemCaseSensitive(root, "cmd");
+    cJSON *args = cJSON_GetObjectItemCaseSensitive(root, "args");
+    if (cJSON_IsNumber(id))
+    {
+        cJSON_AddNumberToObject(out, "id", id->valuedouble);
+    }
+    if (cJSON_IsString(cmd))
+    {
+        cJSON_AddStringToObject(out, "cmd", cmd->valuestring);
+    }
+    cJSON *arg;
+    cJSON_ArrayForEach(arg, args)
+    {
+        if (cJSON_IsNumber(arg))
+        {
+            cJSON_AddNumberToObject(out, arg->string, arg->valuedouble);
+        }
+    }
+    cJSON_AddBoolToObject(out, "ok", 1);
+    size_t n = cJSON_PrintPreallocated(out, resp, (int)cap, 0) ? strlen(resp) : 0;
+    cJSON_Delete(out);
+    cJSON_Delete(root);
+    return n;
+}
+
+int main(void)
+{
+    char resp[256];
+    host_log_quiet = 1;
+    app_cmd_init();
+
+    cJSON_Hooks hooks = {.malloc_fn = bench_malloc, .free_fn = free};
+    cJSON_InitHooks(&hooks);
+
+    printf("%-28s %14s %14s %16s\n", "command", "app_cmd ns", "cJSON ns", "cJSON mallocs");
+    for (size_t c = 0; c < sizeof(s_cmds) / sizeof(s_cmds[0]); c++)
+    {
+        const char *json = s_cmds[c];
+        size_t len = strlen(json);
+
+        uint64_t start = test_now_ns();
+        for (int r = 0; r < BENCH_ROUNDS; r++)
+        {
+            s_sink += app_cmd_dispatch(json, len, resp, sizeof(resp));
+        }
+        double reader_ns = (double)(test_now_ns() - start) / BENCH_ROUNDS;
+
+        s_mallocs = 0;
+        start = test_now_ns();
+        for (int r = 0; r < BENCH_ROUNDS; r++)
+        {
+            s_sink += bench_cjson_dispatch(json, resp, sizeof(resp));
+        }
+        double cjson_ns = (double)(test_now_ns() - start) / BENCH_ROUNDS;
+
+        // 表头显示用：取出 cmd 的值
+        const char *name = strstr(json, "\"cmd\":\"") + 7;
+        printf("%-28.*s %14.0f %14.0f %16.1f\n", (int)(strchr(name, '"') - name), name,
+               reader_ns, cjson_ns, (double)s_mallocs / BENCH_ROUNDS);
+    }
+
+    cJSON_InitHooks(NULL);
+    return 0;
+}
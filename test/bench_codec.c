@@ -0,0 +1,158 @@
+// 上行编码基准：
+// 1. 同一批次用 cJSON 建树再打印，与 json_writer 直接写缓冲区对比：每条消息耗时与堆分配次数
+// 2. JSON / CBOR / 差分编码的体积、每 1000 个样本的编码耗时，以及参考解码器的解码耗时
+#include "app_codec.h"
+#include "cJSON.h"
+#include "upload_decode.h"
+#include "test_util.h"
+#include <stdlib.h>
+
+#define BENCH_ROUNDS 20000
+
+static app_batch_t s_batch;
+static uint8_t s_out[8192];
+static volatile size_t s_sink;
+
+// ========================
+// 统计 cJSON 的堆分配
+// ========================
+
+static uint64_t s_mallocs;
+static uint64_t s_malloc_bytes;
+
+static void *bench_malloc(size_t n)
+{
+    s_mallocs++;
+    s_malloc_bytes += n;
+    return malloc(n);
+}
+
+static void bench_free(void *p)
+{
+    free(p);
+}
+
+// 与 app_codec 输出相同的文档，按 cJSON 的常规用法建树
+static char *bench_cjson_encode(const app_batch_t *batch)
+{
+    const int32_t *cols[UPLOAD_COLUMNS] = {batch->dt_us, batch->ax, batch->ay, batch->az,
+                                           batch->gx, batch->gy, batch->gz, batch->temp};
+    cJSON *root = cJSON_CreateObject();
+    cJSON_AddStringToObject(root, "type", "upload");
+    cJSON_AddNumberToObject(root, "ver", APP_CODEC_SCHEMA_VER);
+    cJSON_AddNumberToObject(root, "t0", (double)batch->t0_us);
+    cJSON_AddBoolToObject(root, "utc", 0);
+    cJSON_AddNumberToObject(root, "n", batch->count);
+    for (int c = 0; c < UPLOAD_COLUMNS; c++)
+    {
+        cJSON_AddItemToObject(root, upload_column_keys[c], cJSON_CreateIntArray((const int *)cols[c], batch->count));
+    }
+    char *out = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    return out;
+}
+
+static void bench_fill(void)
+{
+    srand(1);
+    app_batch_reset(&s_batch);
+    for (int i = 0; i < APP_BATCH_CAPACITY; i++)
+    {
+        app_sample_t s = {0};
+        s.ts_us = 1000000 + (int64_t)i * 10000;
+        s.ax = (int16_t)(rand() % 41 - 20);
+        s.ay = (int16_t)(rand() % 41 - 20);
+        s.az = (int16_t)(1000 + rand() % 41 - 20);
+        s.gx = (int32_t)(rand() % 2001 - 1000);
+        s.gy = (int32_t)(rand() % 2001 - 1000);
+        s.gz = (int32_t)(rand() % 2001 - 1000);
+        s.temp = (int16_t)(2537 + rand() % 3);
+        app_batch_push(&s_batch, &s, APP_BATCH_PRIO_NORMAL);
+    }
+}
+
+static void bench_cjson_vs_writer(void)
+{
+    cJSON_Hooks hooks = {.malloc_fn = bench_malloc, .free_fn = bench_free};
+    cJSON_InitHooks(&hooks);
+
+    s_mallocs = 0;
+    s_malloc_bytes = 0;
+    size_t cjson_len = 0;
+    uint64_t start = test_now_ns();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+    {
+        char *out = bench_cjson_encode(&s_batch);
+        cjson_len = strlen(out);
+        s_sink += cjson_len;
+        free(out);
+    }
+    double cjson_ns = (double)(test_now_ns() - start) / BENCH_ROUNDS;
+    double mallocs = (double)s_mallocs / BENCH_ROUNDS;
+    double malloc_bytes = (double)s_malloc_bytes / BENCH_ROUNDS;
+
+    const app_codec_t *json = app_codec_get(APP_CODEC_JSON);
+    size_t writer_len = 0;
+    start = test_now_ns();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+    {
+        writer_len = json->encode_batch(&s_batch, 0, s_batch.count, s_out, sizeof(s_out));
+        s_sink += writer_len;
+    }
+    double writer_ns = (double)(test_now_ns() - start) / BENCH_ROUNDS;
+
+    cJSON_InitHooks(NULL);
+
+    printf("JSON, %d samples per message:\n", s_batch.count);
+    printf("  cJSON tree + print: %8.0f ns/msg, %6.1f mallocs/msg (%.0f bytes), %zu bytes out\n",
+           cjson_ns, mallocs, malloc_bytes, cjson_len);
+    printf("  json_writer:        %8.0f ns/msg, %6.1f mallocs/msg, %zu bytes out (%.1fx faster)\n",
+           writer_ns, 0.0, writer_len, cjson_ns / writer_ns);
+}
+
+static void bench_codecs(void)
+{
+    static upload_t up;
+    typedef bool (*decode_fn_t)(const uint8_t *, size_t, upload_t *);
+    static const decode_fn_t decoders[APP_CODEC_MAX] = {upload_decode_json, upload_decode_cbor, upload_decode_delta};
+    size_t json_len = 0;
+    const double per_1000 = 1000.0 / ((double)BENCH_ROUNDS * s_batch.count);
+
+    printf("\n%-6s %8s %10s %10s %16s %16s\n", "codec", "bytes", "B/sample", "vs json", "encode us/1000", "decode us/1000");
+    for (int id = 0; id < APP_CODEC_MAX; id++)
+    {
+        const app_codec_t *codec = app_codec_get((app_codec_id_t)id);
+        size_t len = 0;
+
+        uint64_t start = test_now_ns();
+        for (int r = 0; r < BENCH_ROUNDS; r++)
+        {
+            len = codec->encode_batch(&s_batch, 0, s_batch.count, s_out, sizeof(s_out));
+            s_sink += len;
+        }
+        double enc_ns = (double)(test_now_ns() - start);
+
+        start = test_now_ns();
+        for (int r = 0; r < BENCH_ROUNDS; r++)
+        {
+            s_sink += decoders[id](s_out, len, &up);
+        }
+        double dec_ns = (double)(test_now_ns() - start);
+
+        if (id == APP_CODEC_JSON)
+        {
+            json_len = len;
+        }
+        printf("%-6s %8zu %10.2f %9.0f%% %16.1f %16.1f\n", codec->name, len, (double)len / s_batch.count,
+               100.0 * (double)len / (double)json_len, enc_ns * per_1000 / 1000.0, dec_ns * per_1000 / 1000.0);
+    }
+}
+
+int main(void)
+{
+    host_log_quiet = 1;
+    bench_fill();
+    bench_cjson_vs_writer();
+    bench_codecs();
+    return 0;
+}
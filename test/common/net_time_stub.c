@@ -0,0 +1,33 @@
+// net_time 的主机替身：测试通过 net_time_stub_set 控制是否已对时
+#include "net_time.h"
+#include "net_time_stub.h"
+
+static bool s_synced = false;
+static int64_t s_offset_us = 0;
+
+void net_time_stub_set(bool synced, int64_t offset_us)
+{
+    s_synced = synced;
+    s_offset_us = offset_us;
+}
+
+esp_err_t net_time_sync_start(const char *server)
+{
+    (void)server;
+    return ESP_OK;
+}
+
+bool net_time_is_synced(void)
+{
+    return s_synced;
+}
+
+esp_err_t net_time_to_epoch_us(int64_t mono_us, int64_t *epoch_us)
+{
+    if (!s_synced)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    *epoch_us = mono_us + s_offset_us;
+    return ESP_OK;
+}
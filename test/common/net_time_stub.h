@@ -0,0 +1,10 @@
+#ifndef __NET_TIME_STUB_H__
+#define __NET_TIME_STUB_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// 设置替身的对时状态：synced 为 true 时 UTC = esp_timer 时间 + offset_us
+void net_time_stub_set(bool synced, int64_t offset_us);
+
+#endif // __NET_TIME_STUB_H__
@@ -0,0 +1,8 @@
+// platform 的主机替身：app_calib 只用到量程，固定为上电默认的 ±2g / ±2000°/s
+#include "platform.h"
+
+void platform_sensor_get_range(uint16_t *accel_g, uint16_t *gyro_dps)
+{
+    *accel_g = 2;
+    *gyro_dps = 2000;
+}
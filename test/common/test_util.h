@@ -0,0 +1,64 @@
+// 主机测试的断言与计时工具：不依赖测试框架，失败时打印位置并计数，main 返回非 0 让 ctest 判为失败
+#ifndef __TEST_UTIL_H__
+#define __TEST_UTIL_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "esp_log.h"
+
+static int test_failures __attribute__((unused)) = 0;
+
+#define TEST_CHECK(cond)                                                        \
+    do                                                                          \
+    {                                                                           \
+        if (!(cond))                                                            \
+        {                                                                       \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            test_failures++;                                                    \
+        }                                                                       \
+    } while (0)
+
+#define TEST_CHECK_INT(expected, actual)                                                    \
+    do                                                                                      \
+    {                                                                                       \
+        long long e_ = (long long)(expected), a_ = (long long)(actual);                     \
+        if (e_ != a_)                                                                       \
+        {                                                                                   \
+            fprintf(stderr, "%s:%d: %s: expected %lld, got %lld\n", __FILE__, __LINE__, #actual, e_, a_); \
+            test_failures++;                                                                \
+        }                                                                                   \
+    } while (0)
+
+#define TEST_CHECK_STR(expected, actual)                                                     \
+    do                                                                                       \
+    {                                                                                        \
+        const char *e_ = (expected), *a_ = (actual);                                         \
+        if (strcmp(e_, a_) != 0)                                                             \
+        {                                                                                    \
+            fprintf(stderr, "%s:%d: %s:\n  expected %s\n  got      %s\n", __FILE__, __LINE__, #actual, e_, a_); \
+            test_failures++;                                                                 \
+        }                                                                                    \
+    } while (0)
+
+#define RUN_TEST(fn)                                 \
+    do                                               \
+    {                                                \
+        int before_ = test_failures;                 \
+        fn();                                        \
+        printf("%-40s %s\n", #fn, test_failures == before_ ? "ok" : "FAIL"); \
+    } while (0)
+
+#define TEST_RESULT() (test_failures == 0 ? 0 : 1)
+
+// 单调时钟（纳秒），基准测试用
+static inline uint64_t test_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+#endif // __TEST_UTIL_H__
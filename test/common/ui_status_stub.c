@@ -0,0 +1,8 @@
+// ui_status 的主机替身：my_mqtt 在连接状态变化时投递事件，测试中不显示
+#include "ui_status.h"
+
+void ui_status_post(ui_event_id_t id, uint8_t arg)
+{
+    (void)id;
+    (void)arg;
+}
@@ -0,0 +1,365 @@
+#include "upload_decode.h"
+#include <string.h>
+#include "cJSON.h"
+
+// 差分编码的首字节与标志位（与 app_codec.c 的格式说明一致）
+#define UPLOAD_DELTA_MAGIC 0xD3
+#define UPLOAD_DELTA_F_UTC 0x01
+
+const char *const upload_column_keys[UPLOAD_COLUMNS] = {"dt", "ax", "ay", "az", "gx", "gy", "gz", "temp"};
+
+static int upload_column_index(const char *key, size_t len)
+{
+    for (int i = 0; i < UPLOAD_COLUMNS; i++)
+    {
+        if (strlen(upload_column_keys[i]) == len && memcmp(upload_column_keys[i], key, len) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static bool upload_int32_ok(int64_t v)
+{
+    return v >= INT32_MIN && v <= INT32_MAX;
+}
+
+// ========================
+// JSON（cJSON 解析，与服务端常见做法相同）
+// ========================
+
+bool upload_decode_json(const uint8_t *buf, size_t len, upload_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    cJSON *root = cJSON_ParseWithLength((const char *)buf, len);
+    if (!root)
+    {
+        return false;
+    }
+
+    bool ok = false;
+    cJSON *type = cJSON_GetObjectItemCaseSensitive(root, "type");
+    cJSON *ver = cJSON_GetObjectItemCaseSensitive(root, "ver");
+    cJSON *t0 = cJSON_GetObjectItemCaseSensitive(root, "t0");
+    cJSON *utc = cJSON_GetObjectItemCaseSensitive(root, "utc");
+    cJSON *n = cJSON_GetObjectItemCaseSensitive(root, "n");
+    if (!cJSON_IsString(type) || strcmp(type->valuestring, "upload") != 0 || !cJSON_IsNumber(ver) ||
+        !cJSON_IsNumber(t0) || !cJSON_IsBool(utc) || !cJSON_IsNumber(n) ||
+        n->valuedouble < 1 || n->valuedouble > APP_BATCH_CAPACITY)
+    {
+        goto done;
+    }
+    out->ver = (int64_t)ver->valuedouble;
+    out->t0_us = (int64_t)t0->valuedouble;
+    out->utc = cJSON_IsTrue(utc);
+    out->n = (uint16_t)n->valuedouble;
+
+    for (int c = 0; c < UPLOAD_COLUMNS; c++)
+    {
+        cJSON *arr = cJSON_GetObjectItemCaseSensitive(root, upload_column_keys[c]);
+        if (!cJSON_IsArray(arr) || cJSON_GetArraySize(arr) != out->n)
+        {
+            goto done;
+        }
+        int i = 0;
+        cJSON *item;
+        cJSON_ArrayForEach(item, arr)
+        {
+            if (!cJSON_IsNumber(item) || !upload_int32_ok((int64_t)item->valuedouble))
+            {
+                goto done;
+            }
+            out->cols[c][i++] = (int32_t)item->valuedouble;
+        }
+    }
+    ok = true;
+
+done:
+    cJSON_Delete(root);
+    return ok;
+}
+
+// ========================
+// CBOR
+// ========================
+
+bool cbor_read_head(cbor_cursor_t *c, uint8_t *major, uint64_t *arg)
+{
+    if (c->p >= c->end)
+    {
+        return false;
+    }
+    uint8_t ib = *c->p++;
+    uint8_t ai = ib & 0x1F;
+    *major = ib >> 5;
+
+    if (ai < 24)
+    {
+        *arg = ai;
+        return true;
+    }
+    if (ai > 27)
+    {
+        return false; // 不定长和保留值
+    }
+
+    size_t n = (size_t)1 << (ai - 24);
+    if ((size_t)(c->end - c->p) < n)
+    {
+        return false;
+    }
+    uint64_t v = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        v = (v << 8) | *c->p++;
+    }
+    *arg = v;
+    return true;
+}
+
+bool cbor_read_int(cbor_cursor_t *c, int64_t *value)
+{
+    uint8_t major;
+    uint64_t arg;
+    if (!cbor_read_head(c, &major, &arg) || major > 1 || arg > (uint64_t)INT64_MAX)
+    {
+        return false;
+    }
+    *value = (major == 0) ? (int64_t)arg : -1 - (int64_t)arg;
+    return true;
+}
+
+bool cbor_read_text(cbor_cursor_t *c, const char **str, size_t *len)
+{
+    uint8_t major;
+    uint64_t arg;
+    if (!cbor_read_head(c, &major, &arg) || major != 3 || arg > (uint64_t)(c->end - c->p))
+    {
+        return false;
+    }
+    *str = (const char *)c->p;
+    *len = (size_t)arg;
+    c->p += arg;
+    return true;
+}
+
+static bool cbor_read_bool(cbor_cursor_t *c, bool *value)
+{
+    uint8_t major;
+    uint64_t arg;
+    if (!cbor_read_head(c, &major, &arg) || major != 7 || (arg != 20 && arg != 21))
+    {
+        return false;
+    }
+    *value = (arg == 21);
+    return true;
+}
+
+static bool cbor_key_is(const char *key, size_t len, const char *expect)
+{
+    return strlen(expect) == len && memcmp(key, expect, len) == 0;
+}
+
+bool upload_decode_cbor(const uint8_t *buf, size_t len, upload_t *out)
+{
+    cbor_cursor_t c = {buf, buf + len};
+    uint8_t major;
+    uint64_t pairs;
+
+    memset(out, 0, sizeof(*out));
+    if (!cbor_read_head(&c, &major, &pairs) || major != 5)
+    {
+        return false;
+    }
+
+    // 列数组的长度要和 n 一致，n 可能在列之后出现，先记下各列的长度
+    uint64_t col_len[UPLOAD_COLUMNS] = {0};
+    uint32_t seen = 0;
+    int64_t n = -1;
+
+    for (uint64_t i = 0; i < pairs; i++)
+    {
+        const char *key;
+        size_t key_len;
+        if (!cbor_read_text(&c, &key, &key_len))
+        {
+            return false;
+        }
+
+        int col = upload_column_index(key, key_len);
+        if (col >= 0)
+        {
+            uint64_t count;
+            if (!cbor_read_head(&c, &major, &count) || major != 4 || count > APP_BATCH_CAPACITY)
+            {
+                return false;
+            }
+            for (uint64_t k = 0; k < count; k++)
+            {
+                int64_t v;
+                if (!cbor_read_int(&c, &v) || !upload_int32_ok(v))
+                {
+                    return false;
+                }
+                out->cols[col][k] = (int32_t)v;
+            }
+            col_len[col] = count;
+            seen |= 1u << col;
+        }
+        else if (cbor_key_is(key, key_len, "type"))
+        {
+            const char *type;
+            size_t type_len;
+            if (!cbor_read_text(&c, &type, &type_len) || !cbor_key_is(type, type_len, "upload"))
+            {
+                return false;
+            }
+        }
+        else if (cbor_key_is(key, key_len, "ver"))
+        {
+            if (!cbor_read_int(&c, &out->ver))
+            {
+                return false;
+            }
+        }
+        else if (cbor_key_is(key, key_len, "t0"))
+        {
+            if (!cbor_read_int(&c, &out->t0_us))
+            {
+                return false;
+            }
+        }
+        else if (cbor_key_is(key, key_len, "utc"))
+        {
+            if (!cbor_read_bool(&c, &out->utc))
+            {
+                return false;
+            }
+        }
+        else if (cbor_key_is(key, key_len, "n"))
+        {
+            if (!cbor_read_int(&c, &n))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    if (c.p != c.end || n < 1 || n > APP_BATCH_CAPACITY || seen != (1u << UPLOAD_COLUMNS) - 1)
+    {
+        return false;
+    }
+    for (int i = 0; i < UPLOAD_COLUMNS; i++)
+    {
+        if (col_len[i] != (uint64_t)n)
+        {
+            return false;
+        }
+    }
+    out->n = (uint16_t)n;
+    return true;
+}
+
+// ========================
+// 差分 + 变长整数
+// ========================
+
+bool varint_read_uint(const uint8_t **p, const uint8_t *end, uint64_t *value)
+{
+    uint64_t v = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+        if (*p >= end)
+        {
+            return false;
+        }
+        uint8_t b = *(*p)++;
+        v |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+        {
+            *value = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool varint_read_sint(const uint8_t **p, const uint8_t *end, int64_t *value)
+{
+    uint64_t u;
+    if (!varint_read_uint(p, end, &u))
+    {
+        return false;
+    }
+    *value = (int64_t)(u >> 1) ^ -(int64_t)(u & 1);
+    return true;
+}
+
+bool upload_decode_delta(const uint8_t *buf, size_t len, upload_t *out)
+{
+    const uint8_t *p = buf;
+    const uint8_t *end = buf + len;
+    uint64_t ver, n;
+
+    memset(out, 0, sizeof(*out));
+    if (len < 3 || *p++ != UPLOAD_DELTA_MAGIC || !varint_read_uint(&p, end, &ver) || p >= end)
+    {
+        return false;
+    }
+    uint8_t flags = *p++;
+    if (!varint_read_sint(&p, end, &out->t0_us) || !varint_read_uint(&p, end, &n) ||
+        n < 1 || n > APP_BATCH_CAPACITY)
+    {
+        return false;
+    }
+    out->ver = (int64_t)ver;
+    out->utc = (flags & UPLOAD_DELTA_F_UTC) != 0;
+    out->n = (uint16_t)n;
+
+    for (int c = 0; c < UPLOAD_COLUMNS; c++)
+    {
+        int64_t prev = 0;
+        int64_t prev_delta = 0;
+        for (uint64_t i = 0; i < n; i++)
+        {
+            int64_t d;
+            if (!varint_read_sint(&p, end, &d))
+            {
+                return false;
+            }
+            // dt 为二阶差分，其余为一阶差分
+            int64_t delta = (c == 0) ? prev_delta + d : d;
+            prev_delta = delta;
+            prev += delta;
+            if (!upload_int32_ok(prev))
+            {
+                return false;
+            }
+            out->cols[c][i] = (int32_t)prev;
+        }
+    }
+    return p == end;
+}
+
+bool upload_matches_batch(const upload_t *up, const app_batch_t *batch, uint16_t start, uint16_t n)
+{
+    const int32_t *cols[UPLOAD_COLUMNS] = {batch->dt_us, batch->ax, batch->ay, batch->az,
+                                           batch->gx, batch->gy, batch->gz, batch->temp};
+    if (up->n != n)
+    {
+        return false;
+    }
+    for (int c = 0; c < UPLOAD_COLUMNS; c++)
+    {
+        if (memcmp(up->cols[c], &cols[c][start], n * sizeof(int32_t)) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,53 @@
+// 上行批量数据的参考解码器：按服务端的方式把 JSON / CBOR / 差分编码还原成同一个结构，供往返测试和基准使用
+// 只接受 app_codec 实际输出的结构（定长容器、规定的键和顺序无关），遇到不认识的内容返回 false
+#ifndef __UPLOAD_DECODE_H__
+#define __UPLOAD_DECODE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "app_batch.h"
+
+// 列的顺序与 app_codec 相同：dt ax ay az gx gy gz temp
+#define UPLOAD_COLUMNS 8
+
+typedef struct
+{
+    int64_t ver;
+    int64_t t0_us;
+    bool utc;
+    uint16_t n;
+    int32_t cols[UPLOAD_COLUMNS][APP_BATCH_CAPACITY];
+} upload_t;
+
+extern const char *const upload_column_keys[UPLOAD_COLUMNS];
+
+bool upload_decode_json(const uint8_t *buf, size_t len, upload_t *out);
+bool upload_decode_cbor(const uint8_t *buf, size_t len, upload_t *out);
+bool upload_decode_delta(const uint8_t *buf, size_t len, upload_t *out);
+
+// 与批次第 start 个起的 n 个样本比较
+bool upload_matches_batch(const upload_t *up, const app_batch_t *batch, uint16_t start, uint16_t n);
+
+// ========================
+// 最小 CBOR 读取器：只支持定长编码
+// ========================
+typedef struct
+{
+    const uint8_t *p;
+    const uint8_t *end;
+} cbor_cursor_t;
+
+// 读一个数据项的头：主类型（0~7）和参数（整数值、长度或元素个数、简单值）
+bool cbor_read_head(cbor_cursor_t *c, uint8_t *major, uint64_t *arg);
+bool cbor_read_int(cbor_cursor_t *c, int64_t *value);
+// 文本串：返回指向缓冲区内部的指针和长度（不以 '\0' 结尾）
+bool cbor_read_text(cbor_cursor_t *c, const char **str, size_t *len);
+
+// ========================
+// 变长整数读取
+// ========================
+bool varint_read_uint(const uint8_t **p, const uint8_t *end, uint64_t *value);
+bool varint_read_sint(const uint8_t **p, const uint8_t *end, int64_t *value);
+
+#endif // __UPLOAD_DECODE_H__
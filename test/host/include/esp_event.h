@@ -0,0 +1,13 @@
+// 主机测试用的 esp_event.h：只有事件回调的类型，事件由各模拟器直接回调
+#ifndef __HOST_ESP_EVENT_H__
+#define __HOST_ESP_EVENT_H__
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef const char *esp_event_base_t;
+typedef void (*esp_event_handler_t)(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data);
+
+#define ESP_EVENT_ANY_ID -1
+
+#endif // __HOST_ESP_EVENT_H__
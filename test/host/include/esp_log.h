@@ -0,0 +1,25 @@
+// 主机测试用的 esp_log.h：日志打到 stderr，HOST_LOG_QUIET 非 0 时只保留错误
+#ifndef __HOST_ESP_LOG_H__
+#define __HOST_ESP_LOG_H__
+
+#include <stdio.h>
+
+extern int host_log_quiet;
+
+#define HOST_LOG(letter, tag, fmt, ...)                                      \
+    do                                                                       \
+    {                                                                        \
+        if (!host_log_quiet || (letter) == 'E')                              \
+        {                                                                    \
+            fprintf(stderr, "%c (%s) " fmt "\n", (letter), tag, ##__VA_ARGS__); \
+        }                                                                    \
+    } while (0)
+
+#define ESP_LOGE(tag, fmt, ...) HOST_LOG('E', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) HOST_LOG('W', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) HOST_LOG('I', tag, fmt, ##__VA_ARGS__)
+// DEBUG / VERBOSE 不输出，参数照常检查（避免只在日志里用到的变量报未使用）
+#define ESP_LOGD(tag, fmt, ...) do { if (0) fprintf(stderr, "%s " fmt, tag, ##__VA_ARGS__); } while (0)
+#define ESP_LOGV(tag, fmt, ...) do { if (0) fprintf(stderr, "%s " fmt, tag, ##__VA_ARGS__); } while (0)
+
+#endif // __HOST_ESP_LOG_H__
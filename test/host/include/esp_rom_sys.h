@@ -0,0 +1,9 @@
+// 主机测试用的 esp_rom_sys.h
+#ifndef __HOST_ESP_ROM_SYS_H__
+#define __HOST_ESP_ROM_SYS_H__
+
+#include <stdint.h>
+
+void esp_rom_delay_us(uint32_t us);
+
+#endif // __HOST_ESP_ROM_SYS_H__
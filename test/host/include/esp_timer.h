@@ -0,0 +1,9 @@
+// 主机测试用的 esp_timer.h：单调时钟，从进程启动开始计
+#ifndef __HOST_ESP_TIMER_H__
+#define __HOST_ESP_TIMER_H__
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
+
+#endif // __HOST_ESP_TIMER_H__
@@ -0,0 +1,18 @@
+#ifndef __HOST_FREERTOS_QUEUE_H__
+#define __HOST_FREERTOS_QUEUE_H__
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct host_queue *QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t len, UBaseType_t item_size);
+#define xQueueCreateStatic(len, item_size, storage, ctrl) ((void)(storage), (void)(ctrl), xQueueCreate(len, item_size))
+void vQueueDelete(QueueHandle_t q);
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t wait);
+#define xQueueSendToBack(q, item, wait) xQueueSend(q, item, wait)
+#define xQueueSendFromISR(q, item, woken) ((void)(woken), xQueueSend(q, item, 0))
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t wait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q);
+
+#endif // __HOST_FREERTOS_QUEUE_H__
@@ -0,0 +1,21 @@
+#ifndef __HOST_FREERTOS_SEMPHR_H__
+#define __HOST_FREERTOS_SEMPHR_H__
+
+#include "freertos/FreeRTOS.h"
+
+// 信号量与互斥锁都用计数信号量实现（互斥锁没有优先级继承，也不检查持有者）
+typedef struct host_sem *SemaphoreHandle_t;
+
+SemaphoreHandle_t host_sem_create(UBaseType_t max, UBaseType_t initial);
+void vSemaphoreDelete(SemaphoreHandle_t sem);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t sem);
+
+#define xSemaphoreCreateMutex() host_sem_create(1, 1)
+#define xSemaphoreCreateBinary() host_sem_create(1, 0)
+#define xSemaphoreCreateCounting(max, initial) host_sem_create(max, initial)
+#define xSemaphoreCreateCountingStatic(max, initial, buf) ((void)(buf), host_sem_create(max, initial))
+#define xSemaphoreGiveFromISR(sem, woken) ((void)(woken), xSemaphoreGive(sem))
+
+#endif // __HOST_FREERTOS_SEMPHR_H__
@@ -0,0 +1,9 @@
+// 主机测试用的 sdkconfig.h：与设备上的默认配置一致
+#ifndef __HOST_SDKCONFIG_H__
+#define __HOST_SDKCONFIG_H__
+
+#define CONFIG_APP_STATIC_ALLOC 0
+#define CONFIG_FREERTOS_HZ 1000
+#define CONFIG_MQTT_CUSTOM_OUTBOX 1
+
+#endif // __HOST_SDKCONFIG_H__
@@ -0,0 +1,12 @@
+// 主机测试用的 sys/queue.h：glibc 的版本缺少 ESP-IDF（newlib）中的 *_FOREACH_SAFE，在这里补上
+#ifndef __HOST_SYS_QUEUE_H__
+#define __HOST_SYS_QUEUE_H__
+
+#include_next <sys/queue.h>
+
+#ifndef STAILQ_FOREACH_SAFE
+#define STAILQ_FOREACH_SAFE(var, head, field, tvar) \
+    for ((var) = STAILQ_FIRST((head)); (var) && ((tvar) = STAILQ_NEXT((var), field), 1); (var) = (tvar))
+#endif
+
+#endif // __HOST_SYS_QUEUE_H__
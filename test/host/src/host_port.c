@@ -0,0 +1,501 @@
+// 主机测试用的 ESP-IDF / FreeRTOS 接口实现：队列、信号量、任务都基于 pthread
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include <errno.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+int host_log_quiet = 0;
+
+// ========================
+// 错误码与时间
+// ========================
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code)
+    {
+    case ESP_OK: return "ESP_OK";
+    case ESP_FAIL: return "ESP_FAIL";
+    case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_INVALID_RESPONSE: return "ESP_ERR_INVALID_RESPONSE";
+    case ESP_ERR_INVALID_CRC: return "ESP_ERR_INVALID_CRC";
+    case ESP_ERR_INVALID_VERSION: return "ESP_ERR_INVALID_VERSION";
+    case ESP_ERR_NOT_FINISHED: return "ESP_ERR_NOT_FINISHED";
+    case ESP_ERR_NVS_NOT_FOUND: return "ESP_ERR_NVS_NOT_FOUND";
+    default: return "UNKNOWN ERROR";
+    }
+}
+
+static int64_t host_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int64_t s_boot_us = 0;
+
+int64_t esp_timer_get_time(void)
+{
+    if (s_boot_us == 0)
+    {
+        s_boot_us = host_now_us() - 1;
+    }
+    return host_now_us() - s_boot_us;
+}
+
+void esp_rom_delay_us(uint32_t us)
+{
+    struct timespec ts = {.tv_sec = us / 1000000, .tv_nsec = (long)(us % 1000000) * 1000};
+    nanosleep(&ts, NULL);
+}
+
+// ========================
+// 临界区：一把全局递归锁
+// ========================
+
+static pthread_mutex_t s_critical;
+static pthread_once_t s_critical_once = PTHREAD_ONCE_INIT;
+
+static void host_critical_init(void)
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&s_critical, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+void host_critical_enter(void)
+{
+    pthread_once(&s_critical_once, host_critical_init);
+    pthread_mutex_lock(&s_critical);
+}
+
+void host_critical_exit(void)
+{
+    pthread_mutex_unlock(&s_critical);
+}
+
+// ========================
+// 等待：条件变量用单调时钟，wait 为 tick（1 ms）
+// ========================
+
+static void host_cond_init(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+static struct timespec host_deadline(TickType_t wait)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t ns = (uint64_t)ts.tv_nsec + (uint64_t)wait * portTICK_PERIOD_MS * 1000000ULL;
+    ts.tv_sec += (time_t)(ns / 1000000000ULL);
+    ts.tv_nsec = (long)(ns % 1000000000ULL);
+    return ts;
+}
+
+// 在 mutex 已持有的情况下等待 ready() 为真，超时返回 false
+static bool host_wait(pthread_cond_t *cond, pthread_mutex_t *mutex, TickType_t wait, bool (*ready)(void *), void *ctx)
+{
+    struct timespec deadline = host_deadline(wait == portMAX_DELAY ? 0 : wait);
+    while (!ready(ctx))
+    {
+        if (wait == 0)
+        {
+            return false;
+        }
+        if (wait == portMAX_DELAY)
+        {
+            pthread_cond_wait(cond, mutex);
+        }
+        else if (pthread_cond_timedwait(cond, mutex, &deadline) == ETIMEDOUT)
+        {
+            return ready(ctx);
+        }
+    }
+    return true;
+}
+
+// ========================
+// 队列
+// ========================
+
+struct host_queue
+{
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    uint8_t *items;
+    UBaseType_t len;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t len, UBaseType_t item_size)
+{
+    struct host_queue *q = calloc(1, sizeof(*q));
+    q->items = calloc(len, item_size ? item_size : 1);
+    q->len = len;
+    q->item_size = item_size;
+    pthread_mutex_init(&q->lock, NULL);
+    host_cond_init(&q->changed);
+    return q;
+}
+
+void vQueueDelete(QueueHandle_t q)
+{
+    pthread_mutex_destroy(&q->lock);
+    pthread_cond_destroy(&q->changed);
+    free(q->items);
+    free(q);
+}
+
+static bool host_queue_has_space(void *ctx)
+{
+    struct host_queue *q = ctx;
+    return q->count < q->len;
+}
+
+static bool host_queue_has_item(void *ctx)
+{
+    struct host_queue *q = ctx;
+    return q->count > 0;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t wait)
+{
+    pthread_mutex_lock(&q->lock);
+    if (!host_wait(&q->changed, &q->lock, wait, host_queue_has_space, q))
+    {
+        pthread_mutex_unlock(&q->lock);
+        return pdFALSE;
+    }
+    memcpy(&q->items[((q->head + q->count) % q->len) * q->item_size], item, q->item_size);
+    q->count++;
+    pthread_cond_broadcast(&q->changed);
+    pthread_mutex_unlock(&q->lock);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t wait)
+{
+    pthread_mutex_lock(&q->lock);
+    if (!host_wait(&q->changed, &q->lock, wait, host_queue_has_item, q))
+    {
+        pthread_mutex_unlock(&q->lock);
+        return pdFALSE;
+    }
+    memcpy(item, &q->items[q->head * q->item_size], q->item_size);
+    q->head = (q->head + 1) % q->len;
+    q->count--;
+    pthread_cond_broadcast(&q->changed);
+    pthread_mutex_unlock(&q->lock);
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q)
+{
+    pthread_mutex_lock(&q->lock);
+    UBaseType_t n = q->count;
+    pthread_mutex_unlock(&q->lock);
+    return n;
+}
+
+// ========================
+// 信号量
+// ========================
+
+struct host_sem
+{
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    UBaseType_t count;
+    UBaseType_t max;
+};
+
+SemaphoreHandle_t host_sem_create(UBaseType_t max, UBaseType_t initial)
+{
+    struct host_sem *s = calloc(1, sizeof(*s));
+    s->count = initial;
+    s->max = max;
+    pthread_mutex_init(&s->lock, NULL);
+    host_cond_init(&s->changed);
+    return s;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    pthread_mutex_destroy(&sem->lock);
+    pthread_cond_destroy(&sem->changed);
+    free(sem);
+}
+
+static bool host_sem_available(void *ctx)
+{
+    struct host_sem *s = ctx;
+    return s->count > 0;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait)
+{
+    pthread_mutex_lock(&sem->lock);
+    bool ok = host_wait(&sem->changed, &sem->lock, wait, host_sem_available, sem);
+    if (ok)
+    {
+        sem->count--;
+    }
+    pthread_mutex_unlock(&sem->lock);
+    return ok ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    BaseType_t ok = pdFALSE;
+    pthread_mutex_lock(&sem->lock);
+    if (sem->count < sem->max)
+    {
+        sem->count++;
+        ok = pdTRUE;
+        pthread_cond_broadcast(&sem->changed);
+    }
+    pthread_mutex_unlock(&sem->lock);
+    return ok;
+}
+
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t sem)
+{
+    pthread_mutex_lock(&sem->lock);
+    UBaseType_t n = sem->count;
+    pthread_mutex_unlock(&sem->lock);
+    return n;
+}
+
+// ========================
+// 任务：每个任务一个分离的线程，任务通知用一个计数信号量
+// ========================
+
+struct host_task
+{
+    TaskFunction_t fn;
+    void *arg;
+    SemaphoreHandle_t notify;
+};
+
+static __thread struct host_task *t_current = NULL;
+
+static void *host_task_entry(void *ctx)
+{
+    struct host_task *task = ctx;
+    t_current = task;
+    task->fn(task->arg);
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                   UBaseType_t prio, TaskHandle_t *handle, BaseType_t core)
+{
+    (void)name;
+    (void)stack;
+    (void)prio;
+    (void)core;
+
+    struct host_task *task = calloc(1, sizeof(*task));
+    task->fn = fn;
+    task->arg = arg;
+    task->notify = host_sem_create(0xffffffffu, 0);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, host_task_entry, task) != 0)
+    {
+        free(task);
+        return pdFAIL;
+    }
+    pthread_detach(thread);
+    if (handle)
+    {
+        *handle = task;
+    }
+    return pdPASS;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    esp_rom_delay_us(ticks * portTICK_PERIOD_MS * 1000);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(esp_timer_get_time() / 1000 / portTICK_PERIOD_MS);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    // 测试主线程第一次调用时补一个任务结构
+    if (!t_current)
+    {
+        t_current = calloc(1, sizeof(*t_current));
+        t_current->notify = host_sem_create(0xffffffffu, 0);
+    }
+    return t_current;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait)
+{
+    struct host_task *task = xTaskGetCurrentTaskHandle();
+    if (xSemaphoreTake(task->notify, wait) != pdTRUE)
+    {
+        return 0;
+    }
+    uint32_t n = 1;
+    while (clear && xSemaphoreTake(task->notify, 0) == pdTRUE)
+    {
+        n++;
+    }
+    return n;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    xSemaphoreGive(task->notify);
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken)
+{
+    if (woken)
+    {
+        *woken = pdFALSE;
+    }
+    xTaskNotifyGive(task);
+}
+
+// ========================
+// NVS：固定大小的内存表
+// ========================
+
+#define HOST_NVS_ENTRIES 16
+#define HOST_NVS_BLOB_MAX 512
+
+typedef struct
+{
+    bool used;
+    char ns[16];
+    char key[16];
+    size_t len;
+    uint8_t data[HOST_NVS_BLOB_MAX];
+} host_nvs_entry_t;
+
+static host_nvs_entry_t s_nvs[HOST_NVS_ENTRIES];
+static char s_nvs_open_ns[8][16];
+
+void host_nvs_reset(void)
+{
+    memset(s_nvs, 0, sizeof(s_nvs));
+}
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t mode, nvs_handle_t *out)
+{
+    (void)mode;
+    for (nvs_handle_t i = 0; i < 8; i++)
+    {
+        if (s_nvs_open_ns[i][0] == '\0' || strcmp(s_nvs_open_ns[i], name) == 0)
+        {
+            strncpy(s_nvs_open_ns[i], name, sizeof(s_nvs_open_ns[i]) - 1);
+            *out = i + 1;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+static host_nvs_entry_t *host_nvs_find(nvs_handle_t handle, const char *key)
+{
+    for (int i = 0; i < HOST_NVS_ENTRIES; i++)
+    {
+        if (s_nvs[i].used && strcmp(s_nvs[i].ns, s_nvs_open_ns[handle - 1]) == 0 && strcmp(s_nvs[i].key, key) == 0)
+        {
+            return &s_nvs[i];
+        }
+    }
+    return NULL;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out, size_t *len)
+{
+    host_nvs_entry_t *e = host_nvs_find(handle, key);
+    if (!e)
+    {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (out)
+    {
+        if (*len < e->len)
+        {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        memcpy(out, e->data, e->len);
+    }
+    *len = e->len;
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t len)
+{
+    if (len > HOST_NVS_BLOB_MAX)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    host_nvs_entry_t *e = host_nvs_find(handle, key);
+    for (int i = 0; !e && i < HOST_NVS_ENTRIES; i++)
+    {
+        if (!s_nvs[i].used)
+        {
+            e = &s_nvs[i];
+            e->used = true;
+            strncpy(e->ns, s_nvs_open_ns[handle - 1], sizeof(e->ns) - 1);
+            strncpy(e->key, key, sizeof(e->key) - 1);
+        }
+    }
+    if (!e)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(e->data, value, len);
+    e->len = len;
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    (void)handle;
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    (void)handle;
+}
@@ -0,0 +1,113 @@
+#include "sim_flash.h"
+#include "esp_partition.h"
+#include <stdlib.h>
+#include <string.h>
+
+static esp_partition_t s_part;
+static uint8_t *s_data = NULL;
+static int s_fail_count = 0;
+static size_t s_fail_partial = 0;
+static sim_flash_counters_t s_counters;
+
+void sim_flash_reset(const char *label, uint32_t sectors, uint32_t sector_size)
+{
+    free(s_data);
+    s_data = NULL;
+    memset(&s_part, 0, sizeof(s_part));
+    memset(&s_counters, 0, sizeof(s_counters));
+    s_fail_count = 0;
+    s_fail_partial = 0;
+    if (sectors == 0)
+    {
+        return;
+    }
+
+    s_part.type = ESP_PARTITION_TYPE_DATA;
+    s_part.subtype = ESP_PARTITION_SUBTYPE_DATA_UNDEFINED;
+    s_part.size = sectors * sector_size;
+    s_part.erase_size = sector_size;
+    strncpy(s_part.label, label, sizeof(s_part.label) - 1);
+    s_data = malloc(s_part.size);
+    memset(s_data, 0xFF, s_part.size);
+}
+
+void sim_flash_fail_writes(int count, size_t partial)
+{
+    s_fail_count = count;
+    s_fail_partial = partial;
+}
+
+uint8_t *sim_flash_data(void)
+{
+    return s_data;
+}
+
+void sim_flash_get_counters(sim_flash_counters_t *out)
+{
+    *out = s_counters;
+}
+
+// ========================
+// esp_partition.h
+// ========================
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char *label)
+{
+    if (!s_data || (type != ESP_PARTITION_TYPE_ANY && type != s_part.type) ||
+        (subtype != ESP_PARTITION_SUBTYPE_ANY && subtype != s_part.subtype) ||
+        (label && strcmp(label, s_part.label) != 0))
+    {
+        return NULL;
+    }
+    return &s_part;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *part, size_t offset, void *dst, size_t size)
+{
+    if (part != &s_part || offset + size > s_part.size)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(dst, s_data + offset, size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *part, size_t offset, const void *src, size_t size)
+{
+    if (part != &s_part || offset + size > s_part.size)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    size_t n = size;
+    esp_err_t err = ESP_OK;
+    if (s_fail_count > 0)
+    {
+        s_fail_count--;
+        s_counters.write_errors++;
+        n = (s_fail_partial < size) ? s_fail_partial : size;
+        err = ESP_FAIL;
+    }
+
+    // 写只能清零
+    const uint8_t *p = src;
+    for (size_t i = 0; i < n; i++)
+    {
+        s_data[offset + i] &= p[i];
+    }
+    s_counters.writes++;
+    s_counters.write_bytes += (uint32_t)n;
+    return err;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *part, size_t offset, size_t size)
+{
+    if (part != &s_part || offset + size > s_part.size || offset % s_part.erase_size || size % s_part.erase_size)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(s_data + offset, 0xFF, size);
+    s_counters.erases += (uint32_t)(size / s_part.erase_size);
+    return ESP_OK;
+}
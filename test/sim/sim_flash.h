@@ -0,0 +1,32 @@
+// 模拟 flash 分区：实现主机版 esp_partition.h，数据放在内存中，进程内跨 outbox_init / outbox_destroy 保留（模拟重启）
+// - NOR flash 语义：擦除置 1，写只能把 1 变 0
+// - 可注入写失败和写到一半断电，统计擦写次数
+#ifndef __SIM_FLASH_H__
+#define __SIM_FLASH_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// 创建（或重建）一个全部擦除的分区；sectors 为 0 时删除分区，esp_partition_find_first 找不到它
+void sim_flash_reset(const char *label, uint32_t sectors, uint32_t sector_size);
+
+// 接下来 count 次写入失败；每次失败前先写入前 partial 字节（模拟写到一半断电）
+void sim_flash_fail_writes(int count, size_t partial);
+
+// 分区原始数据（测试用来检查或破坏记录）
+uint8_t *sim_flash_data(void);
+
+// 计数
+typedef struct
+{
+    uint32_t writes;
+    uint32_t erases;       // 擦除的扇区数
+    uint32_t write_bytes;
+    uint32_t write_errors; // 注入的写失败
+} sim_flash_counters_t;
+
+void sim_flash_get_counters(sim_flash_counters_t *out);
+
+#endif // __SIM_FLASH_H__
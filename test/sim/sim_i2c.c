@@ -0,0 +1,316 @@
+#include "sim_i2c.h"
+#include "driver/i2c_master.h"
+#include "driver/gpio.h"
+#include "esp_rom_sys.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_I2C_DEVICES_MAX 4
+
+// 与 platform_i2c.c 的引脚一致
+#define SIM_I2C_SDA_PIN GPIO_NUM_42
+#define SIM_I2C_SCL_PIN GPIO_NUM_41
+
+typedef struct
+{
+    uint16_t addr;
+    sim_i2c_xfer_fn_t fn;
+    void *ctx;
+} sim_i2c_target_t;
+
+struct sim_i2c_bus
+{
+    int in_use;
+};
+
+struct sim_i2c_dev
+{
+    struct sim_i2c_bus *bus;
+    uint16_t addr;
+    uint32_t speed_hz;
+};
+
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static sim_i2c_target_t s_targets[SIM_I2C_DEVICES_MAX];
+static sim_i2c_record_t s_log[SIM_I2C_LOG_MAX];
+static size_t s_log_len = 0;
+static sim_i2c_counters_t s_counters;
+static bool s_timing = false;
+
+static uint16_t s_fail_addr = 0;
+static esp_err_t s_fail_err = ESP_OK;
+static int s_fail_count = 0;
+static esp_err_t s_add_fail_err = ESP_OK;
+static int s_add_fail_count = 0;
+
+static bool s_sda_stuck = false;
+static bool s_release_on_reset = false;
+static int s_release_pulses = 0;
+static uint32_t s_scl_level = 1;
+
+void sim_i2c_reset(void)
+{
+    pthread_mutex_lock(&s_lock);
+    memset(s_targets, 0, sizeof(s_targets));
+    s_log_len = 0;
+    memset(&s_counters, 0, sizeof(s_counters));
+    s_timing = false;
+    s_fail_count = 0;
+    s_add_fail_count = 0;
+    s_sda_stuck = false;
+    s_scl_level = 1;
+    pthread_mutex_unlock(&s_lock);
+}
+
+void sim_i2c_attach(uint16_t addr, sim_i2c_xfer_fn_t fn, void *ctx)
+{
+    pthread_mutex_lock(&s_lock);
+    for (int i = 0; i < SIM_I2C_DEVICES_MAX; i++)
+    {
+        if (!s_targets[i].fn || s_targets[i].addr == addr)
+        {
+            s_targets[i] = (sim_i2c_target_t){.addr = addr, .fn = fn, .ctx = ctx};
+            break;
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+void sim_i2c_set_timing(bool enable)
+{
+    pthread_mutex_lock(&s_lock);
+    s_timing = enable;
+    pthread_mutex_unlock(&s_lock);
+}
+
+void sim_i2c_fail_next(uint16_t addr, esp_err_t err, int count)
+{
+    pthread_mutex_lock(&s_lock);
+    s_fail_addr = addr;
+    s_fail_err = err;
+    s_fail_count = count;
+    pthread_mutex_unlock(&s_lock);
+}
+
+void sim_i2c_fail_add_device(esp_err_t err, int count)
+{
+    pthread_mutex_lock(&s_lock);
+    s_add_fail_err = err;
+    s_add_fail_count = count;
+    pthread_mutex_unlock(&s_lock);
+}
+
+void sim_i2c_stick_sda(bool release_on_reset, int pulses)
+{
+    pthread_mutex_lock(&s_lock);
+    s_sda_stuck = true;
+    s_release_on_reset = release_on_reset;
+    s_release_pulses = pulses;
+    pthread_mutex_unlock(&s_lock);
+}
+
+size_t sim_i2c_log(sim_i2c_record_t *out, size_t max)
+{
+    pthread_mutex_lock(&s_lock);
+    size_t n = (s_log_len < max) ? s_log_len : max;
+    memcpy(out, s_log, n * sizeof(*out));
+    pthread_mutex_unlock(&s_lock);
+    return n;
+}
+
+void sim_i2c_get_counters(sim_i2c_counters_t *out)
+{
+    pthread_mutex_lock(&s_lock);
+    *out = s_counters;
+    pthread_mutex_unlock(&s_lock);
+}
+
+// ========================
+// driver/i2c_master.h
+// ========================
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t *cfg, i2c_master_bus_handle_t *ret)
+{
+    if (!cfg || !ret)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct sim_i2c_bus *bus = calloc(1, sizeof(*bus));
+    pthread_mutex_lock(&s_lock);
+    s_counters.bus_creates++;
+    pthread_mutex_unlock(&s_lock);
+    *ret = bus;
+    return ESP_OK;
+}
+
+esp_err_t i2c_del_master_bus(i2c_master_bus_handle_t bus)
+{
+    pthread_mutex_lock(&s_lock);
+    s_counters.bus_deletes++;
+    pthread_mutex_unlock(&s_lock);
+    free(bus);
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_reset(i2c_master_bus_handle_t bus)
+{
+    (void)bus;
+    pthread_mutex_lock(&s_lock);
+    s_counters.bus_resets++;
+    if (s_release_on_reset)
+    {
+        s_sda_stuck = false;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t bus, const i2c_device_config_t *cfg,
+                                    i2c_master_dev_handle_t *ret)
+{
+    if (!bus || !cfg || !ret)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&s_lock);
+    if (s_add_fail_count > 0)
+    {
+        s_add_fail_count--;
+        s_counters.add_failures++;
+        esp_err_t err = s_add_fail_err;
+        pthread_mutex_unlock(&s_lock);
+        return err;
+    }
+    s_counters.dev_adds++;
+    pthread_mutex_unlock(&s_lock);
+
+    struct sim_i2c_dev *dev = calloc(1, sizeof(*dev));
+    dev->bus = bus;
+    dev->addr = cfg->device_address;
+    dev->speed_hz = cfg->scl_speed_hz;
+    *ret = dev;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_rm_device(i2c_master_dev_handle_t dev)
+{
+    pthread_mutex_lock(&s_lock);
+    s_counters.dev_removes++;
+    pthread_mutex_unlock(&s_lock);
+    free(dev);
+    return ESP_OK;
+}
+
+static esp_err_t sim_i2c_run(i2c_master_dev_handle_t dev, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len)
+{
+    if (!dev || (tx_len > 0 && !tx) || (rx_len > 0 && !rx))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&s_lock);
+    sim_i2c_target_t target = {0};
+    for (int i = 0; i < SIM_I2C_DEVICES_MAX; i++)
+    {
+        if (s_targets[i].fn && s_targets[i].addr == dev->addr)
+        {
+            target = s_targets[i];
+        }
+    }
+
+    esp_err_t err = ESP_OK;
+    if (s_sda_stuck)
+    {
+        err = ESP_ERR_TIMEOUT;
+    }
+    else if (s_fail_count > 0 && s_fail_addr == dev->addr)
+    {
+        s_fail_count--;
+        err = s_fail_err;
+    }
+    else if (!target.fn)
+    {
+        err = ESP_FAIL; // 无应答
+    }
+    bool timing = s_timing;
+    pthread_mutex_unlock(&s_lock);
+
+    if (err == ESP_OK)
+    {
+        err = target.fn(target.ctx, tx, tx_len, rx, rx_len);
+    }
+
+    // 每字节 8 位数据 + 1 位应答；读写各带一个地址字节
+    if (timing && dev->speed_hz > 0)
+    {
+        size_t bytes = tx_len + rx_len + 1 + (rx_len > 0 ? 1 : 0);
+        esp_rom_delay_us((uint32_t)((uint64_t)bytes * 9 * 1000000 / dev->speed_hz));
+    }
+
+    pthread_mutex_lock(&s_lock);
+    if (s_log_len < SIM_I2C_LOG_MAX)
+    {
+        s_log[s_log_len++] = (sim_i2c_record_t){
+            .addr = dev->addr,
+            .speed_hz = dev->speed_hz,
+            .tx_len = tx_len,
+            .rx_len = rx_len,
+            .tx0 = tx_len > 0 ? tx[0] : 0,
+            .err = err,
+        };
+    }
+    pthread_mutex_unlock(&s_lock);
+    return err;
+}
+
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t dev, const uint8_t *tx, size_t tx_len, int timeout_ms)
+{
+    (void)timeout_ms;
+    return sim_i2c_run(dev, tx, tx_len, NULL, 0);
+}
+
+esp_err_t i2c_master_transmit_receive(i2c_master_dev_handle_t dev, const uint8_t *tx, size_t tx_len,
+                                      uint8_t *rx, size_t rx_len, int timeout_ms)
+{
+    (void)timeout_ms;
+    return sim_i2c_run(dev, tx, tx_len, rx, rx_len);
+}
+
+// ========================
+// driver/gpio.h：只模拟恢复流程用到的 SCL/SDA
+// ========================
+
+esp_err_t gpio_config(const gpio_config_t *cfg)
+{
+    return cfg ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level)
+{
+    pthread_mutex_lock(&s_lock);
+    if (pin == SIM_I2C_SCL_PIN)
+    {
+        // SCL 上升沿算一个时钟，从机收够时钟后释放 SDA
+        if (level && !s_scl_level)
+        {
+            s_counters.scl_pulses++;
+            if (s_sda_stuck && s_release_pulses > 0 && --s_release_pulses == 0)
+            {
+                s_sda_stuck = false;
+            }
+        }
+        s_scl_level = level ? 1 : 0;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t pin)
+{
+    pthread_mutex_lock(&s_lock);
+    int level = (pin == SIM_I2C_SDA_PIN) ? !s_sda_stuck : (int)s_scl_level;
+    pthread_mutex_unlock(&s_lock);
+    return level;
+}
@@ -0,0 +1,63 @@
+// 模拟 I2C 总线：实现主机版 driver/i2c_master.h 和 driver/gpio.h，事务按地址交给挂在总线上的模拟设备
+// - 可按 SCL 频率模拟总线耗时（每字节 9 个时钟），用来验证调度顺序
+// - 可注入设备错误、SDA 被拉低（总线卡死），记录每个事务的地址、频率和先后顺序
+#ifndef __SIM_I2C_H__
+#define __SIM_I2C_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// 模拟设备的事务处理函数：tx 为写出的字节，rx_len 非 0 时再读出 rx_len 字节
+typedef esp_err_t (*sim_i2c_xfer_fn_t)(void *ctx, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len);
+
+// 一个事务的记录
+typedef struct
+{
+    uint16_t addr;
+    uint32_t speed_hz;
+    size_t tx_len;
+    size_t rx_len;
+    uint8_t tx0;    // 第一个写出的字节（寄存器地址或 OLED 控制字）
+    esp_err_t err;
+} sim_i2c_record_t;
+
+#define SIM_I2C_LOG_MAX 256
+
+// 清空设备、错误注入、日志和计数
+void sim_i2c_reset(void);
+
+// 挂一个模拟设备
+void sim_i2c_attach(uint16_t addr, sim_i2c_xfer_fn_t fn, void *ctx);
+
+// 打开后每个事务按 (字节数 + 地址字节) * 9 / SCL 频率 占用总线（真实睡眠）
+void sim_i2c_set_timing(bool enable);
+
+// 接下来发往 addr 的 count 个事务返回 err（不交给设备）
+void sim_i2c_fail_next(uint16_t addr, esp_err_t err, int count);
+
+// SDA 被从机拉低：此后所有事务超时，直到控制器复位（release_on_reset）或手动打出 pulses 个 SCL 时钟
+void sim_i2c_stick_sda(bool release_on_reset, int pulses);
+
+// 读出事务记录（最多 SIM_I2C_LOG_MAX 条，之后的不再记录）
+size_t sim_i2c_log(sim_i2c_record_t *out, size_t max);
+
+// 计数
+typedef struct
+{
+    uint32_t bus_creates;
+    uint32_t bus_deletes;
+    uint32_t bus_resets;
+    uint32_t dev_adds;
+    uint32_t dev_removes;
+    uint32_t scl_pulses;   // 手动打出的 SCL 时钟（GPIO 方式）
+    uint32_t add_failures; // 注入的 add_device 失败
+} sim_i2c_counters_t;
+
+void sim_i2c_get_counters(sim_i2c_counters_t *out);
+
+// 接下来 count 次 i2c_master_bus_add_device 返回 err
+void sim_i2c_fail_add_device(esp_err_t err, int count);
+
+#endif // __SIM_I2C_H__
@@ -0,0 +1,316 @@
+#include "sim_mpu6050.h"
+#include "mpu6050_data.h"
+#include <pthread.h>
+#include <string.h>
+
+#define SIM_FIFO_SIZE MPU6050_FIFO_MAX_BYTES
+
+// 寄存器位
+#define SIM_PWR1_DEVICE_RESET 0x80
+#define SIM_PWR1_SLEEP 0x40
+#define SIM_USER_FIFO_EN 0x40
+#define SIM_USER_FIFO_RESET 0x04
+#define SIM_FIFO_EN_TEMP 0x80
+#define SIM_FIFO_EN_XG 0x40
+#define SIM_FIFO_EN_YG 0x20
+#define SIM_FIFO_EN_ZG 0x10
+#define SIM_FIFO_EN_ACCEL 0x08
+#define SIM_INT_FIFO_OFLOW 0x10
+#define SIM_INT_DATA_RDY 0x01
+
+static uint8_t s_regs[128];
+static uint8_t s_fifo[SIM_FIFO_SIZE];
+static uint16_t s_fifo_head = 0; // 最早的字节
+static uint16_t s_fifo_count = 0;
+static sim_mpu6050_stats_t s_stats;
+static uint8_t s_who_am_i = MPU_IIC_ADDR; // WHO_AM_I 的值，器件复位不改变
+static int s_fail_err = 0;
+static int s_fail_count = 0;
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void sim_fifo_clear(void)
+{
+    s_fifo_head = 0;
+    s_fifo_count = 0;
+}
+
+static void sim_fifo_put(uint8_t b)
+{
+    if (s_fifo_count == SIM_FIFO_SIZE)
+    {
+        // 写满：覆盖最早的字节
+        s_fifo_head = (s_fifo_head + 1) % SIM_FIFO_SIZE;
+        s_fifo_count--;
+        s_regs[MPU_INT_STA_REG] |= SIM_INT_FIFO_OFLOW;
+    }
+    s_fifo[(s_fifo_head + s_fifo_count) % SIM_FIFO_SIZE] = b;
+    s_fifo_count++;
+}
+
+static uint8_t sim_fifo_get(void)
+{
+    if (s_fifo_count == 0)
+    {
+        return 0xFF;
+    }
+    uint8_t b = s_fifo[s_fifo_head];
+    s_fifo_head = (s_fifo_head + 1) % SIM_FIFO_SIZE;
+    s_fifo_count--;
+    return b;
+}
+
+static void sim_reset_locked(void)
+{
+    memset(s_regs, 0, sizeof(s_regs));
+    s_regs[MPU_PWR_MGMT1_REG] = SIM_PWR1_SLEEP;
+    s_regs[MPU_DEVICE_ID_REG] = s_who_am_i;
+    sim_fifo_clear();
+}
+
+void sim_mpu6050_reset(void)
+{
+    pthread_mutex_lock(&s_lock);
+    s_who_am_i = MPU_IIC_ADDR;
+    sim_reset_locked();
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_fail_count = 0;
+    pthread_mutex_unlock(&s_lock);
+}
+
+// 写一个寄存器，处理自动清零的控制位
+static void sim_write_reg(uint8_t reg, uint8_t value)
+{
+    switch (reg)
+    {
+    case MPU_PWR_MGMT1_REG:
+        if (value & SIM_PWR1_DEVICE_RESET)
+        {
+            sim_reset_locked();
+            return;
+        }
+        break;
+    case MPU_USER_CTRL_REG:
+        if (value & SIM_USER_FIFO_RESET)
+        {
+            sim_fifo_clear();
+            value &= (uint8_t)~SIM_USER_FIFO_RESET;
+        }
+        break;
+    case MPU_FIFO_RW_REG:
+        sim_fifo_put(value);
+        return;
+    case MPU_INT_STA_REG:
+    case MPU_FIFO_CNTH_REG:
+    case MPU_FIFO_CNTL_REG:
+    case MPU_DEVICE_ID_REG:
+        return; // 只读
+    default:
+        break;
+    }
+    s_regs[reg & 0x7F] = value;
+}
+
+static uint8_t sim_read_reg(uint8_t reg)
+{
+    switch (reg)
+    {
+    case MPU_FIFO_CNTH_REG:
+        return (uint8_t)(s_fifo_count >> 8);
+    case MPU_FIFO_CNTL_REG:
+        return (uint8_t)(s_fifo_count & 0xFF);
+    case MPU_FIFO_RW_REG:
+        return sim_fifo_get();
+    case MPU_INT_STA_REG:
+    {
+        // 读清除
+        uint8_t v = s_regs[reg];
+        s_regs[reg] = 0;
+        return v;
+    }
+    default:
+        return s_regs[reg & 0x7F];
+    }
+}
+
+static void sim_put16(uint8_t *p, short v)
+{
+    p[0] = (uint8_t)((uint16_t)v >> 8);
+    p[1] = (uint8_t)((uint16_t)v & 0xFF);
+}
+
+void sim_mpu6050_produce(const MPU6050_Sample_t *samples, size_t n)
+{
+    pthread_mutex_lock(&s_lock);
+    for (size_t i = 0; i < n; i++)
+    {
+        const MPU6050_Sample_t *s = &samples[i];
+        uint8_t raw[MPU6050_SAMPLE_SIZE];
+        sim_put16(&raw[0], s->ax);
+        sim_put16(&raw[2], s->ay);
+        sim_put16(&raw[4], s->az);
+        sim_put16(&raw[6], s->temp);
+        sim_put16(&raw[8], s->gx);
+        sim_put16(&raw[10], s->gy);
+        sim_put16(&raw[12], s->gz);
+        memcpy(&s_regs[MPU_ACCEL_XOUTH_REG], raw, sizeof(raw));
+        s_regs[MPU_INT_STA_REG] |= SIM_INT_DATA_RDY;
+
+        if (!(s_regs[MPU_USER_CTRL_REG] & SIM_USER_FIFO_EN))
+        {
+            continue;
+        }
+
+        // 按寄存器地址顺序写入被选中的数据
+        uint8_t en = s_regs[MPU_FIFO_EN_REG];
+        if (en & SIM_FIFO_EN_ACCEL)
+        {
+            for (int k = 0; k < 6; k++)
+            {
+                sim_fifo_put(raw[k]);
+            }
+        }
+        if (en & SIM_FIFO_EN_TEMP)
+        {
+            sim_fifo_put(raw[6]);
+            sim_fifo_put(raw[7]);
+        }
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (en & (SIM_FIFO_EN_XG >> axis))
+            {
+                sim_fifo_put(raw[8 + axis * 2]);
+                sim_fifo_put(raw[9 + axis * 2]);
+            }
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+uint8_t sim_mpu6050_peek(uint8_t reg)
+{
+    pthread_mutex_lock(&s_lock);
+    uint8_t v = s_regs[reg & 0x7F];
+    pthread_mutex_unlock(&s_lock);
+    return v;
+}
+
+void sim_mpu6050_poke(uint8_t reg, uint8_t value)
+{
+    pthread_mutex_lock(&s_lock);
+    s_regs[reg & 0x7F] = value;
+    pthread_mutex_unlock(&s_lock);
+}
+
+uint16_t sim_mpu6050_fifo_bytes(void)
+{
+    pthread_mutex_lock(&s_lock);
+    uint16_t n = s_fifo_count;
+    pthread_mutex_unlock(&s_lock);
+    return n;
+}
+
+void sim_mpu6050_get_stats(sim_mpu6050_stats_t *stats)
+{
+    pthread_mutex_lock(&s_lock);
+    *stats = s_stats;
+    pthread_mutex_unlock(&s_lock);
+}
+
+esp_err_t sim_mpu6050_xfer(void *ctx, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len)
+{
+    (void)ctx;
+    if (tx_len == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&s_lock);
+    uint8_t reg = tx[0];
+    if (tx_len > 1)
+    {
+        s_stats.writes++;
+        for (size_t i = 1; i < tx_len; i++)
+        {
+            sim_write_reg(reg, tx[i]);
+            if (reg != MPU_FIFO_RW_REG)
+            {
+                reg++;
+            }
+        }
+    }
+    if (rx_len > 0)
+    {
+        s_stats.reads++;
+        s_stats.read_bytes += (uint32_t)rx_len;
+        for (size_t i = 0; i < rx_len; i++)
+        {
+            rx[i] = sim_read_reg(reg);
+            if (reg != MPU_FIFO_RW_REG)
+            {
+                reg++;
+            }
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+void sim_mpu6050_set_who_am_i(uint8_t id)
+{
+    pthread_mutex_lock(&s_lock);
+    s_who_am_i = id;
+    s_regs[MPU_DEVICE_ID_REG] = id;
+    pthread_mutex_unlock(&s_lock);
+}
+
+void sim_mpu6050_fail_next(int err, int count)
+{
+    pthread_mutex_lock(&s_lock);
+    s_fail_err = err;
+    s_fail_count = count;
+    pthread_mutex_unlock(&s_lock);
+}
+
+static int sim_take_failure(void)
+{
+    pthread_mutex_lock(&s_lock);
+    int err = 0;
+    if (s_fail_count > 0)
+    {
+        s_fail_count--;
+        err = s_fail_err;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return err;
+}
+
+int sim_mpu6050_read_byte(uint8_t reg, uint8_t *value)
+{
+    return sim_mpu6050_read_bytes(reg, value, 1);
+}
+
+int sim_mpu6050_read_bytes(uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    int err = sim_take_failure();
+    if (err)
+    {
+        return err;
+    }
+    return sim_mpu6050_xfer(NULL, &reg, 1, buf, len);
+}
+
+int sim_mpu6050_write_byte(uint8_t reg, uint8_t value)
+{
+    int err = sim_take_failure();
+    if (err)
+    {
+        return err;
+    }
+    uint8_t tx[2] = {reg, value};
+    return sim_mpu6050_xfer(NULL, tx, 2, NULL, 0);
+}
+
+void sim_mpu6050_delay_ms(uint32_t ms)
+{
+    (void)ms; // 模拟设备的复位立即完成
+}
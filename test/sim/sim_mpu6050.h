@@ -0,0 +1,51 @@
+// 寄存器级的 MPU6050 模拟设备：寄存器表 + 1024 字节 FIFO，行为按数据手册（只模拟驱动用到的部分）
+// - 突发读写时寄存器地址自动递增，FIFO_R_W 除外（连续读出 FIFO 中的字节）
+// - FIFO 写满后丢弃最早的字节并置位 INT_STATUS 的 FIFO_OFLOW，与真实芯片一样样本边界会错位
+// - PWR_MGMT_1 的 DEVICE_RESET、USER_CTRL 的 FIFO_RESET 写入后立即完成并自动清零
+#ifndef __SIM_MPU6050_H__
+#define __SIM_MPU6050_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "mpu6050.h"
+
+// 模拟设备的 7 位地址
+#define SIM_MPU6050_ADDR 0x68
+
+void sim_mpu6050_reset(void);
+
+// 模拟 ADC 产生 n 个样本：更新数据寄存器，FIFO 打开时按 FIFO_EN 选择的数据写入 FIFO
+void sim_mpu6050_produce(const MPU6050_Sample_t *samples, size_t n);
+
+// 直接读写寄存器（不经过总线，不产生读清除等副作用），测试断言用
+uint8_t sim_mpu6050_peek(uint8_t reg);
+void sim_mpu6050_poke(uint8_t reg, uint8_t value);
+uint16_t sim_mpu6050_fifo_bytes(void);
+
+// 统计：总线上的读写事务数，读出的字节数
+typedef struct
+{
+    uint32_t writes;
+    uint32_t reads;
+    uint32_t read_bytes;
+} sim_mpu6050_stats_t;
+
+void sim_mpu6050_get_stats(sim_mpu6050_stats_t *stats);
+
+// 总线事务：tx 第一个字节为寄存器地址，后面为写入的数据；rx_len 非 0 时从该地址读出
+esp_err_t sim_mpu6050_xfer(void *ctx, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len);
+
+// 不经过总线、直接注册给驱动的读写函数（MPU6050_RegisterDriver 的参数）
+int sim_mpu6050_read_byte(uint8_t reg, uint8_t *value);
+int sim_mpu6050_read_bytes(uint8_t reg, uint8_t *buf, uint16_t len);
+int sim_mpu6050_write_byte(uint8_t reg, uint8_t value);
+void sim_mpu6050_delay_ms(uint32_t ms);
+
+// 换一个 WHO_AM_I 的值（模拟接错器件），sim_mpu6050_reset 恢复默认
+void sim_mpu6050_set_who_am_i(uint8_t id);
+
+// 注入错误：接下来 count 次直接读写返回 err
+void sim_mpu6050_fail_next(int err, int count);
+
+#endif // __SIM_MPU6050_H__
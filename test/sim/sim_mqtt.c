@@ -0,0 +1,172 @@
+#include "sim_mqtt.h"
+#include <pthread.h>
+#include <string.h>
+
+struct esp_mqtt_client
+{
+    int started;
+};
+
+static struct esp_mqtt_client s_client;
+static esp_event_handler_t s_handler = NULL;
+static void *s_handler_arg = NULL;
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static int s_next_id = 1;
+static int s_fail_enqueue = 0;
+static sim_mqtt_enqueue_fn_t s_on_enqueue = NULL;
+static void *s_on_enqueue_ctx = NULL;
+static sim_mqtt_counters_t s_counters;
+
+void sim_mqtt_reset(void)
+{
+    pthread_mutex_lock(&s_lock);
+    s_next_id = 1;
+    s_fail_enqueue = 0;
+    s_on_enqueue = NULL;
+    s_on_enqueue_ctx = NULL;
+    memset(&s_counters, 0, sizeof(s_counters));
+    pthread_mutex_unlock(&s_lock);
+}
+
+void sim_mqtt_event(esp_mqtt_event_id_t id, int msg_id)
+{
+    esp_mqtt_event_t event = {
+        .event_id = id,
+        .client = &s_client,
+        .msg_id = msg_id,
+    };
+    if (s_handler)
+    {
+        s_handler(s_handler_arg, "MQTT_EVENTS", id, &event);
+    }
+}
+
+void sim_mqtt_data(const char *topic, const char *data, int len)
+{
+    esp_mqtt_event_t event = {
+        .event_id = MQTT_EVENT_DATA,
+        .client = &s_client,
+        .topic = (char *)topic,
+        .topic_len = (int)strlen(topic),
+        .data = (char *)data,
+        .data_len = len,
+        .total_data_len = len,
+    };
+    if (s_handler)
+    {
+        s_handler(s_handler_arg, "MQTT_EVENTS", MQTT_EVENT_DATA, &event);
+    }
+}
+
+void sim_mqtt_on_enqueue(sim_mqtt_enqueue_fn_t fn, void *ctx)
+{
+    pthread_mutex_lock(&s_lock);
+    s_on_enqueue = fn;
+    s_on_enqueue_ctx = ctx;
+    pthread_mutex_unlock(&s_lock);
+}
+
+void sim_mqtt_set_next_id(int msg_id)
+{
+    pthread_mutex_lock(&s_lock);
+    s_next_id = msg_id;
+    pthread_mutex_unlock(&s_lock);
+}
+
+void sim_mqtt_fail_enqueue(int count)
+{
+    pthread_mutex_lock(&s_lock);
+    s_fail_enqueue = count;
+    pthread_mutex_unlock(&s_lock);
+}
+
+void sim_mqtt_get_counters(sim_mqtt_counters_t *out)
+{
+    pthread_mutex_lock(&s_lock);
+    *out = s_counters;
+    pthread_mutex_unlock(&s_lock);
+}
+
+// 与 esp-mqtt 相同：QoS0 的消息 ID 为 0，其余取 1~65535
+static int sim_mqtt_alloc_id(int qos)
+{
+    if (qos == 0)
+    {
+        return 0;
+    }
+    int id = s_next_id;
+    s_next_id = (s_next_id % UINT16_MAX) + 1;
+    return id;
+}
+
+// ========================
+// mqtt_client.h
+// ========================
+
+esp_mqtt_client_handle_t esp_mqtt_client_init(const esp_mqtt_client_config_t *config)
+{
+    return config && config->broker.address.uri ? &s_client : NULL;
+}
+
+esp_err_t esp_mqtt_client_register_event(esp_mqtt_client_handle_t client, esp_mqtt_event_id_t event,
+                                         esp_event_handler_t handler, void *arg)
+{
+    s_handler = handler;
+    s_handler_arg = arg;
+    return ESP_OK;
+}
+
+esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t client)
+{
+    client->started = 1;
+    return ESP_OK;
+}
+
+esp_err_t esp_mqtt_client_destroy(esp_mqtt_client_handle_t client)
+{
+    client->started = 0;
+    s_handler = NULL;
+    return ESP_OK;
+}
+
+int esp_mqtt_client_publish(esp_mqtt_client_handle_t client, const char *topic, const char *data, int len, int qos,
+                            int retain)
+{
+    pthread_mutex_lock(&s_lock);
+    int id = sim_mqtt_alloc_id(qos);
+    s_counters.publishes++;
+    pthread_mutex_unlock(&s_lock);
+    return id;
+}
+
+int esp_mqtt_client_enqueue(esp_mqtt_client_handle_t client, const char *topic, const char *data, int len, int qos,
+                            int retain, bool store)
+{
+    pthread_mutex_lock(&s_lock);
+    if (s_fail_enqueue > 0)
+    {
+        s_fail_enqueue--;
+        pthread_mutex_unlock(&s_lock);
+        return -1;
+    }
+    int id = sim_mqtt_alloc_id(qos);
+    s_counters.enqueues++;
+    sim_mqtt_enqueue_fn_t fn = s_on_enqueue;
+    void *ctx = s_on_enqueue_ctx;
+    pthread_mutex_unlock(&s_lock);
+
+    if (fn)
+    {
+        fn(id, qos, ctx);
+    }
+    return id;
+}
+
+int esp_mqtt_client_subscribe_single(esp_mqtt_client_handle_t client, const char *topic, int qos)
+{
+    pthread_mutex_lock(&s_lock);
+    int id = sim_mqtt_alloc_id(1);
+    s_counters.subscribes++;
+    pthread_mutex_unlock(&s_lock);
+    return id;
+}
@@ -0,0 +1,41 @@
+// 模拟 MQTT 客户端：实现主机版 mqtt_client.h，不联网
+// - 发布和入队只分配消息 ID 并计数；测试调用 sim_mqtt_event 模拟 MQTT 任务投递事件
+// - 可在 esp_mqtt_client_enqueue 返回前回调测试（模拟 MQTT 任务抢先发出并收到确认），可注入入队失败
+#ifndef __SIM_MQTT_H__
+#define __SIM_MQTT_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "mqtt_client.h"
+
+// 入队回调：消息 ID 已分配、esp_mqtt_client_enqueue 尚未返回时调用
+typedef void (*sim_mqtt_enqueue_fn_t)(int msg_id, int qos, void *ctx);
+
+// 清空钩子、错误注入和计数；消息 ID 从 1 开始
+void sim_mqtt_reset(void);
+
+// 向 my_mqtt 的事件回调投递一个事件（可在任意线程调用）
+void sim_mqtt_event(esp_mqtt_event_id_t id, int msg_id);
+
+// 投递一条收到的下行消息（MQTT_EVENT_DATA）
+void sim_mqtt_data(const char *topic, const char *data, int len);
+
+void sim_mqtt_on_enqueue(sim_mqtt_enqueue_fn_t fn, void *ctx);
+
+// 下一条消息使用的 ID（模拟 esp-mqtt 的随机 ID 与重放消息的 ID 相同）
+void sim_mqtt_set_next_id(int msg_id);
+
+// 接下来 count 次入队失败（返回 -1）
+void sim_mqtt_fail_enqueue(int count);
+
+// 计数
+typedef struct
+{
+    uint32_t publishes;  // esp_mqtt_client_publish
+    uint32_t enqueues;   // 成功的 esp_mqtt_client_enqueue
+    uint32_t subscribes;
+} sim_mqtt_counters_t;
+
+void sim_mqtt_get_counters(sim_mqtt_counters_t *out);
+
+#endif // __SIM_MQTT_H__
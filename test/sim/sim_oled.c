@@ -0,0 +1,42 @@
+#include "sim_oled.h"
+#include <pthread.h>
+#include <string.h>
+
+static sim_oled_stats_t s_stats;
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void sim_oled_reset(void)
+{
+    pthread_mutex_lock(&s_lock);
+    memset(&s_stats, 0, sizeof(s_stats));
+    pthread_mutex_unlock(&s_lock);
+}
+
+void sim_oled_get_stats(sim_oled_stats_t *stats)
+{
+    pthread_mutex_lock(&s_lock);
+    *stats = s_stats;
+    pthread_mutex_unlock(&s_lock);
+}
+
+esp_err_t sim_oled_xfer(void *ctx, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len)
+{
+    (void)ctx;
+    if (rx_len > 0)
+    {
+        memset(rx, 0, rx_len); // SSD1306 在 I2C 上不支持读
+    }
+
+    pthread_mutex_lock(&s_lock);
+    if (tx_len > 0 && tx[0] == 0x40)
+    {
+        s_stats.data_xfers++;
+        s_stats.data_bytes += (uint32_t)(tx_len - 1);
+    }
+    else if (tx_len > 0)
+    {
+        s_stats.commands++;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
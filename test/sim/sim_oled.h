@@ -0,0 +1,22 @@
+// OLED（SSD1306）模拟设备：只统计收到的命令和显存数据，不模拟显示内容
+#ifndef __SIM_OLED_H__
+#define __SIM_OLED_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#define SIM_OLED_ADDR 0x3C
+
+typedef struct
+{
+    uint32_t commands;   // 控制字 0x00 的事务数
+    uint32_t data_xfers; // 控制字 0x40 的事务数
+    uint32_t data_bytes; // 显存数据字节数
+} sim_oled_stats_t;
+
+void sim_oled_reset(void);
+void sim_oled_get_stats(sim_oled_stats_t *stats);
+esp_err_t sim_oled_xfer(void *ctx, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len);
+
+#endif // __SIM_OLED_H__
@@ -0,0 +1,419 @@
+// 下行指令测试：json_reader 的字段提取与取值，app_cmd 的查表、参数校验与应答（含延后完成的指令）
+#include "app_cmd.h"
+#include "app_batch.h"
+#include "app_calib.h"
+#include "app_codec.h"
+#include "app_rate.h"
+#include "json_reader.h"
+#include "esp_timer.h"
+#include "test_util.h"
+
+// ========================
+// json_reader
+// ========================
+
+static bool reader_fields(const char *json, const char *const *keys, json_span_t *out, size_t n)
+{
+    return json_reader_fields(json, strlen(json), keys, out, n);
+}
+
+static void test_reader_fields(void)
+{
+    static const char *const keys[] = {"a", "s", "o", "l", "t", "f", "z", "missing"};
+    json_span_t v[8];
+    const char *json = " {\"a\": -12 ,\"s\":\"x\\\"y\",\"o\":{\"a\":1,\"q\":\"}\"},\"l\":[1,[2],{}],"
+                       "\"t\":true,\"f\":false,\"z\":null}\n";
+
+    TEST_CHECK(reader_fields(json, keys, v, 8));
+    TEST_CHECK_INT(JSON_READER_NUMBER, v[0].type);
+    TEST_CHECK_INT(3, v[0].len);
+    TEST_CHECK_INT(JSON_READER_STRING, v[1].type);
+    TEST_CHECK(v[1].len == 4 && memcmp(v[1].p, "x\\\"y", 4) == 0);
+
+    // 嵌套的容器整体返回，内层同名 key 不影响外层
+    TEST_CHECK_INT(JSON_READER_OBJECT, v[2].type);
+    TEST_CHECK(v[2].len == strlen("{\"a\":1,\"q\":\"}\"}"));
+    TEST_CHECK_INT(JSON_READER_ARRAY, v[3].type);
+    TEST_CHECK(v[3].len == strlen("[1,[2],{}]"));
+    TEST_CHECK_INT(JSON_READER_TRUE, v[4].type);
+    TEST_CHECK_INT(JSON_READER_FALSE, v[5].type);
+    TEST_CHECK_INT(JSON_READER_NULL, v[6].type);
+    TEST_CHECK_INT(JSON_READER_NONE, v[7].type);
+
+    // 内层对象可以再解析
+    json_span_t inner[2];
+    static const char *const inner_keys[] = {"a", "q"};
+    TEST_CHECK(json_reader_fields(v[2].p, v[2].len, inner_keys, inner, 2));
+    int64_t a = 0;
+    TEST_CHECK(json_span_int(&inner[0], &a));
+    TEST_CHECK_INT(1, a);
+}
+
+static void test_reader_duplicate_and_empty(void)
+{
+    static const char *const keys[] = {"k"};
+    json_span_t v;
+    int64_t n;
+
+    TEST_CHECK(reader_fields("{\"k\":1,\"k\":2}", keys, &v, 1));
+    TEST_CHECK(json_span_int(&v, &n));
+    TEST_CHECK_INT(2, n);
+
+    TEST_CHECK(reader_fields("{}", keys, &v, 1));
+    TEST_CHECK_INT(JSON_READER_NONE, v.type);
+    TEST_CHECK(reader_fields(" { } ", keys, &v, 1));
+}
+
+static void test_reader_malformed(void)
+{
+    static const char *const bad[] = {
+        "", "[]", "1", "{", "{\"k\"}", "{\"k\":}", "{\"k\":1,}", "{\"k\":1 \"j\":2}", "{\"k\":1}x",
+        "{k:1}", "{\"k\":[1,2}", "{\"k\":{\"a\":[}]}", "{\"k\":\"a\nb\"}", "{\"k\":tru}", "{\"k\":\"abc}",
+        "{\"k\":[[[[[[[[[[[[[[[[[1]]]]]]]]]]]]]]]]]}",
+    };
+    static const char *const keys[] = {"k"};
+    json_span_t v;
+
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++)
+    {
+        if (reader_fields(bad[i], keys, &v, 1))
+        {
+            fprintf(stderr, "  accepted: %s\n", bad[i]);
+            TEST_CHECK(false);
+        }
+    }
+    TEST_CHECK(!json_reader_fields(NULL, 0, keys, &v, 1));
+
+    // 不要求 '\0' 结尾：按长度截断的文本只看前 len 个字节
+    TEST_CHECK(json_reader_fields("{\"k\":1}garbage", 7, keys, &v, 1));
+}
+
+static void test_reader_int(void)
+{
+    static const struct
+    {
+        const char *text;
+        bool ok;
+        int64_t value;
+    } cases[] = {
+        {"0", true, 0}, {"-0", true, 0}, {"42", true, 42}, {"-42", true, -42},
+        {"9223372036854775807", true, INT64_MAX}, {"-9223372036854775808", true, INT64_MIN},
+        {"9223372036854775808", false, 0}, {"-9223372036854775809", false, 0},
+        {"1.5", false, 0}, {"1e3", false, 0}, {"-", false, 0}, {"+1", false, 0}, {"1-", false, 0},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        json_span_t v = {JSON_READER_NUMBER, cases[i].text, strlen(cases[i].text)};
+        int64_t out = 0;
+        bool ok = json_span_int(&v, &out);
+        TEST_CHECK_INT(cases[i].ok, ok);
+        if (ok)
+        {
+            TEST_CHECK_INT(cases[i].value, out);
+        }
+    }
+
+    json_span_t s = {JSON_READER_STRING, "1", 1};
+    int64_t out;
+    TEST_CHECK(!json_span_int(&s, &out));
+    TEST_CHECK(!json_span_int(NULL, &out));
+}
+
+static void test_reader_string(void)
+{
+    char buf[16];
+    json_span_t v = {JSON_READER_STRING, NULL, 0};
+
+#define SPAN(s) (v.p = (s), v.len = strlen(s), &v)
+    TEST_CHECK(json_span_string(SPAN("a\\\"\\\\\\/\\n\\t\\u0041"), buf, sizeof(buf)));
+    TEST_CHECK_STR("a\"\\/\n\tA", buf);
+
+    // 非 ASCII 的 \u、\u0000、未知转义、不完整转义都拒绝
+    TEST_CHECK(!json_span_string(SPAN("\\u00e9"), buf, sizeof(buf)));
+    TEST_CHECK(!json_span_string(SPAN("\\u0000"), buf, sizeof(buf)));
+    TEST_CHECK(!json_span_string(SPAN("\\x"), buf, sizeof(buf)));
+    TEST_CHECK(!json_span_string(SPAN("\\u12"), buf, sizeof(buf)));
+    TEST_CHECK(!json_span_string(SPAN("abc\\"), buf, sizeof(buf)));
+
+    // 结尾 '\0' 也要放得下
+    TEST_CHECK(json_span_string(SPAN("abc"), buf, 4));
+    TEST_CHECK(!json_span_string(SPAN("abcd"), buf, 4));
+#undef SPAN
+
+    bool b;
+    json_span_t t = {JSON_READER_TRUE, "true", 4};
+    TEST_CHECK(json_span_bool(&t, &b) && b);
+    json_span_t n = {JSON_READER_NUMBER, "1", 1};
+    TEST_CHECK(!json_span_bool(&n, &b));
+}
+
+// ========================
+// app_cmd
+// ========================
+
+static char s_resp[256];
+
+static const char *dispatch(const char *json)
+{
+    size_t n = app_cmd_dispatch(json, strlen(json), s_resp, sizeof(s_resp));
+    TEST_CHECK_INT(strlen(s_resp), n);
+    return s_resp;
+}
+
+// 延后完成的指令：dispatch 不应答，返回 0
+static void dispatch_deferred(const char *json)
+{
+    TEST_CHECK_INT(0, app_cmd_dispatch(json, strlen(json), s_resp, sizeof(s_resp)));
+}
+
+static const char *poll(void)
+{
+    size_t n = app_cmd_poll(s_resp, sizeof(s_resp));
+    if (n == 0)
+    {
+        return "";
+    }
+    TEST_CHECK_INT(strlen(s_resp), n);
+    return s_resp;
+}
+
+// 等别的任务完成延后的指令，最多等 timeout_ms
+static const char *poll_wait(uint32_t timeout_ms)
+{
+    for (uint32_t waited = 0; waited < timeout_ms; waited++)
+    {
+        const char *resp = poll();
+        if (resp[0])
+        {
+            return resp;
+        }
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+    return "";
+}
+
+static void test_cmd_init(void)
+{
+    TEST_CHECK_INT(ESP_OK, app_cmd_init());
+}
+
+static void test_cmd_get_config(void)
+{
+    app_rate_profile_t rate = {200, 50};
+    app_batch_config_t batch = {25, 5000};
+    TEST_CHECK_INT(ESP_OK, app_rate_set(&rate, false));
+    TEST_CHECK_INT(ESP_OK, app_batch_set_config(&batch));
+    app_codec_select(APP_CODEC_JSON);
+
+    TEST_CHECK_STR("{\"id\":7,\"cmd\":\"get_config\",\"sample_hz\":200,\"output_hz\":50,\"interval_ms\":5000,"
+                   "\"max_samples\":25,\"encoding\":\"json\",\"ok\":true}",
+                   dispatch("{\"id\":7,\"cmd\":\"get_config\"}"));
+
+    // id 可省略；args 为 null 或空对象都可以
+    TEST_CHECK(strncmp(dispatch("{\"cmd\":\"get_config\",\"args\":null}"), "{\"cmd\":", 7) == 0);
+    TEST_CHECK(strstr(dispatch("{\"cmd\":\"get_config\",\"args\":{}}"), "\"ok\":true") != NULL);
+}
+
+static void test_cmd_set_encoding(void)
+{
+    TEST_CHECK_STR("{\"cmd\":\"set_encoding\",\"encoding\":\"cbor\",\"topic\":\"test/topic/cbor\",\"ok\":true}",
+                   dispatch("{\"cmd\":\"set_encoding\",\"args\":{\"codec\":\"cbor\"}}"));
+    TEST_CHECK_INT(APP_CODEC_CBOR, app_codec_active_id());
+
+    TEST_CHECK_STR("{\"cmd\":\"set_encoding\",\"ok\":false,\"err\":\"ESP_ERR_NOT_FOUND\"}",
+                   dispatch("{\"cmd\":\"set_encoding\",\"args\":{\"codec\":\"xml\"}}"));
+    TEST_CHECK_INT(APP_CODEC_CBOR, app_codec_active_id());
+
+    // 超过 APP_CMD_STR_MAX - 1 个字符
+    TEST_CHECK_STR("{\"cmd\":\"set_encoding\",\"ok\":false,\"err\":\"bad_arg\",\"arg\":\"codec\"}",
+                   dispatch("{\"cmd\":\"set_encoding\",\"args\":{\"codec\":\"0123456789abcdef\"}}"));
+    app_codec_select(APP_CODEC_JSON);
+}
+
+// 代替采集任务：被 app_rate_set 唤醒后取走配置，报告 s_apply_err 作为应用结果
+static volatile esp_err_t s_apply_err = ESP_OK;
+static app_rate_profile_t s_applied;
+
+static void fake_sample_task(void *arg)
+{
+    (void)arg;
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        app_rate_profile_t profile;
+        if (app_rate_take_pending(&profile))
+        {
+            if (s_apply_err == ESP_OK)
+            {
+                s_applied = profile;
+            }
+            app_rate_applied(s_apply_err);
+        }
+    }
+}
+
+static void test_cmd_set_rate(void)
+{
+    app_rate_profile_t rate = {100, 100}, pending;
+    TEST_CHECK_INT(ESP_OK, app_rate_set(&rate, false));
+    app_rate_take_pending(&pending);
+
+    // 没有采集任务来应用：发起后不应答，到时间后应答超时，配置仍然挂起
+    dispatch_deferred("{\"cmd\":\"set_rate\",\"args\":{\"sample_hz\":100}}");
+    TEST_CHECK_STR("{\"cmd\":\"set_rate\",\"ok\":false,\"err\":\"busy\"}",
+                   dispatch("{\"cmd\":\"set_rate\",\"args\":{\"sample_hz\":200}}"));
+    TEST_CHECK_STR("", poll());
+    TEST_CHECK_STR("{\"cmd\":\"set_rate\",\"ok\":false,\"err\":\"ESP_ERR_TIMEOUT\"}", poll_wait(2000));
+    TEST_CHECK(app_rate_take_pending(&pending));
+    TEST_CHECK_INT(100, pending.sample_hz);
+
+    TaskHandle_t task = NULL;
+    TEST_CHECK(xTaskCreate(fake_sample_task, "fake_sample", 4096, NULL, 5, &task) == pdPASS);
+    app_rate_set_notify(task);
+
+    dispatch_deferred("{\"id\":1,\"cmd\":\"set_rate\",\"args\":{\"sample_hz\":500,\"output_hz\":50}}");
+    TEST_CHECK_STR("{\"id\":1,\"cmd\":\"set_rate\",\"sample_hz\":500,\"output_hz\":50,\"ok\":true}", poll_wait(1000));
+    TEST_CHECK_INT(500, s_applied.sample_hz);
+    TEST_CHECK_INT(50, s_applied.output_hz);
+    TEST_CHECK(!app_rate_take_pending(&pending));
+
+    // 应用失败：应答带错误码，配置重新挂起等待重试
+    s_apply_err = ESP_FAIL;
+    dispatch_deferred("{\"cmd\":\"set_rate\",\"args\":{\"sample_hz\":200}}");
+    TEST_CHECK_STR("{\"cmd\":\"set_rate\",\"ok\":false,\"err\":\"ESP_FAIL\"}", poll_wait(1000));
+    TEST_CHECK_INT(500, s_applied.sample_hz);
+    TEST_CHECK(app_rate_take_pending(&pending));
+    TEST_CHECK_INT(200, pending.sample_hz);
+    s_apply_err = ESP_OK;
+
+    // output_hz 省略时保持原值，超过新的采样率时取采样率
+    dispatch_deferred("{\"cmd\":\"set_rate\",\"args\":{\"sample_hz\":20}}");
+    TEST_CHECK(strstr(poll_wait(1000), "\"output_hz\":20") != NULL);
+
+    // 缺参数、超范围、类型不对：不改配置
+    TEST_CHECK_STR("{\"cmd\":\"set_rate\",\"ok\":false,\"err\":\"missing_arg\",\"arg\":\"sample_hz\"}",
+                   dispatch("{\"cmd\":\"set_rate\",\"args\":{\"output_hz\":10}}"));
+    TEST_CHECK_STR("{\"cmd\":\"set_rate\",\"ok\":false,\"err\":\"bad_arg\",\"arg\":\"sample_hz\"}",
+                   dispatch("{\"cmd\":\"set_rate\",\"args\":{\"sample_hz\":1001}}"));
+    TEST_CHECK_STR("{\"cmd\":\"set_rate\",\"ok\":false,\"err\":\"bad_arg\",\"arg\":\"persist\"}",
+                   dispatch("{\"cmd\":\"set_rate\",\"args\":{\"sample_hz\":100,\"persist\":1}}"));
+    TEST_CHECK_STR("{\"cmd\":\"set_rate\",\"ok\":false,\"err\":\"bad_arg\",\"arg\":\"sample_hz\"}",
+                   dispatch("{\"cmd\":\"set_rate\",\"args\":{\"sample_hz\":\"100\"}}"));
+
+    // 单个参数合法但组合不合法（抽取倍数超过上限）由 app_rate_set 拒绝
+    TEST_CHECK_STR("{\"cmd\":\"set_rate\",\"ok\":false,\"err\":\"ESP_ERR_INVALID_ARG\"}",
+                   dispatch("{\"cmd\":\"set_rate\",\"args\":{\"sample_hz\":100,\"output_hz\":200}}"));
+    app_rate_get(&rate);
+    TEST_CHECK_INT(20, rate.sample_hz);
+}
+
+// 静止、Z 轴朝上（±2g 量程下 1g 为 16384）的原始样本，各轴带固定零偏
+static const SensorData s_still = {.mpu_ax = 10, .mpu_ay = -20, .mpu_az = 16384 + 30,
+                                   .mpu_gx = 5, .mpu_gy = -6, .mpu_gz = 7};
+
+static void test_cmd_calibrate(void)
+{
+    SensorData raw[10];
+    for (int i = 0; i < 10; i++)
+    {
+        raw[i] = s_still;
+    }
+
+    TEST_CHECK_INT(ESP_OK, app_calib_init());
+    TEST_CHECK_STR("{\"cmd\":\"calibrate\",\"ok\":false,\"err\":\"bad_arg\",\"arg\":\"samples\"}",
+                   dispatch("{\"cmd\":\"calibrate\",\"args\":{\"samples\":1001}}"));
+    TEST_CHECK(app_cmd_deadline_us() == INT64_MAX);
+    TEST_CHECK(!app_calib_collect(raw, 10));
+
+    // 发起后不应答，也不等；同一条指令在应答前不能再发起
+    dispatch_deferred("{\"id\":9,\"cmd\":\"calibrate\",\"args\":{\"samples\":25}}");
+    TEST_CHECK(app_cmd_deadline_us() != INT64_MAX);
+    TEST_CHECK_STR("{\"cmd\":\"calibrate\",\"ok\":false,\"err\":\"busy\"}", dispatch("{\"cmd\":\"calibrate\"}"));
+
+    // 代替采集任务送样本：收齐的那一批返回 true，之后的样本不再累加
+    TEST_CHECK(!app_calib_collect(raw, 10));
+    TEST_CHECK_STR("", poll());
+    TEST_CHECK(!app_calib_collect(raw, 10));
+    TEST_CHECK(app_calib_collect(raw, 10));
+    TEST_CHECK(!app_calib_collect(raw, 10));
+    TEST_CHECK_STR("{\"id\":9,\"cmd\":\"calibrate\",\"samples\":25,\"bias\":[10,-20,30,5,-6,7],\"ok\":true}", poll());
+    TEST_CHECK_STR("", poll());
+    TEST_CHECK(app_cmd_deadline_us() == INT64_MAX);
+
+    // 标定后同样的静止样本换算为 (0, 0, 1000mg)，角速度为 0
+    app_calib_snap_t snap;
+    app_sample_t out;
+    app_calib_snapshot(&snap);
+    app_calib_apply(&snap, &s_still, &out);
+    TEST_CHECK_INT(0, out.ax);
+    TEST_CHECK_INT(0, out.ay);
+    TEST_CHECK_INT(1000, out.az);
+    TEST_CHECK_INT(0, out.gx);
+    TEST_CHECK_INT(0, out.gz);
+
+    // 超时：应答失败，标定取消，零偏不变
+    dispatch_deferred("{\"cmd\":\"calibrate\",\"args\":{\"samples\":100}}");
+    TEST_CHECK(!app_calib_collect(raw, 10));
+    while (esp_timer_get_time() < app_cmd_deadline_us())
+    {
+        TEST_CHECK_STR("", poll());
+        vTaskDelay(pdMS_TO_TICKS(50));
+    }
+    TEST_CHECK_STR("{\"cmd\":\"calibrate\",\"ok\":false,\"err\":\"ESP_ERR_TIMEOUT\"}", poll());
+    TEST_CHECK(!app_calib_collect(raw, 10));
+    app_calib_t cal;
+    app_calib_get(&cal);
+    TEST_CHECK_INT(30, cal.bias[APP_CALIB_AZ]);
+}
+
+static void test_cmd_set_upload(void)
+{
+    TEST_CHECK_STR("{\"cmd\":\"set_upload\",\"interval_ms\":1000,\"max_samples\":25,\"ok\":true}",
+                   dispatch("{\"cmd\":\"set_upload\",\"args\":{\"interval_ms\":1000}}"));
+    TEST_CHECK_STR("{\"cmd\":\"set_upload\",\"ok\":false,\"err\":\"ESP_ERR_INVALID_ARG\"}",
+                   dispatch("{\"cmd\":\"set_upload\",\"args\":{}}"));
+    TEST_CHECK_STR("{\"cmd\":\"set_upload\",\"ok\":false,\"err\":\"bad_arg\",\"arg\":\"max_samples\"}",
+                   dispatch("{\"cmd\":\"set_upload\",\"args\":{\"max_samples\":51}}"));
+}
+
+static void test_cmd_errors(void)
+{
+    TEST_CHECK_STR("{\"ok\":false,\"err\":\"bad_json\"}", dispatch("{\"cmd\":"));
+    TEST_CHECK_STR("{\"ok\":false,\"err\":\"bad_json\"}", dispatch("[]"));
+    TEST_CHECK_STR("{\"id\":3,\"ok\":false,\"err\":\"bad_cmd\"}", dispatch("{\"id\":3,\"cmd\":5}"));
+    TEST_CHECK_STR("{\"ok\":false,\"err\":\"bad_cmd\"}", dispatch("{\"args\":{}}"));
+    TEST_CHECK_STR("{\"cmd\":\"reboot\",\"ok\":false,\"err\":\"unknown_cmd\"}", dispatch("{\"cmd\":\"reboot\"}"));
+    TEST_CHECK_STR("{\"cmd\":\"set_rate\",\"ok\":false,\"err\":\"bad_args\"}",
+                   dispatch("{\"cmd\":\"set_rate\",\"args\":[100]}"));
+
+    // 指令名里的转义字符在应答中重新转义
+    TEST_CHECK_STR("{\"cmd\":\"a\\\"b\",\"ok\":false,\"err\":\"unknown_cmd\"}", dispatch("{\"cmd\":\"a\\\"b\"}"));
+
+    // 二分查找的边界：比表中所有名称都小和都大
+    TEST_CHECK(strstr(dispatch("{\"cmd\":\"a\"}"), "unknown_cmd") != NULL);
+    TEST_CHECK(strstr(dispatch("{\"cmd\":\"zzz\"}"), "unknown_cmd") != NULL);
+
+    // 应答放不下返回 0
+    char small[16];
+    const char *json = "{\"cmd\":\"get_config\"}";
+    TEST_CHECK_INT(0, app_cmd_dispatch(json, strlen(json), small, sizeof(small)));
+}
+
+int main(void)
+{
+    host_log_quiet = 1;
+
+    RUN_TEST(test_reader_fields);
+    RUN_TEST(test_reader_duplicate_and_empty);
+    RUN_TEST(test_reader_malformed);
+    RUN_TEST(test_reader_int);
+    RUN_TEST(test_reader_string);
+    RUN_TEST(test_cmd_init);
+    RUN_TEST(test_cmd_get_config);
+    RUN_TEST(test_cmd_set_encoding);
+    RUN_TEST(test_cmd_set_rate);
+    RUN_TEST(test_cmd_calibrate);
+    RUN_TEST(test_cmd_set_upload);
+    RUN_TEST(test_cmd_errors);
+    return TEST_RESULT();
+}
@@ -0,0 +1,579 @@
+// 上行编码测试：写入器的单元测试（RFC 8949 附录 A 的 CBOR 样例、JSON 转义与定点数、LEB128/zigzag），
+// 以及三种编码经参考解码器还原后与原批次逐值比较的往返测试
+#include "app_codec.h"
+#include "cbor_writer.h"
+#include "json_writer.h"
+#include "varint_writer.h"
+#include "net_time_stub.h"
+#include "upload_decode.h"
+#include "test_util.h"
+#include <stdlib.h>
+
+// 把十六进制串转成字节，返回长度
+static size_t hex_to_bytes(const char *hex, uint8_t *out)
+{
+    size_t n = 0;
+    for (; hex[0] && hex[1]; hex += 2)
+    {
+        unsigned v;
+        sscanf(hex, "%2x", &v);
+        out[n++] = (uint8_t)v;
+    }
+    return n;
+}
+
+#define CHECK_BYTES(expect_hex, buf, len)                                      \
+    do                                                                         \
+    {                                                                          \
+        uint8_t e_[64];                                                        \
+        size_t en_ = hex_to_bytes(expect_hex, e_);                             \
+        TEST_CHECK_INT(en_, (len));                                            \
+        TEST_CHECK(en_ == (len) && memcmp(e_, (buf), en_) == 0);               \
+    } while (0)
+
+// ========================
+// CBOR 写入器
+// ========================
+
+static void test_cbor_rfc8949_uint(void)
+{
+    static const struct
+    {
+        uint64_t v;
+        const char *hex;
+    } cases[] = {
+        {0, "00"}, {1, "01"}, {10, "0a"}, {23, "17"}, {24, "1818"}, {25, "1819"}, {100, "1864"},
+        {1000, "1903e8"}, {1000000, "1a000f4240"}, {1000000000000ULL, "1b000000e8d4a51000"},
+        {UINT64_MAX, "1bffffffffffffffff"},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        uint8_t buf[16];
+        cbor_writer_t w;
+        cbor_writer_init(&w, buf, sizeof(buf));
+        cbor_writer_uint(&w, cases[i].v);
+        CHECK_BYTES(cases[i].hex, buf, cbor_writer_finish(&w));
+    }
+}
+
+static void test_cbor_rfc8949_int(void)
+{
+    static const struct
+    {
+        int64_t v;
+        const char *hex;
+    } cases[] = {
+        {0, "00"}, {-1, "20"}, {-10, "29"}, {-24, "37"}, {-25, "3818"}, {-100, "3863"},
+        {-1000, "3903e7"}, {INT64_MIN, "3b7fffffffffffffff"}, {INT64_MAX, "1b7fffffffffffffff"},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        uint8_t buf[16];
+        cbor_writer_t w;
+        cbor_writer_init(&w, buf, sizeof(buf));
+        cbor_writer_int(&w, cases[i].v);
+        CHECK_BYTES(cases[i].hex, buf, cbor_writer_finish(&w));
+    }
+}
+
+static void test_cbor_rfc8949_other(void)
+{
+    uint8_t buf[64];
+    cbor_writer_t w;
+
+    cbor_writer_init(&w, buf, sizeof(buf));
+    cbor_writer_bool(&w, false);
+    cbor_writer_bool(&w, true);
+    CHECK_BYTES("f4f5", buf, cbor_writer_finish(&w));
+
+    cbor_writer_init(&w, buf, sizeof(buf));
+    cbor_writer_text(&w, "");
+    cbor_writer_text(&w, "a");
+    cbor_writer_text(&w, "IETF");
+    CHECK_BYTES("6061616449455446", buf, cbor_writer_finish(&w));
+
+    static const uint8_t raw[] = {1, 2, 3, 4};
+    cbor_writer_init(&w, buf, sizeof(buf));
+    cbor_writer_bytes(&w, raw, 0);
+    cbor_writer_bytes(&w, raw, sizeof(raw));
+    CHECK_BYTES("404401020304", buf, cbor_writer_finish(&w));
+
+    // [1, [2, 3], [4, 5]]
+    cbor_writer_init(&w, buf, sizeof(buf));
+    cbor_writer_array(&w, 3);
+    cbor_writer_uint(&w, 1);
+    cbor_writer_array(&w, 2);
+    cbor_writer_uint(&w, 2);
+    cbor_writer_uint(&w, 3);
+    cbor_writer_array(&w, 2);
+    cbor_writer_uint(&w, 4);
+    cbor_writer_uint(&w, 5);
+    CHECK_BYTES("8301820203820405", buf, cbor_writer_finish(&w));
+
+    // {"a": 1, "b": [2, 3]}
+    cbor_writer_init(&w, buf, sizeof(buf));
+    cbor_writer_map(&w, 2);
+    cbor_writer_text(&w, "a");
+    cbor_writer_uint(&w, 1);
+    cbor_writer_text(&w, "b");
+    cbor_writer_array(&w, 2);
+    cbor_writer_uint(&w, 2);
+    cbor_writer_uint(&w, 3);
+    CHECK_BYTES("a26161016162820203", buf, cbor_writer_finish(&w));
+
+    // 25 个元素的数组头需要一个额外字节
+    int32_t v[25];
+    for (int i = 0; i < 25; i++)
+    {
+        v[i] = i + 1;
+    }
+    cbor_writer_init(&w, buf, sizeof(buf));
+    cbor_writer_int32_array(&w, v, 25);
+    CHECK_BYTES("98190102030405060708090a0b0c0d0e0f101112131415161718181819", buf, cbor_writer_finish(&w));
+}
+
+static void test_cbor_int_round_trip(void)
+{
+    // 各编码宽度的边界值经最小读取器还原
+    static const int64_t values[] = {
+        0, 1, 23, 24, 255, 256, 65535, 65536, 4294967295LL, 4294967296LL, INT64_MAX,
+        -1, -24, -25, -256, -257, -65536, -65537, -4294967296LL, -4294967297LL, INT64_MIN,
+        INT32_MIN, INT32_MAX,
+    };
+    uint8_t buf[512];
+    cbor_writer_t w;
+    cbor_writer_init(&w, buf, sizeof(buf));
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+    {
+        cbor_writer_int(&w, values[i]);
+    }
+    size_t len = cbor_writer_finish(&w);
+    TEST_CHECK(len > 0);
+
+    cbor_cursor_t c = {buf, buf + len};
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+    {
+        int64_t v = 0;
+        TEST_CHECK(cbor_read_int(&c, &v));
+        TEST_CHECK_INT(values[i], v);
+    }
+    TEST_CHECK(c.p == c.end);
+}
+
+static void test_cbor_overflow(void)
+{
+    uint8_t buf[4];
+    cbor_writer_t w;
+
+    // 刚好写满不算溢出
+    cbor_writer_init(&w, buf, sizeof(buf));
+    cbor_writer_text(&w, "abc");
+    TEST_CHECK_INT(4, cbor_writer_finish(&w));
+
+    // 多一个字节就整体失败，且之后的写入被忽略
+    cbor_writer_init(&w, buf, sizeof(buf));
+    cbor_writer_uint(&w, 1000);
+    cbor_writer_uint(&w, 1000);
+    TEST_CHECK(w.overflow);
+    TEST_CHECK_INT(3, w.len);
+    cbor_writer_uint(&w, 1);
+    TEST_CHECK_INT(3, w.len);
+    TEST_CHECK_INT(0, cbor_writer_finish(&w));
+}
+
+// ========================
+// JSON 写入器
+// ========================
+
+static void test_json_writer_structure(void)
+{
+    char buf[256];
+    json_writer_t w;
+    static const int32_t arr[] = {1, -2, 2147483647, -2147483647 - 1};
+
+    json_writer_init(&w, buf, sizeof(buf));
+    json_writer_begin_object(&w);
+    json_writer_kv_string(&w, "s", "x");
+    json_writer_kv_int(&w, "i", INT64_MIN);
+    json_writer_kv_bool(&w, "b", false);
+    json_writer_key(&w, "n");
+    json_writer_null(&w);
+    json_writer_key(&w, "a");
+    json_writer_int32_array(&w, arr, 4);
+    json_writer_key(&w, "e");
+    json_writer_int32_array(&w, arr, 0);
+    json_writer_key(&w, "o");
+    json_writer_begin_object(&w);
+    json_writer_end_object(&w);
+    json_writer_key(&w, "l");
+    json_writer_begin_array(&w);
+    json_writer_begin_object(&w);
+    json_writer_kv_int(&w, "k", 0);
+    json_writer_end_object(&w);
+    json_writer_int(&w, 7);
+    json_writer_end_array(&w);
+    json_writer_end_object(&w);
+
+    size_t len = json_writer_finish(&w);
+    TEST_CHECK_STR("{\"s\":\"x\",\"i\":-9223372036854775808,\"b\":false,\"n\":null,"
+                   "\"a\":[1,-2,2147483647,-2147483648],\"e\":[],\"o\":{},\"l\":[{\"k\":0},7]}",
+                   buf);
+    TEST_CHECK_INT(strlen(buf), len);
+}
+
+static void test_json_writer_escape(void)
+{
+    char buf[128];
+    json_writer_t w;
+
+    json_writer_init(&w, buf, sizeof(buf));
+    json_writer_string(&w, "q\"b\\n\nt\t\x01\x1f/\xc3\xa9");
+    TEST_CHECK(json_writer_finish(&w) > 0);
+    // 引号、反斜杠、控制字符转义；'/' 和 UTF-8 原样输出
+    TEST_CHECK_STR("\"q\\\"b\\\\n\\u000at\\u0009\\u0001\\u001f/\xc3\xa9\"", buf);
+}
+
+static void test_json_writer_fixed(void)
+{
+    static const struct
+    {
+        int64_t v;
+        uint8_t dec;
+        const char *out;
+    } cases[] = {
+        {2537, 2, "25.37"}, {-2537, 2, "-25.37"}, {5, 2, "0.05"}, {-5, 3, "-0.005"}, {0, 1, "0.0"},
+        {100, 2, "1.00"}, {123, 0, "123"}, {42, 10, "42"}, {INT64_MIN, 9, "-9223372036.854775808"},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        char buf[64];
+        json_writer_t w;
+        json_writer_init(&w, buf, sizeof(buf));
+        json_writer_fixed(&w, cases[i].v, cases[i].dec);
+        TEST_CHECK(json_writer_finish(&w) > 0);
+        TEST_CHECK_STR(cases[i].out, buf);
+    }
+}
+
+static void test_json_writer_failures(void)
+{
+    char buf[8];
+    json_writer_t w;
+
+    // 结尾 '\0' 也要占位：7 个字符正好放下，8 个放不下
+    json_writer_init(&w, buf, sizeof(buf));
+    json_writer_string(&w, "abcde");
+    TEST_CHECK_INT(7, json_writer_finish(&w));
+
+    json_writer_init(&w, buf, sizeof(buf));
+    json_writer_string(&w, "abcdef");
+    TEST_CHECK_INT(0, json_writer_finish(&w));
+    TEST_CHECK_STR("", buf);
+
+    // 没有闭合
+    json_writer_init(&w, buf, sizeof(buf));
+    json_writer_begin_array(&w);
+    TEST_CHECK_INT(0, json_writer_finish(&w));
+
+    // 超过最大嵌套层数
+    char deep[64];
+    json_writer_init(&w, deep, sizeof(deep));
+    for (int i = 0; i <= JSON_WRITER_MAX_DEPTH; i++)
+    {
+        json_writer_begin_array(&w);
+    }
+    TEST_CHECK(w.overflow);
+    TEST_CHECK_INT(0, json_writer_finish(&w));
+}
+
+// ========================
+// 变长整数写入器
+// ========================
+
+static void test_varint_leb128(void)
+{
+    static const struct
+    {
+        uint64_t v;
+        const char *hex;
+    } cases[] = {
+        {0, "00"}, {1, "01"}, {127, "7f"}, {128, "8001"}, {300, "ac02"}, {16383, "ff7f"}, {16384, "808001"},
+        {UINT64_MAX, "ffffffffffffffffff01"},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        uint8_t buf[16];
+        varint_writer_t w;
+        varint_writer_init(&w, buf, sizeof(buf));
+        varint_writer_uint(&w, cases[i].v);
+        size_t len = varint_writer_finish(&w);
+        CHECK_BYTES(cases[i].hex, buf, len);
+
+        const uint8_t *p = buf;
+        uint64_t back = 0;
+        TEST_CHECK(varint_read_uint(&p, buf + len, &back));
+        TEST_CHECK(back == cases[i].v);
+    }
+}
+
+static void test_varint_zigzag(void)
+{
+    TEST_CHECK_INT(0, varint_zigzag64(0));
+    TEST_CHECK_INT(1, varint_zigzag64(-1));
+    TEST_CHECK_INT(2, varint_zigzag64(1));
+    TEST_CHECK_INT(3, varint_zigzag64(-2));
+    TEST_CHECK(varint_zigzag64(INT64_MAX) == UINT64_MAX - 1);
+    TEST_CHECK(varint_zigzag64(INT64_MIN) == UINT64_MAX);
+
+    static const int64_t values[] = {0, -1, 1, -64, 63, -65, 64, INT32_MIN, INT32_MAX, INT64_MIN, INT64_MAX};
+    uint8_t buf[128];
+    varint_writer_t w;
+    varint_writer_init(&w, buf, sizeof(buf));
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+    {
+        varint_writer_sint(&w, values[i]);
+    }
+    size_t len = varint_writer_finish(&w);
+    TEST_CHECK(len > 0);
+
+    const uint8_t *p = buf;
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+    {
+        int64_t back = 0;
+        TEST_CHECK(varint_read_sint(&p, buf + len, &back));
+        TEST_CHECK_INT(values[i], back);
+    }
+    TEST_CHECK(p == buf + len);
+}
+
+static void test_varint_delta(void)
+{
+    uint8_t buf[64];
+    varint_writer_t w;
+
+    // 等间隔时间戳的二阶差分：只有前两个非 0
+    static const int32_t dt[] = {0, 10000, 20000, 30000, 40000};
+    varint_writer_init(&w, buf, sizeof(buf));
+    varint_writer_delta_int32(&w, dt, 5, 2);
+    CHECK_BYTES("00a09c01000000", buf, varint_writer_finish(&w));
+
+    // 一阶差分，跨越整个 int32 范围的跳变也不溢出
+    static const int32_t ext[] = {INT32_MAX, INT32_MIN, 0};
+    varint_writer_init(&w, buf, sizeof(buf));
+    varint_writer_delta_int32(&w, ext, 3, 1);
+    size_t len = varint_writer_finish(&w);
+    const uint8_t *p = buf;
+    int64_t d;
+    TEST_CHECK(varint_read_sint(&p, buf + len, &d));
+    TEST_CHECK_INT(INT32_MAX, d);
+    TEST_CHECK(varint_read_sint(&p, buf + len, &d));
+    TEST_CHECK_INT((int64_t)INT32_MIN - INT32_MAX, d);
+    TEST_CHECK(varint_read_sint(&p, buf + len, &d));
+    TEST_CHECK_INT(-(int64_t)INT32_MIN, d);
+
+    varint_writer_init(&w, buf, 2);
+    varint_writer_delta_int32(&w, dt, 5, 1);
+    TEST_CHECK_INT(0, varint_writer_finish(&w));
+}
+
+// ========================
+// 编码器往返
+// ========================
+
+static app_batch_t s_batch;
+static uint8_t s_out[8192];
+
+// 模拟 100Hz 采样：加速度在 1g 附近抖动，角速度缓慢变化，可选混入满量程的极值
+static void batch_fill(app_batch_t *batch, uint16_t n, uint32_t seed, bool extremes)
+{
+    srand(seed);
+    app_batch_reset(batch);
+    for (uint16_t i = 0; i < n; i++)
+    {
+        app_sample_t s = {0};
+        s.ts_us = 123456789 + (int64_t)i * 10000 + (rand() % 3 - 1);
+        s.ax = (int16_t)(rand() % 41 - 20);
+        s.ay = (int16_t)(rand() % 41 - 20);
+        s.az = (int16_t)(1000 + rand() % 41 - 20);
+        s.gx = (int32_t)(i * 150 - 3000);
+        s.gy = (int32_t)(rand() % 2001 - 1000);
+        s.gz = (int32_t)(-i * 75);
+        s.temp = (int16_t)(2537 + rand() % 3);
+        if (extremes && (i % 7) == 3)
+        {
+            s.ax = INT16_MIN;
+            s.ay = INT16_MAX;
+            s.gx = -2000000;
+            s.gy = 2000000;
+            s.temp = INT16_MIN;
+        }
+        app_batch_push(batch, &s, APP_BATCH_PRIO_NORMAL);
+    }
+}
+
+typedef bool (*decode_fn_t)(const uint8_t *, size_t, upload_t *);
+
+static const decode_fn_t s_decoders[APP_CODEC_MAX] = {
+    [APP_CODEC_JSON] = upload_decode_json,
+    [APP_CODEC_CBOR] = upload_decode_cbor,
+    [APP_CODEC_DELTA] = upload_decode_delta,
+};
+
+static void round_trip(app_codec_id_t id, uint16_t start, uint16_t n, bool utc)
+{
+    static upload_t up;
+    const app_codec_t *codec = app_codec_get(id);
+
+    size_t len = codec->encode_batch(&s_batch, start, n, s_out, sizeof(s_out));
+    TEST_CHECK(len > 0);
+    TEST_CHECK(s_decoders[id](s_out, len, &up));
+    TEST_CHECK_INT(APP_CODEC_SCHEMA_VER, up.ver);
+    TEST_CHECK_INT(utc, up.utc);
+    TEST_CHECK_INT(utc ? s_batch.t0_us + 1700000000000000LL : s_batch.t0_us, up.t0_us);
+    TEST_CHECK(upload_matches_batch(&up, &s_batch, start, n));
+}
+
+static void test_codec_round_trip(void)
+{
+    static const struct
+    {
+        uint16_t start, n;
+        bool extremes;
+    } cases[] = {{0, 1, false}, {0, 50, false}, {0, 50, true}, {17, 9, true}, {49, 1, true}};
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+    {
+        batch_fill(&s_batch, APP_BATCH_CAPACITY, (uint32_t)c + 1, cases[c].extremes);
+        for (int utc = 0; utc <= 1; utc++)
+        {
+            net_time_stub_set(utc, 1700000000000000LL);
+            for (int id = 0; id < APP_CODEC_MAX; id++)
+            {
+                round_trip((app_codec_id_t)id, cases[c].start, cases[c].n, utc);
+            }
+        }
+    }
+    net_time_stub_set(false, 0);
+}
+
+static void test_codec_magic_bytes(void)
+{
+    // 首字节各不相同，服务端拿到一条消息不看主题也能分辨编码
+    batch_fill(&s_batch, 10, 1, false);
+    TEST_CHECK(app_codec_get(APP_CODEC_JSON)->encode_batch(&s_batch, 0, 10, s_out, sizeof(s_out)) > 0);
+    TEST_CHECK_INT('{', s_out[0]);
+    TEST_CHECK(app_codec_get(APP_CODEC_CBOR)->encode_batch(&s_batch, 0, 10, s_out, sizeof(s_out)) > 0);
+    TEST_CHECK_INT(0xAD, s_out[0]);
+    TEST_CHECK(app_codec_get(APP_CODEC_DELTA)->encode_batch(&s_batch, 0, 10, s_out, sizeof(s_out)) > 0);
+    TEST_CHECK_INT(0xD3, s_out[0]);
+}
+
+static void test_codec_size_order(void)
+{
+    size_t len[APP_CODEC_MAX];
+
+    batch_fill(&s_batch, APP_BATCH_CAPACITY, 7, false);
+    for (int id = 0; id < APP_CODEC_MAX; id++)
+    {
+        len[id] = app_codec_get((app_codec_id_t)id)->encode_batch(&s_batch, 0, APP_BATCH_CAPACITY, s_out, sizeof(s_out));
+        TEST_CHECK(len[id] > 0);
+    }
+    TEST_CHECK(len[APP_CODEC_CBOR] < len[APP_CODEC_JSON]);
+    TEST_CHECK(len[APP_CODEC_DELTA] < len[APP_CODEC_CBOR]);
+}
+
+static void test_codec_bad_args(void)
+{
+    batch_fill(&s_batch, 10, 1, false);
+    for (int id = 0; id < APP_CODEC_MAX; id++)
+    {
+        const app_codec_t *codec = app_codec_get((app_codec_id_t)id);
+        size_t full = codec->encode_batch(&s_batch, 0, 10, s_out, sizeof(s_out));
+        TEST_CHECK(full > 0);
+
+        // 缓冲区差一个字节就整体失败，不输出半截消息
+        TEST_CHECK_INT(0, codec->encode_batch(&s_batch, 0, 10, s_out, full - (id == APP_CODEC_JSON ? 0 : 1)));
+        TEST_CHECK_INT(0, codec->encode_batch(&s_batch, 5, 6, s_out, sizeof(s_out)));
+        TEST_CHECK_INT(0, codec->encode_batch(&s_batch, 0, 0, s_out, sizeof(s_out)));
+        TEST_CHECK_INT(0, codec->encode_batch(NULL, 0, 1, s_out, sizeof(s_out)));
+    }
+}
+
+static void test_codec_select(void)
+{
+    app_codec_id_t id;
+
+    TEST_CHECK_INT(ESP_OK, app_codec_find("delta", &id));
+    TEST_CHECK_INT(APP_CODEC_DELTA, id);
+    TEST_CHECK_INT(ESP_ERR_NOT_FOUND, app_codec_find("xml", &id));
+    TEST_CHECK_INT(ESP_ERR_INVALID_ARG, app_codec_select(APP_CODEC_MAX));
+    TEST_CHECK(app_codec_get(APP_CODEC_MAX) == NULL);
+
+    TEST_CHECK_INT(ESP_OK, app_codec_select(APP_CODEC_CBOR));
+    TEST_CHECK_INT(APP_CODEC_CBOR, app_codec_active_id());
+    TEST_CHECK_STR("test/topic/cbor", app_codec_active()->topic);
+    TEST_CHECK_INT(ESP_OK, app_codec_select(APP_CODEC_JSON));
+}
+
+// ========================
+// 批次：紧急样本只在收取后上报一次，且两次紧急上报之间受最小间隔限制
+// ========================
+
+static void test_batch_urgent(void)
+{
+    static app_batch_t batch;
+    app_sample_t s = {0};
+    int64_t t = 1000000;
+
+    memset(&batch, 0, sizeof(batch));
+    for (int i = 0; i < 5; i++)
+    {
+        s.ts_us = t + i * 10000;
+        TEST_CHECK(!app_batch_push(&batch, &s, APP_BATCH_PRIO_URGENT));
+    }
+    TEST_CHECK(batch.urgent);
+    TEST_CHECK(app_batch_due(&batch, s.ts_us));
+    TEST_CHECK(app_batch_deadline_us(&batch) == t);
+    app_batch_reset(&batch);
+
+    // 紧跟着的紧急样本要等到间隔满了才上报
+    int64_t next = t + (int64_t)APP_BATCH_URGENT_GAP_MS * 1000;
+    s.ts_us = t + 100000;
+    TEST_CHECK(!app_batch_push(&batch, &s, APP_BATCH_PRIO_URGENT));
+    TEST_CHECK(!app_batch_due(&batch, s.ts_us));
+    TEST_CHECK(app_batch_deadline_us(&batch) == next);
+    TEST_CHECK(app_batch_due(&batch, next));
+    app_batch_reset(&batch);
+
+    // 间隔之后的紧急样本当场上报；普通样本不受影响
+    s.ts_us = next + 5000000;
+    TEST_CHECK(!app_batch_push(&batch, &s, APP_BATCH_PRIO_NORMAL));
+    TEST_CHECK(!app_batch_due(&batch, s.ts_us));
+    TEST_CHECK(!app_batch_push(&batch, &s, APP_BATCH_PRIO_URGENT));
+    TEST_CHECK(app_batch_due(&batch, s.ts_us));
+}
+
+int main(void)
+{
+    host_log_quiet = 1;
+
+    RUN_TEST(test_cbor_rfc8949_uint);
+    RUN_TEST(test_cbor_rfc8949_int);
+    RUN_TEST(test_cbor_rfc8949_other);
+    RUN_TEST(test_cbor_int_round_trip);
+    RUN_TEST(test_cbor_overflow);
+    RUN_TEST(test_json_writer_structure);
+    RUN_TEST(test_json_writer_escape);
+    RUN_TEST(test_json_writer_fixed);
+    RUN_TEST(test_json_writer_failures);
+    RUN_TEST(test_varint_leb128);
+    RUN_TEST(test_varint_zigzag);
+    RUN_TEST(test_varint_delta);
+    RUN_TEST(test_codec_round_trip);
+    RUN_TEST(test_codec_magic_bytes);
+    RUN_TEST(test_codec_size_order);
+    RUN_TEST(test_codec_bad_args);
+    RUN_TEST(test_codec_select);
+    RUN_TEST(test_batch_urgent);
+    return TEST_RESULT();
+}
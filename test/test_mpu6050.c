@@ -0,0 +1,252 @@
+// MPU6050 驱动测试：驱动的读写函数直接注册到寄存器级模拟设备，不经过总线
+#include "mpu6050.h"
+#include "mpu6050_data.h"
+#include "sim_mpu6050.h"
+#include "test_util.h"
+
+static void mpu_setup(void)
+{
+    sim_mpu6050_reset();
+    MPU6050_RegisterDriver(sim_mpu6050_read_byte, sim_mpu6050_read_bytes, sim_mpu6050_write_byte, sim_mpu6050_delay_ms);
+}
+
+// 生成 n 个各字段互不相同、含负数的样本
+static void mpu_make_samples(MPU6050_Sample_t *out, int n, int seed)
+{
+    for (int i = 0; i < n; i++)
+    {
+        int v = seed + i;
+        out[i].ax = (short)(v * 3 - 1000);
+        out[i].ay = (short)(-v * 5);
+        out[i].az = (short)(16384 + v);
+        out[i].temp = (short)(-521 + v);
+        out[i].gx = (short)(v * 11);
+        out[i].gy = (short)(-32768 + v);
+        out[i].gz = (short)(32767 - v);
+    }
+}
+
+static bool mpu_sample_equal(const MPU6050_Sample_t *a, const MPU6050_Sample_t *b)
+{
+    return a->ax == b->ax && a->ay == b->ay && a->az == b->az && a->temp == b->temp &&
+           a->gx == b->gx && a->gy == b->gy && a->gz == b->gz;
+}
+
+static void test_mpu_init(void)
+{
+    mpu_setup();
+    TEST_CHECK_INT(0, Int_MPU6050_Init());
+
+    // 唤醒并选陀螺仪 X 轴时钟，FIFO 与中断关闭，默认 100 Hz（分频 9）
+    TEST_CHECK_INT(0x01, sim_mpu6050_peek(MPU_PWR_MGMT1_REG));
+    TEST_CHECK_INT(0x00, sim_mpu6050_peek(MPU_FIFO_EN_REG));
+    TEST_CHECK_INT(0x00, sim_mpu6050_peek(MPU_INT_EN_REG));
+    TEST_CHECK_INT(9, sim_mpu6050_peek(MPU_SAMPLE_RATE_REG));
+    TEST_CHECK_INT(100, Int_MPU6050_GetSampleRate());
+    TEST_CHECK_INT(MPU6050_GYRO_FSR_2000DPS << 3, sim_mpu6050_peek(MPU_GYRO_CFG_REG));
+    TEST_CHECK_INT(2000, Int_MPU6050_GetGyroRangeDps());
+    TEST_CHECK_INT(2, Int_MPU6050_GetAccelRangeG());
+}
+
+static void test_mpu_init_errors(void)
+{
+    // 器件 ID 不对：不继续配置时钟源，保持复位后的休眠状态
+    mpu_setup();
+    sim_mpu6050_set_who_am_i(0x68);
+    TEST_CHECK_INT(-1, Int_MPU6050_Init());
+    TEST_CHECK_INT(0x00, sim_mpu6050_peek(MPU_PWR_MGMT1_REG));
+
+    // 第一次写就失败：驱动的错误码原样返回
+    mpu_setup();
+    sim_mpu6050_fail_next(0x107, 1);
+    TEST_CHECK_INT(0x107, Int_MPU6050_Init());
+
+    // 之后重试能成功
+    TEST_CHECK_INT(0, Int_MPU6050_Init());
+    TEST_CHECK_INT(0x01, sim_mpu6050_peek(MPU_PWR_MGMT1_REG));
+}
+
+static void test_mpu_sample_rate(void)
+{
+    mpu_setup();
+    TEST_CHECK_INT(0, Int_MPU6050_SetGyroRate(1000));
+    TEST_CHECK_INT(0, sim_mpu6050_peek(MPU_SAMPLE_RATE_REG));
+    TEST_CHECK_INT(1000, Int_MPU6050_GetSampleRate());
+    TEST_CHECK_INT(1, sim_mpu6050_peek(MPU_CFG_REG)); // 带宽 188 Hz
+
+    // 低于 4 Hz 按 4 Hz；整除后实际速率可能与期望不同
+    TEST_CHECK_INT(0, Int_MPU6050_SetGyroRate(1));
+    TEST_CHECK_INT(249, sim_mpu6050_peek(MPU_SAMPLE_RATE_REG));
+    TEST_CHECK_INT(4, Int_MPU6050_GetSampleRate());
+
+    TEST_CHECK_INT(0, Int_MPU6050_SetGyroRate(300));
+    TEST_CHECK_INT(2, sim_mpu6050_peek(MPU_SAMPLE_RATE_REG));
+    TEST_CHECK_INT(333, Int_MPU6050_GetSampleRate());
+}
+
+static void test_mpu_get_all(void)
+{
+    MPU6050_Sample_t in, out;
+
+    mpu_setup();
+    TEST_CHECK_INT(0, Int_MPU6050_Init());
+    mpu_make_samples(&in, 1, 42);
+    sim_mpu6050_produce(&in, 1);
+
+    TEST_CHECK_INT(0, Int_MPU6050_Get_All(&out));
+    TEST_CHECK(mpu_sample_equal(&in, &out));
+
+    short ax, ay, az, gx, gy, gz;
+    TEST_CHECK_INT(0, Int_MPU6050_Get_Accel(&ax, &ay, &az));
+    TEST_CHECK_INT(0, Int_MPU6050_Get_Gyro(&gx, &gy, &gz));
+    TEST_CHECK(ax == in.ax && ay == in.ay && az == in.az);
+    TEST_CHECK(gx == in.gx && gy == in.gy && gz == in.gz);
+}
+
+static void test_mpu_fifo_burst(void)
+{
+    MPU6050_Sample_t in[20], out[MPU6050_FIFO_MAX_SAMPLES];
+    uint16_t count = 0, bytes = 0;
+    sim_mpu6050_stats_t before, after;
+
+    mpu_setup();
+    TEST_CHECK_INT(0, Int_MPU6050_Init());
+    TEST_CHECK_INT(0, Int_MPU6050_FIFO_Enable());
+    TEST_CHECK_INT(0x40, sim_mpu6050_peek(MPU_USER_CTRL_REG));
+    TEST_CHECK_INT(0xF8, sim_mpu6050_peek(MPU_FIFO_EN_REG));
+
+    mpu_make_samples(in, 20, 7);
+    sim_mpu6050_produce(in, 20);
+    TEST_CHECK_INT(0, Int_MPU6050_FIFO_Count(&bytes));
+    TEST_CHECK_INT(20 * MPU6050_FIFO_SAMPLE_SIZE, bytes);
+
+    // 查询计数一次，整批样本一次突发读出
+    sim_mpu6050_get_stats(&before);
+    TEST_CHECK_INT(0, Int_MPU6050_FIFO_Read(out, MPU6050_FIFO_MAX_SAMPLES, &count));
+    sim_mpu6050_get_stats(&after);
+    TEST_CHECK_INT(20, count);
+    TEST_CHECK_INT(2, after.reads - before.reads);
+    TEST_CHECK_INT(2 + 20 * MPU6050_FIFO_SAMPLE_SIZE, after.read_bytes - before.read_bytes);
+    for (int i = 0; i < 20; i++)
+    {
+        TEST_CHECK(mpu_sample_equal(&in[i], &out[i]));
+    }
+    TEST_CHECK_INT(0, sim_mpu6050_fifo_bytes());
+}
+
+static void test_mpu_fifo_partial(void)
+{
+    MPU6050_Sample_t in[5], out[5];
+    uint16_t count = 0;
+
+    mpu_setup();
+    TEST_CHECK_INT(0, Int_MPU6050_FIFO_Enable());
+    mpu_make_samples(in, 5, 100);
+    sim_mpu6050_produce(in, 5);
+
+    // 数组放不下时只取前 max 个，剩下的留在 FIFO 中按顺序下次取
+    TEST_CHECK_INT(0, Int_MPU6050_FIFO_Read(out, 3, &count));
+    TEST_CHECK_INT(3, count);
+    TEST_CHECK_INT(2 * MPU6050_FIFO_SAMPLE_SIZE, sim_mpu6050_fifo_bytes());
+    TEST_CHECK_INT(0, Int_MPU6050_FIFO_Read(out + 3, 5, &count));
+    TEST_CHECK_INT(2, count);
+    for (int i = 0; i < 5; i++)
+    {
+        TEST_CHECK(mpu_sample_equal(&in[i], &out[i]));
+    }
+
+    // 空 FIFO：不发起突发读
+    TEST_CHECK_INT(0, Int_MPU6050_FIFO_Read(out, 5, &count));
+    TEST_CHECK_INT(0, count);
+}
+
+static void test_mpu_fifo_overflow(void)
+{
+    MPU6050_Sample_t in[80], out[MPU6050_FIFO_MAX_SAMPLES];
+    uint16_t count = 99;
+
+    mpu_setup();
+    TEST_CHECK_INT(0, Int_MPU6050_FIFO_Enable());
+    mpu_make_samples(in, 80, 0);
+    sim_mpu6050_produce(in, 80);
+    TEST_CHECK_INT(MPU6050_FIFO_MAX_BYTES, sim_mpu6050_fifo_bytes());
+    TEST_CHECK(Int_MPU6050_Get_INT_Status() & MPU6050_INT_FIFO_OFLOW);
+
+    // 写满后样本边界已错位：不交出数据，复位 FIFO 重新开始，并计入溢出次数
+    uint32_t overflows = Int_MPU6050_FIFO_GetOverflows();
+    TEST_CHECK_INT(0, Int_MPU6050_FIFO_Read(out, MPU6050_FIFO_MAX_SAMPLES, &count));
+    TEST_CHECK_INT(0, count);
+    TEST_CHECK_INT(0, sim_mpu6050_fifo_bytes());
+    TEST_CHECK_INT(overflows + 1, Int_MPU6050_FIFO_GetOverflows());
+
+    sim_mpu6050_produce(&in[10], 2);
+    TEST_CHECK_INT(0, Int_MPU6050_FIFO_Read(out, MPU6050_FIFO_MAX_SAMPLES, &count));
+    TEST_CHECK_INT(2, count);
+    TEST_CHECK(mpu_sample_equal(&in[10], &out[0]));
+    TEST_CHECK(mpu_sample_equal(&in[11], &out[1]));
+    TEST_CHECK_INT(overflows + 1, Int_MPU6050_FIFO_GetOverflows());
+}
+
+static void test_mpu_fifo_bus_error(void)
+{
+    MPU6050_Sample_t in[4], out[4];
+    uint16_t count = 99;
+
+    mpu_setup();
+    TEST_CHECK_INT(0, Int_MPU6050_FIFO_Enable());
+    mpu_make_samples(in, 4, 0);
+    sim_mpu6050_produce(in, 4);
+
+    // 读失败时输出 0 个样本并返回驱动的错误码，数据仍留在 FIFO 中
+    sim_mpu6050_fail_next(0x107, 1);
+    TEST_CHECK_INT(0x107, Int_MPU6050_FIFO_Read(out, 4, &count));
+    TEST_CHECK_INT(0, count);
+    TEST_CHECK_INT(4 * MPU6050_FIFO_SAMPLE_SIZE, sim_mpu6050_fifo_bytes());
+
+    TEST_CHECK_INT(0, Int_MPU6050_FIFO_Read(out, 4, &count));
+    TEST_CHECK_INT(4, count);
+}
+
+static void test_mpu_fifo_disable(void)
+{
+    MPU6050_Sample_t in[2];
+
+    mpu_setup();
+    TEST_CHECK_INT(0, Int_MPU6050_FIFO_Enable());
+    TEST_CHECK_INT(0, Int_MPU6050_FIFO_Disable());
+    TEST_CHECK_INT(0x00, sim_mpu6050_peek(MPU_USER_CTRL_REG));
+    TEST_CHECK_INT(0x00, sim_mpu6050_peek(MPU_FIFO_EN_REG));
+
+    mpu_make_samples(in, 2, 0);
+    sim_mpu6050_produce(in, 2);
+    TEST_CHECK_INT(0, sim_mpu6050_fifo_bytes());
+}
+
+static void test_mpu_int(void)
+{
+    mpu_setup();
+    TEST_CHECK_INT(0, Int_MPU6050_INT_Enable(MPU6050_INT_DATA_RDY));
+    TEST_CHECK_INT(0x10, sim_mpu6050_peek(MPU_INTBP_CFG_REG));
+    TEST_CHECK_INT(MPU6050_INT_DATA_RDY, sim_mpu6050_peek(MPU_INT_EN_REG));
+
+    // 状态读后清零
+    MPU6050_Sample_t s = {0};
+    sim_mpu6050_produce(&s, 1);
+    TEST_CHECK_INT(MPU6050_INT_DATA_RDY, Int_MPU6050_Get_INT_Status());
+    TEST_CHECK_INT(0, Int_MPU6050_Get_INT_Status());
+}
+
+int main(void)
+{
+    RUN_TEST(test_mpu_init);
+    RUN_TEST(test_mpu_init_errors);
+    RUN_TEST(test_mpu_sample_rate);
+    RUN_TEST(test_mpu_get_all);
+    RUN_TEST(test_mpu_fifo_burst);
+    RUN_TEST(test_mpu_fifo_partial);
+    RUN_TEST(test_mpu_fifo_overflow);
+    RUN_TEST(test_mpu_fifo_bus_error);
+    RUN_TEST(test_mpu_fifo_disable);
+    RUN_TEST(test_mpu_int);
+    return TEST_RESULT();
+}
@@ -0,0 +1,495 @@
+// 异步发布测试（模拟 MQTT 客户端）：确认与 mqtt_pub_bind / mqtt_pub_complete 的配合，
+// 包括确认在 esp_mqtt_client_enqueue 返回前就到达、提前确认属于其他消息、入队失败、在途上限，以及 MQTT 任务并发确认；
+// 统计快照：连接时长与重连、字节数、确认延迟直方图和 JSON 输出
+#include "my_mqtt.h"
+#include "json_reader.h"
+#include "sim_mqtt.h"
+#include "esp_rom_sys.h"
+#include "test_util.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+#define TOPIC "dev/up"
+#define PAYLOAD "{\"t\":1}"
+
+// 每个消息 ID 的回调次数和最后一次结果
+static atomic_int s_cb_count[UINT16_MAX + 1];
+static int s_cb_result[UINT16_MAX + 1];
+static atomic_int s_cb_total;
+static int s_cb_ctx_ok = 1;
+static void *s_cb_ctx = NULL;
+
+static void pub_cb(int handle, mqtt_pub_result_t result, uint32_t latency_ms, void *ctx)
+{
+    if (handle > 0 && handle <= UINT16_MAX)
+    {
+        s_cb_result[handle] = result;
+        atomic_fetch_add(&s_cb_count[handle], 1);
+    }
+    if (ctx != s_cb_ctx)
+    {
+        s_cb_ctx_ok = 0;
+    }
+    atomic_fetch_add(&s_cb_total, 1);
+}
+
+static void reset(void)
+{
+    sim_mqtt_reset();
+    for (int i = 0; i <= UINT16_MAX; i++)
+    {
+        atomic_store(&s_cb_count[i], 0);
+    }
+    atomic_store(&s_cb_total, 0);
+    s_cb_ctx = NULL;
+}
+
+static int publish(int qos, esp_err_t *err)
+{
+    int handle = -1;
+    *err = mqtt_app_publish_async(TOPIC, PAYLOAD, strlen(PAYLOAD), qos, false, pub_cb, s_cb_ctx, &handle);
+    return handle;
+}
+
+static mqtt_stats_t stats(void)
+{
+    mqtt_stats_t st;
+    mqtt_app_get_stats(&st);
+    return st;
+}
+
+static void test_mqtt_not_connected(void)
+{
+    reset();
+    esp_err_t err;
+    uint32_t dropped = stats().dropped;
+    int handle = publish(1, &err);
+    TEST_CHECK_INT(ESP_ERR_INVALID_STATE, err);
+    TEST_CHECK_INT(0, handle);
+    TEST_CHECK_INT(dropped + 1, stats().dropped);
+    TEST_CHECK_INT(0, mqtt_app_inflight());
+
+    sim_mqtt_event(MQTT_EVENT_CONNECTED, 0);
+    TEST_CHECK(mqtt_is_connected());
+}
+
+static void test_mqtt_ack(void)
+{
+    reset();
+    esp_err_t err;
+    int ctx;
+    s_cb_ctx = &ctx;
+    mqtt_stats_t before = stats();
+
+    int h1 = publish(1, &err);
+    TEST_CHECK_INT(ESP_OK, err);
+    int h2 = publish(2, &err);
+    TEST_CHECK(h1 > 0 && h2 > 0 && h1 != h2);
+    TEST_CHECK_INT(2, mqtt_app_inflight());
+    TEST_CHECK_INT(0, s_cb_total);
+
+    // 先后顺序与发布无关；同一条的重复确认只回调一次
+    sim_mqtt_event(MQTT_EVENT_PUBLISHED, h2);
+    sim_mqtt_event(MQTT_EVENT_PUBLISHED, h2);
+    TEST_CHECK_INT(1, s_cb_count[h2]);
+    TEST_CHECK_INT(MQTT_PUB_ACKED, s_cb_result[h2]);
+    TEST_CHECK_INT(1, mqtt_app_inflight());
+
+    // 过期删除按失败回调
+    sim_mqtt_event(MQTT_EVENT_DELETED, h1);
+    TEST_CHECK_INT(1, s_cb_count[h1]);
+    TEST_CHECK_INT(MQTT_PUB_FAILED, s_cb_result[h1]);
+    TEST_CHECK_INT(0, mqtt_app_inflight());
+    TEST_CHECK(s_cb_ctx_ok);
+
+    mqtt_stats_t after = stats();
+    TEST_CHECK_INT(before.published + 2, after.published);
+    TEST_CHECK_INT(before.acked + 1, after.acked);
+    TEST_CHECK_INT(before.failed + 1, after.failed);
+
+    // QoS0 不跟踪、不回调
+    int h0 = publish(0, &err);
+    TEST_CHECK_INT(ESP_OK, err);
+    TEST_CHECK_INT(0, h0);
+    TEST_CHECK_INT(0, mqtt_app_inflight());
+    TEST_CHECK_INT(2, s_cb_total);
+}
+
+// ========================
+// 确认在入队返回前到达：跟踪项还没有消息 ID，结果先记下，由 mqtt_pub_bind 在发布任务中回调
+// ========================
+
+static int s_early_ack_id = 0; // 非 0 时入队回调改为确认这个 ID（模拟其他消息的确认）
+static mqtt_pub_result_t s_early_result = MQTT_PUB_ACKED;
+static int s_early_seen_cb = -1;
+
+static void ack_during_enqueue(int msg_id, int qos, void *ctx)
+{
+    int id = s_early_ack_id ? s_early_ack_id : msg_id;
+    sim_mqtt_event(s_early_result == MQTT_PUB_ACKED ? MQTT_EVENT_PUBLISHED : MQTT_EVENT_DELETED, id);
+    // 此时还在 esp_mqtt_client_enqueue 里，不应已经回调
+    s_early_seen_cb = s_cb_total;
+}
+
+static void test_mqtt_early_ack(void)
+{
+    reset();
+    esp_err_t err;
+    sim_mqtt_on_enqueue(ack_during_enqueue, NULL);
+    s_early_ack_id = 0;
+
+    s_early_result = MQTT_PUB_ACKED;
+    int h = publish(1, &err);
+    TEST_CHECK_INT(ESP_OK, err);
+    TEST_CHECK_INT(0, s_early_seen_cb);
+    TEST_CHECK_INT(1, s_cb_count[h]);
+    TEST_CHECK_INT(MQTT_PUB_ACKED, s_cb_result[h]);
+    TEST_CHECK_INT(0, mqtt_app_inflight());
+
+    s_early_result = MQTT_PUB_FAILED;
+    h = publish(1, &err);
+    TEST_CHECK_INT(1, s_cb_count[h]);
+    TEST_CHECK_INT(MQTT_PUB_FAILED, s_cb_result[h]);
+    TEST_CHECK_INT(0, mqtt_app_inflight());
+    sim_mqtt_on_enqueue(NULL, NULL);
+}
+
+static void test_mqtt_early_ack_other(void)
+{
+    reset();
+    esp_err_t err;
+
+    // 入队期间到达的是另一条消息（同步发布或重放消息 900）的确认：不能算到这条上
+    sim_mqtt_on_enqueue(ack_during_enqueue, NULL);
+    s_early_result = MQTT_PUB_ACKED;
+    s_early_ack_id = 900;
+    int h = publish(1, &err);
+    sim_mqtt_on_enqueue(NULL, NULL);
+    TEST_CHECK_INT(ESP_OK, err);
+    TEST_CHECK(h != 900);
+    TEST_CHECK_INT(0, s_cb_total);
+    TEST_CHECK_INT(1, mqtt_app_inflight());
+
+    // 入队结束后记下的提前确认被清掉：之后恰好分到 ID 900 的消息要等它自己的确认
+    sim_mqtt_set_next_id(900);
+    int h900 = publish(1, &err);
+    TEST_CHECK_INT(900, h900);
+    TEST_CHECK_INT(0, s_cb_count[900]);
+    TEST_CHECK_INT(2, mqtt_app_inflight());
+
+    sim_mqtt_event(MQTT_EVENT_PUBLISHED, 900);
+    sim_mqtt_event(MQTT_EVENT_PUBLISHED, h);
+    TEST_CHECK_INT(1, s_cb_count[900]);
+    TEST_CHECK_INT(1, s_cb_count[h]);
+    TEST_CHECK_INT(0, mqtt_app_inflight());
+
+    // 没有消息正在入队时，找不到跟踪项的确认直接忽略
+    sim_mqtt_event(MQTT_EVENT_PUBLISHED, 901);
+    sim_mqtt_set_next_id(901);
+    int h901 = publish(1, &err);
+    TEST_CHECK_INT(901, h901);
+    TEST_CHECK_INT(0, s_cb_count[901]);
+    sim_mqtt_event(MQTT_EVENT_PUBLISHED, 901);
+    TEST_CHECK_INT(1, s_cb_count[901]);
+}
+
+static void test_mqtt_enqueue_fail(void)
+{
+    reset();
+    esp_err_t err;
+    sim_mqtt_fail_enqueue(1);
+    int h = publish(1, &err);
+    TEST_CHECK_INT(ESP_FAIL, err);
+    TEST_CHECK_INT(0, h);
+    TEST_CHECK_INT(0, mqtt_app_inflight());
+    TEST_CHECK_INT(0, s_cb_total);
+
+    // 跟踪项已释放，可以照常发布
+    h = publish(1, &err);
+    TEST_CHECK_INT(ESP_OK, err);
+    sim_mqtt_event(MQTT_EVENT_PUBLISHED, h);
+    TEST_CHECK_INT(1, s_cb_count[h]);
+}
+
+static void test_mqtt_inflight_max(void)
+{
+    reset();
+    esp_err_t err;
+    int handles[MQTT_PUB_INFLIGHT_MAX];
+    for (int i = 0; i < MQTT_PUB_INFLIGHT_MAX; i++)
+    {
+        handles[i] = publish(1, &err);
+        TEST_CHECK_INT(ESP_OK, err);
+    }
+    TEST_CHECK_INT(MQTT_PUB_INFLIGHT_MAX, mqtt_app_inflight());
+    TEST_CHECK_INT(0, publish(1, &err));
+    TEST_CHECK_INT(ESP_ERR_NO_MEM, err);
+
+    // 满了也不影响 QoS0
+    publish(0, &err);
+    TEST_CHECK_INT(ESP_OK, err);
+
+    sim_mqtt_event(MQTT_EVENT_PUBLISHED, handles[3]);
+    int h = publish(1, &err);
+    TEST_CHECK_INT(ESP_OK, err);
+    for (int i = 0; i < MQTT_PUB_INFLIGHT_MAX; i++)
+    {
+        sim_mqtt_event(MQTT_EVENT_PUBLISHED, handles[i]);
+    }
+    TEST_CHECK_INT(1, mqtt_app_inflight());
+    sim_mqtt_event(MQTT_EVENT_PUBLISHED, h);
+    TEST_CHECK_INT(MQTT_PUB_INFLIGHT_MAX + 1, s_cb_total);
+}
+
+// ========================
+// 并发：MQTT 任务（另一个线程）一拿到消息 ID 就确认，常常赶在入队返回之前；每条消息恰好回调一次
+// ========================
+
+#define STRESS_COUNT 20000
+#define STRESS_QUEUE 64
+
+static int s_stress_ids[STRESS_QUEUE];
+static atomic_int s_stress_head;
+static atomic_int s_stress_tail;
+static atomic_bool s_stress_stop;
+
+static void stress_push(int msg_id, int qos, void *ctx)
+{
+    int tail = atomic_load(&s_stress_tail);
+    while (tail - atomic_load(&s_stress_head) >= STRESS_QUEUE)
+    {
+        sched_yield();
+    }
+    s_stress_ids[tail % STRESS_QUEUE] = msg_id;
+    atomic_store(&s_stress_tail, tail + 1);
+}
+
+static void *stress_mqtt_task(void *arg)
+{
+    while (!atomic_load(&s_stress_stop) || atomic_load(&s_stress_head) != atomic_load(&s_stress_tail))
+    {
+        int head = atomic_load(&s_stress_head);
+        if (head == atomic_load(&s_stress_tail))
+        {
+            sched_yield();
+            continue;
+        }
+        int id = s_stress_ids[head % STRESS_QUEUE];
+        atomic_store(&s_stress_head, head + 1);
+        sim_mqtt_event(MQTT_EVENT_PUBLISHED, id);
+    }
+    return NULL;
+}
+
+static void test_mqtt_concurrent_ack(void)
+{
+    reset();
+    atomic_store(&s_stress_head, 0);
+    atomic_store(&s_stress_tail, 0);
+    atomic_store(&s_stress_stop, false);
+    sim_mqtt_on_enqueue(stress_push, NULL);
+
+    pthread_t task;
+    TEST_CHECK(pthread_create(&task, NULL, stress_mqtt_task, NULL) == 0);
+    int sent = 0;
+    for (int i = 0; i < STRESS_COUNT; i++)
+    {
+        esp_err_t err;
+        publish(1, &err);
+        if (err == ESP_OK)
+        {
+            sent++;
+        }
+        else
+        {
+            // 在途满了，等 MQTT 任务确认
+            TEST_CHECK_INT(ESP_ERR_NO_MEM, err);
+            sched_yield();
+        }
+    }
+    atomic_store(&s_stress_stop, true);
+    pthread_join(task, NULL);
+    sim_mqtt_on_enqueue(NULL, NULL);
+
+    TEST_CHECK_INT(0, mqtt_app_inflight());
+    TEST_CHECK_INT(sent, s_cb_total);
+    int wrong = 0;
+    for (int i = 1; i <= UINT16_MAX; i++)
+    {
+        if (s_cb_count[i] > 1 || (s_cb_count[i] == 1 && s_cb_result[i] != MQTT_PUB_ACKED))
+        {
+            wrong++;
+        }
+    }
+    TEST_CHECK_INT(0, wrong);
+}
+
+// ========================
+// 统计快照
+// ========================
+
+static void test_mqtt_stats_link(void)
+{
+    mqtt_stats_t before = stats();
+    TEST_CHECK(before.connected);
+
+    // 连接期间的快照包含本次连接已经过的时间
+    esp_rom_delay_us(30 * 1000);
+    mqtt_stats_t st = stats();
+    TEST_CHECK(st.connected_ms >= before.connected_ms + 30);
+
+    // 断开后累计时长不再增长，发布被拒绝并计入 dropped（同步和异步都算）
+    sim_mqtt_event(MQTT_EVENT_DISCONNECTED, 0);
+    st = stats();
+    TEST_CHECK(!st.connected);
+    esp_rom_delay_us(20 * 1000);
+    TEST_CHECK_INT(st.connected_ms, stats().connected_ms);
+    esp_err_t err;
+    publish(1, &err);
+    TEST_CHECK_INT(ESP_ERR_INVALID_STATE, err);
+    TEST_CHECK_INT(ESP_ERR_INVALID_STATE, mqtt_app_publish(TOPIC, PAYLOAD, strlen(PAYLOAD), 1, false));
+    TEST_CHECK_INT(st.dropped + 2, stats().dropped);
+    TEST_CHECK_INT(st.published, stats().published);
+
+    // 重连计数；错误事件也算断开，重复的断开不重复累计
+    sim_mqtt_event(MQTT_EVENT_CONNECTED, 0);
+    sim_mqtt_event(MQTT_EVENT_ERROR, 0);
+    sim_mqtt_event(MQTT_EVENT_DISCONNECTED, 0);
+    sim_mqtt_event(MQTT_EVENT_CONNECTED, 0);
+    sim_mqtt_event(MQTT_EVENT_CONNECTED, 0);
+    st = stats();
+    TEST_CHECK(st.connected);
+    TEST_CHECK_INT(before.reconnects + 2, st.reconnects);
+}
+
+static size_t s_rx_bytes = 0;
+
+static void data_cb(const char *topic, size_t topic_len, const char *data, size_t data_len)
+{
+    s_rx_bytes += data_len;
+}
+
+static void test_mqtt_stats_bytes(void)
+{
+    reset();
+    mqtt_stats_t before = stats();
+    esp_err_t err;
+
+    // 发送按负载字节计，同步、异步和 QoS0 都算
+    TEST_CHECK_INT(ESP_OK, mqtt_app_publish(TOPIC, "abc", 3, 0, false));
+    int h = publish(1, &err);
+    publish(0, &err);
+    sim_mqtt_event(MQTT_EVENT_PUBLISHED, h);
+
+    mqtt_register_data_cb(data_cb);
+    sim_mqtt_data("dev/down", "{\"cmd\":1}", 9);
+    sim_mqtt_data("dev/down", "xy", 2);
+    mqtt_register_data_cb(NULL);
+
+    mqtt_stats_t st = stats();
+    TEST_CHECK_INT(before.published + 3, st.published);
+    TEST_CHECK_INT(before.bytes_sent + 3 + 2 * strlen(PAYLOAD), st.bytes_sent);
+    TEST_CHECK_INT(before.received + 2, st.received);
+    TEST_CHECK_INT(before.bytes_received + 11, st.bytes_received);
+    TEST_CHECK_INT(11, s_rx_bytes);
+}
+
+static void test_mqtt_stats_latency(void)
+{
+    reset();
+    mqtt_stats_t before = stats();
+    esp_err_t err;
+
+    // 立即确认的落在第一个桶，等 30 ms 再确认的落在 25 ms 以上的桶
+    int fast = publish(1, &err);
+    sim_mqtt_event(MQTT_EVENT_PUBLISHED, fast);
+    int slow = publish(1, &err);
+    esp_rom_delay_us(30 * 1000);
+    sim_mqtt_event(MQTT_EVENT_PUBLISHED, slow);
+    // 失败的不计入延迟
+    int lost = publish(1, &err);
+    esp_rom_delay_us(5 * 1000);
+    sim_mqtt_event(MQTT_EVENT_DELETED, lost);
+
+    mqtt_stats_t st = stats();
+    TEST_CHECK_INT(before.acked + 2, st.acked);
+    TEST_CHECK_INT(before.failed + 1, st.failed);
+    TEST_CHECK(st.latency_min_ms <= 10);
+    TEST_CHECK(st.latency_max_ms >= 30);
+    TEST_CHECK(st.latency_avg_ms <= st.latency_max_ms);
+
+    uint32_t sum = 0, low = 0, high = 0;
+    for (int i = 0; i < MQTT_LATENCY_BUCKETS; i++)
+    {
+        uint32_t n = st.latency_hist[i] - before.latency_hist[i];
+        sum += n;
+        if (i == 0)
+        {
+            low += n;
+        }
+        if (i >= 2)
+        {
+            high += n;
+        }
+    }
+    TEST_CHECK_INT(2, sum);
+    TEST_CHECK_INT(1, low);
+    TEST_CHECK_INT(1, high);
+}
+
+static void test_mqtt_stats_json(void)
+{
+    reset();
+    esp_err_t err;
+    int h = publish(1, &err);
+
+    char buf[512];
+    size_t len = mqtt_app_stats_json(buf, sizeof(buf));
+    TEST_CHECK(len > 0 && len < sizeof(buf));
+
+    mqtt_stats_t st = stats();
+    static const char *const keys[] = {"connected", "acked", "inflight", "tx_bytes", "lat_hist", "outbox"};
+    json_span_t v[6];
+    TEST_CHECK(json_reader_fields(buf, len, keys, v, 6));
+    bool connected = false;
+    int64_t acked = -1, inflight = -1, tx = -1;
+    TEST_CHECK(json_span_bool(&v[0], &connected) && connected);
+    TEST_CHECK(json_span_int(&v[1], &acked));
+    TEST_CHECK_INT(st.acked, acked);
+    TEST_CHECK(json_span_int(&v[2], &inflight));
+    TEST_CHECK_INT(1, inflight);
+    TEST_CHECK(json_span_int(&v[3], &tx));
+    TEST_CHECK_INT(st.bytes_sent, tx);
+    TEST_CHECK_INT(JSON_READER_ARRAY, v[4].type);
+    TEST_CHECK_INT(JSON_READER_OBJECT, v[5].type);
+
+    static const char *const outbox_keys[] = {"depth", "del_dropped"};
+    json_span_t ov[2];
+    TEST_CHECK(json_reader_fields(v[5].p, v[5].len, outbox_keys, ov, 2));
+    TEST_CHECK_INT(JSON_READER_NUMBER, ov[0].type);
+    TEST_CHECK_INT(JSON_READER_NUMBER, ov[1].type);
+
+    // 放不下时返回 0
+    TEST_CHECK_INT(0, mqtt_app_stats_json(buf, 64));
+    sim_mqtt_event(MQTT_EVENT_PUBLISHED, h);
+}
+
+int main(void)
+{
+    host_log_quiet = 1;
+    TEST_CHECK_INT(ESP_OK, mqtt_app_init("mqtt://127.0.0.1", "test", NULL, NULL, NULL));
+
+    RUN_TEST(test_mqtt_not_connected);
+    RUN_TEST(test_mqtt_ack);
+    RUN_TEST(test_mqtt_early_ack);
+    RUN_TEST(test_mqtt_early_ack_other);
+    RUN_TEST(test_mqtt_enqueue_fail);
+    RUN_TEST(test_mqtt_inflight_max);
+    RUN_TEST(test_mqtt_concurrent_ack);
+    RUN_TEST(test_mqtt_stats_link);
+    RUN_TEST(test_mqtt_stats_bytes);
+    RUN_TEST(test_mqtt_stats_latency);
+    RUN_TEST(test_mqtt_stats_json);
+    return TEST_RESULT();
+}
@@ -0,0 +1,402 @@
+// 持久化 MQTT outbox 测试（模拟 flash 分区）：批量写入、重启后重放、删除记录、清空、重放消息换 ID、
+// 写失败重试、写满淘汰，以及一次收到大量确认时删除记录不丢
+#include "mqtt_outbox.h"
+#include "my_outbox.h"
+#include "sim_flash.h"
+#include "test_util.h"
+#include <pthread.h>
+
+#define SECTOR_SIZE 4096
+#define MSG_TYPE_PUBLISH 3
+#define MSG_TYPE_SUBSCRIBE 8
+#define TOPIC "dev/up"
+
+// 拼一条 PUBLISH 报文：固定头、剩余长度、主题、报文标识符，负载全部为 fill
+static int make_publish(uint8_t *buf, uint16_t id, int qos, int payload_len, uint8_t fill)
+{
+    int topic_len = (int)strlen(TOPIC);
+    int remaining = 2 + topic_len + (qos > 0 ? 2 : 0) + payload_len;
+    int off = 0;
+    buf[off++] = (uint8_t)(0x30 | (qos << 1));
+    do
+    {
+        uint8_t b = remaining & 0x7F;
+        remaining >>= 7;
+        buf[off++] = b | (remaining ? 0x80 : 0);
+    } while (remaining);
+    buf[off++] = 0;
+    buf[off++] = (uint8_t)topic_len;
+    memcpy(&buf[off], TOPIC, (size_t)topic_len);
+    off += topic_len;
+    if (qos > 0)
+    {
+        buf[off++] = (uint8_t)(id >> 8);
+        buf[off++] = (uint8_t)id;
+    }
+    memset(&buf[off], fill, (size_t)payload_len);
+    return off + payload_len;
+}
+
+// 报文头放 data，负载放 remaining_data（esp-mqtt 发布大消息时就是这样分开的）
+static outbox_item_handle_t enqueue_pub(outbox_t ob, uint16_t id, int qos, int payload_len, uint8_t fill)
+{
+    static uint8_t buf[4096];
+    int len = make_publish(buf, id, qos, payload_len, fill);
+    int head = len - payload_len;
+    outbox_message_t msg = {
+        .data = buf,
+        .len = head,
+        .msg_id = id,
+        .msg_qos = qos,
+        .msg_type = MSG_TYPE_PUBLISH,
+        .remaining_data = buf + head,
+        .remaining_len = payload_len,
+    };
+    return outbox_enqueue(ob, &msg, 0);
+}
+
+// 按 ID 取出消息，检查报文与 make_publish(id, ...) 一致
+static bool check_pub(outbox_t ob, uint16_t id, int payload_len, uint8_t fill)
+{
+    uint8_t expected[4096];
+    int len = make_publish(expected, id, 1, payload_len, fill);
+
+    size_t got_len;
+    uint16_t got_id;
+    int type, qos;
+    uint8_t *data = outbox_item_get_data(outbox_get(ob, id), &got_len, &got_id, &type, &qos);
+    return data && got_len == (size_t)len && got_id == id && type == MSG_TYPE_PUBLISH && qos == 1 &&
+           memcmp(data, expected, (size_t)len) == 0;
+}
+
+// 模拟重启：销毁时写入待写的批次，再从 flash 重放
+static outbox_t restart(outbox_t ob)
+{
+    outbox_destroy(ob);
+    return outbox_init();
+}
+
+static mqtt_outbox_stats_t stats(void)
+{
+    mqtt_outbox_stats_t st;
+    mqtt_outbox_get_stats(&st);
+    return st;
+}
+
+// 待写的批次写入 flash：攒够一批时 MQTT 任务的 outbox_dequeue 会写
+static void flush_by_dequeue(outbox_t ob)
+{
+    outbox_dequeue(ob, QUEUED, NULL);
+}
+
+static void test_outbox_ram_only(void)
+{
+    sim_flash_reset(NULL, 0, 0);
+    outbox_t ob = outbox_init();
+    TEST_CHECK(ob != NULL);
+    TEST_CHECK(outbox_init() == NULL);
+
+    enqueue_pub(ob, 1, 1, 100, 0xA1);
+    enqueue_pub(ob, 2, 1, 100, 0xA2);
+    TEST_CHECK(check_pub(ob, 1, 100, 0xA1));
+    TEST_CHECK(!stats().flash);
+    TEST_CHECK_INT(2, stats().depth);
+
+    TEST_CHECK_INT(ESP_OK, outbox_delete(ob, 1, MSG_TYPE_PUBLISH));
+    TEST_CHECK_INT(ESP_FAIL, outbox_delete(ob, 1, MSG_TYPE_PUBLISH));
+    TEST_CHECK(outbox_get(ob, 1) == NULL);
+    TEST_CHECK(check_pub(ob, 2, 100, 0xA2));
+
+    // 没有 flash 时重启后什么也不剩
+    ob = restart(ob);
+    TEST_CHECK_INT(0, stats().depth);
+    outbox_destroy(ob);
+}
+
+static void test_outbox_replay(void)
+{
+    sim_flash_reset(MQTT_OUTBOX_PARTITION_LABEL, 4, SECTOR_SIZE);
+    outbox_t ob = outbox_init();
+    TEST_CHECK(stats().flash);
+    uint32_t replayed_before = stats().replayed;
+
+    enqueue_pub(ob, 1, 1, 200, 0x11);
+    enqueue_pub(ob, 2, 1, 300, 0x22);
+    enqueue_pub(ob, 3, 2, 10, 0x33);
+    // QoS0 和非 PUBLISH 只留在内存
+    enqueue_pub(ob, 0, 0, 50, 0x44);
+    outbox_message_t sub = {.data = (uint8_t *)"\x82\x00", .len = 2, .msg_id = 9, .msg_type = MSG_TYPE_SUBSCRIBE, .msg_qos = 1};
+    outbox_enqueue(ob, &sub, 0);
+    TEST_CHECK_INT(5, stats().depth);
+    TEST_CHECK_INT(0, stats().flash_bytes);
+
+    ob = restart(ob);
+    mqtt_outbox_stats_t st = stats();
+    TEST_CHECK_INT(3, st.depth);
+    TEST_CHECK_INT(3, st.replayed - replayed_before);
+    TEST_CHECK_INT(st.bytes, st.flash_bytes);
+    TEST_CHECK(check_pub(ob, 1, 200, 0x11));
+    TEST_CHECK(check_pub(ob, 2, 300, 0x22));
+    TEST_CHECK(outbox_get(ob, 9) == NULL);
+
+    // 重放的消息按原来的顺序待发，QoS 保留
+    outbox_tick_t tick;
+    outbox_item_handle_t item = outbox_dequeue(ob, QUEUED, &tick);
+    size_t len;
+    uint16_t id;
+    int type, qos;
+    TEST_CHECK(outbox_item_get_data(item, &len, &id, &type, &qos) != NULL);
+    TEST_CHECK_INT(1, id);
+    TEST_CHECK_INT(QUEUED, outbox_item_get_pending(item));
+    TEST_CHECK(outbox_item_get_data(outbox_get(ob, 3), &len, &id, &type, &qos) != NULL);
+    TEST_CHECK_INT(2, qos);
+
+    // 没有改动时再重启一次，重放的还是同样三条
+    ob = restart(ob);
+    TEST_CHECK_INT(3, stats().depth);
+    TEST_CHECK(check_pub(ob, 2, 300, 0x22));
+    outbox_destroy(ob);
+}
+
+static void test_outbox_delete(void)
+{
+    sim_flash_reset(MQTT_OUTBOX_PARTITION_LABEL, 4, SECTOR_SIZE);
+    outbox_t ob = outbox_init();
+    for (uint16_t id = 1; id <= 4; id++)
+    {
+        enqueue_pub(ob, id, 1, 100, (uint8_t)id);
+    }
+    ob = restart(ob);
+    TEST_CHECK_INT(4, stats().depth);
+
+    // 已在 flash 中的消息被确认：写删除记录，重启后不再重放
+    TEST_CHECK_INT(ESP_OK, outbox_delete(ob, 2, MSG_TYPE_PUBLISH));
+    TEST_CHECK_INT(ESP_OK, outbox_delete_item(ob, outbox_get(ob, 4)));
+    TEST_CHECK_INT(ESP_FAIL, outbox_delete(ob, 3, MSG_TYPE_SUBSCRIBE));
+
+    // 写入 flash 之前就被确认的消息不写 flash
+    sim_flash_counters_t before, after;
+    enqueue_pub(ob, 7, 1, 500, 0x77);
+    TEST_CHECK_INT(ESP_OK, outbox_delete(ob, 7, MSG_TYPE_PUBLISH));
+    sim_flash_get_counters(&before);
+
+    ob = restart(ob);
+    sim_flash_get_counters(&after);
+    TEST_CHECK(after.write_bytes - before.write_bytes < 100);
+    TEST_CHECK_INT(2, stats().depth);
+    TEST_CHECK(check_pub(ob, 1, 100, 1));
+    TEST_CHECK(check_pub(ob, 3, 100, 3));
+    TEST_CHECK(outbox_get(ob, 2) == NULL);
+    TEST_CHECK(outbox_get(ob, 7) == NULL);
+
+    // 过期删除同样写删除记录
+    outbox_set_tick(ob, 1, 1000);
+    outbox_set_tick(ob, 3, 5000);
+    TEST_CHECK_INT(1, outbox_delete_expired(ob, 6000, 2000));
+    ob = restart(ob);
+    TEST_CHECK_INT(1, stats().depth);
+    TEST_CHECK(check_pub(ob, 3, 100, 3));
+
+    // 清空：之前的全部不再重放，之后的照常
+    outbox_delete_all_items(ob);
+    enqueue_pub(ob, 8, 1, 100, 8);
+    ob = restart(ob);
+    TEST_CHECK_INT(1, stats().depth);
+    TEST_CHECK(check_pub(ob, 8, 100, 8));
+    TEST_CHECK(outbox_get(ob, 3) == NULL);
+    outbox_destroy(ob);
+}
+
+static void test_outbox_batch(void)
+{
+    sim_flash_reset(MQTT_OUTBOX_PARTITION_LABEL, 4, SECTOR_SIZE);
+    outbox_t ob = outbox_init();
+    uint32_t flushes = stats().flushes;
+
+    // 不满一批时不写
+    enqueue_pub(ob, 1, 1, 1000, 0x01);
+    flush_by_dequeue(ob);
+    TEST_CHECK_INT(0, stats().flash_bytes);
+
+    // 攒够一批由 MQTT 任务写入，内存释放后从 flash 读出
+    enqueue_pub(ob, 2, 1, 1100, 0x02);
+    flush_by_dequeue(ob);
+    mqtt_outbox_stats_t st = stats();
+    TEST_CHECK_INT(flushes + 1, st.flushes);
+    TEST_CHECK_INT(st.bytes, st.flash_bytes);
+    TEST_CHECK(check_pub(ob, 1, 1000, 0x01));
+    TEST_CHECK(check_pub(ob, 2, 1100, 0x02));
+
+    // 写失败：消息退回内存，下一批换一个扇区重写，不丢
+    sim_flash_fail_writes(1, 10);
+    enqueue_pub(ob, 3, 1, 1000, 0x03);
+    enqueue_pub(ob, 4, 1, 1100, 0x04);
+    flush_by_dequeue(ob);
+    TEST_CHECK_INT(st.flash_bytes, stats().flash_bytes);
+    TEST_CHECK(check_pub(ob, 3, 1000, 0x03));
+    flush_by_dequeue(ob);
+    TEST_CHECK_INT(stats().bytes, stats().flash_bytes);
+
+    ob = restart(ob);
+    TEST_CHECK_INT(4, stats().depth);
+    for (uint16_t id = 1; id <= 4; id++)
+    {
+        TEST_CHECK(check_pub(ob, id, (id % 2) ? 1000 : 1100, (uint8_t)id));
+    }
+    outbox_destroy(ob);
+}
+
+static void test_outbox_torn_write(void)
+{
+    sim_flash_reset(MQTT_OUTBOX_PARTITION_LABEL, 4, SECTOR_SIZE);
+    outbox_t ob = outbox_init();
+    enqueue_pub(ob, 1, 1, 100, 0x01);
+    ob = restart(ob);
+
+    // 写到一半断电：不完整的记录校验失败，之前的记录照常重放
+    enqueue_pub(ob, 2, 1, 100, 0x02);
+    sim_flash_fail_writes(1, 60);
+    ob = restart(ob);
+    TEST_CHECK_INT(1, stats().depth);
+    TEST_CHECK(check_pub(ob, 1, 100, 0x01));
+
+    // 之后新写的消息在新扇区，重启后也能重放
+    enqueue_pub(ob, 3, 1, 100, 0x03);
+    ob = restart(ob);
+    TEST_CHECK_INT(2, stats().depth);
+    TEST_CHECK(check_pub(ob, 3, 100, 0x03));
+    outbox_destroy(ob);
+}
+
+static void test_outbox_renumber(void)
+{
+    sim_flash_reset(MQTT_OUTBOX_PARTITION_LABEL, 4, SECTOR_SIZE);
+    outbox_t ob = outbox_init();
+    enqueue_pub(ob, 5, 1, 100, 0x05);
+    ob = restart(ob);
+
+    // 新消息用了重放消息的 ID：重放的那条换 ID，报文中的标识符跟着改
+    // （已发出的也改回待发，用新 ID 重发）
+    outbox_set_pending(ob, 5, TRANSMITTED);
+    outbox_item_handle_t fresh = enqueue_pub(ob, 5, 1, 100, 0x55);
+    TEST_CHECK(outbox_get(ob, 5) == fresh);
+    outbox_set_pending(ob, 5, TRANSMITTED);
+
+    outbox_item_handle_t replayed = outbox_dequeue(ob, QUEUED, NULL);
+    TEST_CHECK(replayed != NULL && replayed != fresh);
+    size_t len;
+    uint16_t id = 0;
+    int type, qos;
+    outbox_item_get_data(replayed, &len, &id, &type, &qos);
+    TEST_CHECK(id != 5);
+    TEST_CHECK(check_pub(ob, id, 100, 0x05));
+
+    // 确认新 ID 后写删除记录，重启后只剩新消息
+    TEST_CHECK_INT(ESP_OK, outbox_delete(ob, id, MSG_TYPE_PUBLISH));
+    ob = restart(ob);
+    TEST_CHECK_INT(1, stats().depth);
+    TEST_CHECK(check_pub(ob, 5, 100, 0x55));
+    outbox_destroy(ob);
+}
+
+static void test_outbox_evict(void)
+{
+    // 三个扇区：写满后启用下一个扇区时丢弃其中还没确认的最旧消息
+    sim_flash_reset(MQTT_OUTBOX_PARTITION_LABEL, 3, SECTOR_SIZE);
+    outbox_t ob = outbox_init();
+    uint32_t evicted = stats().evicted;
+    for (uint16_t id = 1; id <= 12; id++)
+    {
+        enqueue_pub(ob, id, 1, 1100, (uint8_t)id);
+        enqueue_pub(ob, id + 100, 1, 1100, (uint8_t)id);
+        flush_by_dequeue(ob);
+    }
+    mqtt_outbox_stats_t st = stats();
+    TEST_CHECK(st.evicted > evicted);
+    TEST_CHECK_INT(24 - (st.evicted - evicted), st.depth);
+    TEST_CHECK(outbox_get(ob, 1) == NULL);
+    TEST_CHECK(check_pub(ob, 112, 1100, 12));
+
+    // 重启后在最新扇区之后启用新扇区，同样淘汰其中的消息；其余的全部重放
+    ob = restart(ob);
+    mqtt_outbox_stats_t after = stats();
+    TEST_CHECK_INT(st.depth - (after.evicted - st.evicted), after.depth);
+    TEST_CHECK(check_pub(ob, 112, 1100, 12));
+    outbox_destroy(ob);
+}
+
+// ========================
+// 一次确认很多条：MQTT 任务里删除时攒到一半就写，不丢删除记录；
+// 其他任务删除的只能等 MQTT 任务写，超出的丢弃并计数
+// ========================
+
+#define BURST 40
+
+static outbox_t s_burst_ob;
+
+static void *delete_thread(void *arg)
+{
+    for (uint16_t id = 1; id <= BURST; id++)
+    {
+        outbox_delete(s_burst_ob, id, MSG_TYPE_PUBLISH);
+    }
+    return NULL;
+}
+
+static outbox_t burst_setup(void)
+{
+    sim_flash_reset(MQTT_OUTBOX_PARTITION_LABEL, 4, SECTOR_SIZE);
+    outbox_t ob = outbox_init();
+    for (uint16_t id = 1; id <= BURST; id++)
+    {
+        enqueue_pub(ob, id, 1, 20, (uint8_t)id);
+    }
+    ob = restart(ob);
+    TEST_CHECK_INT(BURST, stats().depth);
+    // 记下 MQTT 任务（本线程）
+    outbox_dequeue(ob, QUEUED, NULL);
+    return ob;
+}
+
+static void test_outbox_delete_burst(void)
+{
+    outbox_t ob = burst_setup();
+    uint32_t dropped = stats().del_dropped;
+    for (uint16_t id = 1; id <= BURST; id++)
+    {
+        TEST_CHECK_INT(ESP_OK, outbox_delete(ob, id, MSG_TYPE_PUBLISH));
+    }
+    TEST_CHECK_INT(dropped, stats().del_dropped);
+    ob = restart(ob);
+    TEST_CHECK_INT(0, stats().depth);
+    outbox_destroy(ob);
+
+    s_burst_ob = burst_setup();
+    dropped = stats().del_dropped;
+    pthread_t thread;
+    TEST_CHECK(pthread_create(&thread, NULL, delete_thread, NULL) == 0);
+    pthread_join(thread, NULL);
+    TEST_CHECK_INT(0, stats().depth);
+    TEST_CHECK_INT(BURST - 32, stats().del_dropped - dropped);
+
+    // 删除记录被丢掉的消息重启后重发一次
+    ob = restart(s_burst_ob);
+    TEST_CHECK_INT(BURST - 32, stats().depth);
+    TEST_CHECK(check_pub(ob, BURST, 20, BURST));
+    outbox_destroy(ob);
+}
+
+int main(void)
+{
+    host_log_quiet = 1;
+
+    RUN_TEST(test_outbox_ram_only);
+    RUN_TEST(test_outbox_replay);
+    RUN_TEST(test_outbox_delete);
+    RUN_TEST(test_outbox_batch);
+    RUN_TEST(test_outbox_torn_write);
+    RUN_TEST(test_outbox_renumber);
+    RUN_TEST(test_outbox_evict);
+    RUN_TEST(test_outbox_delete_burst);
+    return TEST_RESULT();
+}
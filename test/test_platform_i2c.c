@@ -0,0 +1,373 @@
+// I2C 总线调度测试：真实的 platform_i2c.c 跑在模拟总线上，MPU6050 与 OLED 为模拟设备
+// 调度任务只能创建一次，各用例按顺序共享同一条总线
+#include "platform_i2c.h"
+#include "mpu6050.h"
+#include "mpu6050_data.h"
+#include "OLED.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sim_i2c.h"
+#include "sim_mpu6050.h"
+#include "sim_oled.h"
+#include "test_util.h"
+
+// platform_i2c.c 中注册给 OLED 驱动的写函数，没有放进头文件
+void OLED_WriteDataFunc(uint8_t *Data, uint8_t Count);
+
+static sim_i2c_record_t s_log[SIM_I2C_LOG_MAX];
+
+// 清空模拟设备与总线记录，重新挂上两个设备；总线和设备句柄保持不变
+static void bus_setup(void)
+{
+    sim_i2c_reset();
+    sim_mpu6050_reset();
+    sim_oled_reset();
+    sim_i2c_attach(SIM_MPU6050_ADDR, sim_mpu6050_xfer, NULL);
+    sim_i2c_attach(SIM_OLED_ADDR, sim_oled_xfer, NULL);
+}
+
+// 低优先级队列先进先出：一个同步的低优先级事务返回时，之前提交的显示事务都已执行完
+static void bus_drain_low(void)
+{
+    uint8_t cmd[2] = {0x00, 0xE3}; // SSD1306 NOP
+    platform_i2c_transfer(PLATFORM_I2C_DEV_OLED, PLATFORM_I2C_PRIO_LOW, cmd, sizeof(cmd), NULL, 0);
+}
+
+static void stats_get(platform_i2c_dev_t dev, platform_i2c_stats_t *st)
+{
+    TEST_CHECK_INT(ESP_OK, platform_i2c_get_stats(dev, st));
+}
+
+static void test_i2c_init(void)
+{
+    sim_i2c_counters_t c;
+    sim_i2c_get_counters(&c);
+    TEST_CHECK_INT(1, c.bus_creates);
+    TEST_CHECK_INT(PLATFORM_I2C_DEV_MAX, c.dev_adds);
+
+    platform_i2c_stats_t st;
+    stats_get(PLATFORM_I2C_DEV_MPU6050, &st);
+    TEST_CHECK_INT(400000, st.speed_hz);
+    stats_get(PLATFORM_I2C_DEV_OLED, &st);
+    TEST_CHECK_INT(400000, st.speed_hz);
+}
+
+static void test_i2c_mpu_over_bus(void)
+{
+    bus_setup();
+    TEST_CHECK_INT(0, Int_MPU6050_Init());
+    TEST_CHECK_INT(0x01, sim_mpu6050_peek(MPU_PWR_MGMT1_REG));
+
+    size_t n = sim_i2c_log(s_log, SIM_I2C_LOG_MAX);
+    TEST_CHECK(n > 0);
+    for (size_t i = 0; i < n; i++)
+    {
+        TEST_CHECK_INT(SIM_MPU6050_ADDR, s_log[i].addr);
+        TEST_CHECK_INT(400000, s_log[i].speed_hz);
+        TEST_CHECK_INT(ESP_OK, s_log[i].err);
+    }
+}
+
+static void test_i2c_fifo_single_burst(void)
+{
+    MPU6050_Sample_t in[30], out[MPU6050_FIFO_MAX_SAMPLES];
+    uint16_t count = 0;
+
+    bus_setup();
+    TEST_CHECK_INT(0, Int_MPU6050_Init());
+    TEST_CHECK_INT(0, Int_MPU6050_FIFO_Enable());
+    for (int i = 0; i < 30; i++)
+    {
+        in[i] = (MPU6050_Sample_t){.ax = (short)i, .ay = (short)-i, .az = 16384, .temp = -500,
+                                   .gx = (short)(i * 100), .gy = -32768, .gz = 32767};
+    }
+    sim_mpu6050_produce(in, 30);
+
+    size_t before = sim_i2c_log(s_log, SIM_I2C_LOG_MAX);
+    TEST_CHECK_INT(0, Int_MPU6050_FIFO_Read(out, MPU6050_FIFO_MAX_SAMPLES, &count));
+    size_t after = sim_i2c_log(s_log, SIM_I2C_LOG_MAX);
+    TEST_CHECK_INT(30, count);
+    TEST_CHECK(memcmp(in, out, sizeof(in)) == 0);
+
+    // 读计数一个事务，样本整批一个事务，不按样本拆分
+    TEST_CHECK_INT(2, after - before);
+    TEST_CHECK_INT(MPU_FIFO_CNTH_REG, s_log[before].tx0);
+    TEST_CHECK_INT(2, s_log[before].rx_len);
+    TEST_CHECK_INT(MPU_FIFO_RW_REG, s_log[before + 1].tx0);
+    TEST_CHECK_INT(30 * MPU6050_FIFO_SAMPLE_SIZE, s_log[before + 1].rx_len);
+}
+
+static void test_i2c_high_prio_preempts_display(void)
+{
+    uint8_t page[128];
+    uint8_t who = 0;
+    uint8_t reg = 0x75;
+
+    bus_setup();
+    sim_i2c_set_timing(true); // 400KHz 下一页显存约 3ms，一屏约 95ms
+
+    memset(page, 0x5A, sizeof(page));
+    for (int i = 0; i < 32; i++)
+    {
+        OLED_WriteDataFunc(page, sizeof(page));
+    }
+
+    // 显示事务排在前面，传感器读只等正在进行的那一个
+    uint64_t start = test_now_ns();
+    TEST_CHECK_INT(ESP_OK, platform_i2c_transfer(PLATFORM_I2C_DEV_MPU6050, PLATFORM_I2C_PRIO_HIGH, &reg, 1, &who, 1));
+    uint64_t wait_us = (test_now_ns() - start) / 1000;
+    TEST_CHECK_INT(MPU_IIC_ADDR, who);
+
+    bus_drain_low();
+    sim_i2c_set_timing(false);
+
+    size_t n = sim_i2c_log(s_log, SIM_I2C_LOG_MAX);
+    TEST_CHECK_INT(34, n);
+    size_t mpu_at = n;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (s_log[i].addr == SIM_MPU6050_ADDR)
+        {
+            mpu_at = i;
+            break;
+        }
+    }
+    TEST_CHECK(mpu_at <= 2);
+    TEST_CHECK(wait_us < 30000);
+    printf("  sensor read waited %llu us behind 32 queued display writes (position %zu)\n",
+           (unsigned long long)wait_us, mpu_at);
+
+    sim_oled_stats_t os;
+    sim_oled_get_stats(&os);
+    TEST_CHECK_INT(32, os.data_xfers);
+    TEST_CHECK_INT(32 * 128, os.data_bytes);
+}
+
+// ========================
+// 异步提交与重试
+// ========================
+
+static SemaphoreHandle_t s_done;
+static volatile esp_err_t s_done_err;
+
+static void on_done(esp_err_t err, void *arg)
+{
+    (void)arg;
+    s_done_err = err;
+    xSemaphoreGive(s_done);
+}
+
+static void test_i2c_async_error_after_retries(void)
+{
+    platform_i2c_stats_t before, after;
+
+    bus_setup();
+    stats_get(PLATFORM_I2C_DEV_OLED, &before);
+
+    // 第一次加 3 次重试全部失败
+    sim_i2c_fail_next(SIM_OLED_ADDR, ESP_FAIL, 4);
+    platform_i2c_xfer_t xfer = {.dev = PLATFORM_I2C_DEV_OLED, .tx = {0x00, 0xAF}, .tx_len = 2,
+                                .done_cb = on_done};
+    TEST_CHECK_INT(ESP_OK, platform_i2c_submit(&xfer, PLATFORM_I2C_PRIO_LOW, 0));
+    TEST_CHECK(xSemaphoreTake(s_done, pdMS_TO_TICKS(1000)) == pdTRUE);
+    TEST_CHECK_INT(ESP_FAIL, s_done_err);
+
+    stats_get(PLATFORM_I2C_DEV_OLED, &after);
+    TEST_CHECK_INT(4, after.xfers - before.xfers);
+    TEST_CHECK_INT(3, after.retries - before.retries);
+    TEST_CHECK_INT(1, after.errors - before.errors);
+
+    // 从机无应答时 SDA 是高的，不做总线恢复
+    TEST_CHECK_INT(0, after.recoveries - before.recoveries);
+}
+
+static void test_i2c_retry_success(void)
+{
+    platform_i2c_stats_t before, after;
+    uint8_t reg = 0x75, who = 0;
+
+    bus_setup();
+    stats_get(PLATFORM_I2C_DEV_MPU6050, &before);
+    sim_i2c_fail_next(SIM_MPU6050_ADDR, ESP_ERR_TIMEOUT, 2);
+    TEST_CHECK_INT(ESP_OK, platform_i2c_transfer(PLATFORM_I2C_DEV_MPU6050, PLATFORM_I2C_PRIO_HIGH, &reg, 1, &who, 1));
+    TEST_CHECK_INT(MPU_IIC_ADDR, who);
+
+    stats_get(PLATFORM_I2C_DEV_MPU6050, &after);
+    TEST_CHECK_INT(3, after.xfers - before.xfers);
+    TEST_CHECK_INT(2, after.retries - before.retries);
+    TEST_CHECK_INT(0, after.errors - before.errors);
+}
+
+static void test_i2c_invalid_args(void)
+{
+    platform_i2c_xfer_t xfer = {.dev = PLATFORM_I2C_DEV_MAX, .tx_len = 1};
+    TEST_CHECK_INT(ESP_ERR_INVALID_ARG, platform_i2c_submit(&xfer, PLATFORM_I2C_PRIO_LOW, 0));
+    xfer.dev = PLATFORM_I2C_DEV_OLED;
+    xfer.tx_len = PLATFORM_I2C_TX_MAX + 1;
+    TEST_CHECK_INT(ESP_ERR_INVALID_ARG, platform_i2c_submit(&xfer, PLATFORM_I2C_PRIO_LOW, 0));
+    TEST_CHECK_INT(ESP_ERR_INVALID_ARG, platform_i2c_submit(NULL, PLATFORM_I2C_PRIO_LOW, 0));
+    TEST_CHECK_INT(ESP_ERR_INVALID_ARG, platform_i2c_set_speed(PLATFORM_I2C_DEV_OLED, 9999));
+    TEST_CHECK_INT(ESP_ERR_INVALID_ARG, platform_i2c_set_speed(PLATFORM_I2C_DEV_OLED, 1000001));
+    TEST_CHECK_INT(ESP_ERR_INVALID_ARG, platform_i2c_set_speed(PLATFORM_I2C_DEV_MAX, 400000));
+    TEST_CHECK_INT(ESP_ERR_INVALID_ARG, platform_i2c_get_stats(PLATFORM_I2C_DEV_OLED, NULL));
+}
+
+// ========================
+// 总线卡死恢复
+// ========================
+
+// 连续 3 个事务重试用尽才恢复，前两个事务只报错
+static void bus_fail_until_recovery(void)
+{
+    uint8_t reg = 0x75, who = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        TEST_CHECK_INT(ESP_ERR_TIMEOUT,
+                       platform_i2c_transfer(PLATFORM_I2C_DEV_MPU6050, PLATFORM_I2C_PRIO_HIGH, &reg, 1, &who, 1));
+    }
+}
+
+static void test_i2c_recover_by_controller_reset(void)
+{
+    platform_i2c_stats_t before, after;
+    sim_i2c_counters_t c;
+    uint8_t reg = 0x75, who = 0;
+
+    bus_setup();
+    stats_get(PLATFORM_I2C_DEV_MPU6050, &before);
+    sim_i2c_stick_sda(true, 0);
+    bus_fail_until_recovery();
+
+    sim_i2c_get_counters(&c);
+    TEST_CHECK_INT(1, c.bus_resets);
+    TEST_CHECK_INT(0, c.bus_deletes); // 控制器复位就够了，不重建总线
+    stats_get(PLATFORM_I2C_DEV_MPU6050, &after);
+    TEST_CHECK_INT(1, after.recoveries - before.recoveries);
+    TEST_CHECK_INT(3, after.errors - before.errors);
+
+    TEST_CHECK_INT(ESP_OK, platform_i2c_transfer(PLATFORM_I2C_DEV_MPU6050, PLATFORM_I2C_PRIO_HIGH, &reg, 1, &who, 1));
+    TEST_CHECK_INT(MPU_IIC_ADDR, who);
+}
+
+static void test_i2c_recover_by_clock_out(void)
+{
+    sim_i2c_counters_t c;
+    uint8_t reg = 0x75, who = 0;
+
+    bus_setup();
+    sim_i2c_stick_sda(false, 5); // 控制器复位不管用，要手动打 5 个时钟
+    bus_fail_until_recovery();
+
+    sim_i2c_get_counters(&c);
+    TEST_CHECK_INT(1, c.bus_resets);
+    TEST_CHECK_INT(1, c.bus_deletes);
+    TEST_CHECK_INT(1, c.bus_creates);
+    TEST_CHECK_INT(PLATFORM_I2C_DEV_MAX, c.dev_removes);
+    TEST_CHECK_INT(PLATFORM_I2C_DEV_MAX, c.dev_adds);
+    TEST_CHECK(c.scl_pulses >= 5);
+
+    // 重建后两个设备保持原来的速率
+    TEST_CHECK_INT(ESP_OK, platform_i2c_transfer(PLATFORM_I2C_DEV_MPU6050, PLATFORM_I2C_PRIO_HIGH, &reg, 1, &who, 1));
+    bus_drain_low();
+    size_t n = sim_i2c_log(s_log, SIM_I2C_LOG_MAX);
+    TEST_CHECK(n >= 2);
+    TEST_CHECK_INT(400000, s_log[n - 2].speed_hz);
+    TEST_CHECK_INT(400000, s_log[n - 1].speed_hz);
+}
+
+// ========================
+// 运行时改速率
+// ========================
+
+static void test_i2c_set_speed(void)
+{
+    sim_i2c_counters_t c;
+    platform_i2c_stats_t st;
+
+    bus_setup();
+    TEST_CHECK_INT(ESP_OK, platform_i2c_set_speed(PLATFORM_I2C_DEV_OLED, 100000));
+    bus_drain_low();
+
+    sim_i2c_get_counters(&c);
+    TEST_CHECK_INT(1, c.dev_removes);
+    TEST_CHECK_INT(1, c.dev_adds);
+    size_t n = sim_i2c_log(s_log, SIM_I2C_LOG_MAX);
+    TEST_CHECK_INT(1, n);
+    TEST_CHECK_INT(100000, s_log[0].speed_hz);
+    stats_get(PLATFORM_I2C_DEV_OLED, &st);
+    TEST_CHECK_INT(100000, st.speed_hz);
+
+    // 设置和当前相同的速率不重建句柄
+    TEST_CHECK_INT(ESP_OK, platform_i2c_set_speed(PLATFORM_I2C_DEV_OLED, 100000));
+    bus_drain_low();
+    sim_i2c_get_counters(&c);
+    TEST_CHECK_INT(1, c.dev_adds);
+
+    // 新速率添加失败时退回原速率
+    sim_i2c_fail_add_device(ESP_ERR_NO_MEM, 1);
+    TEST_CHECK_INT(ESP_OK, platform_i2c_set_speed(PLATFORM_I2C_DEV_OLED, 1000000));
+    bus_drain_low();
+    n = sim_i2c_log(s_log, SIM_I2C_LOG_MAX);
+    TEST_CHECK_INT(100000, s_log[n - 1].speed_hz);
+    TEST_CHECK_INT(ESP_OK, s_log[n - 1].err);
+
+    // 原速率也加不回去：事务报错，不上总线；之后的事务重新添加设备
+    // 首次执行失败两次（新速率、原速率），3 次重试各失败一次
+    uint8_t nop[2] = {0x00, 0xE3};
+    sim_i2c_fail_add_device(ESP_ERR_NO_MEM, 2 + 3);
+    TEST_CHECK_INT(ESP_OK, platform_i2c_set_speed(PLATFORM_I2C_DEV_OLED, 1000000));
+    TEST_CHECK_INT(ESP_ERR_NO_MEM, platform_i2c_transfer(PLATFORM_I2C_DEV_OLED, PLATFORM_I2C_PRIO_LOW, nop, sizeof(nop), NULL, 0));
+    bus_setup();
+    TEST_CHECK_INT(ESP_OK, platform_i2c_transfer(PLATFORM_I2C_DEV_OLED, PLATFORM_I2C_PRIO_LOW, nop, sizeof(nop), NULL, 0));
+    n = sim_i2c_log(s_log, SIM_I2C_LOG_MAX);
+    TEST_CHECK_INT(1, n);
+    TEST_CHECK_INT(100000, s_log[0].speed_hz);
+
+    TEST_CHECK_INT(ESP_OK, platform_i2c_set_speed(PLATFORM_I2C_DEV_OLED, 400000));
+    bus_drain_low();
+    stats_get(PLATFORM_I2C_DEV_OLED, &st);
+    TEST_CHECK_INT(400000, st.speed_hz);
+}
+
+static void test_i2c_oled_frame(void)
+{
+    sim_oled_stats_t os;
+
+    bus_setup();
+    OLED_Init();
+    OLED_Clear();
+    OLED_ShowString(0, 0, "host", OLED_8X16);
+    OLED_Update();
+    bus_drain_low();
+
+    // 一帧 8 页，每页一次 128 字节的数据写
+    sim_oled_get_stats(&os);
+    TEST_CHECK(os.data_xfers >= 8);
+    TEST_CHECK(os.data_bytes >= 8 * 128);
+    TEST_CHECK(os.commands > 0);
+}
+
+int main(void)
+{
+    host_log_quiet = 1;
+    bus_setup();
+    // 与 app_main 一样在初始化前设置速率（默认是 100KHz）
+    TEST_CHECK_INT(ESP_OK, platform_i2c_set_speed(PLATFORM_I2C_DEV_MPU6050, 400000));
+    TEST_CHECK_INT(ESP_OK, platform_i2c_set_speed(PLATFORM_I2C_DEV_OLED, 400000));
+    platform_i2c_init();
+    platform_driver_register();
+    s_done = xSemaphoreCreateBinary();
+
+    RUN_TEST(test_i2c_init);
+    RUN_TEST(test_i2c_mpu_over_bus);
+    RUN_TEST(test_i2c_fifo_single_burst);
+    RUN_TEST(test_i2c_high_prio_preempts_display);
+    RUN_TEST(test_i2c_async_error_after_retries);
+    RUN_TEST(test_i2c_retry_success);
+    RUN_TEST(test_i2c_invalid_args);
+    RUN_TEST(test_i2c_recover_by_controller_reset);
+    RUN_TEST(test_i2c_recover_by_clock_out);
+    RUN_TEST(test_i2c_set_speed);
+    RUN_TEST(test_i2c_oled_frame);
+    return TEST_RESULT();
+}
@@ -0,0 +1,211 @@
+// app_ring 单元测试：边界、回绕、对齐，以及一个生产者线程 + 一个消费者线程的顺序校验
+#include "app_ring.h"
+#include "test_util.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+static app_ring_t s_ring;
+
+static void ring_push_ts(int64_t ts)
+{
+    app_sample_t *slot = app_ring_reserve(&s_ring);
+    TEST_CHECK(slot != NULL);
+    if (slot)
+    {
+        memset(slot, 0, sizeof(*slot));
+        slot->ts_us = ts;
+        app_ring_commit(&s_ring);
+    }
+}
+
+static void test_ring_empty(void)
+{
+    const app_sample_t *first = NULL;
+
+    app_ring_init(&s_ring);
+    TEST_CHECK_INT(0, app_ring_count(&s_ring));
+    TEST_CHECK_INT(0, app_ring_peek(&s_ring, &first));
+}
+
+static void test_ring_layout(void)
+{
+    // 读写索引不在同一个 cache line，样本数组按 cache line 对齐
+    TEST_CHECK(offsetof(app_ring_t, tail) - offsetof(app_ring_t, head) >= APP_RING_ALIGN);
+    TEST_CHECK(offsetof(app_ring_t, buf) % APP_RING_ALIGN == 0);
+    TEST_CHECK_INT(32, sizeof(app_sample_t));
+}
+
+static void test_ring_fill_and_full(void)
+{
+    app_ring_init(&s_ring);
+    for (int i = 0; i < APP_RING_CAPACITY; i++)
+    {
+        ring_push_ts(i);
+    }
+    TEST_CHECK_INT(APP_RING_CAPACITY, app_ring_count(&s_ring));
+
+    // 写满后不再给出槽位，也不会覆盖未读的样本
+    TEST_CHECK(app_ring_reserve(&s_ring) == NULL);
+    TEST_CHECK(app_ring_reserve(&s_ring) == NULL);
+
+    const app_sample_t *first = NULL;
+    TEST_CHECK_INT(APP_RING_CAPACITY, app_ring_peek(&s_ring, &first));
+    TEST_CHECK_INT(0, first[0].ts_us);
+    TEST_CHECK_INT(APP_RING_CAPACITY - 1, first[APP_RING_CAPACITY - 1].ts_us);
+
+    // 释放一个后又能写一个
+    app_ring_release(&s_ring, 1);
+    TEST_CHECK(app_ring_reserve(&s_ring) != NULL);
+}
+
+static void test_ring_reserve_without_commit(void)
+{
+    // 没有提交的槽位对消费者不可见，再次 reserve 返回同一个槽位
+    app_ring_init(&s_ring);
+    app_sample_t *a = app_ring_reserve(&s_ring);
+    app_sample_t *b = app_ring_reserve(&s_ring);
+    TEST_CHECK(a == b);
+    TEST_CHECK_INT(0, app_ring_count(&s_ring));
+}
+
+static void test_ring_wrap(void)
+{
+    const app_sample_t *first = NULL;
+    const int head_start = APP_RING_CAPACITY - 3;
+
+    app_ring_init(&s_ring);
+
+    // 把读写位置推到接近数组末尾
+    for (int i = 0; i < head_start; i++)
+    {
+        ring_push_ts(-1);
+    }
+    TEST_CHECK_INT(head_start, app_ring_peek(&s_ring, &first));
+    app_ring_release(&s_ring, head_start);
+
+    for (int i = 0; i < 10; i++)
+    {
+        ring_push_ts(i);
+    }
+    TEST_CHECK_INT(10, app_ring_count(&s_ring));
+
+    // peek 只给出回绕点之前的连续部分，剩下的下一次给出
+    size_t n = app_ring_peek(&s_ring, &first);
+    TEST_CHECK_INT(3, n);
+    TEST_CHECK_INT(0, first[0].ts_us);
+    TEST_CHECK_INT(2, first[2].ts_us);
+    app_ring_release(&s_ring, n);
+
+    n = app_ring_peek(&s_ring, &first);
+    TEST_CHECK_INT(7, n);
+    TEST_CHECK(first == &s_ring.buf[0]);
+    TEST_CHECK_INT(3, first[0].ts_us);
+    TEST_CHECK_INT(9, first[6].ts_us);
+    app_ring_release(&s_ring, n);
+    TEST_CHECK_INT(0, app_ring_count(&s_ring));
+}
+
+static void test_ring_index_overflow(void)
+{
+    // 索引是自由增长的 uint32_t，跨过 2^32 时计数仍然正确
+    const app_sample_t *first = NULL;
+
+    app_ring_init(&s_ring);
+    atomic_store(&s_ring.head, UINT32_MAX - 1);
+    atomic_store(&s_ring.tail, UINT32_MAX - 1);
+
+    for (int i = 0; i < 5; i++)
+    {
+        ring_push_ts(i);
+    }
+    TEST_CHECK_INT(5, app_ring_count(&s_ring));
+
+    size_t total = 0;
+    int64_t expect = 0;
+    size_t n;
+    while ((n = app_ring_peek(&s_ring, &first)) > 0)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            TEST_CHECK_INT(expect++, first[i].ts_us);
+        }
+        app_ring_release(&s_ring, n);
+        total += n;
+    }
+    TEST_CHECK_INT(5, total);
+}
+
+// ========================
+// 双线程：生产者按序号写，消费者批量读并检查序号连续、不丢不重
+// ========================
+
+#define RING_STRESS_COUNT 2000000
+
+static void *ring_producer(void *arg)
+{
+    (void)arg;
+    for (int64_t i = 0; i < RING_STRESS_COUNT;)
+    {
+        app_sample_t *slot = app_ring_reserve(&s_ring);
+        if (!slot)
+        {
+            sched_yield(); // 单核机器上让消费者有机会运行
+            continue;
+        }
+        slot->ts_us = i;
+        slot->gx = (int32_t)(i * 7);
+        app_ring_commit(&s_ring);
+        i++;
+    }
+    return NULL;
+}
+
+static void test_ring_spsc_threads(void)
+{
+    pthread_t producer;
+    int64_t expect = 0;
+    int errors = 0;
+
+    app_ring_init(&s_ring);
+    pthread_create(&producer, NULL, ring_producer, NULL);
+
+    while (expect < RING_STRESS_COUNT)
+    {
+        const app_sample_t *first = NULL;
+        size_t n = app_ring_peek(&s_ring, &first);
+        for (size_t i = 0; i < n; i++)
+        {
+            if (first[i].ts_us != expect || first[i].gx != (int32_t)(expect * 7))
+            {
+                errors++;
+            }
+            expect++;
+        }
+        if (n > 0)
+        {
+            app_ring_release(&s_ring, n);
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+
+    pthread_join(producer, NULL);
+    TEST_CHECK_INT(0, errors);
+    TEST_CHECK_INT(0, app_ring_count(&s_ring));
+}
+
+int main(void)
+{
+    RUN_TEST(test_ring_empty);
+    RUN_TEST(test_ring_layout);
+    RUN_TEST(test_ring_fill_and_full);
+    RUN_TEST(test_ring_reserve_without_commit);
+    RUN_TEST(test_ring_wrap);
+    RUN_TEST(test_ring_index_overflow);
+    RUN_TEST(test_ring_spsc_threads);
+    return TEST_RESULT();
+}
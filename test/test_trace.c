@@ -0,0 +1,240 @@
+// 二进制跟踪测试：记录格式与截断、运行期级别、采样、环形缓冲区回绕，以及写入方不停写时的分段读取
+#include "trace.h"
+#include "test_util.h"
+#include <pthread.h>
+#include <sched.h>
+
+static trace_record_t s_out[TRACE_RECORD_COUNT + 8];
+
+// 读出 since 之后的全部记录
+static size_t read_all(uint32_t since)
+{
+    return trace_read(since, UINT32_MAX, s_out, sizeof(s_out) / sizeof(s_out[0]));
+}
+
+static void test_trace_empty(void)
+{
+    TEST_CHECK_INT(0, trace_last_seq());
+    TEST_CHECK_INT(0, read_all(0));
+}
+
+static void test_trace_record(void)
+{
+    uint8_t big[TRACE_PAYLOAD_MAX + 10];
+    for (size_t i = 0; i < sizeof(big); i++)
+    {
+        big[i] = (uint8_t)i;
+    }
+
+    uint32_t since = trace_last_seq();
+    trace_write(TRACE_MOD_MQTT, TRACE_INFO, TRACE_EV_MQTT_RX, "abc", 3);
+    trace_write(TRACE_MOD_APP, TRACE_WARN, TRACE_EV_APP_CMD, big, sizeof(big));
+    trace_write(TRACE_MOD_NET, TRACE_ERROR, 7, NULL, 5);
+    trace_write(TRACE_MOD_MAX, TRACE_ERROR, 7, NULL, 0);
+
+    TEST_CHECK_INT(since + 3, trace_last_seq());
+    TEST_CHECK_INT(3, read_all(since));
+    TEST_CHECK_INT(since + 1, s_out[0].seq);
+    TEST_CHECK_INT(TRACE_MOD_MQTT, s_out[0].module);
+    TEST_CHECK_INT(TRACE_EV_MQTT_RX, s_out[0].event);
+    TEST_CHECK_INT(3, s_out[0].stored);
+    TEST_CHECK(memcmp(s_out[0].data, "abc", 3) == 0);
+
+    // 超长的数据截断，保留原始长度
+    TEST_CHECK_INT(TRACE_WARN, s_out[1].level);
+    TEST_CHECK_INT(sizeof(big), s_out[1].len);
+    TEST_CHECK_INT(TRACE_PAYLOAD_MAX, s_out[1].stored);
+    TEST_CHECK(memcmp(s_out[1].data, big, TRACE_PAYLOAD_MAX) == 0);
+
+    // 没有数据时只记长度
+    TEST_CHECK_INT(5, s_out[2].len);
+    TEST_CHECK_INT(0, s_out[2].stored);
+}
+
+static void test_trace_levels(void)
+{
+    uint32_t since = trace_last_seq();
+
+    // 默认只到 INFO，DEBUG 的负载跟踪不记录
+    TRACE_EVENT(MQTT, TRACE_DEBUG, TRACE_EV_MQTT_TX, "x", 1);
+    TEST_CHECK_INT(since, trace_last_seq());
+
+    trace_set_level(TRACE_MOD_MQTT, TRACE_DEBUG, 0);
+    TRACE_EVENT(MQTT, TRACE_DEBUG, TRACE_EV_MQTT_TX, "x", 1);
+    TEST_CHECK_INT(since + 1, trace_last_seq());
+
+    // 关闭后 ERROR 也不记录，其他模块不受影响
+    trace_set_level(TRACE_MOD_MQTT, TRACE_NONE, 0);
+    TRACE_EVENT(MQTT, TRACE_ERROR, TRACE_EV_MQTT_TX, "x", 1);
+    TRACE_EVENT(NET, TRACE_ERROR, 1, NULL, 0);
+    TEST_CHECK_INT(since + 2, trace_last_seq());
+
+    uint8_t level;
+    uint16_t sample;
+    trace_set_level(TRACE_MOD_MQTT, TRACE_VERBOSE + 3, 0);
+    trace_get_level(TRACE_MOD_MQTT, &level, &sample);
+    TEST_CHECK_INT(TRACE_VERBOSE, level);
+    trace_set_level(TRACE_MOD_MQTT, TRACE_RUNTIME_LEVEL_DEFAULT, 0);
+
+    TEST_CHECK_INT(TRACE_MOD_APP, trace_module_find("app"));
+    TEST_CHECK_INT(TRACE_MOD_MAX, trace_module_find("wifi"));
+    TEST_CHECK_INT(TRACE_MOD_MAX, trace_module_find(NULL));
+}
+
+static void test_trace_sampling(void)
+{
+    uint32_t sampled_before, sampled_after;
+    trace_get_stats(&sampled_before, NULL);
+    uint32_t since = trace_last_seq();
+
+    // 每 3 条记 1 条：第 1、4、7 条
+    trace_set_level(TRACE_MOD_APP, TRACE_INFO, 3);
+    for (uint8_t i = 1; i <= 9; i++)
+    {
+        trace_write(TRACE_MOD_APP, TRACE_INFO, TRACE_EV_APP_CMD, &i, 1);
+    }
+    // 采样按模块计数，其他模块照常记录
+    trace_write(TRACE_MOD_NET, TRACE_INFO, 1, NULL, 0);
+
+    TEST_CHECK_INT(4, read_all(since));
+    TEST_CHECK_INT(1, s_out[0].data[0]);
+    TEST_CHECK_INT(4, s_out[1].data[0]);
+    TEST_CHECK_INT(7, s_out[2].data[0]);
+    TEST_CHECK_INT(TRACE_MOD_NET, s_out[3].module);
+    trace_get_stats(&sampled_after, NULL);
+    TEST_CHECK_INT(6, sampled_after - sampled_before);
+
+    // 重新设置后采样计数从头开始；sample 为 0 或 1 时全部记录
+    since = trace_last_seq();
+    trace_set_level(TRACE_MOD_APP, TRACE_INFO, 2);
+    for (uint8_t i = 1; i <= 4; i++)
+    {
+        trace_write(TRACE_MOD_APP, TRACE_INFO, TRACE_EV_APP_CMD, &i, 1);
+    }
+    TEST_CHECK_INT(2, read_all(since));
+    TEST_CHECK_INT(1, s_out[0].data[0]);
+    TEST_CHECK_INT(3, s_out[1].data[0]);
+
+    since = trace_last_seq();
+    trace_set_level(TRACE_MOD_APP, TRACE_INFO, 1);
+    for (uint8_t i = 1; i <= 4; i++)
+    {
+        trace_write(TRACE_MOD_APP, TRACE_INFO, TRACE_EV_APP_CMD, &i, 1);
+    }
+    TEST_CHECK_INT(4, read_all(since));
+    trace_set_level(TRACE_MOD_APP, TRACE_RUNTIME_LEVEL_DEFAULT, 0);
+}
+
+static void test_trace_wrap(void)
+{
+    // 写满一圈再多写 10 条：最早的记录被覆盖
+    for (uint32_t i = 0; i < TRACE_RECORD_COUNT + 10; i++)
+    {
+        trace_write(TRACE_MOD_NET, TRACE_INFO, 1, &i, sizeof(i));
+    }
+    uint32_t last = trace_last_seq();
+    uint32_t oldest = last - TRACE_RECORD_COUNT + 1;
+
+    uint32_t overwritten;
+    trace_get_stats(NULL, &overwritten);
+    TEST_CHECK_INT(last - TRACE_RECORD_COUNT, overwritten);
+
+    // 从 0 或已被覆盖的序号读起，都从最早仍在缓冲区中的一条开始，按序号连续
+    TEST_CHECK_INT(TRACE_RECORD_COUNT, read_all(0));
+    TEST_CHECK_INT(oldest, s_out[0].seq);
+    TEST_CHECK_INT(TRACE_RECORD_COUNT, read_all(oldest - 5));
+    TEST_CHECK_INT(oldest, s_out[0].seq);
+    for (size_t i = 1; i < TRACE_RECORD_COUNT; i++)
+    {
+        if (s_out[i].seq != s_out[i - 1].seq + 1)
+        {
+            TEST_CHECK_INT(s_out[i - 1].seq + 1, s_out[i].seq);
+            break;
+        }
+    }
+    uint32_t v;
+    memcpy(&v, s_out[TRACE_RECORD_COUNT - 1].data, sizeof(v));
+    TEST_CHECK_INT(TRACE_RECORD_COUNT + 9, v);
+
+    // 续读、读到最新、until 截止、max 限制
+    TEST_CHECK_INT(3, read_all(last - 3));
+    TEST_CHECK_INT(last - 2, s_out[0].seq);
+    TEST_CHECK_INT(0, read_all(last));
+    TEST_CHECK_INT(2, trace_read(last - 5, last - 3, s_out, 8));
+    TEST_CHECK_INT(last - 3, s_out[1].seq);
+    TEST_CHECK_INT(4, trace_read(0, last, s_out, 4));
+    TEST_CHECK_INT(oldest + 3, s_out[3].seq);
+}
+
+// ========================
+// 写入方不停写时按 /trace 的方式分段读：先定下 until，读到它为止一定结束
+// ========================
+
+static volatile bool s_writer_stop = false;
+static volatile uint32_t s_writer_count = 0;
+
+static void *writer_thread(void *arg)
+{
+    (void)arg;
+    while (!s_writer_stop)
+    {
+        uint32_t n = s_writer_count;
+        trace_write(TRACE_MOD_MQTT, TRACE_INFO, TRACE_EV_MQTT_RX, &n, sizeof(n));
+        s_writer_count = n + 1;
+    }
+    return NULL;
+}
+
+static void test_trace_bounded_read(void)
+{
+    pthread_t writer;
+    s_writer_stop = false;
+    TEST_CHECK(pthread_create(&writer, NULL, writer_thread, NULL) == 0);
+    while (s_writer_count < 1000)
+    {
+        sched_yield();
+    }
+
+    for (int round = 0; round < 20; round++)
+    {
+        uint32_t since = 0;
+        uint32_t until = trace_last_seq();
+        size_t n, batches = 0;
+        trace_record_t batch[4];
+        while ((n = trace_read(since, until, batch, 4)) > 0)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                if (batch[i].seq <= since || batch[i].seq > until)
+                {
+                    TEST_CHECK(batch[i].seq > since && batch[i].seq <= until);
+                }
+                since = batch[i].seq;
+            }
+            batches++;
+            if (batches > TRACE_RECORD_COUNT)
+            {
+                TEST_CHECK(batches <= TRACE_RECORD_COUNT);
+                break;
+            }
+        }
+        TEST_CHECK(since <= until);
+    }
+
+    s_writer_stop = true;
+    pthread_join(writer, NULL);
+    TEST_CHECK(trace_last_seq() >= 1000);
+}
+
+int main(void)
+{
+    host_log_quiet = 1;
+
+    RUN_TEST(test_trace_empty);
+    RUN_TEST(test_trace_record);
+    RUN_TEST(test_trace_levels);
+    RUN_TEST(test_trace_sampling);
+    RUN_TEST(test_trace_wrap);
+    RUN_TEST(test_trace_bounded_read);
+    return TEST_RESULT();
+}